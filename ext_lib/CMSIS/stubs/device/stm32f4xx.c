@@ -14,10 +14,17 @@ void stm_stub_init()
 	USART1 = (USART_TypeDef*) calloc(1, sizeof(USART_TypeDef));
 	USART2 = (USART_TypeDef*) calloc(1, sizeof(USART_TypeDef));
 	NVIC = (NVIC_Type*) calloc(1, sizeof(NVIC_Type));
+	SysTick = (SysTick_Type*) calloc(1, sizeof(SysTick_Type));
+	SCB = (SCB_Type*) calloc(1, sizeof(SCB_Type));
+	DWT = (DWT_Type*) calloc(1, sizeof(DWT_Type));
+	CoreDebug = (CoreDebug_Type*) calloc(1, sizeof(CoreDebug_Type));
 	SYSCFG = (SYSCFG_TypeDef*) calloc(1, sizeof(SYSCFG_TypeDef));
 	EXTI = (EXTI_TypeDef*) calloc(1, sizeof(EXTI_TypeDef));
 	TIM2 = (TIM_TypeDef*) calloc(1, sizeof(TIM_TypeDef));
 	TIM4 = (TIM_TypeDef*) calloc(1, sizeof(TIM_TypeDef));
+	TIM5 = (TIM_TypeDef*) calloc(1, sizeof(TIM_TypeDef));
+	PWR = (PWR_TypeDef*) calloc(1, sizeof(PWR_TypeDef));
+	RTC = (RTC_TypeDef*) calloc(1, sizeof(RTC_TypeDef));
 	I2C1 = (I2C_TypeDef*) calloc(1, sizeof(I2C_TypeDef));
 
 	for (uint8_t i = 0; i < irq_arr_size; i++)
@@ -35,10 +42,17 @@ void stm_stub_deinit()
 	free(USART1);
 	free(USART2);
 	free(NVIC);
+	free(SysTick);
+	free(SCB);
+	free(DWT);
+	free(CoreDebug);
 	free(SYSCFG);
 	free(EXTI);
 	free(TIM2);
    free(TIM4);
+   free(TIM5);
+   free(PWR);
+   free(RTC);
 	free(I2C1);
 }
 void NVIC_EnableIRQ(IRQn_Type IRQn)
@@ -100,7 +114,11 @@ uint8_t stm_stub_check_irq(IRQn_Type IRQn, uint8_t active)
 
 void SysTick_Config(uint32_t ticks)
 {
-
+	if (SysTick)
+	{
+		SysTick->LOAD = ticks - 1;
+		SysTick->VAL = 0;
+	}
 }
 void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
 {
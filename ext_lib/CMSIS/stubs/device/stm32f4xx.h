@@ -91,6 +91,40 @@ typedef struct
   uint32_t STIR;                    /*!< Offset: 0xE00 ( /W)  Software Trigger Interrupt Register     */
 }  NVIC_Type;
 
+typedef struct
+{
+  uint32_t CTRL;                    /*!< Offset: 0x000 (R/W)  SysTick Control and Status Register */
+  uint32_t LOAD;                    /*!< Offset: 0x004 (R/W)  SysTick Reload Value Register       */
+  uint32_t VAL;                     /*!< Offset: 0x008 (R/W)  SysTick Current Value Register      */
+  uint32_t CALIB;                   /*!< Offset: 0x00C (R/ )  SysTick Calibration Register        */
+} SysTick_Type;
+
+typedef struct
+{
+  uint32_t CPUID;                   /*!< Offset: 0x000 (R/ )  CPUID Base Register                                   */
+  uint32_t ICSR;                    /*!< Offset: 0x004 (R/W)  Interrupt Control and State Register                  */
+} SCB_Type;
+
+typedef struct
+{
+  uint32_t CTRL;                    /*!< Offset: 0x000 (R/W)  Control Register                    */
+  uint32_t CYCCNT;                  /*!< Offset: 0x004 (R/W)  Cycle Count Register                */
+} DWT_Type;
+
+typedef struct
+{
+  uint32_t DHCSR;                   /*!< Offset: 0x000 (R/W)  Debug Halting Control and Status Register    */
+  uint32_t DCRSR;                   /*!< Offset: 0x004 ( /W)  Debug Core Register Selector Register        */
+  uint32_t DCRDR;                   /*!< Offset: 0x008 (R/W)  Debug Core Register Data Register            */
+  uint32_t DEMCR;                   /*!< Offset: 0x00C (R/W)  Debug Exception and Monitor Control Register */
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk               ((uint32_t)0x00000001)
+#define CoreDebug_DEMCR_TRCENA_Msk           ((uint32_t)0x01000000)
+#define SCB_ICSR_PENDSTSET_Msk               ((uint32_t)0x04000000)
+#define SCB_ICSR_PENDSVSET_Msk               ((uint32_t)0x10000000)
+#define SysTick_LOAD_RELOAD_Msk              ((uint32_t)0x00FFFFFF)
+
 #define  RCC_AHB1ENR_GPIOAEN                 ((uint32_t)0x00000001)
 #define  RCC_AHB1ENR_GPIOBEN                 ((uint32_t)0x00000002)
 #define  RCC_AHB1ENR_GPIOCEN                 ((uint32_t)0x00000004)
@@ -99,6 +133,26 @@ typedef struct
 #define  RCC_APB1ENR_TIM3EN                  ((uint32_t)0x00000002)
 #define  RCC_APB1ENR_TIM4EN                  ((uint32_t)0x00000004)
 #define  RCC_APB1ENR_TIM5EN                  ((uint32_t)0x00000008)
+#define  RCC_APB1ENR_PWREN                   ((uint32_t)0x10000000)
+#define  RCC_BDCR_LSEON                      ((uint32_t)0x00000001)
+#define  RCC_BDCR_LSERDY                     ((uint32_t)0x00000002)
+#define  RCC_BDCR_RTCSEL                     ((uint32_t)0x00000300)
+#define  RCC_BDCR_RTCSEL_0                   ((uint32_t)0x00000100)
+#define  RCC_BDCR_RTCEN                      ((uint32_t)0x00008000)
+#define  PWR_CR_DBP                          ((uint32_t)0x00000100)
+#define RTC_CR_ALRAIE                        ((uint32_t)0x00001000)
+#define RTC_CR_ALRAE                         ((uint32_t)0x00000100)
+#define RTC_CR_FMT                           ((uint32_t)0x00000040)
+#define RTC_ISR_ALRAF                        ((uint32_t)0x00000100)
+#define RTC_ISR_INIT                         ((uint32_t)0x00000080)
+#define RTC_ISR_INITF                        ((uint32_t)0x00000040)
+#define RTC_ISR_RSF                          ((uint32_t)0x00000020)
+#define RTC_ISR_INITS                        ((uint32_t)0x00000010)
+#define RTC_ISR_SHPF                         ((uint32_t)0x00000008)
+#define RTC_ISR_ALRAWF                       ((uint32_t)0x00000001)
+#define RTC_SHIFTR_ADD1S                     ((uint32_t)0x80000000)
+#define RTC_ALRMASSR_MASKSS                  ((uint32_t)0x0F000000)
+#define RTC_ALRMASSR_SS                      ((uint32_t)0x00007FFF)
 #define  RCC_APB1ENR_TIM6EN                  ((uint32_t)0x00000010)
 #define  RCC_APB1ENR_TIM7EN                  ((uint32_t)0x00000020)
 #define  RCC_APB1ENR_TIM12EN                 ((uint32_t)0x00000040)
@@ -564,6 +618,7 @@ typedef struct
 #define  TIM_DIER_COMDE                      ((uint16_t)0x2000)            /*!<COM DMA request enable               */
 #define  TIM_DIER_TDE                        ((uint16_t)0x4000)            /*!<Trigger DMA request enable           */
 
+#define  TIM_EGR_UG                          ((uint16_t)0x0001)            /*!<Update Generation                  */
 #define  TIM_SR_UIF                          ((uint16_t)0x0001)            /*!<Update interrupt Flag              */
 #define  TIM_SR_CC1IF                        ((uint16_t)0x0002)            /*!<Capture/Compare 1 interrupt Flag   */
 #define  TIM_SR_CC2IF                        ((uint16_t)0x0004)            /*!<Capture/Compare 2 interrupt Flag   */
@@ -705,6 +760,38 @@ typedef struct
   uint16_t      RESERVED14;  /*!< Reserved, 0x52                                            */
 } TIM_TypeDef;
 
+typedef struct
+{
+  uint32_t CR;
+  uint32_t CSR;
+} PWR_TypeDef;
+
+typedef struct
+{
+  uint32_t TR;
+  uint32_t DR;
+  uint32_t CR;
+  uint32_t ISR;
+  uint32_t PRER;
+  uint32_t WUTR;
+  uint32_t CALIBR;
+  uint32_t ALRMAR;
+  uint32_t ALRMBR;
+  uint32_t WPR;
+  uint32_t SSR;
+  uint32_t SHIFTR;
+  uint32_t TSTR;
+  uint32_t TSDR;
+  uint32_t TSSSR;
+  uint32_t CALR;
+  uint32_t TAFCR;
+  uint32_t ALRMASSR;
+  uint32_t ALRMBSSR;
+  uint32_t RESERVED7;
+  uint32_t BKP0R;
+  uint32_t BKP1R;
+} RTC_TypeDef;
+
 typedef enum IRQn
 {
    EXTI4_IRQn                  = 22,
@@ -746,6 +833,7 @@ typedef enum IRQn
 	FPU_IRQn                    = 81,      /*!< FPU global interrupt                                             */
 	SPI4_IRQn                   = 84,     /*!< SPI4 global Interrupt                                             */
 	SysTick_IRQn,
+	PendSV_IRQn,
 }IRQn_Type;
 
 
@@ -756,10 +844,17 @@ RCC_TypeDef* RCC;
 USART_TypeDef* USART1;
 USART_TypeDef* USART2;
 NVIC_Type* NVIC;
+SysTick_Type* SysTick;
+SCB_Type* SCB;
+DWT_Type* DWT;
+CoreDebug_Type* CoreDebug;
 SYSCFG_TypeDef* SYSCFG;
 EXTI_TypeDef* EXTI;
 TIM_TypeDef* TIM2;
 TIM_TypeDef* TIM4;
+TIM_TypeDef* TIM5;
+PWR_TypeDef* PWR;
+RTC_TypeDef* RTC;
 I2C_TypeDef* I2C1;
 
 
@@ -7,6 +7,7 @@
 #include "task_scheduler.h"
 #include "command_parser.h"
 #include "Logger.h"
+#include "logger_crashlog.h"
 #include "i2c_driver.h"
 #include "inputs_board.h"
 #include "relays_board.h"
@@ -15,6 +16,8 @@
 #include "bathroom_fan.h"
 #include "system_timestamp.h"
 #include "notification_manager.h"
+#include "event_queue.h"
+#include "rtc_driver.h"
 #include "system_config_values.h"
 
 #ifdef SIMULATION
@@ -61,6 +64,14 @@ void sm_setup_int_priorities()
    prio = NVIC_EncodePriority(0x05, 2, 0);
    NVIC_SetPriority(USART1_IRQn, prio);
 
+   /*
+    * PendSV is used by task scheduler as soft interrupt for SOFTIRQ tasks. It has the lowest
+    * priority (the same preemption level as SysTick, lower subpriority), so it is called
+    * after all other interrupts return, but still before main loop.
+    */
+   prio = NVIC_EncodePriority(0x05, 3, 3);
+   NVIC_SetPriority(PendSV_IRQn, prio);
+
 }
 
 
@@ -71,6 +82,18 @@ int main(void)
    ts_init();
 	time_init();
 	sch_initialize();
+#ifdef SH_USE_TICKLESS
+	/* timer interrupt only when the next task is due */
+	time_set_tickless(&sch_get_next_deadline);
+#endif
+#ifdef SH_USE_RTC
+	/* calendar is kept by RTC during reset, local time is restored from it */
+	static const TimeCalendarBackend rtc_backend = {&rtc_get_calendar, &rtc_set_calendar};
+	if (rtc_initialize() != RETURN_OK || time_set_calendar_backend(&rtc_backend) != RETURN_OK)
+	{
+	   logger_send(LOG_ERROR, __func__, "Cannot initialize RTC");
+	}
+#endif
 
 	/* BTengine is module shared between logger and command parser, therefore is always initialized */
 	BT_Config config = {UART_COMMON_BAUD_RATE, UART_COMMON_BUFFER_SIZE, UART_COMMON_STRING_SIZE};
@@ -110,10 +133,30 @@ int main(void)
    logger_set_group_state(LOG_ENV, LOGGER_ENV_GROUP_STATE);
    logger_set_group_state(LOG_SLM, LOGGER_SLM_GROUP_STATE);
    logger_set_group_state(LOG_FAN, LOGGER_SLM_GROUP_STATE);
-   if (logger_register_sender(&btengine_send_string) != RETURN_OK)
+#ifdef SH_USE_LOGGER_BINARY
+   /* compact frames sent over BT, decoded on host by log_decoder tool */
+   logger_set_binary_sender(&btengine_send_bytes);
+   logger_set_deferred(1);
+#else
+   LoggerSinkConfig bt_sink = {&btengine_try_send_string, LOGGER_ALL_GROUPS, LOGGER_COMPILED_LEVEL, LOGGER_SINK_QUEUE_DEFAULT};
+   if (logger_add_sink(&bt_sink) == LOGGER_INVALID_SINK)
    {
-      logger_send(LOG_ERROR, __func__, "Cannot register BT sender!");
+      logger_send(LOG_ERROR, __func__, "Cannot add BT sink!");
    }
+#endif
+   /* crash log is written immediately, queued lines would be lost on reset */
+   logger_crashlog_init();
+   LoggerSinkConfig crashlog_sink = {&logger_crashlog_write, LOGGER_ALL_GROUPS, LOGGER_LEVEL_INFO, 0};
+   if (logger_add_sink(&crashlog_sink) == LOGGER_INVALID_SINK)
+   {
+      logger_send(LOG_ERROR, __func__, "Cannot add crash log sink!");
+   }
+   /* error storms (e.g. not responding sensor) cannot saturate the link */
+   logger_set_rate_limit(LOGGER_RATE_BURST_DEFAULT, LOGGER_RATE_PER_S_DEFAULT);
+#ifdef SH_USE_LOGGER_DEFERRED
+   /* logs from interrupts are formatted and sent from main loop */
+   logger_set_deferred(1);
+#endif
 #endif
    logger_send(LOG_ERROR, __func__, "Booting started!");
 
@@ -124,6 +167,16 @@ int main(void)
    {
       logger_send(LOG_ERROR, __func__, "Cannot initiailize wifi manager!");
    }
+#ifdef SH_USE_LOGGER
+   /* logs of WiFi modules are not sent over WiFi, every sent line would produce new logs,
+    * one line per call as every transfer waits for two replies of WiFi module */
+   LoggerSinkConfig wifi_sink = {&wifimgr_try_broadcast_data, LOGGER_ALL_GROUPS & ~(((uint32_t)1 << LOG_WIFI_DRIVER) | ((uint32_t)1 << LOG_WIFI_MANAGER)),
+                                 LOGGER_LEVEL_INFO, LOGGER_SINK_QUEUE_DEFAULT, 1};
+   if (logger_add_sink(&wifi_sink) == LOGGER_INVALID_SINK)
+   {
+      logger_send(LOG_ERROR, __func__, "Cannot add WiFi sink!");
+   }
+#endif
 #endif
 
 
@@ -237,10 +290,9 @@ int main(void)
 
 	while (1)
 	{
-	   i2c_watcher();
-	   dht_data_watcher();
-		sch_task_watcher(TASKPRIO_LOW);
-		btengine_string_watcher();
+		/* work deferred from interrupts: low priority tasks, time callbacks, i2c, dht, bluetooth */
+		evq_dispatch_all();
+		logger_watcher();
 		wifi_data_watcher();
 #ifdef SIMULATION
 		hwstub_watcher();
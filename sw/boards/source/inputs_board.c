@@ -54,7 +54,7 @@ void (*INP_CALLBACKS[INPUTS_CALLBACK_MAX_SIZE])(INPUT_STATUS status);
 
 RET_CODE inp_initialize(const INPUTS_CONFIG* config)
 {
-   logger_send(LOG_INPUTS, __func__, "");
+   LOG_INFO(LOG_INPUTS, __func__, "");
    RET_CODE result = RETURN_NOK;
    inp_module.autoupdate_enabled = INPUTS_AUTOUPDATE_STATE;
    inp_module.autoupdate_time = INPUTS_AUTOUPDATE_DEF_TIME_MS;
@@ -79,7 +79,7 @@ RET_CODE inp_initialize(const INPUTS_CONFIG* config)
       }
    }
    int_handler_init();
-   logger_send_if(result != RETURN_OK, LOG_ERROR, __func__, "error");
+   LOG_ERR_IF(result != RETURN_OK, __func__, "error");
    return result;
 }
 void inp_deinitialize()
@@ -147,7 +147,7 @@ RET_CODE inp_get_config(INPUTS_CONFIG* buffer)
 }
 void inp_read_inputs()
 {
-   logger_send(LOG_INPUTS, __func__, "");
+   LOG_INFO(LOG_INPUTS, __func__, "");
    uint8_t data [2];
    I2C_STATUS result = i2c_read(inp_module.cfg.address + 1, data, 2);
 
@@ -164,13 +164,13 @@ void inp_read_inputs()
    }
    else
    {
-      logger_send(LOG_ERROR, __func__, "cannot read inputs");
+      LOG_ERR(__func__, "cannot read inputs");
    }
 }
 
 void inp_parse_state(uint16_t state, INPUT_STATUS* buffer)
 {
-   logger_send(LOG_INPUTS, __func__, "current %x new %x", inp_module.current_inputs, state);
+   LOG_INFO(LOG_INPUTS, __func__, "current %x new %x", inp_module.current_inputs, state);
    for (uint8_t i = 0; i < INPUTS_MAX_INPUT_LINES; i++)
    {
       uint16_t inp_mask = inp_input_to_mask(inp_module.cfg.items[i].input_no);
@@ -181,7 +181,7 @@ void inp_parse_state(uint16_t state, INPUT_STATUS* buffer)
 
 void inp_on_timeout()
 {
-   logger_send(LOG_INPUTS, __func__, "reading after timeout");
+   LOG_INFO(LOG_INPUTS, __func__, "reading after timeout");
    inp_read_inputs();
 }
 void inp_notify_inputs_change(const INPUT_STATUS* new_inputs)
@@ -191,7 +191,7 @@ void inp_notify_inputs_change(const INPUT_STATUS* new_inputs)
       if (new_inputs[i].state != inp_module.current_states[i].state)
       {
          inp_module.current_states[i] = new_inputs[i];
-         logger_send(LOG_INPUTS, __func__, "changed %u to %u", inp_module.cfg.items[i].input_no, inp_module.current_states[i].state);
+         LOG_INFO(LOG_INPUTS, __func__, "changed %u to %u", inp_module.cfg.items[i].input_no, inp_module.current_states[i].state);
          inp_notify_callbacks(&inp_module.current_states[i]);
       }
    }
@@ -244,12 +244,12 @@ RET_CODE inp_validate_autoupdate_time(uint16_t time)
 
 void inp_enable_interrupt()
 {
-   logger_send(LOG_INPUTS, __func__, "enabling interrupts");
+   LOG_INFO(LOG_INPUTS, __func__, "enabling interrupts");
    inp_module.interrupt_enabled = 1;
 }
 void inp_disable_interrupt()
 {
-   logger_send(LOG_INPUTS, __func__, "disabling interrupts");
+   LOG_INFO(LOG_INPUTS, __func__, "disabling interrupts");
    inp_module.interrupt_enabled = 0;
 }
 RET_CODE inp_set_debounce_time(uint16_t time)
@@ -261,10 +261,10 @@ RET_CODE inp_set_debounce_time(uint16_t time)
       {
          result = RETURN_OK;
          inp_module.debounce_time = time;
-         logger_send(LOG_INPUTS, __func__, "new debounce time %u", time);
+         LOG_INFO(LOG_INPUTS, __func__, "new debounce time %u", time);
       }
    }
-   logger_send_if(result != RETURN_OK, LOG_ERROR, __func__, "invalid time %d", time);
+   LOG_ERR_IF(result != RETURN_OK, __func__, "invalid time %d", time);
    return result;
 }
 uint16_t inp_get_debounce_time()
@@ -284,23 +284,23 @@ RET_CODE inp_set_periodic_update_time(uint16_t period)
       {
          result = RETURN_OK;
          inp_module.autoupdate_time = period;
-         logger_send(LOG_INPUTS, __func__, "new autoupdate time %u", period);
+         LOG_INFO(LOG_INPUTS, __func__, "new autoupdate time %u", period);
       }
    }
-   logger_send_if(result != RETURN_OK, LOG_ERROR, __func__, "invalid time %d", period);
+   LOG_ERR_IF(result != RETURN_OK, __func__, "invalid time %d", period);
    return result;
 }
 void inp_enable_periodic_update()
 {
    inp_module.autoupdate_enabled = 1;
    sch_set_task_state(&inp_read_inputs, TASKSTATE_RUNNING);
-   logger_send(LOG_INPUTS, __func__, "enabling autoupdate");
+   LOG_INFO(LOG_INPUTS, __func__, "enabling autoupdate");
 }
 void inp_disable_periodic_update()
 {
    inp_module.autoupdate_enabled = 0;
    sch_set_task_state(&inp_read_inputs, TASKSTATE_STOPPED);
-   logger_send(LOG_INPUTS, __func__, "disabling autoupdate");
+   LOG_INFO(LOG_INPUTS, __func__, "disabling autoupdate");
 }
 RET_CODE inp_add_input_listener(INPUT_LISTENER callback)
 {
@@ -16,7 +16,9 @@
 #include "bathroom_fan.h"
 #include "env_monitor.h"
 #include "Logger.h"
+#include "logger_crashlog.h"
 #include "stairs_led_module.h"
+#include "task_scheduler.h"
 #include "system_config_values.h"
 #include "stm32f4xx.h"
 /* =============================
@@ -40,6 +42,7 @@ RET_CODE cmd_handle_bathfan_subcommand(const char** command, uint8_t size);
 RET_CODE cmd_handle_env_subcommand(const char** command, uint8_t size);
 RET_CODE cmd_handle_logger_subcommand(const char** command, uint8_t size);
 RET_CODE cmd_handle_system_subcommand(const char** command, uint8_t size);
+RET_CODE cmd_handle_sch_subcommand(const char** command, uint8_t size);
 /* =============================
  *      Module variables
  * =============================*/
@@ -57,7 +60,7 @@ void cmd_unregister_sender()
 }
 void cmd_prepare_response(RET_CODE result)
 {
-   string_format(CMD_REPLY_BUFFER, "%s", result == RETURN_OK? "OK\n" : "ERROR\n");
+   string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "%s", result == RETURN_OK? "OK\n" : "ERROR\n");
 }
 
 void cmd_send_response()
@@ -75,7 +78,7 @@ void cmd_handle_data(const char* data)
 	if (CMD_PARSER_USE_ECHO)
 	{
 		/* send echo */
-		string_format(CMD_REPLY_BUFFER, "CMD: %s\n", data);
+		string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "CMD: %s\n", data);
 		cmd_send_response();
 	}
 	/* send response */
@@ -86,11 +89,11 @@ void cmd_handle_data(const char* data)
 RET_CODE cmd_parse_data(const char* data)
 {
 	RET_CODE result = RETURN_NOK;
-	char cmd_received [strlen(data)];
+	char cmd_received [strlen(data) + 1];
 	const char* cmd_items [10];
 	char delims[3] = " ";
 	uint8_t index = 0;
-	string_format(cmd_received, "%s", data);
+	string_format_n(cmd_received, sizeof(cmd_received), "%s", data);
 	char* item = strtok(cmd_received, delims);
 
 	while(item)
@@ -110,6 +113,7 @@ RET_CODE cmd_parse_data(const char* data)
    if (!strcmp(cmd_items[0], "env")) result =  cmd_handle_env_subcommand(cmd_items, index);
    if (!strcmp(cmd_items[0], "log")) result =  cmd_handle_logger_subcommand(cmd_items, index);
    if (!strcmp(cmd_items[0], "system")) result =  cmd_handle_system_subcommand(cmd_items, index);
+   if (!strcmp(cmd_items[0], "sch")) result =  cmd_handle_sch_subcommand(cmd_items, index);
 	return result;
 }
 
@@ -123,7 +127,7 @@ RET_CODE cmd_handle_system_subcommand(const char** command, uint8_t size)
    }
    if (!strcmp(command[1], "version"))
    {
-	  string_format(CMD_REPLY_BUFFER, "VERSION: %s", SYSTEM_VERSION);
+	  string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "VERSION: %s", SYSTEM_VERSION);
 	  cmd_send_response();
       result = RETURN_OK;
    }
@@ -138,12 +142,12 @@ RET_CODE cmd_handle_inp_subcommand(const char** command, uint8_t size)
       result = inp_get_all(inputs_state);
       if (result == RETURN_OK)
       {
-         int offset = string_format(CMD_REPLY_BUFFER, "INP_STATE: ");
+         int offset = string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "INP_STATE: ");
          for (uint8_t i = 0; i < INPUTS_MAX_INPUT_LINES; i++)
          {
-            offset += string_format(CMD_REPLY_BUFFER + (offset), "%d:%s ", (i + 1), inputs_state[i].state == INPUT_STATE_ACTIVE? "ON" : "OFF");
+            offset += string_format_n(CMD_REPLY_BUFFER + (offset), CMD_REPLY_BUFFER_SIZE - (offset), "%d:%s ", (i + 1), inputs_state[i].state == INPUT_STATE_ACTIVE? "ON" : "OFF");
          }
-         string_format(CMD_REPLY_BUFFER + (offset-1), "\n");
+         string_format_n(CMD_REPLY_BUFFER + (offset-1), CMD_REPLY_BUFFER_SIZE - (offset-1), "\n");
          cmd_send_response();
       }
    }
@@ -153,12 +157,12 @@ RET_CODE cmd_handle_inp_subcommand(const char** command, uint8_t size)
       result = inp_read_all(inputs_state);
       if (result == RETURN_OK)
       {
-         int offset = string_format(CMD_REPLY_BUFFER, "INP_STATE: ");
+         int offset = string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "INP_STATE: ");
          for (uint8_t i = 0; i < INPUTS_MAX_INPUT_LINES; i++)
          {
-            offset += string_format(CMD_REPLY_BUFFER + (offset), "%d:%s ", (i + 1), inputs_state[i].state == INPUT_STATE_ACTIVE? "ON" : "OFF");
+            offset += string_format_n(CMD_REPLY_BUFFER + (offset), CMD_REPLY_BUFFER_SIZE - (offset), "%d:%s ", (i + 1), inputs_state[i].state == INPUT_STATE_ACTIVE? "ON" : "OFF");
          }
-         string_format(CMD_REPLY_BUFFER + (offset -1), "\n");
+         string_format_n(CMD_REPLY_BUFFER + (offset -1), CMD_REPLY_BUFFER_SIZE - (offset -1), "\n");
          cmd_send_response();
       }
    }
@@ -168,12 +172,12 @@ RET_CODE cmd_handle_inp_subcommand(const char** command, uint8_t size)
       result = inp_get_config(&cfg);
       if (result == RETURN_OK)
       {
-         int offset = string_format(CMD_REPLY_BUFFER, "INP_CONFIG:\n");
-         offset += string_format(CMD_REPLY_BUFFER + (offset) , "address: %d\n", cfg.address);
-         offset += string_format(CMD_REPLY_BUFFER + (offset) , "item:input no\n");
+         int offset = string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "INP_CONFIG:\n");
+         offset += string_format_n(CMD_REPLY_BUFFER + (offset), CMD_REPLY_BUFFER_SIZE - (offset), "address: %d\n", cfg.address);
+         offset += string_format_n(CMD_REPLY_BUFFER + (offset), CMD_REPLY_BUFFER_SIZE - (offset), "item:input no\n");
          for (uint8_t i = 0; i < INPUTS_MAX_INPUT_LINES; i++)
          {
-            offset += string_format(CMD_REPLY_BUFFER + (offset), "%d:%d\n", cfg.items[i].item, cfg.items[i].input_no);
+            offset += string_format_n(CMD_REPLY_BUFFER + (offset), CMD_REPLY_BUFFER_SIZE - (offset), "%d:%d\n", cfg.items[i].item, cfg.items[i].input_no);
          }
          cmd_send_response();
       }
@@ -194,7 +198,7 @@ RET_CODE cmd_handle_inp_subcommand(const char** command, uint8_t size)
    }
    else if (!strcmp(command[1], "get_debounce_time"))
    {
-      string_format(CMD_REPLY_BUFFER, "DEB_TIME:%d\n", inp_get_debounce_time());
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "DEB_TIME:%d\n", inp_get_debounce_time());
       cmd_send_response();
       result = RETURN_OK;
    }
@@ -204,7 +208,7 @@ RET_CODE cmd_handle_inp_subcommand(const char** command, uint8_t size)
    }
    else if (!strcmp(command[1], "get_update_time"))
    {
-      string_format(CMD_REPLY_BUFFER, "UPD_TIME:%d\n", inp_get_periodic_update_time());
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "UPD_TIME:%d\n", inp_get_periodic_update_time());
       cmd_send_response();
       result = RETURN_OK;
    }
@@ -237,12 +241,12 @@ RET_CODE cmd_handle_rel_subcommand(const char** command, uint8_t size)
       result = rel_get_all(relays_state);
       if (result == RETURN_OK)
       {
-         int offset = string_format(CMD_REPLY_BUFFER, "REL_STATE: ");
+         int offset = string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "REL_STATE: ");
          for (uint8_t i = 0; i < RELAYS_BOARD_COUNT; i++)
          {
-            offset += string_format(CMD_REPLY_BUFFER + (offset -1), "%d:%s ", (i + 1), relays_state[i].state == RELAY_STATE_ON? "ON" : "OFF");
+            offset += string_format_n(CMD_REPLY_BUFFER + (offset -1), CMD_REPLY_BUFFER_SIZE - (offset -1), "%d:%s ", (i + 1), relays_state[i].state == RELAY_STATE_ON? "ON" : "OFF");
          }
-         string_format(CMD_REPLY_BUFFER + (offset -2), "\n");
+         string_format_n(CMD_REPLY_BUFFER + (offset -2), CMD_REPLY_BUFFER_SIZE - (offset -2), "\n");
          cmd_send_response();
       }
    }
@@ -252,12 +256,12 @@ RET_CODE cmd_handle_rel_subcommand(const char** command, uint8_t size)
       result = rel_read_all(relays_state);
       if (result == RETURN_OK)
       {
-         int offset = string_format(CMD_REPLY_BUFFER, "REL_STATE: ");
+         int offset = string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "REL_STATE: ");
          for (uint8_t i = 0; i < RELAYS_BOARD_COUNT; i++)
          {
-            offset += string_format(CMD_REPLY_BUFFER + (offset -1), "%d:%s ", (i + 1), relays_state[i].state == RELAY_STATE_ON? "ON" : "OFF");
+            offset += string_format_n(CMD_REPLY_BUFFER + (offset -1), CMD_REPLY_BUFFER_SIZE - (offset -1), "%d:%s ", (i + 1), relays_state[i].state == RELAY_STATE_ON? "ON" : "OFF");
          }
-         string_format(CMD_REPLY_BUFFER + (offset -2), "\n");
+         string_format_n(CMD_REPLY_BUFFER + (offset -2), CMD_REPLY_BUFFER_SIZE - (offset -2), "\n");
          cmd_send_response();
       }
    }
@@ -267,12 +271,12 @@ RET_CODE cmd_handle_rel_subcommand(const char** command, uint8_t size)
       result = rel_get_config(&cfg);
       if (result == RETURN_OK)
       {
-         int offset = string_format(CMD_REPLY_BUFFER, "REL_CONFIG:\n");
-         offset += string_format(CMD_REPLY_BUFFER + (offset) , "address: %d\n", cfg.address);
-         offset += string_format(CMD_REPLY_BUFFER + (offset) , "item:relay no\n");
+         int offset = string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "REL_CONFIG:\n");
+         offset += string_format_n(CMD_REPLY_BUFFER + (offset), CMD_REPLY_BUFFER_SIZE - (offset), "address: %d\n", cfg.address);
+         offset += string_format_n(CMD_REPLY_BUFFER + (offset), CMD_REPLY_BUFFER_SIZE - (offset), "item:relay no\n");
          for (uint8_t i = 0; i < RELAYS_BOARD_COUNT; i++)
          {
-            offset += string_format(CMD_REPLY_BUFFER + (offset), "%d:%d\n", cfg.items[i].id, cfg.items[i].relay_no);
+            offset += string_format_n(CMD_REPLY_BUFFER + (offset), CMD_REPLY_BUFFER_SIZE - (offset), "%d:%d\n", cfg.items[i].id, cfg.items[i].relay_no);
          }
          cmd_send_response();
       }
@@ -283,7 +287,7 @@ RET_CODE cmd_handle_rel_subcommand(const char** command, uint8_t size)
    }
    else if (!strcmp(command[1], "get_update_time"))
    {
-      string_format(CMD_REPLY_BUFFER, "UPD_TIME:%d\n", rel_get_verification_period());
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "UPD_TIME:%d\n", rel_get_verification_period());
       cmd_send_response();
       result = RETURN_OK;
    }
@@ -309,7 +313,7 @@ RET_CODE cmd_handle_slm_subcommand(const char** command, uint8_t size)
    {
       SLM_CONFIG cfg;
       result = slm_get_config(&cfg);
-      string_format(CMD_REPLY_BUFFER, "SLM_CONFIG:\nID:%d\nOFF_MODE:%d\naddr:%d\n", cfg.program_id, cfg.off_effect_mode, cfg.address);
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "SLM_CONFIG:\nID:%d\nOFF_MODE:%d\naddr:%d\n", cfg.program_id, cfg.off_effect_mode, cfg.address);
       cmd_send_response();
    }
    else if (!strcmp(command[1], "start"))
@@ -326,7 +330,7 @@ RET_CODE cmd_handle_slm_subcommand(const char** command, uint8_t size)
    }
    else if (!strcmp(command[1], "status"))
    {
-      string_format(CMD_REPLY_BUFFER, "STATUS:state:%d, id:%d\n", (uint8_t)slm_get_state(), (uint8_t)slm_get_current_program_id());
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "STATUS:state:%d, id:%d\n", (uint8_t)slm_get_state(), (uint8_t)slm_get_current_program_id());
       cmd_send_response();
       result = RETURN_OK;
    }
@@ -354,7 +358,7 @@ RET_CODE cmd_handle_wifimgr_subcommand(const char** command, uint8_t size)
 		{
 			IPAddress item = {};
 			result = wifimgr_get_ip_address(&item);
-			string_format(CMD_REPLY_BUFFER, "IP:%d.%d.%d.%d\n", item.ip_address[0], item.ip_address[1], item.ip_address[2], item.ip_address[3]);
+			string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "IP:%d.%d.%d.%d\n", item.ip_address[0], item.ip_address[1], item.ip_address[2], item.ip_address[3]);
 			cmd_send_response();
 		}
 	}
@@ -368,7 +372,7 @@ RET_CODE cmd_handle_wifimgr_subcommand(const char** command, uint8_t size)
 		{
 			char network_name [100];
 			result = wifimgr_get_network_name(network_name, 100);
-			string_format(CMD_REPLY_BUFFER, "SSID:%s\n", network_name);
+			string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "SSID:%s\n", network_name);
 			cmd_send_response();
 		}
 	}
@@ -382,7 +386,7 @@ RET_CODE cmd_handle_wifimgr_subcommand(const char** command, uint8_t size)
 		{
 			const char* server = wifimgr_get_ntp_server();
 			result = server? RETURN_OK : RETURN_NOK;
-			string_format(CMD_REPLY_BUFFER, "NTP:%s\n", server);
+			string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "NTP:%s\n", server);
 			cmd_send_response();
 		}
 	}
@@ -396,7 +400,7 @@ RET_CODE cmd_handle_wifimgr_subcommand(const char** command, uint8_t size)
 		{
 			uint16_t port = wifimgr_get_server_port();
 			result = RETURN_OK;
-			string_format(CMD_REPLY_BUFFER, "PORT:%d\n", port);
+			string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "PORT:%d\n", port);
 			cmd_send_response();
 		}
 	}
@@ -409,7 +413,7 @@ RET_CODE cmd_handle_wifimgr_subcommand(const char** command, uint8_t size)
 			result = count != 0? RETURN_OK : RETURN_NOK;
 			for (uint8_t i = 0; i < count; i++)
 			{
-				string_format(CMD_REPLY_BUFFER, "CLIENT%d: type %d, %d.%d.%d.%d\n", buffer[i].id,
+				string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "CLIENT%d: type %d, %d.%d.%d.%d\n", buffer[i].id,
 											buffer[i].type, buffer[i].address.ip_address[0],
 															buffer[i].address.ip_address[1],
 															buffer[i].address.ip_address[2],
@@ -431,7 +435,7 @@ RET_CODE cmd_handle_i2cdrv_subcommand(const char** command, uint8_t size)
    }
    else if (!strcmp(command[1], "get_timeout"))
    {
-      string_format(CMD_REPLY_BUFFER, "TIMEOUT:%d\n", i2c_get_timeout());
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "TIMEOUT:%d\n", i2c_get_timeout());
       cmd_send_response();
       result = RETURN_OK;
    }
@@ -442,12 +446,12 @@ RET_CODE cmd_handle_i2cdrv_subcommand(const char** command, uint8_t size)
       uint8_t buffer [size];
       if (i2c_read(address, buffer, size) == I2C_STATUS_OK)
       {
-         int offset = string_format(CMD_REPLY_BUFFER, "DATA:");
+         int offset = string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "DATA:");
          for (uint8_t i = 0; i < size; i++)
          {
-            offset += string_format(CMD_REPLY_BUFFER + (offset), " %d", buffer[i]);
+            offset += string_format_n(CMD_REPLY_BUFFER + (offset), CMD_REPLY_BUFFER_SIZE - (offset), " %d", buffer[i]);
          }
-         string_format(CMD_REPLY_BUFFER + (offset), "\n");
+         string_format_n(CMD_REPLY_BUFFER + (offset), CMD_REPLY_BUFFER_SIZE - (offset), "\n");
          cmd_send_response();
          result = RETURN_OK;
       }
@@ -485,7 +489,7 @@ RET_CODE cmd_handle_dhtdrv_subcommand(const char** command, uint8_t size)
    }
    else if (!strcmp(command[1], "get_timeout"))
    {
-      string_format(CMD_REPLY_BUFFER, "TIMEOUT:%d\n", dht_get_timeout());
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "TIMEOUT:%d\n", dht_get_timeout());
       cmd_send_response();
       result = RETURN_OK;
    }
@@ -494,7 +498,7 @@ RET_CODE cmd_handle_dhtdrv_subcommand(const char** command, uint8_t size)
    {
       DHT_SENSOR sensor;
       dht_read((DHT_SENSOR_ID)(atoi(command[2])), &sensor);
-      string_format(CMD_REPLY_BUFFER, "DATA:%d.%dC %d.%d%% t:%d\n", sensor.data.temp_h, sensor.data.temp_l, sensor.data.hum_h, sensor.data.hum_l, sensor.type);
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "DATA:%d.%dC %d.%d%% t:%d\n", sensor.data.temp_h, sensor.data.temp_l, sensor.data.hum_h, sensor.data.hum_l, sensor.type);
       cmd_send_response();
       result = RETURN_OK;
    }
@@ -530,7 +534,7 @@ RET_CODE cmd_handle_bathfan_subcommand(const char** command, uint8_t size)
    }
    else if(!strcmp(command[1], "get_state"))
    {
-      string_format(CMD_REPLY_BUFFER, "STATE:%d\n", (uint8_t)fan_get_state());
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "STATE:%d\n", (uint8_t)fan_get_state());
       cmd_send_response();
       result = RETURN_OK;
    }
@@ -538,7 +542,7 @@ RET_CODE cmd_handle_bathfan_subcommand(const char** command, uint8_t size)
    {
       FAN_CONFIG cfg;
       result = fan_get_config(&cfg);
-      string_format(CMD_REPLY_BUFFER, "FAN_CONFIG:\nMIN_WORK_TIME:%d\nMAX_WORK_TIME:%d\nHUM_THR:%d\nTHR_HYST:%d\n",
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "FAN_CONFIG:\nMIN_WORK_TIME:%d\nMAX_WORK_TIME:%d\nHUM_THR:%d\nTHR_HYST:%d\n",
                                        cfg.min_working_time_s, cfg.max_working_time_s, cfg.fan_humidity_threshold, cfg.fan_threshold_hysteresis);
       cmd_send_response();
    }
@@ -552,13 +556,13 @@ RET_CODE cmd_handle_env_subcommand(const char** command, uint8_t size)
    {
       DHT_SENSOR sensor;
       result = env_read_sensor((ENV_ITEM_ID)atoi(command[2]), &sensor);
-      string_format(CMD_REPLY_BUFFER, "DATA:%d.%dC %d.%d%% t:%d\n", sensor.data.temp_h, sensor.data.temp_l, sensor.data.hum_h, sensor.data.hum_l, sensor.type);
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "DATA:%d.%dC %d.%d%% t:%d\n", sensor.data.temp_h, sensor.data.temp_l, sensor.data.hum_h, sensor.data.hum_l, sensor.type);
       cmd_send_response();
    }
    else if(!strcmp(command[1], "read_error"))
    {
       ENV_ERROR_RATE sensor = env_get_error_stats((ENV_ITEM_ID)atoi(command[2]));
-      string_format(CMD_REPLY_BUFFER, "DATA:\nNR:%d%% CS:%d%%\n", sensor.nr_err_rate, sensor.cs_err_rate);
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "DATA:\nNR:%d%% CS:%d%%\n", sensor.nr_err_rate, sensor.cs_err_rate);
       cmd_send_response();
       result = RETURN_OK;
    }
@@ -568,7 +572,7 @@ RET_CODE cmd_handle_env_subcommand(const char** command, uint8_t size)
    }
    else if(!strcmp(command[1], "get_meas_period"))
    {
-      string_format(CMD_REPLY_BUFFER, "PERIOD:%d\n", env_get_measurement_period());
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "PERIOD:%d\n", env_get_measurement_period());
       cmd_send_response();
       result = RETURN_OK;
    }
@@ -606,11 +610,112 @@ RET_CODE cmd_handle_logger_subcommand(const char** command, uint8_t size)
       uint16_t offset = 0;
       for (uint8_t i = 0; i < LOG_ENUM_MAX; i++)
       {
-         offset += string_format(CMD_REPLY_BUFFER + (offset), "%s:%d\n", logger_group_to_string((LogGroup)i),
+         offset += string_format_n(CMD_REPLY_BUFFER + (offset), CMD_REPLY_BUFFER_SIZE - (offset), "%s:%d\n", logger_group_to_string((LogGroup)i),
                                                                          logger_get_group_state((LogGroup)i));
       }
       cmd_send_response();
       result = RETURN_OK;
    }
+   else if(size == 4 && !strcmp(command[1], "set_rate"))
+   {
+      /* log set_rate <burst> <logs per second>, burst 0 disables rate limiting */
+      result = logger_set_rate_limit(atoi(command[2]), atoi(command[3]));
+   }
+   else if(!strcmp(command[1], "get_rate"))
+   {
+      uint16_t burst;
+      uint16_t rate;
+      logger_get_rate_limit(&burst, &rate);
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "BURST:%d RATE:%d\n", burst, rate);
+      cmd_send_response();
+      result = RETURN_OK;
+   }
+   else if(size == 5 && !strcmp(command[1], "set_sink"))
+   {
+      /* log set_sink <sink> <groups mask, e.g. 0x1F> <level> */
+      result = logger_set_sink_filter(atoi(command[2]), strtoul(command[3], NULL, 0), atoi(command[4]));
+   }
+   else if(size == 3 && !strcmp(command[1], "get_sink"))
+   {
+      uint32_t groups;
+      uint8_t level;
+      result = logger_get_sink_filter(atoi(command[2]), &groups, &level);
+      if (result == RETURN_OK)
+      {
+         string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "GROUPS:%x LEVEL:%d DROPPED:%u\n", groups, level, logger_get_sink_dropped(atoi(command[2])));
+         cmd_send_response();
+      }
+   }
+   else if(!strcmp(command[1], "crashlog"))
+   {
+      /* crash log is bigger than reply buffer, it is sent in parts */
+      uint16_t offset = 0;
+      uint16_t length;
+      while ((length = logger_crashlog_read(CMD_REPLY_BUFFER, offset, CMD_REPLY_BUFFER_SIZE - 1)) > 0)
+      {
+         CMD_REPLY_BUFFER[length] = 0x00;
+         cmd_send_response();
+         offset += length;
+      }
+      result = RETURN_OK;
+   }
+   else if(!strcmp(command[1], "crashlog_clear"))
+   {
+      logger_crashlog_clear();
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE cmd_handle_sch_subcommand(const char** command, uint8_t size)
+{
+   RET_CODE result = RETURN_NOK;
+   if (size >= 2 && !strcmp(command[1], "stats"))
+   {
+      if (size == 2)
+      {
+         SchTaskStats stats;
+         uint8_t idx = 0;
+         while (sch_get_task_stats(idx, &stats) == RETURN_OK)
+         {
+            uint32_t avg_time = stats.calls? stats.total_time_us / stats.calls : 0;
+            string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "TASK%d:%x prio:%d period:%d calls:%u last:%uus max:%uus avg:%uus lat:%uus max_lat:%uus ovr:%d late:%u drop:%u\n",
+                                            idx, (unsigned int)(uintptr_t)stats.task, (uint8_t)stats.priority, stats.period,
+                                            stats.calls, stats.last_time_us, stats.max_time_us, avg_time,
+                                            stats.last_latency_us, stats.max_latency_us, stats.overruns,
+                                            stats.late_calls, stats.dropped_calls);
+            cmd_send_response();
+            idx++;
+         }
+         result = RETURN_OK;
+      }
+      else if (!strcmp(command[2], "enable"))
+      {
+         sch_enable_stats();
+         result = RETURN_OK;
+      }
+      else if (!strcmp(command[2], "disable"))
+      {
+         sch_disable_stats();
+         result = RETURN_OK;
+      }
+      else if (!strcmp(command[2], "reset"))
+      {
+         sch_reset_stats();
+         result = RETURN_OK;
+      }
+   }
+   else if (size >= 2 && !strcmp(command[1], "pool"))
+   {
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "POOL: size:%d used:%d max_used:%d\n", SCH_TASK_POOL_SIZE, sch_get_tasks_count(), sch_get_pool_high_water());
+      cmd_send_response();
+      result = RETURN_OK;
+   }
+   else if (size >= 2 && !strcmp(command[1], "ticks"))
+   {
+      string_format_n(CMD_REPLY_BUFFER, CMD_REPLY_BUFFER_SIZE, "TICKS: dropped:%u\n", sch_get_dropped_ticks());
+      cmd_send_response();
+      result = RETURN_OK;
+   }
    return result;
 }
@@ -16,7 +16,9 @@ extern "C" {
 #include "bathroom_fan_mock.h"
 #include "env_monitor_mock.h"
 #include "logger_mock.h"
+#include "logger_crashlog_mock.h"
 #include "stairs_led_module_mock.h"
+#include "task_scheduler_mock.h"
 #include "system_config_values.h"
 /* ============================= */
 /**
@@ -59,7 +61,9 @@ struct cmdParserFixture : public ::testing::Test
 		mock_fan_init();
 		mock_env_init();
 		mock_logger_init();
+		mock_crashlog_init();
 		mock_slm_init();
+		mock_sch_init();
 		callMock = new callbackMock;
 
 		cmd_register_sender(&send_callback);
@@ -75,7 +79,9 @@ struct cmdParserFixture : public ::testing::Test
 		mock_fan_deinit();
 		mock_env_deinit();
 		mock_logger_deinit();
+		mock_crashlog_deinit();
 		mock_slm_deinit();
+		mock_sch_deinit();
 		delete callMock;
 		cmd_unregister_sender();
 	}
@@ -1382,6 +1388,172 @@ TEST_F(cmdParserFixture, log_cmds_test)
    EXPECT_CALL(*logger_mock, logger_get_group_state(_)).WillRepeatedly(Return(LOGGER_GROUP_ENABLE));
    cmd_handle_data("log groups_state");
 
+   /**
+    * <b>scenario</b>: Set rate limit.<br>
+    * <b>expected</b>: Command executed, response sent.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, send_callback(_))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "CMD: log set_rate 10 2\n");
+            return RETURN_OK;
+         }))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "OK\n");
+            return RETURN_OK;
+         }));
+   EXPECT_CALL(*logger_mock, logger_set_rate_limit(10, 2)).WillOnce(Return(RETURN_OK));
+   cmd_handle_data("log set_rate 10 2");
+
+   /**
+    * <b>scenario</b>: Get rate limit.<br>
+    * <b>expected</b>: Command executed, response sent.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, send_callback(_))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "CMD: log get_rate\n");
+            return RETURN_OK;
+         }))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "BURST:10 RATE:2\n");
+            return RETURN_OK;
+         }))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "OK\n");
+            return RETURN_OK;
+         }));
+   EXPECT_CALL(*logger_mock, logger_get_rate_limit(_, _)).WillOnce(DoAll(SetArgPointee<0>(10), SetArgPointee<1>(2)));
+   cmd_handle_data("log get_rate");
+
+   /**
+    * <b>scenario</b>: Set sink filter.<br>
+    * <b>expected</b>: Command executed, response sent.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, send_callback(_))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "CMD: log set_sink 1 0x11 2\n");
+            return RETURN_OK;
+         }))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "OK\n");
+            return RETURN_OK;
+         }));
+   EXPECT_CALL(*logger_mock, logger_set_sink_filter(1, 0x11, 2)).WillOnce(Return(RETURN_OK));
+   cmd_handle_data("log set_sink 1 0x11 2");
+
+   /**
+    * <b>scenario</b>: Get sink filter.<br>
+    * <b>expected</b>: Command executed, response sent.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, send_callback(_))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "CMD: log get_sink 1\n");
+            return RETURN_OK;
+         }))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "GROUPS:11 LEVEL:2 DROPPED:3\n");
+            return RETURN_OK;
+         }))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "OK\n");
+            return RETURN_OK;
+         }));
+   EXPECT_CALL(*logger_mock, logger_get_sink_filter(1, _, _)).WillOnce(DoAll(SetArgPointee<1>(0x11), SetArgPointee<2>(2), Return(RETURN_OK)));
+   EXPECT_CALL(*logger_mock, logger_get_sink_dropped(1)).WillOnce(Return(3));
+   cmd_handle_data("log get_sink 1");
+
+   /**
+    * <b>scenario</b>: Get filter of not existing sink.<br>
+    * <b>expected</b>: Error response sent.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, send_callback(_))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "CMD: log get_sink 7\n");
+            return RETURN_OK;
+         }))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "ERROR\n");
+            return RETURN_OK;
+         }));
+   EXPECT_CALL(*logger_mock, logger_get_sink_filter(7, _, _)).WillOnce(Return(RETURN_NOK));
+   cmd_handle_data("log get_sink 7");
+
+   /**
+    * <b>scenario</b>: Read crash log.<br>
+    * <b>expected</b>: Crash log sent in parts, response sent.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, send_callback(_))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "CMD: log crashlog\n");
+            return RETURN_OK;
+         }))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "line 1\n");
+            return RETURN_OK;
+         }))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "line 2\n");
+            return RETURN_OK;
+         }))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "OK\n");
+            return RETURN_OK;
+         }));
+   EXPECT_CALL(*crashlog_mock, logger_crashlog_read(_, 0, CMD_REPLY_BUFFER_SIZE - 1))
+         .WillOnce(Invoke([&](char* buf, uint16_t offset, uint16_t size) -> uint16_t
+         {
+            memcpy(buf, "line 1\n", 7);
+            return 7;
+         }));
+   EXPECT_CALL(*crashlog_mock, logger_crashlog_read(_, 7, CMD_REPLY_BUFFER_SIZE - 1))
+         .WillOnce(Invoke([&](char* buf, uint16_t offset, uint16_t size) -> uint16_t
+         {
+            memcpy(buf, "line 2\n", 7);
+            return 7;
+         }));
+   EXPECT_CALL(*crashlog_mock, logger_crashlog_read(_, 14, _)).WillOnce(Return(0));
+   cmd_handle_data("log crashlog");
+
+   /**
+    * <b>scenario</b>: Clear crash log.<br>
+    * <b>expected</b>: Command executed, response sent.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, send_callback(_))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "CMD: log crashlog_clear\n");
+            return RETURN_OK;
+         }))
+         .WillOnce(Invoke([&](const char* data) -> RET_CODE
+         {
+            EXPECT_STREQ(data, "OK\n");
+            return RETURN_OK;
+         }));
+   EXPECT_CALL(*crashlog_mock, logger_crashlog_clear());
+   cmd_handle_data("log crashlog_clear");
+
 }
 
 /**
@@ -1541,3 +1713,114 @@ TEST_F(cmdParserFixture, system_cmds_test)
 
 	EXPECT_THAT(version_response, HasSubstr(SYSTEM_VERSION));
 }
+
+/**
+ * @test Checks task scheduler related command behavior
+ */
+TEST_F(cmdParserFixture, sch_cmds_test)
+{
+   /**
+    * <b>scenario</b>: Get tasks statistics command received.<br>
+    * <b>expected</b>: One line per task sent, response sent.<br>
+    * ************************************************
+    */
+   std::string task_response;
+   SchTaskStats stats = {};
+   stats.priority = TASKPRIO_HIGH;
+   stats.period = 100;
+   stats.calls = 4;
+   stats.last_time_us = 150;
+   stats.max_time_us = 300;
+   stats.total_time_us = 800;
+   stats.last_latency_us = 20;
+   stats.max_latency_us = 12000;
+   stats.overruns = 1;
+   stats.late_calls = 3;
+   stats.dropped_calls = 12;
+
+   EXPECT_CALL(*callMock, send_callback(_))
+       .WillOnce(Invoke([&](const char* data) -> RET_CODE
+       {
+         EXPECT_STREQ(data, "CMD: sch stats\n");
+         return RETURN_OK;
+       }))
+       .WillOnce(Invoke([&](const char* data) -> RET_CODE
+       {
+         task_response = data;
+         return RETURN_OK;
+       }))
+       .WillOnce(Invoke([&](const char* data) -> RET_CODE
+       {
+         EXPECT_STREQ(data, "OK\n");
+         return RETURN_OK;
+       }));
+   EXPECT_CALL(*sch_mock, sch_get_task_stats(0, _)).WillOnce(DoAll(SetArgPointee<1>(stats), Return(RETURN_OK)));
+   EXPECT_CALL(*sch_mock, sch_get_task_stats(1, _)).WillOnce(Return(RETURN_NOK));
+   cmd_handle_data("sch stats");
+   EXPECT_THAT(task_response, HasSubstr("TASK0:"));
+   EXPECT_THAT(task_response, HasSubstr("prio:1 period:100 calls:4 last:150us max:300us avg:200us lat:20us max_lat:12000us ovr:1 late:3 drop:12\n"));
+
+   /**
+    * <b>scenario</b>: Enable, disable and reset statistics commands received.<br>
+    * <b>expected</b>: Commands executed, responses sent.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, send_callback(_)).Times(6).WillRepeatedly(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_enable_stats());
+   EXPECT_CALL(*sch_mock, sch_disable_stats());
+   EXPECT_CALL(*sch_mock, sch_reset_stats());
+   cmd_handle_data("sch stats enable");
+   cmd_handle_data("sch stats disable");
+   cmd_handle_data("sch stats reset");
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /**
+    * <b>scenario</b>: Get task pool usage command received.<br>
+    * <b>expected</b>: Pool usage sent, response sent.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, send_callback(_))
+       .WillOnce(Invoke([&](const char* data) -> RET_CODE
+       {
+         EXPECT_STREQ(data, "CMD: sch pool\n");
+         return RETURN_OK;
+       }))
+       .WillOnce(Invoke([&](const char* data) -> RET_CODE
+       {
+         EXPECT_STREQ(data, "POOL: size:20 used:7 max_used:9\n");
+         return RETURN_OK;
+       }))
+       .WillOnce(Invoke([&](const char* data) -> RET_CODE
+       {
+         EXPECT_STREQ(data, "OK\n");
+         return RETURN_OK;
+       }));
+   EXPECT_CALL(*sch_mock, sch_get_tasks_count()).WillOnce(Return(7));
+   EXPECT_CALL(*sch_mock, sch_get_pool_high_water()).WillOnce(Return(9));
+   cmd_handle_data("sch pool");
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /**
+    * <b>scenario</b>: Get dropped scheduler ticks command received.<br>
+    * <b>expected</b>: Number of dropped ticks sent, response sent.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, send_callback(_))
+       .WillOnce(Invoke([&](const char* data) -> RET_CODE
+       {
+         EXPECT_STREQ(data, "CMD: sch ticks\n");
+         return RETURN_OK;
+       }))
+       .WillOnce(Invoke([&](const char* data) -> RET_CODE
+       {
+         EXPECT_STREQ(data, "TICKS: dropped:5\n");
+         return RETURN_OK;
+       }))
+       .WillOnce(Invoke([&](const char* data) -> RET_CODE
+       {
+         EXPECT_STREQ(data, "OK\n");
+         return RETURN_OK;
+       }));
+   EXPECT_CALL(*sch_mock, sch_get_dropped_ticks()).WillOnce(Return(5));
+   cmd_handle_data("sch ticks");
+}
@@ -54,6 +54,14 @@ void btengine_deinitialize();
  * @return See RETURN_CODES.
  */
 RET_CODE btengine_send_string(const char *);
+/**
+ * @brief Send string over BT module without blocking.
+ * @details String is written only when it fits in internal buffer as a whole.
+ * @param[in] data - pointer to data to send
+ * @return RETURN_OK when written, RETURN_NOK when there is no place now (call again later),
+ *         RETURN_ERROR when string is longer than internal buffer.
+ */
+RET_CODE btengine_try_send_string(const char *);
 /**
  * @brief Send bytes over BT module.
  * @details Function is blocking if there is no place in internal buffer.
@@ -85,12 +93,13 @@ uint16_t btengine_count_bytes();
 /**
  * @brief Get all bytes already received.
  * @details Before call user should check how many bytes are ready.
+ * At most string_size bytes are returned, the rest stays in buffer.
  * @return Pointer to data bytes.
  */
 const uint8_t* btengine_get_bytes();
 /**
- * @brief Constatly check for string in buffer.
- * @details If there is string ready, registered callback are called.
+ * @brief Handle strings received since last call.
+ * @details Drains module event queue (also drained by evq_dispatch_all()), registered callbacks are called for every string.
  * @return None.
  */
 void btengine_string_watcher();
@@ -95,7 +95,8 @@ RET_CODE dht_set_timeout(uint16_t timeout);
  */
 uint16_t dht_get_timeout();
 /**
- * @brief Watcher responsible for calling callbacks - should be executed in main thread loop.
+ * @brief Watcher responsible for calling callbacks.
+ * @details Drains module event queue, which is also drained by evq_dispatch_all() in main loop.
  * @return See RETURN_CODES.
  */
 void dht_data_watcher();
@@ -104,7 +104,8 @@ uint16_t i2c_get_timeout();
  */
 RET_CODE i2c_set_timeout(uint16_t timeout);
 /**
- * @brief Function responsible for calling callback - should be called in main thread loop.
+ * @brief Function responsible for calling callback.
+ * @details Drains module event queue, which is also drained by evq_dispatch_all() in main loop.
  * @return None.
  */
 void i2c_watcher();
@@ -61,6 +61,11 @@ RET_CODE uartengine_send_string(const char *);
  * @return See RETURN_CODES.
  */
 RET_CODE uartengine_send_bytes(const uint8_t* data, uint16_t size);
+/**
+ * @brief Check how many bytes can be sent without blocking.
+ * @return Free space in transmit buffer.
+ */
+uint16_t uartengine_get_tx_space();
 /**
  * @brief Checks if there is string received in buffer.
  * @return RETURN_OK if string can be read.
@@ -84,6 +89,7 @@ void uartengine_clear_rx();
 /**
  * @brief Get all bytes already received.
  * @details Before call user should check how many bytes are ready.
+ * At most string_size bytes are returned, the rest stays in buffer.
  * @return Pointer to data bytes.
  */
 const uint8_t* uartengine_get_bytes();
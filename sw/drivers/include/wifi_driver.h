@@ -126,6 +126,21 @@ RET_CODE wifi_send_data(ServerClientID id, const char* data, uint16_t size);
  * @return See RETURN_CODES.
  */
 RET_CODE wifi_send_bytes(ServerClientID id, const uint8_t* data, uint16_t size);
+/**
+ * @brief Start sending data to connected client without waiting for module replies.
+ * @details Transfer is continued in wifi_data_watcher(). Data is not copied, it has to stay valid
+ * until wifi_is_sending() returns RETURN_NOK.
+ * @param[in] id - id of the client.
+ * @param[in] data - string to send.
+ * @param[in] size - size in bytes of string
+ * @return RETURN_OK - transfer started, RETURN_NOK - other transfer pending or UART buffer full.
+ */
+RET_CODE wifi_try_send_data(ServerClientID id, const char* data, uint16_t size);
+/**
+ * @brief Check if transfer started by wifi_try_send_data() is still pending.
+ * @return RETURN_OK - transfer pending, RETURN_NOK - driver is ready for next transfer.
+ */
+RET_CODE wifi_is_sending();
 /**
  * @brief Set IP address of device.
  * @details Driver should be reset to apply setting
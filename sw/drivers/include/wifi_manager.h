@@ -108,6 +108,16 @@ RET_CODE wifimgr_send_bytes(ServerClientID id, const uint8_t* data, uint16_t siz
  * @return See RETURN_CODES.
  */
 RET_CODE wifimgr_broadcast_data(const char* data);
+/**
+ * @brief Send data to all connected clients without waiting for WiFi module.
+ * @details
+ * Data cannot be NULL.<br>
+ * Function has to be called again with the same data until RETURN_OK is returned,
+ * data has to stay valid until then.<br>
+ * @param[in] data - pointer to char data.
+ * @return RETURN_OK - data sent to all clients (or no client connected), RETURN_NOK - broadcast in progress.
+ */
+RET_CODE wifimgr_try_broadcast_data(const char* data);
 /**
  * @brief Send bytes to all connected clients.
  * @details
@@ -11,6 +11,8 @@
 #include "bt_engine.h"
 #include "gpio_lib.h"
 #include "return_codes.h"
+#include "event_queue.h"
+#include "ring_buffer.h"
 /* =============================
  *          Defines
  * =============================*/
@@ -22,26 +24,19 @@ void btengine_start_sending();
 void btengine_stop_sending();
 void btengine_notify_callbacks();
 RET_CODE btengine_get_string_from_buffer();
-void btengine_write_byte(const uint8_t* byte);
-/* =============================
- *       Internal types
- * =============================*/
-typedef struct
-{
-	char * buf;
-	uint16_t tail;
-	uint16_t head;
-	uint8_t string_cnt;
-	uint16_t bytes_cnt;
-} BT_BUFFER;
+uint8_t btengine_count_strings();
+void btengine_on_string(uint32_t arg);
 /* =============================
  *      Module variables
  * =============================*/
 BT_Config config;
-volatile BT_BUFFER bt_tx_buf;
-volatile BT_BUFFER bt_rx_buf;
+RING_BUFFER bt_tx_buf;
+RING_BUFFER bt_rx_buf;
+volatile uint8_t bt_rx_strings;  /**< Lines received, written in USART1 interrupt only */
+uint8_t bt_rx_strings_read;      /**< Lines read, written in main loop only */
 char* bt_rx_string;
 void (*BT_CALLBACKS[BT_ENGINE_CALLBACK_SIZE])(const char *);
+EVQ bt_rx_events;   /**< One event per received line, produced in USART1 interrupt */
 
 
 
@@ -59,21 +54,18 @@ RET_CODE btengine_initialize(BT_Config* cfg)
 	gpio_pin_cfg(GPIOA, PA10, gpio_mode_AF7_OD_PU_LS);
 	gpio_pin_cfg(GPIOA, PA9, gpio_mode_AF7_PP_LS);
 
-	bt_tx_buf.buf = (char*) malloc (sizeof(char)*config.buffer_size);
-	bt_rx_buf.buf = (char*) malloc (sizeof(char)*config.buffer_size);
+	/* ring buffer needs power of 2 size */
+	uint16_t buffer_size = rb_align_size(config.buffer_size);
+	uint8_t* tx_buf = (uint8_t*) malloc (buffer_size);
+	uint8_t* rx_buf = (uint8_t*) malloc (buffer_size);
 	bt_rx_string = (char*) malloc (sizeof(char)*config.string_size);
+	bt_rx_strings = 0;
+	bt_rx_strings_read = 0;
+	evq_init(&bt_rx_events);
+	evq_register(&bt_rx_events);
 
-	bt_tx_buf.head = 0;
-	bt_tx_buf.tail = 0;
-	bt_tx_buf.string_cnt = 0; /* not used */
-	bt_tx_buf.bytes_cnt = 0;  /* not used */
-
-	bt_rx_buf.head = 0;
-	bt_rx_buf.tail = 0;
-	bt_rx_buf.string_cnt = 0;
-	bt_rx_buf.bytes_cnt = 0;
-
-	if (!bt_rx_buf.buf || !bt_rx_buf.buf || !bt_rx_string)
+	if (rb_init(&bt_tx_buf, tx_buf, buffer_size) != RETURN_OK ||
+		 rb_init(&bt_rx_buf, rx_buf, buffer_size) != RETURN_OK || !bt_rx_string)
 	{
 		result = RETURN_ERROR;
 	}
@@ -85,6 +77,7 @@ RET_CODE btengine_initialize(BT_Config* cfg)
 
 void btengine_deinitialize()
 {
+	evq_unregister(&bt_rx_events);
 	free(bt_tx_buf.buf);
 	free(bt_rx_buf.buf);
 	free(bt_rx_string);
@@ -99,50 +92,57 @@ void btengine_deinitialize()
 
 RET_CODE btengine_send_string(const char * buffer)
 {
-	if (!bt_tx_buf.buf)
+	if (!buffer)
 	{
 		return RETURN_ERROR;
 	}
-	while (*buffer)
-	{
-		btengine_write_byte((uint8_t*)buffer++);
-		btengine_start_sending();
-	}
-	return RETURN_OK;
+	return btengine_send_bytes((const uint8_t*)buffer, strlen(buffer));
 }
 
-RET_CODE btengine_send_bytes(const uint8_t* data, uint16_t size)
+RET_CODE btengine_try_send_string(const char * buffer)
 {
-   if (!bt_tx_buf.buf)
+   if (!buffer || !bt_tx_buf.buf)
    {
       return RETURN_ERROR;
    }
-   for (uint16_t i = 0; i < size; i++)
+   RET_CODE result = RETURN_NOK;
+   uint16_t size = strlen(buffer);
+   if (size > bt_tx_buf.mask + 1)
+   {
+      result = RETURN_ERROR;
+   }
+   /* string is not split, so the caller can keep it and try again later */
+   else if (rb_get_space(&bt_tx_buf) >= size)
    {
-      btengine_write_byte(data + i);
+      rb_push_n(&bt_tx_buf, (const uint8_t*)buffer, size);
       btengine_start_sending();
+      result = RETURN_OK;
    }
-   return RETURN_OK;
+   return result;
 }
 
-void btengine_write_byte(const uint8_t* byte)
+RET_CODE btengine_send_bytes(const uint8_t* data, uint16_t size)
 {
-   __disable_irq();
-   bt_tx_buf.buf[bt_tx_buf.head] = *byte;
-   bt_tx_buf.head++;
-   bt_tx_buf.bytes_cnt++;
-   if (bt_tx_buf.head == config.buffer_size)
+   if (!bt_tx_buf.buf)
    {
-      bt_tx_buf.head = 0;
+      return RETURN_ERROR;
    }
-   __enable_irq();
+   while (size)
+   {
+      /* wait until interrupt makes place for the rest of data */
+      uint16_t written = rb_push_n(&bt_tx_buf, data, size);
+      data += written;
+      size -= written;
+      btengine_start_sending();
+   }
+   return RETURN_OK;
 }
 
 RET_CODE btengine_can_read_string()
 {
 	RET_CODE result = RETURN_NOK;
 
-	if (bt_rx_buf.string_cnt > 0)
+	if (btengine_count_strings() > 0)
 	{
 		btengine_get_string_from_buffer();
 		if (strlen(bt_rx_string) > 0)
@@ -160,74 +160,68 @@ const char* btengine_get_string()
 
 void btengine_clear_rx()
 {
-	bt_rx_buf.tail = bt_rx_buf.head;
-	bt_rx_buf.string_cnt = 0;
-	bt_rx_buf.bytes_cnt = 0;
+	rb_flush(&bt_rx_buf);
+	bt_rx_strings_read = bt_rx_strings;
+}
+
+uint8_t btengine_count_strings()
+{
+	return (uint8_t)(bt_rx_strings - bt_rx_strings_read);
 }
 
 RET_CODE btengine_get_string_from_buffer()
 {
-	char* buffer = bt_rx_string;
-	if (!bt_rx_buf.buf || bt_rx_buf.string_cnt == 0 || !buffer)
+	if (!bt_rx_buf.buf || btengine_count_strings() == 0 || !bt_rx_string)
 	{
 		return RETURN_ERROR;
 	}
 
-	char c;
-	while (1)
+	uint16_t length = 0;
+	uint8_t line_end = 0;
+	while (!line_end)
 	{
-		c = bt_rx_buf.buf[bt_rx_buf.tail];
-		bt_rx_buf.tail++;
-		bt_rx_buf.bytes_cnt--;
-		if (bt_rx_buf.tail == config.buffer_size)
-		{
-			bt_rx_buf.tail = 0;
-		}
-		if (c != '\r' && c != '\n')
+		const uint8_t* data;
+		uint16_t size = rb_get_read_view(&bt_rx_buf, &data);
+		if (!size)
 		{
-			*buffer = c;
+			break;
 		}
-		else
+		const uint8_t* end = (const uint8_t*)memchr(data, '\n', size);
+		if (end)
 		{
-			*buffer = 0x00;
+			size = end - data + 1;
+			line_end = 1;
 		}
-		if (c == '\n')
+		/* the end of too long line is dropped */
+		uint16_t copy = size;
+		if (copy > config.string_size - 1 - length)
 		{
-			*buffer = 0x00;
-			break;
+			copy = config.string_size - 1 - length;
 		}
-		buffer++;
-
+		memcpy(bt_rx_string + length, data, copy);
+		length += copy;
+		rb_consume(&bt_rx_buf, size);
 	}
-	bt_rx_buf.string_cnt--;
+	bt_rx_string[length] = 0x00;
+	/* line ends on first CR or LF */
+	bt_rx_string[strcspn(bt_rx_string, "\r\n")] = 0x00;
+	bt_rx_strings_read++;
 	return RETURN_OK;
 }
 
 uint16_t btengine_count_bytes()
 {
-	return bt_rx_buf.bytes_cnt;
+	return rb_get_count(&bt_rx_buf);
 }
 
 const uint8_t* btengine_get_bytes()
 {
-	char* buffer = bt_rx_string;
-	if (!bt_rx_buf.buf || bt_rx_buf.bytes_cnt == 0 || !buffer)
+	if (!bt_rx_buf.buf || rb_get_count(&bt_rx_buf) == 0 || !bt_rx_string)
 	{
 		return NULL;
 	}
 
-	while (bt_rx_buf.bytes_cnt)
-	{
-		*buffer = bt_rx_buf.buf[bt_rx_buf.tail];
-		bt_rx_buf.tail++;
-		bt_rx_buf.bytes_cnt--;
-		if (bt_rx_buf.tail == config.buffer_size)
-		{
-			bt_rx_buf.tail = 0;
-		}
-		buffer++;
-
-	}
+	rb_pop_n(&bt_rx_buf, (uint8_t*)bt_rx_string, config.string_size);
 	return (uint8_t*)bt_rx_string;
 }
 
@@ -273,6 +267,11 @@ void btengine_notify_callbacks()
 }
 
 void btengine_string_watcher()
+{
+	evq_dispatch(&bt_rx_events);
+}
+
+void btengine_on_string(uint32_t arg)
 {
 	if (btengine_can_read_string())
 	{
@@ -292,36 +291,23 @@ void btengine_stop_sending()
 void USART1_IRQHandler (void)
 {
 	if (USART1->SR & USART_SR_RXNE){
-		char c = USART1->DR;
-		bt_rx_buf.buf[bt_rx_buf.head] = USART1->DR;
-		bt_rx_buf.head++;
-		bt_rx_buf.bytes_cnt++;
-		if (c == '\n')
-		{
-			bt_rx_buf.string_cnt++;
-		}
-
-		if (bt_rx_buf.head == config.buffer_size)
+		uint8_t c = USART1->DR;
+		if (rb_push(&bt_rx_buf, c) == RETURN_OK && c == '\n')
 		{
-			bt_rx_buf.head = 0;
+			bt_rx_strings++;
+			evq_push(&bt_rx_events, &btengine_on_string, 0);
 		}
-
 	}
 
 	if (USART1->SR & USART_SR_TXE){
-		if (bt_tx_buf.head == bt_tx_buf.tail && bt_tx_buf.bytes_cnt == 0)
+		uint8_t c;
+		if (rb_pop(&bt_tx_buf, &c) == RETURN_OK)
 		{
-			btengine_stop_sending();
+			USART1->DR = c;
 		}
 		else
 		{
-			USART1->DR = bt_tx_buf.buf[bt_tx_buf.tail];
-			bt_tx_buf.bytes_cnt--;
-			bt_tx_buf.tail++;
-			if (bt_tx_buf.tail == config.buffer_size)
-			{
-				bt_tx_buf.tail = 0;
-			}
+			btengine_stop_sending();
 		}
 	}
 }
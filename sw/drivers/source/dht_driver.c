@@ -10,6 +10,8 @@
 #include "gpio_lib.h"
 #include "task_scheduler.h"
 #include "Logger.h"
+#include "event_queue.h"
+#include "core_cmFunc.h"
 /* =============================
  *          Defines
  * =============================*/
@@ -24,6 +26,7 @@
  *   Internal module functions
  * =============================*/
 void dht_on_timeout();
+void dht_on_measurement_end(uint32_t arg);
 RET_CODE dht_verify_timeout(uint16_t);
 DHT_STATUS dht_get_result();
 RET_CODE dht_send_start();
@@ -63,9 +66,16 @@ typedef struct DHT_DRIVER
 uint32_t DHT_MEASURE_TIMESTAMPS[DHT_TIMESTAMPS_BUFFER_SIZE];
 DHT_SENSOR_MASKS DHT_REG_MAP[DHT_ENUM_MAX];
 volatile uint8_t dht_timestamp_idx;
-volatile uint8_t dht_measurement_ready;
+/**
+ * Measurement end is signaled once - either by EXTI interrupt or by timeout task.
+ * Timeout task runs on lower priority, so it checks and changes state with interrupts
+ * masked. Every producer has own queue, as required by event queue.
+ */
+EVQ dht_events;            /**< Written by EXTI interrupt only */
+EVQ dht_timeout_events;    /**< Written by timeout task only */
 DHT_DRIVER dht_driver;
 DHT_CALLBACK dht_callback;
+SCH_HANDLE dht_timeout_task;
 
 RET_CODE dht_initialize()
 {
@@ -78,7 +88,7 @@ RET_CODE dht_initialize()
     * 	- interrupts only on rising edge (falling edge disabled)
     * 	TIM2 configured to ensure 1us period beteen interrupts fires
     */
-   logger_send(LOG_DHT_DRV, __func__, "start");
+   LOG_TRACE(LOG_DHT_DRV, __func__, "start");
    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN;
    RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
    RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
@@ -145,16 +155,20 @@ RET_CODE dht_initialize()
    NVIC_EnableIRQ(EXTI9_5_IRQn);
    NVIC_EnableIRQ(EXTI15_10_IRQn);
 
-   if (sch_subscribe_and_set(&dht_on_timeout, TASKPRIO_HIGH, DHT_START_TIME_MS,
-         TASKSTATE_STOPPED, TASKTYPE_TRIGGER) == RETURN_OK)
+   dht_timeout_task = sch_subscribe_handle(&dht_on_timeout, TASKPRIO_SOFTIRQ, DHT_START_TIME_MS,
+                                           TASKSTATE_STOPPED, TASKTYPE_TRIGGER);
+   if (dht_timeout_task != SCH_INVALID_HANDLE)
    {
       dht_driver.state = DHT_STATE_IDLE;
       dht_driver.timeout = DHT_DEFAULT_TIMEOUT_MS;
-      dht_measurement_ready = 0;
+      evq_init(&dht_events);
+      evq_init(&dht_timeout_events);
+      evq_register(&dht_events);
+      evq_register(&dht_timeout_events);
       result = RETURN_OK;
-      logger_send(LOG_DHT_DRV, __func__, "end");
+      LOG_TRACE(LOG_DHT_DRV, __func__, "end");
    }
-   logger_send_if(result != RETURN_OK, LOG_DHT_DRV, __func__, "cannot init");
+   LOG_ERR_IF(result != RETURN_OK, __func__, "cannot init");
    return result;
 }
 
@@ -162,12 +176,13 @@ RET_CODE dht_read_async(DHT_SENSOR_ID id, DHT_CALLBACK clb)
 {
    RET_CODE result = RETURN_NOK;
    dht_timestamp_idx = 0;
-   dht_measurement_ready = 0;
+   evq_flush(&dht_events);
+   evq_flush(&dht_timeout_events);
    dht_callback = clb;
 
    if (dht_driver.state == DHT_STATE_IDLE && id < DHT_ENUM_MAX)
    {
-      logger_send(LOG_DHT_DRV, __func__, "read s %d", id);
+      LOG_TRACE(LOG_DHT_DRV, __func__, "read s %d", id);
       dht_driver.sensor.id = id;
       result = dht_send_start();
    }
@@ -180,14 +195,14 @@ RET_CODE dht_send_start()
 
    do
    {
-      if (sch_set_task_period(&dht_on_timeout, DHT_START_TIME_MS) != RETURN_OK)
+      if (sch_handle_set_period(dht_timeout_task, DHT_START_TIME_MS) != RETURN_OK)
       {
-         logger_send(LOG_ERROR, __func__, "Cannot set task period");
+         LOG_ERR(__func__, "Cannot set task period");
          break;
       }
-      if (sch_trigger_task(&dht_on_timeout) != RETURN_OK)
+      if (sch_handle_trigger(dht_timeout_task) != RETURN_OK)
       {
-         logger_send(LOG_ERROR, __func__, "Cannot start task");
+         LOG_ERR(__func__, "Cannot start task");
          break;
       }
       dht_set_gpio_state(dht_driver.sensor.id, 0);
@@ -216,14 +231,15 @@ DHT_STATUS dht_read(DHT_SENSOR_ID id, DHT_SENSOR *sensor)
 
    if (dht_read_async(id, NULL) == RETURN_OK)
    {
-      logger_send(LOG_DHT_DRV, __func__, "read async");
-      while(dht_measurement_ready == 0);
-      dht_measurement_ready = 0;
+      LOG_TRACE(LOG_DHT_DRV, __func__, "read async");
+      while(evq_get_count(&dht_events) == 0 && evq_get_count(&dht_timeout_events) == 0);
+      evq_flush(&dht_events);
+      evq_flush(&dht_timeout_events);
       result = dht_get_result();
       *sensor = dht_driver.sensor;
       dht_driver.state = DHT_STATE_IDLE;
    }
-   logger_send(LOG_DHT_DRV, __func__, "read async status %d", result);
+   LOG_TRACE(LOG_DHT_DRV, __func__, "read async status %d", result);
    return result;
 }
 
@@ -233,8 +249,8 @@ RET_CODE dht_set_timeout(uint16_t timeout)
    if (dht_verify_timeout(timeout) == RETURN_OK)
    {
       dht_driver.timeout = timeout;
-      result = sch_set_task_period(&dht_on_timeout, timeout);
-      logger_send(LOG_DHT_DRV, __func__, "new timeout %d", timeout);
+      result = sch_handle_set_period(dht_timeout_task, timeout);
+      LOG_TRACE(LOG_DHT_DRV, __func__, "new timeout %d", timeout);
    }
    return result;
 }
@@ -246,7 +262,7 @@ RET_CODE dht_verify_timeout(uint16_t period)
    {
       result = RETURN_OK;
    }
-   logger_send_if(result != RETURN_OK, LOG_DHT_DRV, __func__, "incorrect timeout %d", period);
+   LOG_TRACE_IF(result != RETURN_OK, LOG_DHT_DRV, __func__, "incorrect timeout %d", period);
    return result;
 }
 
@@ -257,12 +273,14 @@ uint16_t dht_get_timeout()
 
 void dht_on_timeout()
 {
+   uint32_t primask = __get_PRIMASK();
+   __disable_irq();
    switch (dht_driver.state)
    {
    case DHT_STATE_START:
       dht_set_gpio_state(dht_driver.sensor.id, 1);
-      if (sch_set_task_period(&dht_on_timeout, dht_driver.timeout) == RETURN_OK &&
-          sch_trigger_task(&dht_on_timeout) == RETURN_OK)
+      if (sch_handle_set_period(dht_timeout_task, dht_driver.timeout) == RETURN_OK &&
+          sch_handle_trigger(dht_timeout_task) == RETURN_OK)
       {
          TIM2->CR1 |= TIM_CR1_CEN;
          TIM2->CNT = 0;
@@ -271,33 +289,35 @@ void dht_on_timeout()
       else
       {
          dht_driver.state = DHT_STATE_ERROR;
-         dht_measurement_ready = 1;
+         evq_push(&dht_timeout_events, &dht_on_measurement_end, 0);
       }
       break;
    case DHT_STATE_READING:
       dht_driver.state = DHT_STATE_TIMEOUT;
       TIM2->CR1 &= ~TIM_CR1_CEN;
       TIM2->CNT = 0;
-      dht_measurement_ready = 1;
+      evq_push(&dht_timeout_events, &dht_on_measurement_end, 0);
       break;
    default:
       break;
    }
-
+   __set_PRIMASK(primask);
 }
 
 void dht_data_watcher()
 {
-   if (dht_measurement_ready == 1)
+   evq_dispatch(&dht_events);
+   evq_dispatch(&dht_timeout_events);
+}
+
+void dht_on_measurement_end(uint32_t arg)
+{
+   DHT_STATUS result = dht_get_result();
+   if (dht_callback)
    {
-      dht_measurement_ready = 0;
-      DHT_STATUS result = dht_get_result();
-      if (dht_callback)
-      {
-         dht_callback(result, &dht_driver.sensor);
-      }
-      dht_driver.state = DHT_STATE_IDLE;
+      dht_callback(result, &dht_driver.sensor);
    }
+   dht_driver.state = DHT_STATE_IDLE;
 }
 
 DHT_STATUS dht_get_result()
@@ -347,7 +367,7 @@ RET_CODE dht_parse_data()
       }
       byte_shift_idx--;
    }
-   logger_send(LOG_DHT_DRV, __func__, "DHT data %d %d %d %d %d", parsed_data[0], parsed_data[1], parsed_data[2], parsed_data[3], parsed_data[4]);
+   LOG_TRACE(LOG_DHT_DRV, __func__, "DHT data %d %d %d %d %d", parsed_data[0], parsed_data[1], parsed_data[2], parsed_data[3], parsed_data[4]);
    uint8_t checksum = parsed_data[0] + parsed_data[1] + parsed_data[2] + parsed_data[3];
 
    if (checksum == parsed_data[4])
@@ -381,14 +401,14 @@ RET_CODE dht_parse_data()
             break;
          }
       }
-      logger_send(LOG_DHT_DRV, __func__, "s%d t:%d: %d.%d%% %d.%ddegC", dht_driver.sensor.id, dht_driver.sensor.type,
+      LOG_TRACE(LOG_DHT_DRV, __func__, "s%d t:%d: %d.%d%% %d.%ddegC", dht_driver.sensor.id, dht_driver.sensor.type,
                                                                       dht_driver.sensor.data.hum_h, dht_driver.sensor.data.hum_l,
                                                                       dht_driver.sensor.data.temp_h, dht_driver.sensor.data.temp_l);
       result =  RETURN_OK;
    }
    else
    {
-      logger_send(LOG_ERROR, __func__, "invalid cs: r %d c %d", parsed_data[4], checksum);
+      LOG_ERR(__func__, "invalid cs: r %d c %d", parsed_data[4], checksum);
       result = RETURN_NOK;
    }
    return result;
@@ -417,13 +437,17 @@ void dht_handle_exti_interrupt(uint32_t pr_mask)
 
 void dht_handle_timestamp()
 {
-   DHT_MEASURE_TIMESTAMPS[dht_timestamp_idx] = TIM2->CNT;
-   dht_timestamp_idx++;
-   if (dht_timestamp_idx == DHT_TIMESTAMPS_BUFFER_SIZE)
+   if (dht_timestamp_idx < DHT_TIMESTAMPS_BUFFER_SIZE)
+   {
+      DHT_MEASURE_TIMESTAMPS[dht_timestamp_idx] = TIM2->CNT;
+      dht_timestamp_idx++;
+   }
+   /* measurement can be already ended by timeout */
+   if (dht_timestamp_idx == DHT_TIMESTAMPS_BUFFER_SIZE && dht_driver.state == DHT_STATE_READING)
    {
-      sch_set_task_state(&dht_on_timeout, TASKSTATE_STOPPED); // stop timeout counter
+      sch_handle_set_state(dht_timeout_task, TASKSTATE_STOPPED); // stop timeout counter
       TIM2->CR1 &= ~TIM_CR1_CEN;
-      dht_measurement_ready = 1;
+      evq_push(&dht_events, &dht_on_measurement_end, 0);
       dht_driver.state = DHT_STATE_DATA_DECODING;
    }
    TIM2->CNT = 0;
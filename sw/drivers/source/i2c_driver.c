@@ -10,6 +10,8 @@
 #include "Logger.h"
 #include "task_scheduler.h"
 #include "gpio_lib.h"
+#include "event_queue.h"
+#include "core_cmFunc.h"
 /* =============================
  *          Defines
  * =============================*/
@@ -24,6 +26,7 @@ void i2c_on_timeout();
 RET_CODE i2c_validate_timeout(uint16_t timeout);
 void i2c_print_buffer(I2C_OP_TYPE type);
 I2C_STATUS i2c_get_status();
+void i2c_on_transaction_end(uint32_t arg);
 /* =============================
  *       Internal types
  * =============================*/
@@ -45,7 +48,6 @@ typedef struct I2C_DRIVER_TYPE
    uint16_t timeout;
    uint8_t bytes_requested;
    uint8_t bytes_handled;
-   uint8_t transaction_ready;
 } I2C_DRIVER_TYPE;
 /* =============================
  *      Module variables
@@ -53,41 +55,59 @@ typedef struct I2C_DRIVER_TYPE
 uint8_t I2C_DRV_BUF[I2C_DRV_BUFFER_SIZE];
 volatile I2C_DRIVER_TYPE i2c_driver;
 I2C_CALLBACK i2c_drv_callback;
+SCH_HANDLE i2c_timeout_task;
+/**
+ * Transaction end is signaled once - either by I2C interrupt or by timeout task.
+ * Timeout task runs on lower priority, so it checks and changes state with interrupts
+ * masked. Every producer has own queue, as required by event queue.
+ */
+EVQ i2c_events;            /**< Written by I2C interrupt only */
+EVQ i2c_timeout_events;    /**< Written by timeout task only */
 
 RET_CODE i2c_initialize()
 {
-   logger_send(LOG_I2C_DRV, __func__, "");
+   LOG_TRACE(LOG_I2C_DRV, __func__, "");
    RET_CODE result = RETURN_NOK;
    i2c_driver.state = I2C_STATE_UNKNOWN;
-   if (sch_subscribe_and_set(&i2c_on_timeout, TASKPRIO_HIGH, I2C_DEFAULT_TIMEOUT_MS,
-                                  TASKSTATE_STOPPED, TASKTYPE_TRIGGER) == RETURN_OK)
+   i2c_timeout_task = sch_subscribe_handle(&i2c_on_timeout, TASKPRIO_SOFTIRQ, I2C_DEFAULT_TIMEOUT_MS,
+                                           TASKSTATE_STOPPED, TASKTYPE_TRIGGER);
+   if (i2c_timeout_task != SCH_INVALID_HANDLE)
    {
       i2c_driver.address = 0;
       i2c_driver.type = I2C_OP_UNKNOWN;
       i2c_driver.timeout = I2C_DEFAULT_TIMEOUT_MS;
       i2c_driver.bytes_requested = 0;
       i2c_driver.bytes_handled = 0;
-      i2c_driver.transaction_ready = 0;
+      evq_init(&i2c_events);
+      evq_init(&i2c_timeout_events);
+      evq_register(&i2c_events);
+      evq_register(&i2c_timeout_events);
       i2c_reset();
       result = RETURN_OK;
    }
-   logger_send_if(result != RETURN_OK, LOG_ERROR, __func__, "error");
+   LOG_ERR_IF(result != RETURN_OK, __func__, "error");
    return result;
 }
 void i2c_on_timeout()
 {
-   if (i2c_driver.state != I2C_STATE_IDLE)
+   uint8_t timeout = 0;
+   uint32_t primask = __get_PRIMASK();
+   __disable_irq();
+   if (i2c_driver.state != I2C_STATE_IDLE && i2c_driver.state != I2C_STATE_END_OK &&
+       i2c_driver.state != I2C_STATE_ERROR)
    {
-      logger_send(LOG_ERROR,__func__,"timeout");
       i2c_driver.state = I2C_STATE_ERROR;
-      i2c_driver.transaction_ready = 1;
+      evq_push(&i2c_timeout_events, &i2c_on_transaction_end, 0);
+      timeout = 1;
    }
+   __set_PRIMASK(primask);
+   LOG_ERR_IF(timeout, __func__, "timeout");
 }
 
 RET_CODE i2c_write_async(I2C_ADDRESS address, const uint8_t* data, uint8_t size, I2C_CALLBACK callback)
 {
    RET_CODE result = RETURN_NOK;
-   logger_send(LOG_I2C_DRV, __func__, "writing %u bytes to 0x%x", size, address);
+   LOG_TRACE(LOG_I2C_DRV, __func__, "writing %u bytes to 0x%x", size, address);
    if (i2c_driver.state == I2C_STATE_IDLE && size <= I2C_DRV_BUFFER_SIZE)
    {
       i2c_driver.address = address;
@@ -101,11 +121,11 @@ RET_CODE i2c_write_async(I2C_ADDRESS address, const uint8_t* data, uint8_t size,
       }
       I2C1->CR1 |= I2C_CR1_START;
       I2C1->CR1 |= I2C_CR1_ACK;
-      sch_trigger_task(&i2c_on_timeout);
+      sch_handle_trigger(i2c_timeout_task);
       i2c_driver.state = I2C_STATE_STARTED;
       result = RETURN_OK;
    }
-   logger_send_if(result != RETURN_OK, LOG_ERROR, __func__, "error");
+   LOG_ERR_IF(result != RETURN_OK, __func__, "error");
    return result;
 }
 I2C_STATUS i2c_write(I2C_ADDRESS address, const uint8_t* data, uint8_t size)
@@ -113,7 +133,7 @@ I2C_STATUS i2c_write(I2C_ADDRESS address, const uint8_t* data, uint8_t size)
    I2C_STATUS result = I2C_STATUS_UNKNOWN;
    if (i2c_write_async(address, data, size, NULL) == RETURN_OK)
    {
-      while(i2c_driver.transaction_ready == 0);
+      while(evq_get_count(&i2c_events) == 0 && evq_get_count(&i2c_timeout_events) == 0);
       result = i2c_get_status();
       i2c_watcher();
    }
@@ -123,7 +143,7 @@ I2C_STATUS i2c_write(I2C_ADDRESS address, const uint8_t* data, uint8_t size)
 RET_CODE i2c_read_async(I2C_ADDRESS address, uint8_t size, I2C_CALLBACK callback)
 {
    RET_CODE result = RETURN_NOK;
-   logger_send(LOG_I2C_DRV, __func__, "reading %u bytes from 0x%x", size, address);
+   LOG_TRACE(LOG_I2C_DRV, __func__, "reading %u bytes from 0x%x", size, address);
    if (i2c_driver.state == I2C_STATE_IDLE && size <= I2C_DRV_BUFFER_SIZE)
    {
       i2c_driver.address = address;
@@ -135,7 +155,7 @@ RET_CODE i2c_read_async(I2C_ADDRESS address, uint8_t size, I2C_CALLBACK callback
       I2C1->CR2 |= I2C_CR2_ITBUFEN;
       i2c_driver.state = I2C_STATE_STARTED;
       i2c_drv_callback = callback;
-      sch_trigger_task(&i2c_on_timeout);
+      sch_handle_trigger(i2c_timeout_task);
       result = RETURN_OK;
    }
    return result;
@@ -145,7 +165,7 @@ I2C_STATUS i2c_read(I2C_ADDRESS address, uint8_t* data, uint8_t size)
    I2C_STATUS result = I2C_STATUS_UNKNOWN;
    if (i2c_read_async(address, size, NULL) == RETURN_OK)
    {
-      while(i2c_driver.transaction_ready == 0);
+      while(evq_get_count(&i2c_events) == 0 && evq_get_count(&i2c_timeout_events) == 0);
       result = i2c_get_status();
       for (uint8_t i = 0; i < i2c_driver.bytes_handled; i++)
       {
@@ -158,7 +178,8 @@ I2C_STATUS i2c_read(I2C_ADDRESS address, uint8_t* data, uint8_t size)
 
 void i2c_print_buffer(I2C_OP_TYPE type)
 {
-   if (logger_get_group_state(LOG_I2C_DRV) == LOGGER_GROUP_ENABLE)
+   /* the whole dump is removed when tracing is not compiled */
+   if (LOGGER_IS_ACTIVE(LOGGER_LEVEL_TRACE, LOG_I2C_DRV))
    {
       char data_dump [80];
       uint8_t idx = 0;
@@ -179,9 +200,9 @@ RET_CODE i2c_set_timeout(uint16_t timeout)
    RET_CODE result = RETURN_NOK;
    if (i2c_validate_timeout(timeout) == RETURN_OK)
    {
-      logger_send(LOG_I2C_DRV, __func__, "new timeout %d", timeout);
+      LOG_TRACE(LOG_I2C_DRV, __func__, "new timeout %d", timeout);
       i2c_driver.timeout = timeout;
-      result = sch_set_task_period(&i2c_on_timeout, timeout);
+      result = sch_handle_set_period(i2c_timeout_task, timeout);
    }
    return result;
 }
@@ -193,13 +214,13 @@ RET_CODE i2c_validate_timeout(uint16_t timeout)
    {
       result = RETURN_OK;
    }
-   logger_send_if(result != RETURN_OK, LOG_ERROR, __func__, "invalid timeout", timeout);
+   LOG_ERR_IF(result != RETURN_OK, __func__, "invalid timeout", timeout);
    return result;
 }
 
 void i2c_reset()
 {
-   logger_send(LOG_ERROR, __func__, "resetting i2c");
+   LOG_ERR(__func__, "resetting i2c");
    RCC->APB1RSTR |= RCC_APB1RSTR_I2C1RST;
    __DSB();
    RCC->APB1RSTR &= ~RCC_APB1RSTR_I2C1RST;
@@ -223,6 +244,8 @@ void i2c_reset()
 }
 void i2c_deinitialize()
 {
+   evq_unregister(&i2c_events);
+   evq_unregister(&i2c_timeout_events);
    i2c_driver.state = I2C_STATE_UNKNOWN;
    i2c_driver.type = I2C_OP_UNKNOWN;
 }
@@ -235,18 +258,23 @@ I2C_STATUS i2c_get_status()
 
 void i2c_watcher()
 {
-   if (i2c_driver.transaction_ready)
+   evq_dispatch(&i2c_events);
+   evq_dispatch(&i2c_timeout_events);
+}
+
+void i2c_on_transaction_end(uint32_t arg)
+{
+   if (i2c_driver.state == I2C_STATE_END_OK || i2c_driver.state == I2C_STATE_ERROR)
    {
-      i2c_driver.transaction_ready = 0;
       I2C_STATUS status = i2c_get_status();
       if (status == I2C_STATUS_OK)
       {
-         logger_send(LOG_I2C_DRV, __func__, "transaction OK");
+         LOG_TRACE(LOG_I2C_DRV, __func__, "transaction OK");
          i2c_print_buffer(i2c_driver.type);
       }
       else
       {
-         logger_send(LOG_I2C_DRV, __func__, "error, resetting");
+         LOG_ERR(__func__, "error, resetting");
          i2c_reset();
       }
       if (i2c_drv_callback)
@@ -260,7 +288,8 @@ void i2c_watcher()
 void I2C1_EV_IRQHandler (void) {
 
    if (I2C1->SR1 & I2C_SR1_BTF){
-      if(i2c_driver.type == I2C_OP_WRITE && i2c_driver.state != I2C_STATE_IDLE)
+      /* transaction may be already ended by timeout */
+      if(i2c_driver.type == I2C_OP_WRITE && i2c_driver.state != I2C_STATE_IDLE && i2c_driver.state != I2C_STATE_ERROR)
       {
          if(i2c_driver.bytes_handled != i2c_driver.bytes_requested)
          {
@@ -268,8 +297,8 @@ void I2C1_EV_IRQHandler (void) {
          } else {
             I2C1->CR1 |= I2C_CR1_STOP;
             i2c_driver.state = I2C_STATE_END_OK;
-            i2c_driver.transaction_ready = 1;
-            sch_set_task_state(&i2c_on_timeout, TASKSTATE_STOPPED);
+            evq_push(&i2c_events, &i2c_on_transaction_end, 0);
+            sch_handle_set_state(i2c_timeout_task, TASKSTATE_STOPPED);
          }
       }
       return;
@@ -285,11 +314,11 @@ void I2C1_EV_IRQHandler (void) {
          I2C1->CR1 |= I2C_CR1_STOP;
          return;
       }
-      if (i2c_driver.bytes_handled == i2c_driver.bytes_requested)
+      if (i2c_driver.bytes_handled == i2c_driver.bytes_requested && i2c_driver.state != I2C_STATE_ERROR)
       {
          i2c_driver.state = I2C_STATE_END_OK;
-         i2c_driver.transaction_ready = 1;
-         sch_set_task_state(&i2c_on_timeout, TASKSTATE_STOPPED);
+         evq_push(&i2c_events, &i2c_on_transaction_end, 0);
+         sch_handle_set_state(i2c_timeout_task, TASKSTATE_STOPPED);
          I2C1->CR2 &= ~I2C_CR2_ITBUFEN;
          return;
       }
@@ -11,6 +11,7 @@
 #include "uart_engine.h"
 #include "gpio_lib.h"
 #include "return_codes.h"
+#include "ring_buffer.h"
 /* =============================
  *          Defines
  * =============================*/
@@ -22,24 +23,15 @@ void start_sending();
 void stop_sending();
 void uartengine_notify_callbacks();
 RET_CODE uartengine_get_string_from_buffer();
-void uartengine_write_byte(const uint8_t* byte);
-/* =============================
- *       Internal types
- * =============================*/
-typedef struct
-{
-	char * buf;
-	uint16_t tail;
-	uint16_t head;
-	uint8_t string_cnt;
-	uint16_t bytes_cnt;
-} UART_BUFFER;
+uint8_t uartengine_count_strings();
 /* =============================
  *      Module variables
  * =============================*/
 UARTEngine_Config uart_config;
-volatile UART_BUFFER uart_tx_buf;
-volatile UART_BUFFER uart_rx_buf;
+RING_BUFFER uart_tx_buf;
+RING_BUFFER uart_rx_buf;
+volatile uint8_t uart_rx_strings;   /**< Lines received, written in USART2 interrupt only */
+uint8_t uart_rx_strings_read;       /**< Lines read, written in main loop only */
 char* uart_rx_string;
 void (*UART_CALLBACKS[UART_ENGINE_CALLBACK_SIZE])(const char *);
 
@@ -58,21 +50,16 @@ RET_CODE uartengine_initialize(const UARTEngine_Config* cfg)
 	gpio_pin_cfg(GPIOA, PA3, gpio_mode_AF7_OD_PU_LS);
 	gpio_pin_cfg(GPIOA, PA2, gpio_mode_AF7_PP_LS);
 
-	uart_tx_buf.buf = (char*) malloc (sizeof(char)*uart_config.buffer_size);
-	uart_rx_buf.buf = (char*) malloc (sizeof(char)*uart_config.buffer_size);
+	/* ring buffer needs power of 2 size */
+	uint16_t buffer_size = rb_align_size(uart_config.buffer_size);
+	uint8_t* tx_buf = (uint8_t*) malloc (buffer_size);
+	uint8_t* rx_buf = (uint8_t*) malloc (buffer_size);
 	uart_rx_string = (char*) malloc (sizeof(char)*uart_config.string_size);
+	uart_rx_strings = 0;
+	uart_rx_strings_read = 0;
 
-	uart_tx_buf.head = 0;
-	uart_tx_buf.tail = 0;
-	uart_tx_buf.string_cnt = 0; /* not used */
-	uart_tx_buf.bytes_cnt = 0;  /* not user */
-
-	uart_rx_buf.head = 0;
-	uart_rx_buf.tail = 0;
-	uart_rx_buf.string_cnt = 0;
-	uart_rx_buf.bytes_cnt = 0;
-
-	if (!uart_rx_buf.buf || !uart_rx_buf.buf || !uart_rx_string)
+	if (rb_init(&uart_tx_buf, tx_buf, buffer_size) != RETURN_OK ||
+		 rb_init(&uart_rx_buf, rx_buf, buffer_size) != RETURN_OK || !uart_rx_string)
 	{
 		result = RETURN_ERROR;
 	}
@@ -99,16 +86,11 @@ void uartengine_deinitialize()
 
 RET_CODE uartengine_send_string(const char * buffer)
 {
-   if (!uart_tx_buf.buf)
+   if (!buffer)
    {
       return RETURN_ERROR;
    }
-   while (*buffer)
-   {
-      uartengine_write_byte((uint8_t*)buffer++);
-   }
-   start_sending();
-   return RETURN_OK;
+   return uartengine_send_bytes((const uint8_t*)buffer, strlen(buffer));
 }
 
 RET_CODE uartengine_send_bytes(const uint8_t* data, uint16_t size)
@@ -117,31 +99,27 @@ RET_CODE uartengine_send_bytes(const uint8_t* data, uint16_t size)
    {
       return RETURN_ERROR;
    }
-   for (uint16_t i = 0; i < size; i++)
+   while (size)
    {
-      uartengine_write_byte(data + i);
+      /* wait until interrupt makes place for the rest of data */
+      uint16_t written = rb_push_n(&uart_tx_buf, data, size);
+      data += written;
+      size -= written;
+      start_sending();
    }
-   start_sending();
    return RETURN_OK;
 }
 
-void uartengine_write_byte(const uint8_t* byte)
+uint16_t uartengine_get_tx_space()
 {
-   __disable_irq();
-   uart_tx_buf.buf[uart_tx_buf.head] = *byte;
-   uart_tx_buf.head++;
-   if (uart_tx_buf.head == uart_config.buffer_size)
-   {
-      uart_tx_buf.head = 0;
-   }
-   __enable_irq();
+   return uart_tx_buf.buf? rb_get_space(&uart_tx_buf) : 0;
 }
 
 RET_CODE uartengine_can_read_string()
 {
 	RET_CODE result = RETURN_NOK;
 
-	if (uart_rx_buf.string_cnt > 0)
+	if (uartengine_count_strings() > 0)
 	{
 		uartengine_get_string_from_buffer();
 		if (strlen(uart_rx_string) > 0)
@@ -158,73 +136,68 @@ const char* uartengine_get_string()
 }
 void uartengine_clear_rx()
 {
-	uart_rx_buf.tail = uart_rx_buf.head;
-	uart_rx_buf.string_cnt = 0;
-	uart_rx_buf.bytes_cnt = 0;
+	rb_flush(&uart_rx_buf);
+	uart_rx_strings_read = uart_rx_strings;
+}
+
+uint8_t uartengine_count_strings()
+{
+	return (uint8_t)(uart_rx_strings - uart_rx_strings_read);
 }
 
 RET_CODE uartengine_get_string_from_buffer()
 {
-	char* buffer = uart_rx_string;
-	if (!uart_rx_buf.buf || uart_rx_buf.string_cnt == 0 || !buffer)
+	if (!uart_rx_buf.buf || uartengine_count_strings() == 0 || !uart_rx_string)
 	{
 		return RETURN_ERROR;
 	}
 
-	char c;
-	while (1)
+	uint16_t length = 0;
+	uint8_t line_end = 0;
+	while (!line_end)
 	{
-		c = uart_rx_buf.buf[uart_rx_buf.tail];
-		uart_rx_buf.tail++;
-		uart_rx_buf.bytes_cnt--;
-		if (uart_rx_buf.tail == uart_config.buffer_size)
+		const uint8_t* data;
+		uint16_t size = rb_get_read_view(&uart_rx_buf, &data);
+		if (!size)
 		{
-			uart_rx_buf.tail = 0;
+			break;
 		}
-		if (c != '\r' && c != '\n')
+		const uint8_t* end = (const uint8_t*)memchr(data, '\n', size);
+		if (end)
 		{
-			*buffer = c;
+			size = end - data + 1;
+			line_end = 1;
 		}
-		else
+		/* the end of too long line is dropped */
+		uint16_t copy = size;
+		if (copy > uart_config.string_size - 1 - length)
 		{
-			*buffer = 0x00;
+			copy = uart_config.string_size - 1 - length;
 		}
-		if (c == '\n')
-		{
-			*buffer = 0x00;
-			break;
-		}
-		buffer++;
-
+		memcpy(uart_rx_string + length, data, copy);
+		length += copy;
+		rb_consume(&uart_rx_buf, size);
 	}
-	uart_rx_buf.string_cnt--;
+	uart_rx_string[length] = 0x00;
+	/* line ends on first CR or LF */
+	uart_rx_string[strcspn(uart_rx_string, "\r\n")] = 0x00;
+	uart_rx_strings_read++;
 	return RETURN_OK;
 }
 
 uint16_t uartengine_count_bytes()
 {
-	return uart_rx_buf.bytes_cnt;
+	return rb_get_count(&uart_rx_buf);
 }
 
 const uint8_t* uartengine_get_bytes()
 {
-	char* buffer = uart_rx_string;
-	if (!uart_rx_buf.buf || uart_rx_buf.bytes_cnt == 0 || !buffer)
+	if (!uart_rx_buf.buf || rb_get_count(&uart_rx_buf) == 0 || !uart_rx_string)
 	{
 		return NULL;
 	}
 
-	while (uart_rx_buf.bytes_cnt)
-	{
-      *buffer = uart_rx_buf.buf[uart_rx_buf.tail];
-      uart_rx_buf.tail++;
-      uart_rx_buf.bytes_cnt--;
-      if (uart_rx_buf.tail == uart_config.buffer_size)
-      {
-         uart_rx_buf.tail = 0;
-      }
-      buffer++;
-	}
+	rb_pop_n(&uart_rx_buf, (uint8_t*)uart_rx_string, uart_config.string_size);
 	return (uint8_t*)uart_rx_string;
 }
 
@@ -289,35 +262,22 @@ void stop_sending()
 void USART2_IRQHandler (void)
 {
 	if (USART2->SR & USART_SR_RXNE){
-		char c = USART2->DR;
-		uart_rx_buf.buf[uart_rx_buf.head] = USART2->DR;
-		uart_rx_buf.head++;
-		uart_rx_buf.bytes_cnt++;
-		if (c == '\n')
-		{
-			uart_rx_buf.string_cnt++;
-		}
-
-		if (uart_rx_buf.head == uart_config.buffer_size)
+		uint8_t c = USART2->DR;
+		if (rb_push(&uart_rx_buf, c) == RETURN_OK && c == '\n')
 		{
-			uart_rx_buf.head = 0;
+			uart_rx_strings++;
 		}
-
 	}
 
 	if (USART2->SR & USART_SR_TXE){
-		if (uart_tx_buf.head == uart_tx_buf.tail)
+		uint8_t c;
+		if (rb_pop(&uart_tx_buf, &c) == RETURN_OK)
 		{
-			stop_sending();
+			USART2->DR = c;
 		}
 		else
 		{
-			USART2->DR = uart_tx_buf.buf[uart_tx_buf.tail];
-			uart_tx_buf.tail++;
-			if (uart_tx_buf.tail == uart_config.buffer_size)
-			{
-				uart_tx_buf.tail = 0;
-			}
+			stop_sending();
 		}
 	}
 }
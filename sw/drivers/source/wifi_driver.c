@@ -33,13 +33,33 @@ RET_CODE wifi_disable_echo();
 RET_CODE wifi_connect_server(ConnType type, const char* server, uint16_t port);
 RET_CODE wifi_disconnect_server();
 void wifi_on_uart_data(const char* data);
+RET_CODE wifi_handle_async_reply(const char* data);
+RET_CODE wifi_wait_for_async_send();
 void wifi_convert_ntp_time(uint8_t* data, TimeItem* time);
+/* =============================
+ *       Internal types
+ * =============================*/
+typedef enum
+{
+	WIFI_ASYNC_IDLE,
+	WIFI_ASYNC_WAIT_PROMPT,		/**< CIPSEND command sent, waiting for OK */
+	WIFI_ASYNC_WAIT_SEND_OK,	/**< Data sent, waiting for SEND OK */
+} WIFI_ASYNC_STATE;
+
+typedef struct
+{
+	WIFI_ASYNC_STATE state;
+	const char* data;
+	uint16_t size;
+	uint16_t timestamp;
+} WIFI_ASYNC_SEND;
 /* =============================
  *      Module variables
  * =============================*/
 char TX_BUFFER[128];
 char* RX_BUFFER;
 void(*wifi_status_callback)(ClientEvent ev, ServerClientID id, const char* data);
+WIFI_ASYNC_SEND wifi_async;
 
 
 
@@ -90,9 +110,66 @@ void wifi_call_client_callback(ClientEvent ev, ServerClientID id, const char* da
 
 RET_CODE wifi_send_command()
 {
+	/* replies of commands cannot be mixed with replies of pending data transfer */
+	if (wifi_wait_for_async_send() != RETURN_OK)
+	{
+		return RETURN_NOK;
+	}
 	return uartengine_send_string(TX_BUFFER);
 }
 
+RET_CODE wifi_wait_for_async_send()
+{
+	while(wifi_async.state != WIFI_ASYNC_IDLE)
+	{
+		if (ts_get_diff(wifi_async.timestamp) >= DEFAULT_REPLY_TIMEOUT_MS)
+		{
+			wifi_async.state = WIFI_ASYNC_IDLE;
+			return RETURN_NOK;
+		}
+		if (uartengine_can_read_string() == RETURN_OK)
+		{
+			wifi_handle_async_reply(uartengine_get_string());
+		}
+	}
+	return RETURN_OK;
+}
+
+RET_CODE wifi_handle_async_reply(const char* data)
+{
+	RET_CODE result = RETURN_NOK;
+	if (wifi_async.state == WIFI_ASYNC_WAIT_PROMPT)
+	{
+		if (!strcmp(data, "OK"))
+		{
+			result = RETURN_OK;
+			if (uartengine_send_bytes((const uint8_t*)wifi_async.data, wifi_async.size) == RETURN_OK)
+			{
+				wifi_async.state = WIFI_ASYNC_WAIT_SEND_OK;
+				wifi_async.timestamp = ts_get();
+			}
+			else
+			{
+				wifi_async.state = WIFI_ASYNC_IDLE;
+			}
+		}
+		else if (!strcmp(data, "ERROR"))
+		{
+			result = RETURN_OK;
+			wifi_async.state = WIFI_ASYNC_IDLE;
+		}
+	}
+	else if (wifi_async.state == WIFI_ASYNC_WAIT_SEND_OK)
+	{
+		if (!strcmp(data, "SEND OK") || !strcmp(data, "SEND FAIL") || !strcmp(data, "ERROR"))
+		{
+			result = RETURN_OK;
+			wifi_async.state = WIFI_ASYNC_IDLE;
+		}
+	}
+	return result;
+}
+
 RET_CODE wifi_send_and_wait(uint32_t timeout)
 {
 	RET_CODE result = wifi_send_command();
@@ -116,6 +193,10 @@ RET_CODE wifi_send_and_wait_defined_response(const char* response, uint32_t time
 
 void wifi_on_uart_data(const char* data)
 {
+	if (wifi_async.state != WIFI_ASYNC_IDLE && wifi_handle_async_reply(data) == RETURN_OK)
+	{
+		return;
+	}
 	if (strstr(data, ",CONNECT")) /* new client connected */
 	{
 		ServerClientID id = atoi(strtok((char*)data, ","));
@@ -199,11 +280,17 @@ void wifi_deinitialize()
 {
 	uartengine_deinitialize();
 	wifi_status_callback = NULL;
+	wifi_async.state = WIFI_ASYNC_IDLE;
 
 }
 void wifi_data_watcher()
 {
    uartengine_string_watcher();
+   if (wifi_async.state != WIFI_ASYNC_IDLE && ts_get_diff(wifi_async.timestamp) >= DEFAULT_REPLY_TIMEOUT_MS)
+   {
+      /* module did not answer, transfer is abandoned */
+      wifi_async.state = WIFI_ASYNC_IDLE;
+   }
 }
 /*
  * 		API COMMANDS implementation
@@ -254,6 +341,35 @@ RET_CODE wifi_send_data(ServerClientID id, const char* data, uint16_t size)
 	return result;
 }
 
+RET_CODE wifi_try_send_data(ServerClientID id, const char* data, uint16_t size)
+{
+	if (!data)
+	{
+		return RETURN_ERROR;
+	}
+	RET_CODE result = RETURN_NOK;
+	if (wifi_async.state == WIFI_ASYNC_IDLE)
+	{
+		string_format(TX_BUFFER, "AT+CIPSEND=%d,%d\r\n", id, size);
+		/* command and data are written to UART buffer without waiting for free space */
+		if (uartengine_get_tx_space() >= strlen(TX_BUFFER) + size &&
+			 uartengine_send_string(TX_BUFFER) == RETURN_OK)
+		{
+			wifi_async.data = data;
+			wifi_async.size = size;
+			wifi_async.timestamp = ts_get();
+			wifi_async.state = WIFI_ASYNC_WAIT_PROMPT;
+			result = RETURN_OK;
+		}
+	}
+	return result;
+}
+
+RET_CODE wifi_is_sending()
+{
+	return wifi_async.state != WIFI_ASYNC_IDLE? RETURN_OK : RETURN_NOK;
+}
+
 RET_CODE wifi_send_bytes(ServerClientID id, const uint8_t* data, uint16_t size)
 {
    RET_CODE result = RETURN_NOK;
@@ -42,6 +42,8 @@ typedef struct WifiMgr
 	WIFI_UART_Config config;
 	char* ssid;
 	char* pass;
+	uint8_t broadcast_active;	/**< Non-blocking broadcast in progress */
+	uint8_t broadcast_client;	/**< Next client of non-blocking broadcast */
 } WifiMgr;
 /* =============================
  *      Module variables
@@ -59,6 +61,7 @@ RET_CODE wifimgr_initialize(const WIFI_UART_Config* config)
 	wifi_mgr.wifi_connected = 0;
 	wifi_mgr.server_port = WIFIMGR_SERVER_PORT;
 	wifi_mgr.server_running = 0;
+	wifi_mgr.broadcast_active = 0;
 	wifi_mgr.config = *config;
 
 	RET_CODE result = RETURN_NOK;
@@ -307,6 +310,42 @@ RET_CODE wifimgr_broadcast_data(const char* data)
 	return result;
 }
 
+RET_CODE wifimgr_try_broadcast_data(const char* data)
+{
+	if (!data)
+	{
+		return RETURN_ERROR;
+	}
+	if (!wifi_mgr.clients)
+	{
+		/* nobody to send to */
+		return RETURN_OK;
+	}
+	if (!wifi_mgr.broadcast_active)
+	{
+		wifi_mgr.broadcast_active = 1;
+		wifi_mgr.broadcast_client = 0;
+	}
+	if (wifi_is_sending() != RETURN_OK)
+	{
+		while (wifi_mgr.broadcast_client < WIFIMGR_MAX_CLIENTS && !wifi_mgr.clients[wifi_mgr.broadcast_client].connected)
+		{
+			wifi_mgr.broadcast_client++;
+		}
+		if (wifi_mgr.broadcast_client >= WIFIMGR_MAX_CLIENTS)
+		{
+			/* data sent to all clients, caller can release it */
+			wifi_mgr.broadcast_active = 0;
+			return RETURN_OK;
+		}
+		if (wifi_try_send_data(wifi_mgr.clients[wifi_mgr.broadcast_client].id.id, data, strlen(data)) == RETURN_OK)
+		{
+			wifi_mgr.broadcast_client++;
+		}
+	}
+	return RETURN_NOK;
+}
+
 RET_CODE wifimgr_broadcast_bytes(const uint8_t* bytes, uint16_t size)
 {
    RET_CODE result = RETURN_NOK;
@@ -448,5 +487,6 @@ void wifimgr_deinitialize()
 	wifi_mgr.clients_cnt = 0;
 	wifi_mgr.wifi_connected = 0;
 	wifi_mgr.server_running = 0;
+	wifi_mgr.broadcast_active = 0;
 
 }
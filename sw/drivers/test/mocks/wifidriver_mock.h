@@ -16,6 +16,8 @@ struct wifiDriverMock
 	MOCK_METHOD1(wifi_allow_multiple_clients, RET_CODE(uint8_t state));
 	MOCK_METHOD3(wifi_send_data, RET_CODE(ServerClientID, const char*, uint16_t));
    MOCK_METHOD3(wifi_send_bytes, RET_CODE(ServerClientID, const uint8_t*, uint16_t));
+	MOCK_METHOD3(wifi_try_send_data, RET_CODE(ServerClientID, const char*, uint16_t));
+	MOCK_METHOD0(wifi_is_sending, RET_CODE());
 	MOCK_METHOD1(wifi_set_ip_address, RET_CODE(IPAddress*));
 	MOCK_METHOD1(wifi_get_ip_address, RET_CODE(IPAddress*));
 	MOCK_METHOD2(wifi_get_time, RET_CODE(const char*, TimeItem*));
@@ -78,6 +80,14 @@ RET_CODE wifi_send_bytes(ServerClientID id, const uint8_t* data, uint16_t size)
 {
    return wifi_driver_mock->wifi_send_bytes(id, data, size);
 }
+RET_CODE wifi_try_send_data(ServerClientID id, const char* data, uint16_t size)
+{
+	return wifi_driver_mock->wifi_try_send_data(id, data, size);
+}
+RET_CODE wifi_is_sending()
+{
+	return wifi_driver_mock->wifi_is_sending();
+}
 RET_CODE wifi_set_ip_address(IPAddress* ip_address)
 {
 	return wifi_driver_mock->wifi_set_ip_address(ip_address);
@@ -14,6 +14,7 @@ struct wifiMgrMock
 	MOCK_METHOD2(wifimgr_send_data, RET_CODE(ServerClientID, const char*));
    MOCK_METHOD3(wifimgr_send_bytes, RET_CODE(ServerClientID, const uint8_t*, uint16_t size));
 	MOCK_METHOD1(wifimgr_broadcast_data, RET_CODE(const char*));
+	MOCK_METHOD1(wifimgr_try_broadcast_data, RET_CODE(const char*));
 	MOCK_METHOD2(wifimgr_broadcast_bytes, RET_CODE(const uint8_t*, uint16_t));
 	MOCK_METHOD1(wifimgr_get_time, RET_CODE(TimeItem*));
 	MOCK_METHOD0(wifimgr_count_clients, uint8_t());
@@ -74,6 +75,10 @@ RET_CODE wifimgr_broadcast_data(const char* data)
 {
 	return wifimgr_mock->wifimgr_broadcast_data(data);
 }
+RET_CODE wifimgr_try_broadcast_data(const char* data)
+{
+	return wifimgr_mock->wifimgr_try_broadcast_data(data);
+}
 RET_CODE wifimgr_broadcast_bytes(const uint8_t* data, uint16_t size)
 {
    return wifimgr_mock->wifimgr_broadcast_bytes(data, size);
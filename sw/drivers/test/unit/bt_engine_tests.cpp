@@ -103,7 +103,7 @@ TEST_F(btengineFixture, string_send)
 	 * <b>expected</b>: Data written to buffer, TXEIE enabled.<br>
 	 * ************************************************
 	 */
-	BT_Config cfg = {115200, 20, 15};
+	BT_Config cfg = {115200, 16, 15};
 	EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(2);
 	btengine_initialize(&cfg);
 
@@ -185,22 +185,22 @@ TEST_F(btengineFixture, string_send)
 	 */
 	char data2[]= "SECOND_STRING\n";
 	EXPECT_EQ(RETURN_OK, btengine_send_string(data2));
-	EXPECT_EQ(bt_tx_buf.head, 9);
+	EXPECT_EQ(bt_tx_buf.head, 29);
 	EXPECT_EQ(bt_tx_buf.tail, 15);
 	EXPECT_EQ(bt_tx_buf.buf[15], 'S');
-	EXPECT_EQ(bt_tx_buf.buf[16], 'E');
-	EXPECT_EQ(bt_tx_buf.buf[17], 'C');
-	EXPECT_EQ(bt_tx_buf.buf[18], 'O');
-	EXPECT_EQ(bt_tx_buf.buf[19], 'N');
-	EXPECT_EQ(bt_tx_buf.buf[0], 'D');
-	EXPECT_EQ(bt_tx_buf.buf[1], '_');
-	EXPECT_EQ(bt_tx_buf.buf[2], 'S');
-	EXPECT_EQ(bt_tx_buf.buf[3], 'T');
-	EXPECT_EQ(bt_tx_buf.buf[4], 'R');
-	EXPECT_EQ(bt_tx_buf.buf[5], 'I');
-	EXPECT_EQ(bt_tx_buf.buf[6], 'N');
-	EXPECT_EQ(bt_tx_buf.buf[7], 'G');
-	EXPECT_EQ(bt_tx_buf.buf[8], '\n');
+	EXPECT_EQ(bt_tx_buf.buf[0], 'E');
+	EXPECT_EQ(bt_tx_buf.buf[1], 'C');
+	EXPECT_EQ(bt_tx_buf.buf[2], 'O');
+	EXPECT_EQ(bt_tx_buf.buf[3], 'N');
+	EXPECT_EQ(bt_tx_buf.buf[4], 'D');
+	EXPECT_EQ(bt_tx_buf.buf[5], '_');
+	EXPECT_EQ(bt_tx_buf.buf[6], 'S');
+	EXPECT_EQ(bt_tx_buf.buf[7], 'T');
+	EXPECT_EQ(bt_tx_buf.buf[8], 'R');
+	EXPECT_EQ(bt_tx_buf.buf[9], 'I');
+	EXPECT_EQ(bt_tx_buf.buf[10], 'N');
+	EXPECT_EQ(bt_tx_buf.buf[11], 'G');
+	EXPECT_EQ(bt_tx_buf.buf[12], '\n');
 	EXPECT_TRUE(READ_BIT(USART1->CR1, USART_CR1_TXEIE));
 
 	/* Simulate USART IRQ - read data from buffer */
@@ -219,34 +219,34 @@ TEST_F(btengineFixture, string_send)
 	EXPECT_EQ(bt_tx_buf.tail, 19);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'N');
-	EXPECT_EQ(bt_tx_buf.tail, 0);
+	EXPECT_EQ(bt_tx_buf.tail, 20);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'D');
-	EXPECT_EQ(bt_tx_buf.tail, 1);
+	EXPECT_EQ(bt_tx_buf.tail, 21);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, '_');
-	EXPECT_EQ(bt_tx_buf.tail, 2);
+	EXPECT_EQ(bt_tx_buf.tail, 22);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'S');
-	EXPECT_EQ(bt_tx_buf.tail, 3);
+	EXPECT_EQ(bt_tx_buf.tail, 23);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'T');
-	EXPECT_EQ(bt_tx_buf.tail, 4);
+	EXPECT_EQ(bt_tx_buf.tail, 24);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'R');
-	EXPECT_EQ(bt_tx_buf.tail, 5);
+	EXPECT_EQ(bt_tx_buf.tail, 25);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'I');
-	EXPECT_EQ(bt_tx_buf.tail, 6);
+	EXPECT_EQ(bt_tx_buf.tail, 26);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'N');
-	EXPECT_EQ(bt_tx_buf.tail, 7);
+	EXPECT_EQ(bt_tx_buf.tail, 27);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'G');
-	EXPECT_EQ(bt_tx_buf.tail, 8);
+	EXPECT_EQ(bt_tx_buf.tail, 28);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, '\n');
-	EXPECT_EQ(bt_tx_buf.tail, 9);
+	EXPECT_EQ(bt_tx_buf.tail, 29);
 	USART1_IRQHandler();
 	EXPECT_EQ(bt_tx_buf.tail, bt_tx_buf.head);
 	EXPECT_FALSE(READ_BIT(USART1->CR1, USART_CR1_TXEIE));
@@ -258,44 +258,44 @@ TEST_F(btengineFixture, string_send)
 	 */
 	char data3[]= "AT_CMD\r\n";
 	EXPECT_EQ(RETURN_OK, btengine_send_string(data3));
-	EXPECT_EQ(bt_tx_buf.head, 17);
-	EXPECT_EQ(bt_tx_buf.tail, 9);
-	EXPECT_EQ(bt_tx_buf.buf[9], 'A');
-	EXPECT_EQ(bt_tx_buf.buf[10], 'T');
-	EXPECT_EQ(bt_tx_buf.buf[11], '_');
-	EXPECT_EQ(bt_tx_buf.buf[12], 'C');
-	EXPECT_EQ(bt_tx_buf.buf[13], 'M');
-	EXPECT_EQ(bt_tx_buf.buf[14], 'D');
-	EXPECT_EQ(bt_tx_buf.buf[15], '\r');
-	EXPECT_EQ(bt_tx_buf.buf[16], '\n');
+	EXPECT_EQ(bt_tx_buf.head, 37);
+	EXPECT_EQ(bt_tx_buf.tail, 29);
+	EXPECT_EQ(bt_tx_buf.buf[13], 'A');
+	EXPECT_EQ(bt_tx_buf.buf[14], 'T');
+	EXPECT_EQ(bt_tx_buf.buf[15], '_');
+	EXPECT_EQ(bt_tx_buf.buf[0], 'C');
+	EXPECT_EQ(bt_tx_buf.buf[1], 'M');
+	EXPECT_EQ(bt_tx_buf.buf[2], 'D');
+	EXPECT_EQ(bt_tx_buf.buf[3], '\r');
+	EXPECT_EQ(bt_tx_buf.buf[4], '\n');
 	EXPECT_TRUE(READ_BIT(USART1->CR1, USART_CR1_TXEIE));
 
 	/* Simulate USART IRQ - read data from buffer */
 	USART1->SR |=  USART_SR_TXE;
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'A');
-	EXPECT_EQ(bt_tx_buf.tail, 10);
+	EXPECT_EQ(bt_tx_buf.tail, 30);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'T');
-	EXPECT_EQ(bt_tx_buf.tail, 11);
+	EXPECT_EQ(bt_tx_buf.tail, 31);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, '_');
-	EXPECT_EQ(bt_tx_buf.tail, 12);
+	EXPECT_EQ(bt_tx_buf.tail, 32);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'C');
-	EXPECT_EQ(bt_tx_buf.tail, 13);
+	EXPECT_EQ(bt_tx_buf.tail, 33);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'M');
-	EXPECT_EQ(bt_tx_buf.tail, 14);
+	EXPECT_EQ(bt_tx_buf.tail, 34);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, 'D');
-	EXPECT_EQ(bt_tx_buf.tail, 15);
+	EXPECT_EQ(bt_tx_buf.tail, 35);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, '\r');
-	EXPECT_EQ(bt_tx_buf.tail, 16);
+	EXPECT_EQ(bt_tx_buf.tail, 36);
 	USART1_IRQHandler();
 	EXPECT_EQ(USART1->DR, '\n');
-	EXPECT_EQ(bt_tx_buf.tail, 17);
+	EXPECT_EQ(bt_tx_buf.tail, 37);
 	USART1_IRQHandler();
 
 	EXPECT_EQ(bt_tx_buf.tail, bt_tx_buf.head);
@@ -389,7 +389,7 @@ TEST_F(btengineFixture, string_read)
 	USART1_IRQHandler();
 	USART1->DR = '\n';
 	USART1_IRQHandler();
-	EXPECT_EQ(bt_rx_buf.head, 4);
+	EXPECT_EQ(bt_rx_buf.head, 24);
 
 	EXPECT_CALL(*callMock, callback(_)).WillOnce(Invoke([&](const char* buf)
 			{
@@ -430,7 +430,7 @@ TEST_F(btengineFixture, string_read)
 	USART1_IRQHandler();
 	USART1->DR = '\n';
 	USART1_IRQHandler();
-	EXPECT_EQ(bt_rx_buf.head, 14);
+	EXPECT_EQ(bt_rx_buf.head, 34);
 
 	EXPECT_CALL(*callMock, callback(_)).WillOnce(Invoke([&](const char* buf)
 			{
@@ -554,7 +554,7 @@ TEST_F(btengineFixture, string_read_special_data)
 	USART1_IRQHandler();
 	EXPECT_EQ(bt_rx_buf.head, 6);
 	EXPECT_EQ(bt_rx_buf.tail, 0);
-	EXPECT_EQ(bt_rx_buf.string_cnt, 2);
+	EXPECT_EQ(2, btengine_count_strings());
 
 	EXPECT_CALL(*callMock, callback(_)).WillOnce(Invoke([&](const char* buf)
 			{
@@ -566,7 +566,7 @@ TEST_F(btengineFixture, string_read_special_data)
 	btengine_string_watcher(); //shouldn't call callback, because first string is empty
 	btengine_string_watcher();
 	EXPECT_EQ(bt_rx_buf.head, bt_rx_buf.tail);
-	EXPECT_EQ(bt_rx_buf.string_cnt, 0);
+	EXPECT_EQ(0, btengine_count_strings());
 
 	USART1->DR = '\r';
 	USART1_IRQHandler();
@@ -582,7 +582,7 @@ TEST_F(btengineFixture, string_read_special_data)
 	USART1_IRQHandler();
 	EXPECT_EQ(bt_rx_buf.head, 12);
 	EXPECT_EQ(bt_rx_buf.tail, 6);
-	EXPECT_EQ(bt_rx_buf.string_cnt, 2);
+	EXPECT_EQ(2, btengine_count_strings());
 
 	EXPECT_CALL(*callMock, callback(_)).WillOnce(Invoke([&](const char* buf)
 			{
@@ -594,7 +594,7 @@ TEST_F(btengineFixture, string_read_special_data)
 	btengine_string_watcher(); //shouldn't call callback, because first string is empty
 	btengine_string_watcher();
 	EXPECT_EQ(bt_rx_buf.head, bt_rx_buf.tail);
-	EXPECT_EQ(bt_rx_buf.string_cnt, 0);
+	EXPECT_EQ(0, btengine_count_strings());
 
 	btengine_deinitialize();
 }
@@ -760,7 +760,7 @@ TEST_F(btengineFixture, string_read_bytes)
 	USART1_IRQHandler();
 	EXPECT_EQ(7U, btengine_count_bytes());
 
-	EXPECT_EQ(bt_rx_buf.head, 2);
+	EXPECT_EQ(bt_rx_buf.head, 17);
 	EXPECT_EQ(bt_rx_buf.tail, 10);
 
 	const uint8_t* result2 = btengine_get_bytes();
@@ -860,3 +860,60 @@ TEST_F(btengineFixture, bt_send_bytes)
 
    btengine_deinitialize();
 }
+
+/**
+ * @test Non-blocking string send.
+ */
+TEST_F(btengineFixture, try_send_string)
+{
+   /**
+    * <b>scenario</b>: String send when UART not initialized.<br>
+    * <b>expected</b>: Error returned.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_ERROR, btengine_try_send_string("DATA\n"));
+
+   BT_Config cfg = {115200, 16, 15};
+   EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(2);
+   btengine_initialize(&cfg);
+
+   /**
+    * <b>scenario</b>: String longer than whole buffer.<br>
+    * <b>expected</b>: Error returned, nothing written.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_ERROR, btengine_try_send_string("STRING_LONGER_THAN_BUFFER\n"));
+   EXPECT_EQ(bt_tx_buf.head, 0);
+
+   /**
+    * <b>scenario</b>: String fits into buffer.<br>
+    * <b>expected</b>: Data written to buffer, TXEIE enabled.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, btengine_try_send_string("0123456789\n"));
+   EXPECT_EQ(bt_tx_buf.head, 11);
+   EXPECT_TRUE(READ_BIT(USART1->CR1, USART_CR1_TXEIE));
+
+   /**
+    * <b>scenario</b>: Not enough free space for next string.<br>
+    * <b>expected</b>: NOK returned, buffer not modified.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_NOK, btengine_try_send_string("0123456789\n"));
+   EXPECT_EQ(bt_tx_buf.head, 11);
+
+   /**
+    * <b>scenario</b>: Space released by USART IRQ.<br>
+    * <b>expected</b>: String written to buffer.<br>
+    * ************************************************
+    */
+   USART1->SR |=  USART_SR_TXE;
+   for (uint8_t i = 0; i < 11; i++)
+   {
+      USART1_IRQHandler();
+   }
+   EXPECT_EQ(RETURN_OK, btengine_try_send_string("0123456789\n"));
+   EXPECT_EQ(bt_tx_buf.head, 22);
+
+   btengine_deinitialize();
+}
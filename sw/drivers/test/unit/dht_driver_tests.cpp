@@ -80,27 +80,27 @@ TEST_F(dhtDriverFixture, reading_one_sensor_test)
 	 * <b>expected</b>: Data read and parsed correctly, callback called <br>
 	 * ************************************************
 	 */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
 
    EXPECT_EQ(RETURN_OK, dht_read_async(DHT_SENSOR1, &fake_callback));
 
    //gpio should be set to low
    EXPECT_FALSE( (GPIOB->ODR & GPIO_ODR_ODR_9) != 0);
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    dht_on_timeout();
 
    EXPECT_TRUE( (GPIOB->ODR & GPIO_ODR_ODR_9) != 0);
    EXPECT_TRUE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
 
    /* watchdog task should be disabled */
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
    for (uint8_t i = 0; i < DHT_TIMESTAMPS_BUFFER_SIZE; i++)
    {
       EXTI->PR |= EXTI_PR_PR9;
@@ -110,7 +110,7 @@ TEST_F(dhtDriverFixture, reading_one_sensor_test)
    }
    /* timer disabled, measurement flag set */
    EXPECT_FALSE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
-   EXPECT_TRUE(dht_measurement_ready);
+   EXPECT_EQ(1, evq_get_count(&dht_events));
 
    EXPECT_CALL(*callMock, callback(_,_)).WillOnce(Invoke([&](DHT_STATUS status, DHT_SENSOR* sensor)
          {
@@ -123,7 +123,7 @@ TEST_F(dhtDriverFixture, reading_one_sensor_test)
             EXPECT_EQ(sensor->data.hum_l, 0);
          }));
    dht_data_watcher();
-   EXPECT_FALSE(dht_measurement_ready);
+   EXPECT_EQ(0, evq_get_count(&dht_events));
 
 
    /**
@@ -131,22 +131,22 @@ TEST_F(dhtDriverFixture, reading_one_sensor_test)
     * <b>expected</b>: Data read and parsed correctly, callback called <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    EXPECT_EQ(RETURN_OK, dht_read_async(DHT_SENSOR2, &fake_callback));
 
    //gpio should be set to low
    EXPECT_FALSE( (GPIOB->ODR & GPIO_ODR_ODR_10) != 0);
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    dht_on_timeout();
 
    EXPECT_TRUE( (GPIOB->ODR & GPIO_ODR_ODR_10) != 0);
    EXPECT_TRUE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
 
    /* watchdog task should be disabled */
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
    for (uint8_t i = 0; i < DHT_TIMESTAMPS_BUFFER_SIZE; i++)
    {
       EXTI->PR |= EXTI_PR_PR10;
@@ -156,7 +156,7 @@ TEST_F(dhtDriverFixture, reading_one_sensor_test)
    }
    /* timer disabled, measurement flag set */
    EXPECT_FALSE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
-   EXPECT_TRUE(dht_measurement_ready);
+   EXPECT_EQ(1, evq_get_count(&dht_events));
 
    EXPECT_CALL(*callMock, callback(_,_)).WillOnce(Invoke([&](DHT_STATUS status, DHT_SENSOR* sensor)
          {
@@ -169,7 +169,7 @@ TEST_F(dhtDriverFixture, reading_one_sensor_test)
             EXPECT_EQ(sensor->data.hum_l, 0);
          }));
    dht_data_watcher();
-   EXPECT_FALSE(dht_measurement_ready);
+   EXPECT_EQ(0, evq_get_count(&dht_events));
 }
 
 /**
@@ -195,27 +195,27 @@ TEST_F(dhtDriverFixture, reading_one_sensor_checksum_error_test)
     * <b>expected</b>: Checksum error catched, callback called with error status <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
 
    EXPECT_EQ(RETURN_OK, dht_read_async(DHT_SENSOR3, &fake_callback));
 
    //gpio should be set to low
    EXPECT_FALSE( (GPIOB->ODR & GPIO_ODR_ODR_12) != 0);
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    dht_on_timeout();
 
    EXPECT_TRUE( (GPIOB->ODR & GPIO_ODR_ODR_12) != 0);
    EXPECT_TRUE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
 
    /* watchdog task should be disabled */
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
    for (uint8_t i = 0; i < DHT_TIMESTAMPS_BUFFER_SIZE; i++)
    {
       EXTI->PR |= EXTI_PR_PR12;
@@ -225,7 +225,7 @@ TEST_F(dhtDriverFixture, reading_one_sensor_checksum_error_test)
    }
    /* timer disabled, measurement flag set */
    EXPECT_FALSE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
-   EXPECT_TRUE(dht_measurement_ready);
+   EXPECT_EQ(1, evq_get_count(&dht_events));
 
    EXPECT_CALL(*callMock, callback(_,_)).WillOnce(Invoke([&](DHT_STATUS status, DHT_SENSOR* sensor)
          {
@@ -233,29 +233,29 @@ TEST_F(dhtDriverFixture, reading_one_sensor_checksum_error_test)
             EXPECT_EQ(sensor->id, DHT_SENSOR3);
          }));
    dht_data_watcher();
-   EXPECT_FALSE(dht_measurement_ready);
+   EXPECT_EQ(0, evq_get_count(&dht_events));
 
    /**
     * <b>scenario</b>: Second read sequence for SENSOR4 <br>
     * <b>expected</b>: Data read and parsed correctly, callback called <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    EXPECT_EQ(RETURN_OK, dht_read_async(DHT_SENSOR4, &fake_callback));
 
    //gpio should be set to low
    EXPECT_FALSE( (GPIOB->ODR & GPIO_ODR_ODR_13) != 0);
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    dht_on_timeout();
 
    EXPECT_TRUE( (GPIOB->ODR & GPIO_ODR_ODR_13) != 0);
    EXPECT_TRUE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
 
    /* watchdog task should be disabled */
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
    for (uint8_t i = 0; i < DHT_TIMESTAMPS_BUFFER_SIZE; i++)
    {
       EXTI->PR |= EXTI_PR_PR13;
@@ -265,7 +265,7 @@ TEST_F(dhtDriverFixture, reading_one_sensor_checksum_error_test)
    }
    /* timer disabled, measurement flag set */
    EXPECT_FALSE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
-   EXPECT_TRUE(dht_measurement_ready);
+   EXPECT_EQ(1, evq_get_count(&dht_events));
 
    EXPECT_CALL(*callMock, callback(_,_)).WillOnce(Invoke([&](DHT_STATUS status, DHT_SENSOR* sensor)
          {
@@ -278,7 +278,7 @@ TEST_F(dhtDriverFixture, reading_one_sensor_checksum_error_test)
             EXPECT_EQ(sensor->data.hum_l, 0);
          }));
    dht_data_watcher();
-   EXPECT_FALSE(dht_measurement_ready);
+   EXPECT_EQ(0, evq_get_count(&dht_events));
 }
 
 /**
@@ -297,20 +297,20 @@ TEST_F(dhtDriverFixture, reading_one_sensor_no_response)
     * <b>expected</b>: Data read and parsed correctly, callback called <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
 
    EXPECT_EQ(RETURN_OK, dht_read_async(DHT_SENSOR5, &fake_callback));
 
    //gpio should be set to low
    EXPECT_FALSE( (GPIOB->ODR & GPIO_ODR_ODR_14) != 0);
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    dht_on_timeout();
 
    EXPECT_TRUE( (GPIOB->ODR & GPIO_ODR_ODR_14) != 0);
@@ -321,7 +321,7 @@ TEST_F(dhtDriverFixture, reading_one_sensor_no_response)
 
    /* timer disabled, measurement flag set */
    EXPECT_FALSE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
-   EXPECT_TRUE(dht_measurement_ready);
+   EXPECT_EQ(1, evq_get_count(&dht_timeout_events));
 
    EXPECT_CALL(*callMock, callback(_,_)).WillOnce(Invoke([&](DHT_STATUS status, DHT_SENSOR* sensor)
          {
@@ -334,28 +334,28 @@ TEST_F(dhtDriverFixture, reading_one_sensor_no_response)
             EXPECT_EQ(sensor->data.hum_l, 0);
          }));
    dht_data_watcher();
-   EXPECT_FALSE(dht_measurement_ready);
+   EXPECT_EQ(0, evq_get_count(&dht_timeout_events));
 
    /**
     * <b>scenario</b>: Second read sequence for SENSOR6 <br>
     * <b>expected</b>: Data read and parsed correctly, callback called <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    EXPECT_EQ(RETURN_OK, dht_read_async(DHT_SENSOR6, &fake_callback));
 
    //gpio should be set to low
    EXPECT_FALSE( (GPIOB->ODR & GPIO_ODR_ODR_15) != 0);
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    dht_on_timeout();
 
    EXPECT_TRUE( (GPIOB->ODR & GPIO_ODR_ODR_15) != 0);
    EXPECT_TRUE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
    /* watchdog task should be disabled */
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
    for (uint8_t i = 0; i < DHT_TIMESTAMPS_BUFFER_SIZE; i++)
    {
 
@@ -366,7 +366,7 @@ TEST_F(dhtDriverFixture, reading_one_sensor_no_response)
    }
    /* timer disabled, measurement flag set */
    EXPECT_FALSE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
-   EXPECT_TRUE(dht_measurement_ready);
+   EXPECT_EQ(1, evq_get_count(&dht_events));
 
    EXPECT_CALL(*callMock, callback(_,_)).WillOnce(Invoke([&](DHT_STATUS status, DHT_SENSOR* sensor)
          {
@@ -379,7 +379,7 @@ TEST_F(dhtDriverFixture, reading_one_sensor_no_response)
             EXPECT_EQ(sensor->data.hum_l, 0);
          }));
    dht_data_watcher();
-   EXPECT_FALSE(dht_measurement_ready);
+   EXPECT_EQ(0, evq_get_count(&dht_events));
 }
 
 /**
@@ -398,26 +398,26 @@ TEST_F(dhtDriverFixture, reading_dht11_type_sensor)
     * <b>expected</b>: Data read and parsed correctly, callback called <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
 
    EXPECT_EQ(RETURN_OK, dht_read_async(DHT_SENSOR5, &fake_callback));
 
    //gpio should be set to low
    EXPECT_FALSE( (GPIOB->ODR & GPIO_ODR_ODR_14) != 0);
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    dht_on_timeout();
 
    EXPECT_TRUE( (GPIOB->ODR & GPIO_ODR_ODR_14) != 0);
    EXPECT_TRUE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
    /* watchdog task should be disabled */
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
    for (uint8_t i = 0; i < DHT_TIMESTAMPS_BUFFER_SIZE; i++)
    {
 
@@ -428,7 +428,7 @@ TEST_F(dhtDriverFixture, reading_dht11_type_sensor)
    }
    /* timer disabled, measurement flag set */
    EXPECT_FALSE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
-   EXPECT_TRUE(dht_measurement_ready);
+   EXPECT_EQ(1, evq_get_count(&dht_events));
 
    EXPECT_CALL(*callMock, callback(_,_)).WillOnce(Invoke([&](DHT_STATUS status, DHT_SENSOR* sensor)
          {
@@ -441,7 +441,7 @@ TEST_F(dhtDriverFixture, reading_dht11_type_sensor)
             EXPECT_EQ(sensor->data.hum_l, 0);
          }));
    dht_data_watcher();
-   EXPECT_FALSE(dht_measurement_ready);
+   EXPECT_EQ(0, evq_get_count(&dht_events));
 
    /**
     * <b>scenario</b>: Second read sequence for SENSOR6 <br>
@@ -454,21 +454,21 @@ TEST_F(dhtDriverFixture, reading_dht11_type_sensor)
                                         12000, 8000, 8000, 8000, 8000, 8000, 8000, 12000,
                                         8000, 8000, 12000, 8000, 12000, 12000, 8000, 8000,
                                         8000, 8000, 8000, 8000, 8000, 12000, 12000, 12000};
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    EXPECT_EQ(RETURN_OK, dht_read_async(DHT_SENSOR6, &fake_callback));
 
    //gpio should be set to low
    EXPECT_FALSE( (GPIOB->ODR & GPIO_ODR_ODR_15) != 0);
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    dht_on_timeout();
 
    EXPECT_TRUE( (GPIOB->ODR & GPIO_ODR_ODR_15) != 0);
    EXPECT_TRUE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
    /* watchdog task should be disabled */
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
    for (uint8_t i = 0; i < DHT_TIMESTAMPS_BUFFER_SIZE; i++)
    {
 
@@ -479,7 +479,7 @@ TEST_F(dhtDriverFixture, reading_dht11_type_sensor)
    }
    /* timer disabled, measurement flag set */
    EXPECT_FALSE( (TIM2->CR1 & TIM_CR1_CEN) != 0);
-   EXPECT_TRUE(dht_measurement_ready);
+   EXPECT_EQ(1, evq_get_count(&dht_events));
 
    EXPECT_CALL(*callMock, callback(_,_)).WillOnce(Invoke([&](DHT_STATUS status, DHT_SENSOR* sensor)
          {
@@ -492,7 +492,7 @@ TEST_F(dhtDriverFixture, reading_dht11_type_sensor)
             EXPECT_EQ(sensor->data.hum_l, 0);
          }));
    dht_data_watcher();
-   EXPECT_FALSE(dht_measurement_ready);
+   EXPECT_EQ(0, evq_get_count(&dht_events));
 }
 
 /**
@@ -521,7 +521,7 @@ TEST_F(dhtDriverFixture, set_get_timeout_tests)
     * <b>expected</b>: Timeout changed <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,_)).WillOnce(Return(RETURN_OK));
    EXPECT_EQ(RETURN_OK, dht_set_timeout(DHT_DEFAULT_TIMEOUT_MS + 10));
    EXPECT_EQ(DHT_DEFAULT_TIMEOUT_MS + 10, dht_get_timeout());
 }
@@ -536,12 +536,12 @@ TEST_F(dhtDriverFixture, read_async_negative_cases)
     * <b>expected</b>: Measurement not started <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    EXPECT_EQ(RETURN_NOK, dht_read_async(DHT_ENUM_MAX, &fake_callback));
 
    /**
@@ -557,11 +557,11 @@ TEST_F(dhtDriverFixture, read_async_negative_cases)
     * <b>expected</b>: Status ERROR returned <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_NOK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_NOK));
    EXPECT_EQ(RETURN_NOK, dht_read_async(DHT_SENSOR6, &fake_callback));
 
    /**
@@ -569,12 +569,12 @@ TEST_F(dhtDriverFixture, read_async_negative_cases)
     * <b>expected</b>: Status ERROR returned <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_NOK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_NOK));
    EXPECT_EQ(RETURN_NOK, dht_read_async(DHT_SENSOR6, &fake_callback));
 
    /**
@@ -582,17 +582,17 @@ TEST_F(dhtDriverFixture, read_async_negative_cases)
     * <b>expected</b>: Callback called with error status <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    EXPECT_EQ(RETURN_OK, dht_read_async(DHT_SENSOR6, &fake_callback));
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_NOK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_NOK));
    dht_on_timeout();
-   EXPECT_TRUE(dht_measurement_ready);
+   EXPECT_EQ(1, evq_get_count(&dht_timeout_events));
 
    EXPECT_CALL(*callMock, callback(_,_)).WillOnce(Invoke([&](DHT_STATUS status, DHT_SENSOR* sensor)
          {
@@ -600,19 +600,19 @@ TEST_F(dhtDriverFixture, read_async_negative_cases)
             EXPECT_EQ(sensor->id, DHT_SENSOR6);
          }));
    dht_data_watcher();
-   EXPECT_FALSE(dht_measurement_ready);
+   EXPECT_EQ(0, evq_get_count(&dht_timeout_events));
 
    /**
     * <b>scenario</b>: Cannot run timer for start sequence <br>
     * <b>expected</b>: Status ERROR returned <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_NOK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_NOK));
    EXPECT_EQ(RETURN_NOK, dht_read_async(DHT_SENSOR6, &fake_callback));
 
    /**
@@ -620,18 +620,18 @@ TEST_F(dhtDriverFixture, read_async_negative_cases)
     * <b>expected</b>: Callback called with error status <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK));
    EXPECT_EQ(RETURN_OK, dht_read_async(DHT_SENSOR6, &fake_callback));
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_NOK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_NOK));
    dht_on_timeout();
-   EXPECT_TRUE(dht_measurement_ready);
+   EXPECT_EQ(1, evq_get_count(&dht_timeout_events));
 
    EXPECT_CALL(*callMock, callback(_,_)).WillOnce(Invoke([&](DHT_STATUS status, DHT_SENSOR* sensor)
          {
@@ -639,7 +639,7 @@ TEST_F(dhtDriverFixture, read_async_negative_cases)
             EXPECT_EQ(sensor->id, DHT_SENSOR6);
          }));
    dht_data_watcher();
-   EXPECT_FALSE(dht_measurement_ready);
+   EXPECT_EQ(0, evq_get_count(&dht_timeout_events));
 }
 
 
@@ -660,16 +660,16 @@ TEST_F(dhtDriverFixture, read_blocking_test)
     * <b>expected</b>: Data read and parsed correctly, callback called <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
    dht_on_timeout();
 
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).WillOnce(Return(RETURN_OK));
 
    /* thread have to be started because of while loop in dht_read */
    std::thread thread([&]()
@@ -714,13 +714,13 @@ TEST_F(dhtDriverFixture, read_blocking_test_timeout)
     * <b>expected</b>: Function returns after timeout - no endless loop <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,_,_,_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,_,_,_,_)).WillOnce(Return(1));
    EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(6);
    EXPECT_EQ(RETURN_OK, dht_initialize());
 
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).WillOnce(Return(RETURN_OK)).WillOnce(Return(RETURN_OK));
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_START_TIME_MS)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).WillOnce(Return(RETURN_OK)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,DHT_DEFAULT_TIMEOUT_MS)).WillOnce(Return(RETURN_OK));
    dht_on_timeout();
 
    /* thread have to be started because of while loop in dht_read */
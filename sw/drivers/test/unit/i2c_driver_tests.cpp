@@ -51,8 +51,8 @@ struct i2cDriverFixture : public ::testing::Test
       mock_gpio_init();
       mock_sch_init();
       callMock = new callbackMock();
-      EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_,TASKPRIO_HIGH,I2C_DEFAULT_TIMEOUT_MS,_,_))
-      .WillOnce(Return(RETURN_OK));
+      EXPECT_CALL(*sch_mock, sch_subscribe_handle(_,TASKPRIO_SOFTIRQ,I2C_DEFAULT_TIMEOUT_MS,_,_))
+      .WillOnce(Return(1));
       EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_, _, _)).Times(2);
       i2c_initialize();
    }
@@ -98,7 +98,7 @@ struct i2cDriverFixture : public ::testing::Test
  */
 TEST_F(i2cDriverFixture, i2c_async_write_test)
 {
-   EXPECT_CALL(*logger_mock, logger_get_group_state(_)).WillOnce(Return(LOGGER_GROUP_ENABLE));
+   logger_active_groups |= (uint32_t)1 << LOG_I2C_DRV;
    uint8_t test_buffer [16] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
                                0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E};
    uint8_t test_address = 0xFF;
@@ -107,7 +107,7 @@ TEST_F(i2cDriverFixture, i2c_async_write_test)
     * <b>expected</b>:  RETURN_NOK returned, transaction not started <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(0);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(0);
    EXPECT_EQ(RETURN_NOK, i2c_write_async(test_address, test_buffer, I2C_DRV_BUFFER_SIZE+1, NULL));
 
    /**
@@ -115,7 +115,7 @@ TEST_F(i2cDriverFixture, i2c_async_write_test)
     * <b>expected</b>:  RETURN_OK returned, transaction started <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(1);
    EXPECT_EQ(RETURN_OK, i2c_write_async(test_address, test_buffer, 3, &fake_callback));
 
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_START) != 0);
@@ -133,7 +133,7 @@ TEST_F(i2cDriverFixture, i2c_async_write_test)
       EXPECT_EQ(I2C1->DR, test_buffer[i]);
    }
 
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).Times(1);
    simulate_BTF_interrupt();
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_STOP) != 0);
 
@@ -147,7 +147,7 @@ TEST_F(i2cDriverFixture, i2c_async_write_test)
  */
 TEST_F(i2cDriverFixture, i2c_sync_write_test)
 {
-   EXPECT_CALL(*logger_mock, logger_get_group_state(_)).WillOnce(Return(LOGGER_GROUP_ENABLE));
+   logger_active_groups |= (uint32_t)1 << LOG_I2C_DRV;
    uint8_t test_buffer [16] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
                                0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E};
    uint8_t test_address = 0xFF;
@@ -174,13 +174,13 @@ TEST_F(i2cDriverFixture, i2c_sync_write_test)
                   EXPECT_EQ(I2C1->DR, test_buffer[i]);
                }
 
-               EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).Times(1);
+               EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).Times(1);
                simulate_BTF_interrupt();
                EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_STOP) != 0);
 
             });
 
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(1);
 
    EXPECT_EQ(I2C_STATUS_OK, i2c_write(test_address, test_buffer, 3));
 
@@ -193,7 +193,7 @@ TEST_F(i2cDriverFixture, i2c_sync_write_test)
  */
 TEST_F(i2cDriverFixture, i2c_async_write_one_byte_test)
 {
-   EXPECT_CALL(*logger_mock, logger_get_group_state(_)).WillOnce(Return(LOGGER_GROUP_ENABLE));
+   logger_active_groups |= (uint32_t)1 << LOG_I2C_DRV;
    uint8_t test_buffer [16] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
                                0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E};
    uint8_t test_address = 0xFF;
@@ -202,7 +202,7 @@ TEST_F(i2cDriverFixture, i2c_async_write_one_byte_test)
     * <b>expected</b>:  RETURN_OK returned, transaction started <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(1);
    EXPECT_EQ(RETURN_OK, i2c_write_async(test_address, test_buffer, 1, &fake_callback));
 
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_START) != 0);
@@ -214,10 +214,17 @@ TEST_F(i2cDriverFixture, i2c_async_write_one_byte_test)
    simulate_ADDR_interrupt();
    EXPECT_EQ(I2C1->DR, test_buffer[0]);
 
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).Times(1);
    simulate_BTF_interrupt();
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_STOP) != 0);
 
+   /**
+    * <b>scenario</b>:  Timeout task runs after transaction end was signaled <br>
+    * <b>expected</b>:  Result not overwritten, bus not reset, callback called once with OK <br>
+    * ************************************************
+    */
+   i2c_on_timeout();
+   EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_, _, _)).Times(0);
    EXPECT_CALL(*callMock, callback(I2C_OP_WRITE,I2C_STATUS_OK,_,1));
    i2c_watcher();
 
@@ -229,7 +236,7 @@ TEST_F(i2cDriverFixture, i2c_async_write_one_byte_test)
  */
 TEST_F(i2cDriverFixture, i2c_async_write_timeout_test)
 {
-   EXPECT_CALL(*logger_mock, logger_get_group_state(_)).WillOnce(Return(LOGGER_GROUP_ENABLE));
+   logger_active_groups |= (uint32_t)1 << LOG_I2C_DRV;
    uint8_t test_buffer [16] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
                                0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E};
    uint8_t test_address = 0xFF;
@@ -239,7 +246,7 @@ TEST_F(i2cDriverFixture, i2c_async_write_timeout_test)
     * <b>expected</b>:  RETURN_OK returned, transaction started, callback with error called <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(1);
    EXPECT_EQ(RETURN_OK, i2c_write_async(test_address, test_buffer, 3, &fake_callback));
 
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_START) != 0);
@@ -263,7 +270,7 @@ TEST_F(i2cDriverFixture, i2c_async_write_timeout_test)
     * <b>expected</b>:  RETURN_OK returned, transaction started <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(1);
    EXPECT_EQ(RETURN_OK, i2c_write_async(test_address, test_buffer, 3, &fake_callback));
 
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_START) != 0);
@@ -281,7 +288,7 @@ TEST_F(i2cDriverFixture, i2c_async_write_timeout_test)
       EXPECT_EQ(I2C1->DR, test_buffer[i]);
    }
 
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).Times(1);
    simulate_BTF_interrupt();
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_STOP) != 0);
 
@@ -296,14 +303,14 @@ TEST_F(i2cDriverFixture, i2c_async_write_timeout_test)
  */
 TEST_F(i2cDriverFixture, i2c_async_read_test)
 {
-   EXPECT_CALL(*logger_mock, logger_get_group_state(_)).WillOnce(Return(LOGGER_GROUP_ENABLE));
+   logger_active_groups |= (uint32_t)1 << LOG_I2C_DRV;
    uint8_t test_address = 0xFF;
    /**
     * <b>scenario</b>:  Try to read more data than possible <br>
     * <b>expected</b>:  RETURN_NOK returned, transaction not started <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(0);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(0);
    EXPECT_EQ(RETURN_NOK, i2c_read_async(test_address, I2C_DRV_BUFFER_SIZE+1, NULL));
 
    /**
@@ -311,7 +318,7 @@ TEST_F(i2cDriverFixture, i2c_async_read_test)
     * <b>expected</b>:  RETURN_OK returned, transaction started <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(1);
    EXPECT_EQ(RETURN_OK, i2c_read_async(test_address, 3, &fake_callback));
 
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_START) != 0);
@@ -323,7 +330,7 @@ TEST_F(i2cDriverFixture, i2c_async_read_test)
 
    simulate_ADDR_interrupt();
 
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).Times(1);
    for (uint8_t i = 0; i < 3; i++)
    {
       simulate_RXNE_interrupt(i);
@@ -346,7 +353,7 @@ TEST_F(i2cDriverFixture, i2c_async_read_test)
  */
 TEST_F(i2cDriverFixture, i2c_sync_read_test)
 {
-   EXPECT_CALL(*logger_mock, logger_get_group_state(_)).WillOnce(Return(LOGGER_GROUP_ENABLE));
+   logger_active_groups |= (uint32_t)1 << LOG_I2C_DRV;
    uint8_t test_address = 0xFF;
    uint8_t test_buffer [3] = {0x00, 0x00, 0x00};
    /**
@@ -367,7 +374,7 @@ TEST_F(i2cDriverFixture, i2c_sync_read_test)
 
                simulate_ADDR_interrupt();
 
-               EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).Times(1);
+               EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).Times(1);
                for (uint8_t i = 0; i < 3; i++)
                {
                   simulate_RXNE_interrupt(i);
@@ -377,7 +384,7 @@ TEST_F(i2cDriverFixture, i2c_sync_read_test)
 
             });
 
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(1);
    EXPECT_EQ(I2C_STATUS_OK, i2c_read(test_address, test_buffer, 3));
    EXPECT_EQ(test_buffer[0], 0x00);
    EXPECT_EQ(test_buffer[1], 0x01);
@@ -392,7 +399,7 @@ TEST_F(i2cDriverFixture, i2c_sync_read_test)
  */
 TEST_F(i2cDriverFixture, i2c_async_read_one_byte_test)
 {
-   EXPECT_CALL(*logger_mock, logger_get_group_state(_)).WillOnce(Return(LOGGER_GROUP_ENABLE));
+   logger_active_groups |= (uint32_t)1 << LOG_I2C_DRV;
    uint8_t test_address = 0xFF;
 
    /**
@@ -400,7 +407,7 @@ TEST_F(i2cDriverFixture, i2c_async_read_one_byte_test)
     * <b>expected</b>:  RETURN_OK returned, transaction started <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(1);
    EXPECT_EQ(RETURN_OK, i2c_read_async(test_address, 1, &fake_callback));
 
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_START) != 0);
@@ -411,7 +418,7 @@ TEST_F(i2cDriverFixture, i2c_async_read_one_byte_test)
    EXPECT_EQ(I2C1->DR, test_address);
 
    simulate_ADDR_interrupt();
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).Times(1);
    simulate_RXNE_interrupt(0x11);
 
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_STOP) != 0);
@@ -431,13 +438,13 @@ TEST_F(i2cDriverFixture, i2c_async_read_one_byte_test)
 TEST_F(i2cDriverFixture, i2c_async_read_timeout_test)
 {
    uint8_t test_address = 0xFF;
-   EXPECT_CALL(*logger_mock, logger_get_group_state(_)).WillOnce(Return(LOGGER_GROUP_ENABLE));
+   logger_active_groups |= (uint32_t)1 << LOG_I2C_DRV;
    /**
     * <b>scenario</b>:  Async read from I2C bus - timeout occurs <br>
     * <b>expected</b>:  RETURN_OK returned, transaction started, callback with error called <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(1);
    EXPECT_EQ(RETURN_OK, i2c_read_async(test_address, 3, &fake_callback));
 
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_START) != 0);
@@ -461,7 +468,7 @@ TEST_F(i2cDriverFixture, i2c_async_read_timeout_test)
     * <b>expected</b>:  RETURN_OK returned, transaction started <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(1);
    EXPECT_EQ(RETURN_OK, i2c_read_async(test_address, 3, &fake_callback));
 
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_START) != 0);
@@ -473,7 +480,7 @@ TEST_F(i2cDriverFixture, i2c_async_read_timeout_test)
 
    simulate_ADDR_interrupt();
 
-   EXPECT_CALL(*sch_mock, sch_set_task_state(_, TASKSTATE_STOPPED)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_set_state(_, TASKSTATE_STOPPED)).Times(1);
    for (uint8_t i = 0; i < 3; i++)
    {
       simulate_RXNE_interrupt(i);
@@ -516,7 +523,7 @@ TEST_F(i2cDriverFixture, i2c_set_get_timeout_test)
     * <b>expected</b>:  Timeout changed, scheduler notified <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_set_task_period(_,_)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_handle_set_period(_,_)).WillOnce(Return(RETURN_OK));
    EXPECT_EQ(RETURN_OK, i2c_set_timeout(I2C_DEFAULT_TIMEOUT_MS+1));
    EXPECT_EQ(I2C_DEFAULT_TIMEOUT_MS+1, i2c_get_timeout());
 }
@@ -533,7 +540,7 @@ TEST_F(i2cDriverFixture, i2c_busy_starting_read_test)
     * <b>expected</b>:  Only first request should be processed <br>
     * ************************************************
     */
-   EXPECT_CALL(*sch_mock, sch_trigger_task(_)).Times(1);
+   EXPECT_CALL(*sch_mock, sch_handle_trigger(_)).Times(1);
    EXPECT_EQ(RETURN_OK, i2c_read_async(test_address, 3, &fake_callback));
 
    EXPECT_TRUE( (I2C1->CR1 & I2C_CR1_START) != 0);
@@ -102,7 +102,7 @@ TEST_F(uartengineFixture, string_send)
 	 * <b>expected</b>: Data written to buffer, TXEIE enabled.<br>
     * ************************************************
 	 */
-	UARTEngine_Config cfg = {115200, 20, 15};
+	UARTEngine_Config cfg = {115200, 16, 15};
 	EXPECT_CALL(*gpio_lib_mock, gpio_pin_cfg(_,_,_)).Times(2);
 	uartengine_initialize(&cfg);
 
@@ -184,22 +184,22 @@ TEST_F(uartengineFixture, string_send)
 	 */
 	char data2[]= "SECOND_STRING\n";
 	EXPECT_EQ(RETURN_OK, uartengine_send_string(data2));
-	EXPECT_EQ(uart_tx_buf.head, 9);
+	EXPECT_EQ(uart_tx_buf.head, 29);
 	EXPECT_EQ(uart_tx_buf.tail, 15);
 	EXPECT_EQ(uart_tx_buf.buf[15], 'S');
-	EXPECT_EQ(uart_tx_buf.buf[16], 'E');
-	EXPECT_EQ(uart_tx_buf.buf[17], 'C');
-	EXPECT_EQ(uart_tx_buf.buf[18], 'O');
-	EXPECT_EQ(uart_tx_buf.buf[19], 'N');
-	EXPECT_EQ(uart_tx_buf.buf[0], 'D');
-	EXPECT_EQ(uart_tx_buf.buf[1], '_');
-	EXPECT_EQ(uart_tx_buf.buf[2], 'S');
-	EXPECT_EQ(uart_tx_buf.buf[3], 'T');
-	EXPECT_EQ(uart_tx_buf.buf[4], 'R');
-	EXPECT_EQ(uart_tx_buf.buf[5], 'I');
-	EXPECT_EQ(uart_tx_buf.buf[6], 'N');
-	EXPECT_EQ(uart_tx_buf.buf[7], 'G');
-	EXPECT_EQ(uart_tx_buf.buf[8], '\n');
+	EXPECT_EQ(uart_tx_buf.buf[0], 'E');
+	EXPECT_EQ(uart_tx_buf.buf[1], 'C');
+	EXPECT_EQ(uart_tx_buf.buf[2], 'O');
+	EXPECT_EQ(uart_tx_buf.buf[3], 'N');
+	EXPECT_EQ(uart_tx_buf.buf[4], 'D');
+	EXPECT_EQ(uart_tx_buf.buf[5], '_');
+	EXPECT_EQ(uart_tx_buf.buf[6], 'S');
+	EXPECT_EQ(uart_tx_buf.buf[7], 'T');
+	EXPECT_EQ(uart_tx_buf.buf[8], 'R');
+	EXPECT_EQ(uart_tx_buf.buf[9], 'I');
+	EXPECT_EQ(uart_tx_buf.buf[10], 'N');
+	EXPECT_EQ(uart_tx_buf.buf[11], 'G');
+	EXPECT_EQ(uart_tx_buf.buf[12], '\n');
 	EXPECT_TRUE(READ_BIT(USART2->CR1, USART_CR1_TXEIE));
 
 	/* Simulate USART IRQ - read data from buffer */
@@ -218,34 +218,34 @@ TEST_F(uartengineFixture, string_send)
 	EXPECT_EQ(uart_tx_buf.tail, 19);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'N');
-	EXPECT_EQ(uart_tx_buf.tail, 0);
+	EXPECT_EQ(uart_tx_buf.tail, 20);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'D');
-	EXPECT_EQ(uart_tx_buf.tail, 1);
+	EXPECT_EQ(uart_tx_buf.tail, 21);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, '_');
-	EXPECT_EQ(uart_tx_buf.tail, 2);
+	EXPECT_EQ(uart_tx_buf.tail, 22);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'S');
-	EXPECT_EQ(uart_tx_buf.tail, 3);
+	EXPECT_EQ(uart_tx_buf.tail, 23);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'T');
-	EXPECT_EQ(uart_tx_buf.tail, 4);
+	EXPECT_EQ(uart_tx_buf.tail, 24);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'R');
-	EXPECT_EQ(uart_tx_buf.tail, 5);
+	EXPECT_EQ(uart_tx_buf.tail, 25);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'I');
-	EXPECT_EQ(uart_tx_buf.tail, 6);
+	EXPECT_EQ(uart_tx_buf.tail, 26);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'N');
-	EXPECT_EQ(uart_tx_buf.tail, 7);
+	EXPECT_EQ(uart_tx_buf.tail, 27);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'G');
-	EXPECT_EQ(uart_tx_buf.tail, 8);
+	EXPECT_EQ(uart_tx_buf.tail, 28);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, '\n');
-	EXPECT_EQ(uart_tx_buf.tail, 9);
+	EXPECT_EQ(uart_tx_buf.tail, 29);
 	USART2_IRQHandler();
 	EXPECT_EQ(uart_tx_buf.tail, uart_tx_buf.head);
 	EXPECT_FALSE(READ_BIT(USART2->CR1, USART_CR1_TXEIE));
@@ -257,44 +257,44 @@ TEST_F(uartengineFixture, string_send)
 	 */
 	char data3[]= "AT_CMD\r\n";
 	EXPECT_EQ(RETURN_OK, uartengine_send_string(data3));
-	EXPECT_EQ(uart_tx_buf.head, 17);
-	EXPECT_EQ(uart_tx_buf.tail, 9);
-	EXPECT_EQ(uart_tx_buf.buf[9], 'A');
-	EXPECT_EQ(uart_tx_buf.buf[10], 'T');
-	EXPECT_EQ(uart_tx_buf.buf[11], '_');
-	EXPECT_EQ(uart_tx_buf.buf[12], 'C');
-	EXPECT_EQ(uart_tx_buf.buf[13], 'M');
-	EXPECT_EQ(uart_tx_buf.buf[14], 'D');
-	EXPECT_EQ(uart_tx_buf.buf[15], '\r');
-	EXPECT_EQ(uart_tx_buf.buf[16], '\n');
+	EXPECT_EQ(uart_tx_buf.head, 37);
+	EXPECT_EQ(uart_tx_buf.tail, 29);
+	EXPECT_EQ(uart_tx_buf.buf[13], 'A');
+	EXPECT_EQ(uart_tx_buf.buf[14], 'T');
+	EXPECT_EQ(uart_tx_buf.buf[15], '_');
+	EXPECT_EQ(uart_tx_buf.buf[0], 'C');
+	EXPECT_EQ(uart_tx_buf.buf[1], 'M');
+	EXPECT_EQ(uart_tx_buf.buf[2], 'D');
+	EXPECT_EQ(uart_tx_buf.buf[3], '\r');
+	EXPECT_EQ(uart_tx_buf.buf[4], '\n');
 	EXPECT_TRUE(READ_BIT(USART2->CR1, USART_CR1_TXEIE));
 
 	/* Simulate USART IRQ - read data from buffer */
 	USART2->SR |=  USART_SR_TXE;
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'A');
-	EXPECT_EQ(uart_tx_buf.tail, 10);
+	EXPECT_EQ(uart_tx_buf.tail, 30);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'T');
-	EXPECT_EQ(uart_tx_buf.tail, 11);
+	EXPECT_EQ(uart_tx_buf.tail, 31);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, '_');
-	EXPECT_EQ(uart_tx_buf.tail, 12);
+	EXPECT_EQ(uart_tx_buf.tail, 32);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'C');
-	EXPECT_EQ(uart_tx_buf.tail, 13);
+	EXPECT_EQ(uart_tx_buf.tail, 33);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'M');
-	EXPECT_EQ(uart_tx_buf.tail, 14);
+	EXPECT_EQ(uart_tx_buf.tail, 34);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, 'D');
-	EXPECT_EQ(uart_tx_buf.tail, 15);
+	EXPECT_EQ(uart_tx_buf.tail, 35);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, '\r');
-	EXPECT_EQ(uart_tx_buf.tail, 16);
+	EXPECT_EQ(uart_tx_buf.tail, 36);
 	USART2_IRQHandler();
 	EXPECT_EQ(USART2->DR, '\n');
-	EXPECT_EQ(uart_tx_buf.tail, 17);
+	EXPECT_EQ(uart_tx_buf.tail, 37);
 	USART2_IRQHandler();
 
 	EXPECT_EQ(uart_tx_buf.tail, uart_tx_buf.head);
@@ -388,7 +388,7 @@ TEST_F(uartengineFixture, string_read)
 	USART2_IRQHandler();
 	USART2->DR = '\n';
 	USART2_IRQHandler();
-	EXPECT_EQ(uart_rx_buf.head, 4);
+	EXPECT_EQ(uart_rx_buf.head, 24);
 
 	EXPECT_CALL(*callMock, callback(_)).WillOnce(Invoke([&](const char* buf)
 			{
@@ -429,7 +429,7 @@ TEST_F(uartengineFixture, string_read)
 	USART2_IRQHandler();
 	USART2->DR = '\n';
 	USART2_IRQHandler();
-	EXPECT_EQ(uart_rx_buf.head, 14);
+	EXPECT_EQ(uart_rx_buf.head, 34);
 
 	EXPECT_CALL(*callMock, callback(_)).WillOnce(Invoke([&](const char* buf)
 			{
@@ -530,9 +530,9 @@ TEST_F(uartengineFixture, string_bytes_read_mixed)
 	USART2->DR = '\n';
 	USART2_IRQHandler();
 
-	EXPECT_EQ(2, uart_rx_buf.string_cnt);
+	EXPECT_EQ(2, uartengine_count_strings());
 	EXPECT_EQ(RETURN_NOK, uartengine_can_read_string());
-	EXPECT_EQ(1, uart_rx_buf.string_cnt);
+	EXPECT_EQ(1, uartengine_count_strings());
 	EXPECT_EQ(RETURN_OK, uartengine_can_read_string());
 	EXPECT_STREQ("SEC_STRING", uartengine_get_string());
 	EXPECT_EQ(uart_rx_buf.head, uart_rx_buf.tail);
@@ -644,7 +644,7 @@ TEST_F(uartengineFixture, string_read_special_data)
 	USART2_IRQHandler();
 	EXPECT_EQ(uart_rx_buf.head, 6);
 	EXPECT_EQ(uart_rx_buf.tail, 0);
-	EXPECT_EQ(uart_rx_buf.string_cnt, 2);
+	EXPECT_EQ(2, uartengine_count_strings());
 
 	EXPECT_CALL(*callMock, callback(_)).WillOnce(Invoke([&](const char* buf)
 			{
@@ -656,7 +656,7 @@ TEST_F(uartengineFixture, string_read_special_data)
 	uartengine_string_watcher(); //shouldn't call callback, because first string is empty
 	uartengine_string_watcher();
 	EXPECT_EQ(uart_rx_buf.head, uart_rx_buf.tail);
-	EXPECT_EQ(uart_rx_buf.string_cnt, 0);
+	EXPECT_EQ(0, uartengine_count_strings());
 
 	USART2->DR = '\r';
 	USART2_IRQHandler();
@@ -672,7 +672,7 @@ TEST_F(uartengineFixture, string_read_special_data)
 	USART2_IRQHandler();
 	EXPECT_EQ(uart_rx_buf.head, 12);
 	EXPECT_EQ(uart_rx_buf.tail, 6);
-	EXPECT_EQ(uart_rx_buf.string_cnt, 2);
+	EXPECT_EQ(2, uartengine_count_strings());
 
 	EXPECT_CALL(*callMock, callback(_)).WillOnce(Invoke([&](const char* buf)
 			{
@@ -684,7 +684,7 @@ TEST_F(uartengineFixture, string_read_special_data)
 	uartengine_string_watcher(); //shouldn't call callback, because first string is empty
 	uartengine_string_watcher();
 	EXPECT_EQ(uart_rx_buf.head, uart_rx_buf.tail);
-	EXPECT_EQ(uart_rx_buf.string_cnt, 0);
+	EXPECT_EQ(0, uartengine_count_strings());
 
 	uartengine_deinitialize();
 }
@@ -850,7 +850,7 @@ TEST_F(uartengineFixture, string_read_bytes)
 	USART2_IRQHandler();
 	EXPECT_EQ(7U, uartengine_count_bytes());
 
-	EXPECT_EQ(uart_rx_buf.head, 2);
+	EXPECT_EQ(uart_rx_buf.head, 17);
 	EXPECT_EQ(uart_rx_buf.tail, 10);
 
 	const uint8_t* result2 = uartengine_get_bytes();
@@ -815,6 +815,122 @@ TEST_F(wifiFixture, wifi_send_bytes_to_client_test)
    EXPECT_EQ(RETURN_OK, wifi_send_bytes(1, test_bytes, TEST_BYTES_SIZE));
 }
 
+/**
+ * @test WiFi non-blocking send of data to client
+ */
+TEST_F(wifiFixture, wifi_try_send_data_test)
+{
+	const char data [] = "LOG_LINE\n";
+	wifi_unregister_client_event_callback();
+	EXPECT_EQ(RETURN_OK, wifi_register_client_event_callback(fake_callback));
+
+	/**
+	 * <b>scenario</b>: Not enough space in UART buffer.<br>
+	 * <b>expected</b>: RETURN_NOK returned, nothing sent.<br>
+	 * ************************************************
+	 */
+	EXPECT_CALL(*uartengineMock, uartengine_get_tx_space()).WillOnce(Return(20));
+	EXPECT_CALL(*uartengineMock, uartengine_send_string(_)).Times(0);
+	EXPECT_EQ(RETURN_NOK, wifi_try_send_data(1, data, strlen(data)));
+	EXPECT_EQ(RETURN_NOK, wifi_is_sending());
+	Mock::VerifyAndClearExpectations(uartengineMock);
+
+	/**
+	 * <b>scenario</b>: Transfer started.<br>
+	 * <b>expected</b>: Command sent, next transfer rejected until current one is finished.<br>
+	 * ************************************************
+	 */
+	EXPECT_CALL(*uartengineMock, uartengine_get_tx_space()).WillOnce(Return(1024));
+	EXPECT_CALL(*uartengineMock, uartengine_send_string(_)).WillOnce(Invoke([&](const char * cmd)->RET_CODE
+									{
+										EXPECT_STREQ(cmd, "AT+CIPSEND=1,9\r\n");
+										return RETURN_OK;
+									}));
+	EXPECT_CALL(*ts_mock, ts_get()).WillOnce(Return(0));
+	EXPECT_EQ(RETURN_OK, wifi_try_send_data(1, data, strlen(data)));
+	EXPECT_EQ(RETURN_OK, wifi_is_sending());
+	EXPECT_EQ(RETURN_NOK, wifi_try_send_data(1, data, strlen(data)));
+	Mock::VerifyAndClearExpectations(uartengineMock);
+	Mock::VerifyAndClearExpectations(ts_mock);
+
+	/**
+	 * <b>scenario</b>: Client event received during transfer.<br>
+	 * <b>expected</b>: Callback called, transfer still pending.<br>
+	 * ************************************************
+	 */
+	EXPECT_CALL(*callMock, callback(CLIENT_CONNECTED, 2, _));
+	std::string connect_ok = "2,CONNECT";
+	wifi_on_uart_data(connect_ok.c_str());
+	EXPECT_EQ(RETURN_OK, wifi_is_sending());
+	Mock::VerifyAndClearExpectations(callMock);
+
+	/**
+	 * <b>scenario</b>: Module ready to receive data.<br>
+	 * <b>expected</b>: Data sent, no callback called.<br>
+	 * ************************************************
+	 */
+	EXPECT_CALL(*callMock, callback(_,_,_)).Times(0);
+	EXPECT_CALL(*uartengineMock, uartengine_send_bytes((const uint8_t*)data, strlen(data))).WillOnce(Return(RETURN_OK));
+	EXPECT_CALL(*ts_mock, ts_get()).WillOnce(Return(10));
+	wifi_on_uart_data("OK");
+	EXPECT_EQ(RETURN_OK, wifi_is_sending());
+	Mock::VerifyAndClearExpectations(uartengineMock);
+
+	/**
+	 * <b>scenario</b>: Data sent by module.<br>
+	 * <b>expected</b>: Driver ready for next transfer.<br>
+	 * ************************************************
+	 */
+	wifi_on_uart_data("SEND OK");
+	EXPECT_EQ(RETURN_NOK, wifi_is_sending());
+	Mock::VerifyAndClearExpectations(callMock);
+
+	/**
+	 * <b>scenario</b>: Module does not answer.<br>
+	 * <b>expected</b>: Transfer abandoned after timeout.<br>
+	 * ************************************************
+	 */
+	EXPECT_CALL(*uartengineMock, uartengine_get_tx_space()).WillOnce(Return(1024));
+	EXPECT_CALL(*uartengineMock, uartengine_send_string(_)).WillOnce(Return(RETURN_OK));
+	EXPECT_CALL(*uartengineMock, uartengine_can_read_string()).WillRepeatedly(Return(RETURN_NOK));
+	EXPECT_CALL(*ts_mock, ts_get()).WillOnce(Return(0));
+	EXPECT_CALL(*ts_mock, ts_get_diff(_)).WillOnce(Return(10))
+													 .WillOnce(Return(5000));
+	EXPECT_CALL(*uartengineMock, uartengine_string_watcher()).Times(2);
+	EXPECT_EQ(RETURN_OK, wifi_try_send_data(1, data, strlen(data)));
+	wifi_data_watcher();
+	EXPECT_EQ(RETURN_OK, wifi_is_sending());
+	wifi_data_watcher();
+	EXPECT_EQ(RETURN_NOK, wifi_is_sending());
+	Mock::VerifyAndClearExpectations(uartengineMock);
+	Mock::VerifyAndClearExpectations(ts_mock);
+
+	/**
+	 * <b>scenario</b>: Command requested during transfer.<br>
+	 * <b>expected</b>: Transfer finished first, then command sent.<br>
+	 * ************************************************
+	 */
+	EXPECT_CALL(*uartengineMock, uartengine_get_tx_space()).WillOnce(Return(1024));
+	EXPECT_CALL(*uartengineMock, uartengine_send_string(_)).WillOnce(Return(RETURN_OK))
+														   .WillOnce(Invoke([&](const char * cmd)->RET_CODE
+									{
+										EXPECT_STREQ(cmd, "AT\r\n");
+										return RETURN_OK;
+									}));
+	EXPECT_CALL(*uartengineMock, uartengine_send_bytes(_, strlen(data))).WillOnce(Return(RETURN_OK));
+	EXPECT_CALL(*uartengineMock, uartengine_can_read_string()).WillRepeatedly(Return(RETURN_OK));
+	EXPECT_CALL(*uartengineMock, uartengine_get_string()).WillOnce(Return("OK"))
+														 .WillOnce(Return("SEND OK"))
+														 .WillOnce(Return("OK"));
+	EXPECT_CALL(*ts_mock, ts_get()).WillRepeatedly(Return(0));
+	EXPECT_CALL(*ts_mock, ts_get_diff(_)).WillRepeatedly(Return(0));
+	EXPECT_EQ(RETURN_OK, wifi_try_send_data(1, data, strlen(data)));
+	EXPECT_EQ(RETURN_OK, wifi_test());
+	EXPECT_EQ(RETURN_NOK, wifi_is_sending());
+
+	wifi_unregister_client_event_callback();
+}
+
 
 /**
  * @test WiFi connect / disconnect server
@@ -443,6 +443,62 @@ TEST_F(wifiMgrFixture, sending_bytes_to_client)
    EXPECT_EQ(RETURN_OK, wifimgr_send_bytes(TEST_ID, TEST_DATA, DATA_SIZE));
 }
 
+/**
+ * @test WiFi manager - non-blocking broadcast of data
+ */
+TEST_F(wifiMgrFixture, try_broadcast_data)
+{
+   setup_test_subject();
+   const char string [] = "TEST_STRING";
+
+   /**
+    * <b>scenario</b>: No client connected.<br>
+    * <b>expected</b>: RETURN_OK returned, nothing sent.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*wifi_driver_mock, wifi_is_sending()).WillOnce(Return(RETURN_NOK));
+   EXPECT_CALL(*wifi_driver_mock, wifi_try_send_data(_,_,_)).Times(0);
+   EXPECT_EQ(RETURN_OK, wifimgr_try_broadcast_data(string));
+   Mock::VerifyAndClearExpectations(wifi_driver_mock);
+
+   /**
+    * <b>scenario</b>: Two clients connected, driver busy.<br>
+    * <b>expected</b>: RETURN_NOK returned until data sent to both clients.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*wifi_driver_mock, wifi_request_client_details(_)).WillRepeatedly(Return(RETURN_OK));
+   wifimgr_on_client_event(CLIENT_CONNECTED, 0, NULL);
+   wifimgr_on_client_event(CLIENT_CONNECTED, 1, NULL);
+
+   EXPECT_CALL(*wifi_driver_mock, wifi_is_sending()).WillOnce(Return(RETURN_NOK))
+                                                     .WillOnce(Return(RETURN_OK))
+                                                     .WillOnce(Return(RETURN_NOK))
+                                                     .WillOnce(Return(RETURN_NOK))
+                                                     .WillOnce(Return(RETURN_NOK));
+   EXPECT_CALL(*wifi_driver_mock, wifi_try_send_data(0, string, strlen(string))).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*wifi_driver_mock, wifi_try_send_data(1, string, strlen(string))).WillOnce(Return(RETURN_NOK))
+                                                                               .WillOnce(Return(RETURN_OK));
+   EXPECT_EQ(RETURN_NOK, wifimgr_try_broadcast_data(string));
+   EXPECT_EQ(RETURN_NOK, wifimgr_try_broadcast_data(string));
+   EXPECT_EQ(RETURN_NOK, wifimgr_try_broadcast_data(string));
+   EXPECT_EQ(RETURN_NOK, wifimgr_try_broadcast_data(string));
+   EXPECT_EQ(RETURN_OK, wifimgr_try_broadcast_data(string));
+   Mock::VerifyAndClearExpectations(wifi_driver_mock);
+
+   /**
+    * <b>scenario</b>: Next broadcast, first client disconnected.<br>
+    * <b>expected</b>: Data sent to second client only.<br>
+    * ************************************************
+    */
+   wifimgr_on_client_event(CLIENT_DISCONNECTED, 0, NULL);
+   EXPECT_CALL(*wifi_driver_mock, wifi_is_sending()).WillRepeatedly(Return(RETURN_NOK));
+   EXPECT_CALL(*wifi_driver_mock, wifi_try_send_data(1, string, strlen(string))).WillOnce(Return(RETURN_OK));
+   EXPECT_EQ(RETURN_NOK, wifimgr_try_broadcast_data(string));
+   EXPECT_EQ(RETURN_OK, wifimgr_try_broadcast_data(string));
+
+   teardown_test_subject();
+}
+
 /**
  * @test WiFi manager - changing current wifi network data
  */
@@ -95,6 +95,11 @@ RET_CODE env_initialize(const ENV_CONFIG* cfg)
 
       result = sch_subscribe_and_set(&env_on_timeout, TASKPRIO_LOW, env_module.measure_period,
                env_module.cfg.measure_running? TASKSTATE_RUNNING : TASKSTATE_STOPPED, TASKTYPE_PERIODIC);
+      if (result == RETURN_OK)
+      {
+         /* measurements missed when main loop was blocked are not repeated */
+         result = sch_set_task_catchup(&env_on_timeout, CATCHUP_COALESCE);
+      }
    }
    logger_send_if(result != RETURN_OK, LOG_ERROR, __func__, "ENV init error");
    return result;
@@ -66,6 +66,7 @@ struct envFixture : public ::testing::Test
       mock_dht_init();
 
       EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_, TASKPRIO_LOW, ENV_MEASURE_PERIOD_DEF_MS, TASKSTATE_RUNNING, TASKTYPE_PERIODIC)).WillOnce(Return(RETURN_OK));
+      EXPECT_CALL(*sch_mock, sch_set_task_catchup(_, CATCHUP_COALESCE)).WillOnce(Return(RETURN_OK));
       EXPECT_EQ(RETURN_OK, env_initialize(&cfg));
       callMock = new callbackMock;
    }
@@ -129,6 +130,7 @@ TEST(envInitialization, env_initialization_tests)
     * ************************************************
     */
    EXPECT_CALL(*sch_mock, sch_subscribe_and_set(_, _, _, _, _)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*sch_mock, sch_set_task_catchup(_, CATCHUP_COALESCE)).WillOnce(Return(RETURN_OK));
    EXPECT_EQ(RETURN_OK, env_initialize(&cfg));
 
    /**
@@ -4,15 +4,36 @@
 /**
  * @file Logger.h
  *
- * @brief Allows to send debugs over UART interface (to both BT and WiFi targets)
+ * @brief Allows to send debugs to registered sinks (e.g. BT, WiFi clients, RAM crash log)
  *
  * @details
- * Logger serves basic debug functionality. You have to register at least one sender function,
- * that allows to send logger string.
+ * Logger serves basic debug functionality. You have to add at least one sink, that allows to send logger string.
+ * Every sink has own filter (mask of groups and the highest level). Sink with queue is not called from
+ * the context of log - the lines are copied to the queue and sent from logger_watcher(). Such sink must not
+ * block - when it cannot take the line at once (e.g. UART buffer full, WiFi transfer in progress), it returns
+ * RETURN_NOK and the line is sent again in next call. Every call sends at most drain budget lines per sink,
+ * so slow sink stalls neither the caller nor the main loop. Sink without queue is called immediately
+ * (e.g. RAM crash log).
  * New groups may be added in LogGroup enumeration.
  * New groups have to be also added in logger_get_group_name function.
  * Logger module is disabled by default.
  * All groups are disabled also - except ERROR group).
+ * In deferred mode the log is not formatted in caller context - only group, format, arguments
+ * and timestamp are copied to the buffer. Logs are formatted and sent from main loop by
+ * logger_watcher(). When buffer is full, the log is dropped and counted.
+ * String arguments are copied (truncated to 32 characters), prefix and format have to be constant.
+ * In deferred mode logs may be also sent in binary form (see logger_frame.h) - only addresses of
+ * format and prefix are sent together with raw arguments. Frames are decoded on host by log_decoder tool
+ * (sw/logger/tools) using ELF file of the firmware.
+ * Macro front-ends (LOG_ERR, LOG_INFO, LOG_TRACE) should be used instead of direct logger_send() calls:
+ * - logs above LOGGER_COMPILED_LEVEL or from groups not in LOGGER_COMPILED_GROUPS are removed at compile time,
+ * - logs from disabled groups are skipped before arguments are evaluated.
+ * TRACE level is compiled only in DEBUG builds.
+ * Rate limiting (disabled by default) gives every call site (identified by format string) a token bucket:
+ * burst logs may be sent at once, then rate logs per second. Log equal to the previous one from the same
+ * call site is not sent, but counted and reported as "last message repeated N times". Logs dropped because
+ * of empty bucket are reported as "N messages suppressed". Reports are sent before the next log from the site
+ * or from logger_watcher() - at least every 10s.
  *
  * @author Jacek Skowronek
  * @date 13/12/2020
@@ -33,6 +54,52 @@
  * =============================*/
 #define LOGGER_GROUP_ENABLE  0x01
 #define LOGGER_GROUP_DISABLE 0x00
+
+#define LOGGER_LEVEL_ERROR 0     /**< Errors, always compiled */
+#define LOGGER_LEVEL_INFO  1     /**< State changes and events */
+#define LOGGER_LEVEL_TRACE 2     /**< Detailed tracing, e.g. driver data */
+/** Sink filter accepting all groups */
+#define LOGGER_ALL_GROUPS 0xFFFFFFFF
+#define LOGGER_INVALID_SINK 0xFF
+/** The highest level compiled in - TRACE only with LOGGER_TRACE (CMake option), can be overridden at build time */
+#ifndef LOGGER_COMPILED_LEVEL
+#ifdef LOGGER_TRACE
+#define LOGGER_COMPILED_LEVEL LOGGER_LEVEL_TRACE
+#else
+#define LOGGER_COMPILED_LEVEL LOGGER_LEVEL_INFO
+#endif
+#endif
+/** Default budget of logs per call site, see logger_set_rate_limit() */
+#ifndef LOGGER_RATE_BURST_DEFAULT
+#define LOGGER_RATE_BURST_DEFAULT 5
+#endif
+#ifndef LOGGER_RATE_PER_S_DEFAULT
+#define LOGGER_RATE_PER_S_DEFAULT 1
+#endif
+/** Default size of sink queue in bytes - can be overridden at build time */
+#ifndef LOGGER_SINK_QUEUE_DEFAULT
+#define LOGGER_SINK_QUEUE_DEFAULT 1024
+#endif
+/** Mask of groups compiled in, bit per LogGroup - can be overridden at build time */
+#ifndef LOGGER_COMPILED_GROUPS
+#define LOGGER_COMPILED_GROUPS 0xFFFFFFFF
+#endif
+/** Check if log would be sent - constant part is resolved by compiler */
+#define LOGGER_IS_ACTIVE(level, group) \
+   ((level) <= LOGGER_COMPILED_LEVEL && ((LOGGER_COMPILED_GROUPS >> (group)) & 0x01) && ((logger_active_groups >> (group)) & 0x01))
+/** Send log, arguments are evaluated only when group is active */
+#define LOGGER_SEND(level, group, prefix, ...) \
+   do { if (LOGGER_IS_ACTIVE(level, group)) { logger_send_level(level, group, prefix, __VA_ARGS__); } } while (0)
+/** Send log conditionally, condition is evaluated only when group is active */
+#define LOGGER_SEND_IF(cond, level, group, prefix, ...) \
+   do { if (LOGGER_IS_ACTIVE(level, group) && (cond)) { logger_send_level(level, group, prefix, __VA_ARGS__); } } while (0)
+
+#define LOG_ERR(prefix, ...)                    LOGGER_SEND(LOGGER_LEVEL_ERROR, LOG_ERROR, prefix, __VA_ARGS__)
+#define LOG_ERR_IF(cond, prefix, ...)           LOGGER_SEND_IF(cond, LOGGER_LEVEL_ERROR, LOG_ERROR, prefix, __VA_ARGS__)
+#define LOG_INFO(group, prefix, ...)            LOGGER_SEND(LOGGER_LEVEL_INFO, group, prefix, __VA_ARGS__)
+#define LOG_INFO_IF(cond, group, prefix, ...)   LOGGER_SEND_IF(cond, LOGGER_LEVEL_INFO, group, prefix, __VA_ARGS__)
+#define LOG_TRACE(group, prefix, ...)           LOGGER_SEND(LOGGER_LEVEL_TRACE, group, prefix, __VA_ARGS__)
+#define LOG_TRACE_IF(cond, group, prefix, ...)  LOGGER_SEND_IF(cond, LOGGER_LEVEL_TRACE, group, prefix, __VA_ARGS__)
 /* =============================
  *       Data structures
  * =============================*/
@@ -56,6 +123,22 @@ typedef enum
    LOG_ENUM_MAX               /**< Enums count */
 } LogGroup;
 
+/** Handle to added sink */
+typedef uint8_t LOGGER_SINK;
+
+typedef struct LoggerSinkConfig
+{
+   RET_CODE(*send)(const char*);  /**< Sends the line without blocking, RETURN_NOK if sink is busy - the line is sent again later,
+                                       RETURN_ERROR if line cannot be sent at all - the line is dropped */
+   uint32_t groups;               /**< Bit per LogGroup */
+   uint8_t level;                 /**< The highest level sent */
+   uint16_t queue_size;           /**< Size of queue in bytes, 0 - line sent immediately */
+   uint8_t drain_budget;          /**< Lines sent from queue in one logger_watcher() call, 0 - default (8) */
+} LoggerSinkConfig;
+
+/** Bit per group, set when logger is enabled and group is enabled. Read by macro front-ends. */
+extern volatile uint32_t logger_active_groups;
+
 /**
  * @brief Initialize Logger module.
  * @param[in] buffer_size - size of the buffer where logger string is written.
@@ -64,17 +147,52 @@ typedef enum
 RET_CODE logger_initialize(uint16_t buffer_size);
 /**
  * @brief Register sending function to module.
- * @details Function will be called each time when new string should be send.
+ * @details Sink without queue, accepting all groups and levels is added.
  * @param[in] send_fnc - pointer to function
  * @return See RETURN_CODES.
  */
 RET_CODE logger_register_sender(RET_CODE(*send_fnc)(const char*));
 /**
  * @brief Unregister sending function.
+ * @details All sinks using this function are removed.
  * @param[in] send_fnc - pointer to function
  * @return See RETURN_CODES.
  */
 RET_CODE logger_unregister_sender(RET_CODE(*send_fnc)(const char*));
+/**
+ * @brief Add sink.
+ * @param[in] config - Sink configuration, the queue is allocated
+ * @return Handle of sink, LOGGER_INVALID_SINK on error.
+ */
+LOGGER_SINK logger_add_sink(const LoggerSinkConfig* config);
+/**
+ * @brief Remove sink, queued lines are dropped.
+ * @param[in] sink - Handle of sink
+ * @return See RETURN_CODES.
+ */
+RET_CODE logger_remove_sink(LOGGER_SINK sink);
+/**
+ * @brief Change filter of sink.
+ * @param[in] sink - Handle of sink
+ * @param[in] groups - Bit per LogGroup
+ * @param[in] level - The highest level sent
+ * @return See RETURN_CODES.
+ */
+RET_CODE logger_set_sink_filter(LOGGER_SINK sink, uint32_t groups, uint8_t level);
+/**
+ * @brief Read filter of sink.
+ * @param[in] sink - Handle of sink
+ * @param[out] groups - Bit per LogGroup
+ * @param[out] level - The highest level sent
+ * @return See RETURN_CODES.
+ */
+RET_CODE logger_get_sink_filter(LOGGER_SINK sink, uint32_t* groups, uint8_t* level);
+/**
+ * @brief Returns number of lines dropped because of full queue of sink (or rejected by sink).
+ * @param[in] sink - Handle of sink
+ * @return Number of dropped lines.
+ */
+uint32_t logger_get_sink_dropped(LOGGER_SINK sink);
 /**
  * @brief Enable logger module.
  * @return See RETURN_CODES.
@@ -100,6 +218,7 @@ RET_CODE logger_set_group_state(LogGroup group, uint8_t state);
 uint8_t logger_get_group_state(LogGroup group);
 /**
  * @brief Sends log string.
+ * @details Log from LOG_ERROR group has ERROR level, logs from other groups have INFO level.
  * @param[in] group - the group to which data is related
  * @param[in] prefix - short prefix added to log string
  * @param[in] fmt - printf-like format of string
@@ -107,6 +226,16 @@ uint8_t logger_get_group_state(LogGroup group);
  * @return None.
  */
 void logger_send(LogGroup group, const char* prefix, const char* fmt, ...);
+/**
+ * @brief Sends log string with given level, used by macro front-ends.
+ * @param[in] level - LOGGER_LEVEL_ERROR/INFO/TRACE, used by sink filters
+ * @param[in] group - the group to which data is related
+ * @param[in] prefix - short prefix added to log string
+ * @param[in] fmt - printf-like format of string
+ * @param[in] ... - list of arguments to format
+ * @return None.
+ */
+void logger_send_level(uint8_t level, LogGroup group, const char* prefix, const char* fmt, ...);
 /**
  * @brief Sends log string conditionally.
  * @param[in] cond_bool - expression (log will be send if this is true.
@@ -117,6 +246,49 @@ void logger_send(LogGroup group, const char* prefix, const char* fmt, ...);
  * @return None.
  */
 void logger_send_if(uint8_t cond_bool, LogGroup group, const char* prefix, const char* fmt, ...);
+/**
+ * @brief Enable/Disable deferred mode.
+ * @details Pending logs are sent when deferred mode is disabled.
+ * @param[in] state - 1 - logs deferred to main loop, 0 - logs sent immediately
+ * @return See RETURN_CODES.
+ */
+RET_CODE logger_set_deferred(uint8_t state);
+/**
+ * @brief Returns number of deferred logs dropped because of full buffer.
+ * @return Number of dropped logs.
+ */
+uint32_t logger_get_dropped_count();
+/**
+ * @brief Set budget of logs per call site.
+ * @details
+ * Time of rate limiter is counted in TIME module interrupt (callback is registered when limiting is enabled).
+ * Pending counts are reported when rate limiting is disabled.
+ * @param[in] burst - Number of logs sent at once, 0 disables rate limiting and repeated logs collapsing
+ * @param[in] rate - Number of logs per second, when burst is used
+ * @return See RETURN_CODES.
+ */
+RET_CODE logger_set_rate_limit(uint16_t burst, uint16_t rate);
+/**
+ * @brief Get budget of logs per call site.
+ * @param[out] burst - Number of logs sent at once, 0 if rate limiting is disabled
+ * @param[out] rate - Number of logs per second
+ * @return None.
+ */
+void logger_get_rate_limit(uint16_t* burst, uint16_t* rate);
+/**
+ * @brief Set sender of binary log frames.
+ * @details
+ * Frames are sent only in deferred mode, from logger_watcher(). Text senders are still notified, if registered.
+ * @param[in] send_fnc - Pointer to function sending bytes, NULL disables binary frames
+ * @return See RETURN_CODES.
+ */
+RET_CODE logger_set_binary_sender(RET_CODE(*send_fnc)(const uint8_t*, uint16_t));
+/**
+ * @brief Formats and sends deferred logs, has to be called from main loop.
+ * @details Dropped logs are reported with ERROR group.
+ * @return None.
+ */
+void logger_watcher();
 /**
  * @brief Converts log group enum to string.
  * @param[in] group - Group ID.
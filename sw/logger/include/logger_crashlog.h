@@ -0,0 +1,68 @@
+#ifndef _LOGGER_CRASHLOG_H_
+#define _LOGGER_CRASHLOG_H_
+
+/* ============================= */
+/**
+ * @file logger_crashlog.h
+ *
+ * @brief RAM log kept across reset.
+ *
+ * @details
+ * The last LOGGER_CRASHLOG_SIZE bytes of logs are kept in RAM section, which is not cleared
+ * by startup code (.noinit). After watchdog or fault reset the logs written before the reset
+ * can be read e.g. by "log crashlog" command.
+ * logger_crashlog_write() is used as Logger sink without queue, so the line is stored before
+ * the next instruction - queued line would be lost on crash.
+ */
+/* ============================= */
+/* =============================
+ *  Includes of common headers
+ * =============================*/
+#include <stdint.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "return_codes.h"
+/* =============================
+ *          Defines
+ * =============================*/
+#ifndef LOGGER_CRASHLOG_SIZE
+#define LOGGER_CRASHLOG_SIZE 2048
+#endif
+/** Line added by logger_crashlog_init() to separate logs from different runs */
+#define LOGGER_CRASHLOG_RESET_MARKER "--- reset ---\n"
+/* =============================
+ *   Functions definitions
+ * =============================*/
+/**
+ * @brief Initialize crash log.
+ * @details Content is kept when it is valid (written before reset), otherwise it is cleared.
+ * @return None.
+ */
+void logger_crashlog_init();
+/**
+ * @brief Append line to crash log, the oldest bytes are overwritten.
+ * @param[in] data - Line to store
+ * @return See RETURN_CODES.
+ */
+RET_CODE logger_crashlog_write(const char* data);
+/**
+ * @brief Read content of crash log.
+ * @param[out] buf - Buffer for data, not NULL terminated
+ * @param[in] offset - Offset from the oldest byte
+ * @param[in] size - Size of buffer
+ * @return Number of bytes read, 0 when offset is after the end of log.
+ */
+uint16_t logger_crashlog_read(char* buf, uint16_t offset, uint16_t size);
+/**
+ * @brief Get number of bytes stored in crash log.
+ * @return Number of bytes.
+ */
+uint16_t logger_crashlog_size();
+/**
+ * @brief Remove all data from crash log.
+ * @return None.
+ */
+void logger_crashlog_clear();
+
+#endif
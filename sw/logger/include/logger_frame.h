@@ -0,0 +1,42 @@
+#ifndef _LOGGER_FRAME_H_
+#define _LOGGER_FRAME_H_
+/* ============================= */
+/**
+ * @file logger_frame.h
+ *
+ * @brief Binary log frame, shared by logger and host decoder tool.
+ *
+ * @details
+ * In binary mode the log is not formatted on target. Address of format string and
+ * prefix is sent instead, the host decoder reads strings from ELF file.
+ * Frame layout (multi-byte values are little endian):
+ * | byte | content                                               |
+ * |------|-------------------------------------------------------|
+ * | 0    | LOGGER_FRAME_SYNC                                     |
+ * | 1    | payload length                                        |
+ * | 2-5  | address of format string                              |
+ * | 6-9  | address of prefix                                     |
+ * | 10-15| local time in ms from 01.01.2000 00:00:00             |
+ * | 16   | log group                                             |
+ * | ...  | arguments, in format order                            |
+ * | last | checksum - sum of payload bytes                       |
+ * Integer argument is sent as unsigned LEB128 varint (1-5 bytes), string argument
+ * as length byte followed by characters (without NULL terminator).
+ * Sync byte is not valid in ASCII/UTF-8 text, so frames can be mixed with text on the same link.
+ */
+/* ============================= */
+
+/* =============================
+ *          Defines
+ * =============================*/
+#define LOGGER_FRAME_SYNC 0xFE
+/** Sync and length bytes */
+#define LOGGER_FRAME_HEADER_SIZE 2
+/** Format address, prefix address, timestamp and group */
+#define LOGGER_FRAME_FIXED_PAYLOAD 15
+#define LOGGER_FRAME_MAX_PAYLOAD 255
+/** Size of frame with given payload */
+#define LOGGER_FRAME_SIZE(payload) (LOGGER_FRAME_HEADER_SIZE + (payload) + 1)
+#define LOGGER_FRAME_TIMESTAMP_SIZE 6
+
+#endif
@@ -8,16 +8,78 @@
  *  Includes of project headers
  * =============================*/
 #include "Logger.h"
+#include "logger_frame.h"
 #include "time_counter.h"
 #include "string_formatter.h"
+#include "core_cmFunc.h"
 /* =============================
  *          Defines
  * =============================*/
-#define LOGGER_MAX_SENDERS 2
+#define LOGGER_MAX_SINKS 4
+/* default number of lines sent by single sink in one logger_watcher() call, so slow sink does not stall main loop */
+#define LOGGER_SINK_DRAIN_DEFAULT 8
+/** Size of deferred logs buffer in 32-bit words - can be overridden at build time */
+#ifndef LOGGER_DEFERRED_BUFFER_WORDS
+#define LOGGER_DEFERRED_BUFFER_WORDS 512
+#endif
+/* single record with header and arguments, the rest of arguments is dropped */
+#define LOGGER_RECORD_MAX_WORDS 48
+#define LOGGER_RECORD_HEADER_WORDS ((sizeof(LoggerRecord) + sizeof(uint32_t) - 1) / sizeof(uint32_t))
+/* longer string arguments are truncated in deferred mode */
+#define LOGGER_STRING_ARG_MAX 32
+/* the longest format specifier handled by string formatter, e.g. "%.2d" */
+#define LOGGER_SPEC_MAX 5
+/* record data has to be visible in memory before head index is published */
+#define LOGGER_BARRIER() __sync_synchronize()
+/* number of call sites tracked by rate limiter, the least recently used site is replaced */
+#define LOGGER_RATE_SITES 16
+/* tokens are kept in 1/1000 of log, so refill is exact for every millisecond */
+#define LOGGER_RATE_TOKEN 1000
+/* pending "repeated"/"suppressed" counts are reported at least with this period */
+#define LOGGER_RATE_REPORT_MS 10000
+/* "[dd-mm-yyyy hh:mm:ss:mmm]" - positions of fields in cached time prefix */
+#define LOGGER_TIME_PREFIX_SIZE 25
+#define LOGGER_TIME_POS_DAY 1
+#define LOGGER_TIME_POS_MONTH 4
+#define LOGGER_TIME_POS_YEAR 7
+#define LOGGER_TIME_POS_HOUR 12
+#define LOGGER_TIME_POS_MINUTE 15
+#define LOGGER_TIME_POS_SECOND 18
+#define LOGGER_TIME_POS_MSECOND 21
+/* FNV-1a hash of log arguments, used to detect repeated message */
+#define LOGGER_HASH_INIT 2166136261u
+#define LOGGER_HASH_PRIME 16777619u
 /* =============================
  *   Internal module functions
  * =============================*/
-void logger_notify_data(const char* data);
+struct LoggerRecord;
+struct LoggerSink;
+void logger_notify_data(const char* data, LogGroup group, uint8_t level);
+void logger_update_active_groups();
+int logger_format_header(char* buf, uint16_t size, const TimeItem* time, LogGroup group, const char* prefix);
+void logger_defer(uint8_t level, LogGroup group, const char* prefix, const char* fmt, va_list va);
+uint16_t logger_capture_args(uint32_t* args, uint16_t max_words, const char* fmt, va_list va);
+int logger_format_args(char* buf, uint16_t size, const char* fmt, const uint32_t* args, uint16_t words);
+RET_CODE logger_ring_write(const uint32_t* record, uint16_t words);
+RET_CODE logger_ring_read(uint32_t* record);
+void logger_send_record(const struct LoggerRecord* header, const uint32_t* args, uint16_t words);
+uint16_t logger_encode_frame(uint8_t* frame, const struct LoggerRecord* header, const uint32_t* args, uint16_t words);
+uint8_t logger_is_sink_active(LogGroup group, uint8_t level);
+void logger_dispatch(uint8_t level, LogGroup group, const char* prefix, const char* fmt, va_list va);
+void logger_emit(uint8_t level, LogGroup group, const char* prefix, const char* fmt, ...);
+uint8_t logger_rate_check(uint8_t level, LogGroup group, const char* prefix, const char* fmt, va_list va);
+struct LoggerRateSite* logger_rate_get_site(const char* fmt, uint32_t now);
+void logger_rate_report(uint8_t level, LogGroup group, const char* prefix, uint32_t repeated, uint32_t suppressed);
+void logger_rate_flush(uint8_t force);
+uint32_t logger_hash_args(const char* fmt, va_list va);
+void logger_on_time_change(TimeItem* item);
+void logger_send_va(uint8_t level, LogGroup group, const char* prefix, const char* fmt, va_list va);
+RET_CODE logger_sink_push(struct LoggerSink* sink, const char* data);
+void logger_sink_drain(struct LoggerSink* sink);
+uint8_t logger_default_level(LogGroup group);
+void logger_update_time_prefix(const TimeItem* time);
+void logger_put_digits(char* buf, uint16_t value, uint8_t digits);
+char* logger_append(char* buf, const char* end, const char* str);
 /* =============================
  *       Internal types
  * =============================*/
@@ -28,6 +90,76 @@ typedef struct
 	char* buffer;
 	uint16_t buffer_size;
 } Logger;
+/** Header of deferred log, followed by captured arguments */
+typedef struct LoggerRecord
+{
+   uint32_t words;         /**< Size of record in words, 0 marks unused end of buffer */
+   uint16_t group;
+   uint16_t level;
+   uint64_t epoch_ms;      /**< Local time of log */
+   const char* prefix;
+   const char* fmt;
+} LoggerRecord;
+/**
+ * Ring of variable length records. Producers (interrupts and main loop) write whole record
+ * in critical section, only main loop moves the tail. Record is never split at buffer end.
+ */
+typedef struct LoggerDeferred
+{
+   uint8_t is_enabled;
+   volatile uint16_t head;
+   volatile uint16_t tail;
+   volatile uint32_t dropped;    /**< Number of logs dropped because of full buffer */
+   uint32_t reported;            /**< Number of dropped logs already reported */
+   uint32_t ring[LOGGER_DEFERRED_BUFFER_WORDS];
+} LoggerDeferred;
+/** State of single call site in rate limiter, site is identified by format string */
+typedef struct LoggerRateSite
+{
+   const char* fmt;        /**< NULL if site is not used */
+   const char* prefix;
+   LogGroup group;
+   uint8_t level;
+   uint32_t tokens;        /**< Available logs, in 1/LOGGER_RATE_TOKEN */
+   uint32_t last_ms;       /**< Time of last refill */
+   uint32_t args_hash;     /**< Arguments of last sent log */
+   uint32_t sent_ms;       /**< Time of last sent log */
+   uint32_t report_ms;     /**< Time of first not reported log */
+   uint32_t repeated;      /**< Logs equal to the last sent one, not sent */
+   uint32_t suppressed;    /**< Other logs dropped because of empty bucket */
+} LoggerRateSite;
+/**
+ * Token bucket per call site: every site may send burst logs at once, then rate logs per second.
+ * Time is counted in TIME module interrupt, so the check does not read the clock.
+ */
+typedef struct LoggerRate
+{
+   uint16_t burst;         /**< 0 - rate limiting disabled */
+   uint16_t rate;          /**< Logs per second */
+   uint16_t tick_ms;
+   volatile uint32_t now_ms;
+   LoggerRateSite sites[LOGGER_RATE_SITES];
+} LoggerRate;
+/** Formatted time of the last log, only changed fields are formatted again */
+typedef struct LoggerTimePrefix
+{
+   uint8_t is_valid;
+   TimeItem time;
+   char text[LOGGER_TIME_PREFIX_SIZE];
+} LoggerTimePrefix;
+/** Output of logs with own filter, lines are queued when queue is allocated */
+typedef struct LoggerSink
+{
+   RET_CODE(*send)(const char*);
+   uint32_t groups;
+   uint8_t level;
+   char* queue;            /**< Lines with NULL terminators, 0x00 at head position marks wrap to the beginning */
+   uint16_t queue_size;
+   volatile uint16_t head; /**< Written from log context */
+   volatile uint16_t tail; /**< Written from logger_watcher() */
+   volatile uint32_t dropped;
+   uint8_t drain_budget;   /**< Lines sent in one logger_watcher() call */
+} LoggerSink;
 typedef struct LOG_GROUP
 {
    uint8_t state;
@@ -38,7 +170,16 @@ typedef struct LOG_GROUP
  *      Module variables
  * =============================*/
 Logger logger;
-RET_CODE (*LOGGER_SENDERS[LOGGER_MAX_SENDERS])(const char *);
+volatile uint32_t logger_active_groups;
+LoggerDeferred logger_deferred;
+LoggerSink LOGGER_SINKS[LOGGER_MAX_SINKS];
+RET_CODE (*logger_binary_sender)(const uint8_t*, uint16_t);
+LoggerRate logger_rate;
+LoggerTimePrefix logger_time_prefix;
+/* in binary mode format is sent as address, so it has to be kept in memory */
+const char LOGGER_DROPPED_FMT[] = "%u logs dropped";
+const char LOGGER_REPEATED_FMT[] = "last message repeated %u times";
+const char LOGGER_SUPPRESSED_FMT[] = "%u messages suppressed";
 LOG_GROUP LOGGER_GROUPS[LOG_ENUM_MAX] = {
       {LOGGER_GROUP_ENABLE, LOG_ERROR, "ERROR"},
       {LOGGER_GROUP_ENABLE, LOG_WIFI_DRIVER, "WIFI_DRV"},
@@ -60,7 +201,8 @@ RET_CODE logger_initialize(uint16_t buffer_size)
 {
 	RET_CODE result = RETURN_NOK;
 
-	logger.buffer = (char*) malloc (sizeof(char) * buffer_size);
+	/* buffer has to fit at least new line and NULL terminator */
+	logger.buffer = buffer_size >= 2? (char*) malloc (sizeof(char) * buffer_size) : NULL;
 	if (logger.buffer)
 	{
 		logger.buffer_size = buffer_size;
@@ -72,46 +214,126 @@ RET_CODE logger_initialize(uint16_t buffer_size)
 		/* LOG_ERROR group always is ON */
 	   LOGGER_GROUPS[i].state = (i == LOG_ERROR)? LOGGER_GROUP_ENABLE : LOGGER_GROUP_DISABLE;
 	}
+	logger_update_active_groups();
 	return result;
 }
 
 RET_CODE logger_register_sender(RET_CODE(*send_fnc)(const char*))
+{
+	LoggerSinkConfig config = {send_fnc, LOGGER_ALL_GROUPS, LOGGER_LEVEL_TRACE, 0};
+	return logger_add_sink(&config) != LOGGER_INVALID_SINK? RETURN_OK : RETURN_NOK;
+}
+
+RET_CODE logger_unregister_sender(RET_CODE(*send_fnc)(const char*))
 {
 	RET_CODE result = RETURN_NOK;
-	for (uint8_t i=0; i < LOGGER_MAX_SENDERS; i++)
+	for (uint8_t i=0; i < LOGGER_MAX_SINKS; i++)
 	{
-		if (LOGGER_SENDERS[i] == NULL)
+		if (send_fnc && LOGGER_SINKS[i].send == send_fnc)
 		{
-			LOGGER_SENDERS[i] = send_fnc;
-			result = RETURN_OK;
-			break;
+			result = logger_remove_sink(i);
 		}
 	}
 	return result;
 }
 
-RET_CODE logger_unregister_sender(RET_CODE(*send_fnc)(const char*))
+LOGGER_SINK logger_add_sink(const LoggerSinkConfig* config)
 {
-	RET_CODE result = RETURN_NOK;
-	for (uint8_t i=0; i < LOGGER_MAX_SENDERS; i++)
+	if (!config || !config->send)
+	{
+		return LOGGER_INVALID_SINK;
+	}
+	for (uint8_t i = 0; i < LOGGER_MAX_SINKS; i++)
 	{
-		if (LOGGER_SENDERS[i] == send_fnc)
+		LoggerSink* sink = &LOGGER_SINKS[i];
+		if (sink->send == NULL)
 		{
-			LOGGER_SENDERS[i] = NULL;
-			result = RETURN_OK;
+			char* queue = NULL;
+			if (config->queue_size)
+			{
+				queue = (char*) malloc(config->queue_size);
+				if (!queue)
+				{
+					return LOGGER_INVALID_SINK;
+				}
+			}
+			sink->groups = config->groups;
+			sink->level = config->level;
+			sink->queue = queue;
+			sink->queue_size = config->queue_size;
+			sink->head = 0;
+			sink->tail = 0;
+			sink->dropped = 0;
+			sink->drain_budget = config->drain_budget? config->drain_budget : LOGGER_SINK_DRAIN_DEFAULT;
+			/* sink is visible to logs when fully prepared */
+			sink->send = config->send;
+			return i;
 		}
 	}
-	return result;
+	return LOGGER_INVALID_SINK;
+}
+
+RET_CODE logger_remove_sink(LOGGER_SINK sink)
+{
+	if (sink >= LOGGER_MAX_SINKS || !LOGGER_SINKS[sink].send)
+	{
+		return RETURN_NOK;
+	}
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	char* queue = LOGGER_SINKS[sink].queue;
+	LOGGER_SINKS[sink].send = NULL;
+	LOGGER_SINKS[sink].queue = NULL;
+	LOGGER_SINKS[sink].queue_size = 0;
+	__set_PRIMASK(primask);
+	free(queue);
+	return RETURN_OK;
+}
+
+RET_CODE logger_set_sink_filter(LOGGER_SINK sink, uint32_t groups, uint8_t level)
+{
+	if (sink >= LOGGER_MAX_SINKS || !LOGGER_SINKS[sink].send)
+	{
+		return RETURN_NOK;
+	}
+	LOGGER_SINKS[sink].groups = groups;
+	LOGGER_SINKS[sink].level = level;
+	return RETURN_OK;
+}
+
+RET_CODE logger_get_sink_filter(LOGGER_SINK sink, uint32_t* groups, uint8_t* level)
+{
+	if (sink >= LOGGER_MAX_SINKS || !LOGGER_SINKS[sink].send)
+	{
+		return RETURN_NOK;
+	}
+	*groups = LOGGER_SINKS[sink].groups;
+	*level = LOGGER_SINKS[sink].level;
+	return RETURN_OK;
+}
+
+uint32_t logger_get_sink_dropped(LOGGER_SINK sink)
+{
+	return sink < LOGGER_MAX_SINKS? LOGGER_SINKS[sink].dropped : 0;
 }
 
 void logger_deinitialize()
 {
+	logger_set_rate_limit(0, 0);
+	logger.is_enabled = 0;
+	logger_update_active_groups();
 	free(logger.buffer);
 	logger.is_initialized = 0;
-	for (uint8_t i = 0; i < LOGGER_MAX_SENDERS; i++)
+	logger_deferred.is_enabled = 0;
+	logger_deferred.head = 0;
+	logger_deferred.tail = 0;
+	logger_deferred.dropped = 0;
+	logger_deferred.reported = 0;
+	for (uint8_t i = 0; i < LOGGER_MAX_SINKS; i++)
 	{
-		LOGGER_SENDERS[i] = NULL;
+		logger_remove_sink(i);
 	}
+	logger_binary_sender = NULL;
 }
 RET_CODE logger_enable()
 {
@@ -120,6 +342,7 @@ RET_CODE logger_enable()
 	if (logger.is_initialized)
 	{
 		logger.is_enabled = 1;
+		logger_update_active_groups();
 		result = RETURN_OK;
 	}
 
@@ -129,6 +352,7 @@ RET_CODE logger_enable()
 void logger_disable()
 {
 	logger.is_enabled = 0;
+	logger_update_active_groups();
 }
 RET_CODE logger_set_group_state(LogGroup group, uint8_t state)
 {
@@ -139,6 +363,7 @@ RET_CODE logger_set_group_state(LogGroup group, uint8_t state)
 		if (LOGGER_GROUPS[group].state != state)
 		{
 			LOGGER_GROUPS[group].state = state;
+			logger_update_active_groups();
 			result = RETURN_OK;
 		}
 	}
@@ -155,63 +380,673 @@ uint8_t logger_get_group_state(LogGroup group)
 }
 void logger_send(LogGroup group, const char* prefix, const char* fmt, ...)
 {
-	if (logger.is_enabled && group < LOG_ENUM_MAX)
+	if (group < LOG_ENUM_MAX && (logger_active_groups & ((uint32_t)1 << group)))
+	{
+		va_list va;
+		va_start(va, fmt);
+		logger_send_va(logger_default_level(group), group, prefix, fmt, va);
+		va_end(va);
+	}
+}
+
+void logger_send_level(uint8_t level, LogGroup group, const char* prefix, const char* fmt, ...)
+{
+	if (group < LOG_ENUM_MAX && (logger_active_groups & ((uint32_t)1 << group)))
+	{
+		va_list va;
+		va_start(va, fmt);
+		logger_send_va(level, group, prefix, fmt, va);
+		va_end(va);
+	}
+}
+
+void logger_send_va(uint8_t level, LogGroup group, const char* prefix, const char* fmt, va_list va)
+{
+	if (!logger_is_sink_active(group, level) && !logger_binary_sender)
+	{
+		/* no sink accepts this log, it is not formatted at all */
+		return;
+	}
+	if (logger_rate_check(level, group, prefix, fmt, va))
+	{
+		logger_dispatch(level, group, prefix, fmt, va);
+	}
+}
+
+uint8_t logger_default_level(LogGroup group)
+{
+	return group == LOG_ERROR? LOGGER_LEVEL_ERROR : LOGGER_LEVEL_INFO;
+}
+
+void logger_dispatch(uint8_t level, LogGroup group, const char* prefix, const char* fmt, va_list va)
+{
+	if (logger_deferred.is_enabled)
+	{
+		logger_defer(level, group, prefix, fmt, va);
+	}
+	else
+	{
+		/* the last bytes are kept for new line and NULL terminator */
+		int offset = logger_format_header(logger.buffer, logger.buffer_size - 1, time_get(), group, prefix);
+		int length = sf_format_string_n(logger.buffer+offset, logger.buffer_size - offset - 1, fmt, va);
+		logger.buffer[offset + length++] = '\n';
+		logger.buffer[offset + length] = 0x00;
+		logger_notify_data(logger.buffer, group, level);
+	}
+}
+
+void logger_emit(uint8_t level, LogGroup group, const char* prefix, const char* fmt, ...)
+{
+	va_list va;
+	va_start(va, fmt);
+	logger_dispatch(level, group, prefix, fmt, va);
+	va_end(va);
+}
+
+void logger_notify_data(const char* data, LogGroup group, uint8_t level)
+{
+	for (uint8_t i = 0; i < LOGGER_MAX_SINKS; i++)
+	{
+		LoggerSink* sink = &LOGGER_SINKS[i];
+		if (sink->send == NULL || level > sink->level || !(sink->groups & ((uint32_t)1 << group)))
+		{
+			continue;
+		}
+		if (sink->queue)
+		{
+			logger_sink_push(sink, data);
+		}
+		else
+		{
+			sink->send(data);
+		}
+	}
+}
+
+RET_CODE logger_sink_push(LoggerSink* sink, const char* data)
+{
+	RET_CODE result = RETURN_NOK;
+	uint16_t size = strlen(data) + 1;
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint16_t head = sink->head;
+	uint16_t tail = sink->tail;
+	uint16_t start = head;
+	/* line is never split, so it can be sent directly from the queue */
+	if (head >= tail)
+	{
+		/* the last byte stays free, so head == tail means empty queue */
+		if (sink->queue_size - head >= size && (tail > 0 || sink->queue_size - head > size))
+		{
+			result = RETURN_OK;
+		}
+		else if (tail > size)
+		{
+			start = 0;
+			result = RETURN_OK;
+		}
+	}
+	else if (tail - head > size)
+	{
+		result = RETURN_OK;
+	}
+	if (result == RETURN_OK)
+	{
+		if (start != head)
+		{
+			sink->queue[head] = 0x00;
+		}
+		memcpy(&sink->queue[start], data, size);
+		sink->head = (start + size) % sink->queue_size;
+	}
+	else
+	{
+		sink->dropped++;
+	}
+	__set_PRIMASK(primask);
+	return result;
+}
+
+void logger_sink_drain(LoggerSink* sink)
+{
+	for (uint8_t i = 0; i < sink->drain_budget; i++)
 	{
-		if (LOGGER_GROUPS[group].state == LOGGER_GROUP_ENABLE)
+		uint16_t tail = sink->tail;
+		if (tail == sink->head)
 		{
-			int length = 0;
-			va_list va;
-			va_start(va, fmt);
-			va_end(va);
+			/* empty queue starts from the beginning, so the longest line fits without wrap */
+			uint32_t primask = __get_PRIMASK();
+			__disable_irq();
+			if (sink->tail == sink->head)
 			{
-				TimeItem* time = time_get();
-				int offset = string_format(logger.buffer, "[%.2d-%.2d-%d %.2d:%.2d:%.2d:%.3d] - %s - %s:", time->day, time->month, time->year, time->hour, time->minute, time->second, time->msecond,
-				      LOGGER_GROUPS[group].name, prefix);
-				va_start(va, fmt);
-				length = sf_format_string(logger.buffer+offset, fmt, va);
-				va_end(va);
-				logger.buffer[offset + length++] = '\n';
-				logger.buffer[offset + length] = 0x00;
-				logger_notify_data(logger.buffer);
+				sink->head = 0;
+				sink->tail = 0;
 			}
+			__set_PRIMASK(primask);
+			break;
+		}
+		if (sink->queue[tail] == 0x00)
+		{
+			/* wrap marker */
+			sink->tail = 0;
+			continue;
+		}
+		RET_CODE result = sink->send(&sink->queue[tail]);
+		if (result == RETURN_NOK)
+		{
+			/* sink busy, line is sent again in next call */
+			break;
+		}
+		if (result != RETURN_OK)
+		{
+			/* line cannot be sent at all (e.g. longer than sink buffer), counter is shared with log context */
+			uint32_t primask = __get_PRIMASK();
+			__disable_irq();
+			sink->dropped++;
+			__set_PRIMASK(primask);
+		}
+		sink->tail = (tail + strlen(&sink->queue[tail]) + 1) % sink->queue_size;
+	}
+}
+
+void logger_send_if(uint8_t cond_bool, LogGroup group, const char* prefix, const char* fmt, ...)
+{
+	if (cond_bool != 0 && group < LOG_ENUM_MAX && (logger_active_groups & ((uint32_t)1 << group)))
+	{
+		va_list va;
+		va_start(va, fmt);
+		logger_send_va(logger_default_level(group), group, prefix, fmt, va);
+		va_end(va);
+	}
+}
+
+RET_CODE logger_set_deferred(uint8_t state)
+{
+	RET_CODE result = RETURN_NOK;
+	if (logger.is_initialized)
+	{
+		if (!state)
+		{
+			/* logs captured so far are not lost */
+			logger_watcher();
 		}
+		logger_deferred.is_enabled = state;
+		result = RETURN_OK;
 	}
+	return result;
 }
 
-void logger_notify_data(const char* data)
+uint32_t logger_get_dropped_count()
 {
-	for (uint8_t i = 0; i < LOGGER_MAX_SENDERS; i++)
+	return logger_deferred.dropped;
+}
+
+RET_CODE logger_set_binary_sender(RET_CODE(*send_fnc)(const uint8_t*, uint16_t))
+{
+	logger_binary_sender = send_fnc;
+	return RETURN_OK;
+}
+
+RET_CODE logger_set_rate_limit(uint16_t burst, uint16_t rate)
+{
+	if (burst && !logger_rate.burst)
 	{
-		if (LOGGER_SENDERS[i] != NULL)
+		/* rate limiter time is counted in ticks */
+		logger_rate.tick_ms = time_get_basetime();
+		logger_rate.now_ms = 0;
+		memset(logger_rate.sites, 0, sizeof(logger_rate.sites));
+		if (time_register_callback(&logger_on_time_change, TIME_PRIORITY_HIGH) != RETURN_OK)
 		{
-			LOGGER_SENDERS[i](data);
+			return RETURN_NOK;
 		}
 	}
+	else if (!burst && logger_rate.burst)
+	{
+		/* pending counts are not lost */
+		logger_rate_flush(1);
+		time_unregister_callback(&logger_on_time_change);
+	}
+	logger_rate.burst = burst;
+	logger_rate.rate = rate;
+	return RETURN_OK;
 }
 
-void logger_send_if(uint8_t cond_bool, LogGroup group, const char* prefix, const char* fmt, ...)
+void logger_get_rate_limit(uint16_t* burst, uint16_t* rate)
+{
+	*burst = logger_rate.burst;
+	*rate = logger_rate.rate;
+}
+
+void logger_watcher()
+{
+	uint32_t record[LOGGER_RECORD_MAX_WORDS];
+	if (logger_rate.burst)
+	{
+		logger_rate_flush(0);
+	}
+	LoggerRecord header;
+	while (logger_ring_read(record) == RETURN_OK)
+	{
+		memcpy(&header, record, sizeof(header));
+		logger_send_record(&header, record + LOGGER_RECORD_HEADER_WORDS, header.words - LOGGER_RECORD_HEADER_WORDS);
+	}
+	uint32_t dropped = logger_deferred.dropped;
+	if (dropped != logger_deferred.reported)
+	{
+		uint32_t count = dropped - logger_deferred.reported;
+		header.group = LOG_ERROR;
+		header.level = LOGGER_LEVEL_ERROR;
+		header.epoch_ms = time_get_epoch_ms();
+		header.prefix = __func__;
+		header.fmt = LOGGER_DROPPED_FMT;
+		logger_deferred.reported = dropped;
+		logger_send_record(&header, &count, 1);
+	}
+	for (uint8_t i = 0; i < LOGGER_MAX_SINKS; i++)
+	{
+		if (LOGGER_SINKS[i].send && LOGGER_SINKS[i].queue)
+		{
+			logger_sink_drain(&LOGGER_SINKS[i]);
+		}
+	}
+}
+
+void logger_send_record(const LoggerRecord* header, const uint32_t* args, uint16_t words)
+{
+	if (logger_binary_sender)
+	{
+		uint8_t frame[LOGGER_FRAME_SIZE(LOGGER_FRAME_MAX_PAYLOAD)];
+		logger_binary_sender(frame, logger_encode_frame(frame, header, args, words));
+	}
+	if (logger_is_sink_active((LogGroup)header->group, header->level))
+	{
+		TimeItem time;
+		time_from_epoch_ms(header->epoch_ms, &time);
+		int offset = logger_format_header(logger.buffer, logger.buffer_size - 1, &time, (LogGroup)header->group, header->prefix);
+		int length = logger_format_args(logger.buffer + offset, logger.buffer_size - offset - 1, header->fmt, args, words);
+		logger.buffer[offset + length++] = '\n';
+		logger.buffer[offset + length] = 0x00;
+		logger_notify_data(logger.buffer, (LogGroup)header->group, header->level);
+	}
+}
+
+uint16_t logger_encode_frame(uint8_t* frame, const LoggerRecord* header, const uint32_t* args, uint16_t words)
+{
+	uint8_t* payload = &frame[LOGGER_FRAME_HEADER_SIZE];
+	uint16_t size = 0;
+	uint32_t fmt_address = (uint32_t)(uintptr_t)header->fmt;
+	uint32_t prefix_address = (uint32_t)(uintptr_t)header->prefix;
+	for (uint8_t i = 0; i < sizeof(uint32_t); i++)
+	{
+		payload[size + i] = (fmt_address >> (8 * i)) & 0xFF;
+		payload[size + sizeof(uint32_t) + i] = (prefix_address >> (8 * i)) & 0xFF;
+	}
+	size += 2 * sizeof(uint32_t);
+	for (uint8_t i = 0; i < LOGGER_FRAME_TIMESTAMP_SIZE; i++)
+	{
+		payload[size++] = (header->epoch_ms >> (8 * i)) & 0xFF;
+	}
+	payload[size++] = header->group;
+
+	/* arguments are already captured, format is only needed to check which one is string */
+	const char* fmt = header->fmt;
+	uint16_t idx = 0;
+	while (*fmt && idx < words)
+	{
+		if (*fmt++ != '%')
+		{
+			continue;
+		}
+		if (*fmt == '.' && *(fmt + 1))
+		{
+			fmt += 2;
+		}
+		uint8_t arg[LOGGER_STRING_ARG_MAX + 1];
+		uint8_t arg_size = 0;
+		switch (*fmt)
+		{
+		case 'c':
+		case 'd':
+		case 'i':
+		case 'u':
+		case 'x':
+		case 'X':
+			{
+				uint32_t value = args[idx++];
+				do
+				{
+					arg[arg_size++] = (value & 0x7F) | (value > 0x7F? 0x80 : 0x00);
+					value >>= 7;
+				} while (value);
+			}
+			break;
+		case 's':
+			arg[arg_size++] = args[idx];
+			memcpy(&arg[arg_size], &args[idx + 1], args[idx]);
+			arg_size += args[idx];
+			idx += 1 + (args[idx] + sizeof(uint32_t)) / sizeof(uint32_t);
+			break;
+		}
+		if (*fmt)
+		{
+			fmt++;
+		}
+		if (size + arg_size > LOGGER_FRAME_MAX_PAYLOAD)
+		{
+			/* the rest of arguments is dropped, decoder leaves them empty */
+			break;
+		}
+		memcpy(&payload[size], arg, arg_size);
+		size += arg_size;
+	}
+
+	uint8_t checksum = 0;
+	for (uint16_t i = 0; i < size; i++)
+	{
+		checksum += payload[i];
+	}
+	frame[0] = LOGGER_FRAME_SYNC;
+	frame[1] = size;
+	payload[size] = checksum;
+	return LOGGER_FRAME_SIZE(size);
+}
+
+uint8_t logger_is_sink_active(LogGroup group, uint8_t level)
+{
+	for (uint8_t i = 0; i < LOGGER_MAX_SINKS; i++)
+	{
+		if (LOGGER_SINKS[i].send != NULL && level <= LOGGER_SINKS[i].level && (LOGGER_SINKS[i].groups & ((uint32_t)1 << group)))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int logger_format_header(char* buf, uint16_t size, const TimeItem* time, LogGroup group, const char* prefix)
+{
+	if (time->year < 1000 || time->year > 9999)
+	{
+		return string_format_n(buf, size, "[%.2d-%.2d-%d %.2d:%.2d:%.2d:%.3d] - %s - %s:", time->day, time->month, time->year, time->hour, time->minute, time->second, time->msecond,
+		                       LOGGER_GROUPS[group].name, prefix);
+	}
+	char* start_buf = buf;
+	/* header is truncated like in string_format_n, the last byte is kept for NULL terminator */
+	const char* end = buf + size - 1;
+	uint16_t prefix_size = size - 1 < LOGGER_TIME_PREFIX_SIZE? size - 1 : LOGGER_TIME_PREFIX_SIZE;
+	/* cache is shared with logs from interrupts, which can preempt the update in direct mode */
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	logger_update_time_prefix(time);
+	memcpy(buf, logger_time_prefix.text, prefix_size);
+	__set_PRIMASK(primask);
+	buf += prefix_size;
+	buf = logger_append(buf, end, " - ");
+	buf = logger_append(buf, end, LOGGER_GROUPS[group].name);
+	buf = logger_append(buf, end, " - ");
+	buf = logger_append(buf, end, prefix);
+	buf = logger_append(buf, end, ":");
+	*buf = 0x00;
+	return (int)(buf - start_buf);
+}
+
+void logger_update_time_prefix(const TimeItem* time)
+{
+	LoggerTimePrefix* cache = &logger_time_prefix;
+	if (!cache->is_valid)
+	{
+		memcpy(cache->text, "[00-00-0000 00:00:00:000]", LOGGER_TIME_PREFIX_SIZE);
+	}
+	/* usually only milliseconds changed since the previous log */
+	if (!cache->is_valid || cache->time.msecond != time->msecond)
+	{
+		logger_put_digits(&cache->text[LOGGER_TIME_POS_MSECOND], time->msecond, 3);
+	}
+	if (!cache->is_valid || cache->time.second != time->second)
+	{
+		logger_put_digits(&cache->text[LOGGER_TIME_POS_SECOND], time->second, 2);
+	}
+	if (!cache->is_valid || cache->time.minute != time->minute)
+	{
+		logger_put_digits(&cache->text[LOGGER_TIME_POS_MINUTE], time->minute, 2);
+	}
+	if (!cache->is_valid || cache->time.hour != time->hour)
+	{
+		logger_put_digits(&cache->text[LOGGER_TIME_POS_HOUR], time->hour, 2);
+	}
+	if (!cache->is_valid || cache->time.day != time->day)
+	{
+		logger_put_digits(&cache->text[LOGGER_TIME_POS_DAY], time->day, 2);
+	}
+	if (!cache->is_valid || cache->time.month != time->month)
+	{
+		logger_put_digits(&cache->text[LOGGER_TIME_POS_MONTH], time->month, 2);
+	}
+	if (!cache->is_valid || cache->time.year != time->year)
+	{
+		logger_put_digits(&cache->text[LOGGER_TIME_POS_YEAR], time->year, 4);
+	}
+	cache->time = *time;
+	cache->is_valid = 1;
+}
+
+void logger_put_digits(char* buf, uint16_t value, uint8_t digits)
+{
+	/* fields are always printed with leading zeros, like "%.2d" */
+	while (digits--)
+	{
+		buf[digits] = '0' + (value % 10);
+		value /= 10;
+	}
+}
+
+char* logger_append(char* buf, const char* end, const char* str)
+{
+	while (*str && buf < end)
+	{
+		*buf++ = *str++;
+	}
+	return buf;
+}
+
+void logger_defer(uint8_t level, LogGroup group, const char* prefix, const char* fmt, va_list va)
+{
+	/* record is prepared on stack, so the critical section covers only the copy */
+	uint32_t record[LOGGER_RECORD_MAX_WORDS];
+	LoggerRecord header;
+	header.group = group;
+	header.level = level;
+	header.epoch_ms = time_get_epoch_ms();
+	header.prefix = prefix;
+	header.fmt = fmt;
+	header.words = LOGGER_RECORD_HEADER_WORDS + logger_capture_args(record + LOGGER_RECORD_HEADER_WORDS,
+	                                                                 LOGGER_RECORD_MAX_WORDS - LOGGER_RECORD_HEADER_WORDS, fmt, va);
+	memcpy(record, &header, sizeof(header));
+	if (logger_ring_write(record, header.words) != RETURN_OK)
+	{
+		logger_deferred.dropped++;
+	}
+}
+
+uint16_t logger_capture_args(uint32_t* args, uint16_t max_words, const char* fmt, va_list va)
+{
+	/* format is parsed the same way as in sf_format_string, but only arguments are stored */
+	uint16_t words = 0;
+	while (*fmt)
+	{
+		if (*fmt++ != '%')
+		{
+			continue;
+		}
+		if (*fmt == '.' && *(fmt + 1))
+		{
+			fmt += 2;
+		}
+		switch (*fmt)
+		{
+		case 'c':
+		case 'd':
+		case 'i':
+		case 'u':
+		case 'x':
+		case 'X':
+			if (words >= max_words)
+			{
+				return words;
+			}
+			args[words++] = va_arg(va, unsigned int);
+			break;
+		case 's':
+			{
+				const char* arg = va_arg(va, const char*);
+				uint16_t length = arg? strnlen(arg, LOGGER_STRING_ARG_MAX) : 0;
+				uint16_t str_words = 1 + (length + sizeof(uint32_t)) / sizeof(uint32_t);
+				if (words + str_words > max_words)
+				{
+					return words;
+				}
+				/* length is followed by characters with NULL terminator */
+				args[words] = length;
+				memcpy(&args[words + 1], arg? arg : "", length);
+				((char*)&args[words + 1])[length] = 0x00;
+				words += str_words;
+			}
+			break;
+		}
+		if (*fmt)
+		{
+			fmt++;
+		}
+	}
+	return words;
+}
+
+int logger_format_args(char* buf, uint16_t size, const char* fmt, const uint32_t* args, uint16_t words)
+{
+	/* every format specifier is formatted separately, so the output is the same as in direct mode */
+	char* start_buf = buf;
+	char* end = buf + size - 1;
+	char spec[LOGGER_SPEC_MAX + 1];
+	uint16_t idx = 0;
+	while (*fmt && buf < end)
+	{
+		if (*fmt != '%')
+		{
+			*buf++ = *fmt++;
+			continue;
+		}
+		uint8_t spec_len = 1;
+		if (*(fmt + 1) == '.' && *(fmt + 2))
+		{
+			spec_len += 2;
+		}
+		if (*(fmt + spec_len))
+		{
+			spec_len++;
+		}
+		memcpy(spec, fmt, spec_len);
+		spec[spec_len] = 0x00;
+		fmt += spec_len;
+		switch (spec[spec_len - 1])
+		{
+		case 'c':
+		case 'd':
+		case 'i':
+		case 'u':
+		case 'x':
+		case 'X':
+			if (idx < words)
+			{
+				buf += string_format_n(buf, end - buf + 1, spec, args[idx++]);
+			}
+			break;
+		case 's':
+			if (idx < words)
+			{
+				buf += string_format_n(buf, end - buf + 1, spec, (const char*)&args[idx + 1]);
+				idx += 1 + (args[idx] + sizeof(uint32_t)) / sizeof(uint32_t);
+			}
+			break;
+		case '%':
+			*buf++ = '%';
+			break;
+		}
+	}
+	*buf = 0x00;
+	return (int)(buf - start_buf);
+}
+
+RET_CODE logger_ring_write(const uint32_t* record, uint16_t words)
+{
+	RET_CODE result = RETURN_NOK;
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint16_t head = logger_deferred.head;
+	uint16_t tail = logger_deferred.tail;
+	uint16_t start = LOGGER_DEFERRED_BUFFER_WORDS;
+	/* head cannot reach tail, as equal indexes mean empty buffer */
+	if (head >= tail)
+	{
+		if (head + words < LOGGER_DEFERRED_BUFFER_WORDS || (head + words == LOGGER_DEFERRED_BUFFER_WORDS && tail > 0))
+		{
+			start = head;
+		}
+		else if (words < tail)
+		{
+			/* record does not fit at the end, mark end as unused and start from beginning */
+			logger_deferred.ring[head] = 0;
+			start = 0;
+		}
+	}
+	else if (head + words < tail)
+	{
+		start = head;
+	}
+	if (start < LOGGER_DEFERRED_BUFFER_WORDS)
+	{
+		memcpy(&logger_deferred.ring[start], record, words * sizeof(uint32_t));
+		LOGGER_BARRIER();
+		logger_deferred.head = (start + words) % LOGGER_DEFERRED_BUFFER_WORDS;
+		result = RETURN_OK;
+	}
+	__set_PRIMASK(primask);
+	return result;
+}
+
+RET_CODE logger_ring_read(uint32_t* record)
 {
-	if (cond_bool != 0 && logger.is_enabled && group < LOG_ENUM_MAX)
+	RET_CODE result = RETURN_NOK;
+	uint16_t tail = logger_deferred.tail;
+	if (tail != logger_deferred.head)
 	{
-		if (LOGGER_GROUPS[group].state == LOGGER_GROUP_ENABLE)
+		LOGGER_BARRIER();
+		if (logger_deferred.ring[tail] == 0)
 		{
-			int length = 0;
-			va_list va;
-			va_start(va, fmt);
-			va_end(va);
+			tail = 0;
+		}
+		uint16_t words = logger_deferred.ring[tail];
+		memcpy(record, &logger_deferred.ring[tail], words * sizeof(uint32_t));
+		LOGGER_BARRIER();
+		logger_deferred.tail = (tail + words) % LOGGER_DEFERRED_BUFFER_WORDS;
+		result = RETURN_OK;
+	}
+	return result;
+}
+
+void logger_update_active_groups()
+{
+	uint32_t mask = 0;
+	if (logger.is_enabled)
+	{
+		for (uint8_t i = 0; i < LOG_ENUM_MAX; i++)
+		{
+			if (LOGGER_GROUPS[i].state == LOGGER_GROUP_ENABLE)
 			{
-				TimeItem* time = time_get();
-				int offset = string_format(logger.buffer, "[%.2d-%.2d-%d %.2d:%.2d:%.2d:%.3d] - %s - %s:", time->day, time->month, time->year, time->hour, time->minute, time->second, time->msecond,
-				      LOGGER_GROUPS[group].name, prefix);
-				va_start(va, fmt);
-				length = sf_format_string(logger.buffer+offset, fmt, va);
-				va_end(va);
-				logger.buffer[offset + length++] = '\n';
-				logger.buffer[offset + length] = 0x00;
-				logger_notify_data(logger.buffer);
+				mask |= (uint32_t)1 << i;
 			}
 		}
 	}
+	logger_active_groups = mask;
 }
 
 const char* logger_group_to_string(LogGroup group)
@@ -238,3 +1073,188 @@ LogGroup logger_string_to_group(const char* name)
    }
    return result;
 }
+
+uint8_t logger_rate_check(uint8_t level, LogGroup group, const char* prefix, const char* fmt, va_list va)
+{
+	if (!logger_rate.burst)
+	{
+		return 1;
+	}
+	uint8_t result = 1;
+	uint32_t repeated = 0;
+	uint32_t suppressed = 0;
+	uint32_t hash = logger_hash_args(fmt, va);
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint32_t now = logger_rate.now_ms;
+	LoggerRateSite* site = logger_rate_get_site(fmt, now);
+	if (site)
+	{
+		uint32_t max_tokens = (uint32_t)logger_rate.burst * LOGGER_RATE_TOKEN;
+		uint64_t tokens = site->tokens + (uint64_t)(now - site->last_ms) * logger_rate.rate;
+		site->tokens = tokens > max_tokens? max_tokens : (uint32_t)tokens;
+		site->last_ms = now;
+		site->group = group;
+		site->level = level;
+		site->prefix = prefix;
+		uint8_t is_pending = site->repeated || site->suppressed;
+
+		if (hash == site->args_hash && (site->repeated || now - site->sent_ms < LOGGER_RATE_REPORT_MS))
+		{
+			/* the same message again, only counted */
+			site->repeated++;
+			result = 0;
+		}
+		else if (site->tokens >= LOGGER_RATE_TOKEN)
+		{
+			site->tokens -= LOGGER_RATE_TOKEN;
+			site->args_hash = hash;
+			site->sent_ms = now;
+			repeated = site->repeated;
+			suppressed = site->suppressed;
+			site->repeated = 0;
+			site->suppressed = 0;
+		}
+		else
+		{
+			site->suppressed++;
+			result = 0;
+		}
+		if (!result && !is_pending)
+		{
+			site->report_ms = now;
+		}
+	}
+	__set_PRIMASK(primask);
+
+	/* counts of previous messages are reported before the new one */
+	logger_rate_report(level, group, prefix, repeated, suppressed);
+	return result;
+}
+
+LoggerRateSite* logger_rate_get_site(const char* fmt, uint32_t now)
+{
+	LoggerRateSite* result = NULL;
+	for (uint8_t i = 0; i < LOGGER_RATE_SITES; i++)
+	{
+		LoggerRateSite* site = &logger_rate.sites[i];
+		if (site->fmt == fmt)
+		{
+			return site;
+		}
+		if (!site->fmt)
+		{
+			/* free site is preferred */
+			result = (!result || result->fmt)? site : result;
+		}
+		else if (!site->repeated && !site->suppressed && (!result || (result->fmt && now - site->last_ms > now - result->last_ms)))
+		{
+			/* site with pending counts is not replaced, the counts would be lost */
+			result = site;
+		}
+	}
+	if (result)
+	{
+		memset(result, 0, sizeof(LoggerRateSite));
+		result->fmt = fmt;
+		result->tokens = (uint32_t)logger_rate.burst * LOGGER_RATE_TOKEN;
+		result->last_ms = now;
+		/* first log is never treated as repeated */
+		result->sent_ms = now - LOGGER_RATE_REPORT_MS;
+	}
+	return result;
+}
+
+void logger_rate_report(uint8_t level, LogGroup group, const char* prefix, uint32_t repeated, uint32_t suppressed)
+{
+	if (repeated)
+	{
+		logger_emit(level, group, prefix, LOGGER_REPEATED_FMT, repeated);
+	}
+	if (suppressed)
+	{
+		logger_emit(level, group, prefix, LOGGER_SUPPRESSED_FMT, suppressed);
+	}
+}
+
+void logger_rate_flush(uint8_t force)
+{
+	for (uint8_t i = 0; i < LOGGER_RATE_SITES; i++)
+	{
+		LoggerRateSite* site = &logger_rate.sites[i];
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		uint32_t repeated = site->repeated;
+		uint32_t suppressed = site->suppressed;
+		uint8_t is_due = force || logger_rate.now_ms - site->report_ms >= LOGGER_RATE_REPORT_MS;
+		if (is_due)
+		{
+			site->repeated = 0;
+			site->suppressed = 0;
+			site->report_ms = logger_rate.now_ms;
+		}
+		__set_PRIMASK(primask);
+		if (is_due && site->fmt && logger.is_enabled && LOGGER_GROUPS[site->group].state == LOGGER_GROUP_ENABLE)
+		{
+			logger_rate_report(site->level, site->group, site->prefix, repeated, suppressed);
+		}
+	}
+}
+
+uint32_t logger_hash_args(const char* fmt, va_list va)
+{
+	/* format is parsed the same way as in logger_capture_args */
+	uint32_t hash = LOGGER_HASH_INIT;
+	va_list args;
+	va_copy(args, va);
+	while (*fmt)
+	{
+		if (*fmt++ != '%')
+		{
+			continue;
+		}
+		if (*fmt == '.' && *(fmt + 1))
+		{
+			fmt += 2;
+		}
+		switch (*fmt)
+		{
+		case 'c':
+		case 'd':
+		case 'i':
+		case 'u':
+		case 'x':
+		case 'X':
+			{
+				unsigned int value = va_arg(args, unsigned int);
+				for (uint8_t i = 0; i < sizeof(value); i++)
+				{
+					hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * LOGGER_HASH_PRIME;
+				}
+			}
+			break;
+		case 's':
+			{
+				const char* arg = va_arg(args, const char*);
+				while (arg && *arg)
+				{
+					hash = (hash ^ (uint8_t)*arg++) * LOGGER_HASH_PRIME;
+				}
+				hash = (hash ^ 0x00) * LOGGER_HASH_PRIME;
+			}
+			break;
+		}
+		if (*fmt)
+		{
+			fmt++;
+		}
+	}
+	va_end(args);
+	return hash;
+}
+
+void logger_on_time_change(TimeItem* item)
+{
+	/* called from TIME module interrupt */
+	logger_rate.now_ms += logger_rate.tick_ms;
+}
@@ -0,0 +1,111 @@
+/* =============================
+ *   Includes of common headers
+ * =============================*/
+#include <string.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "logger_crashlog.h"
+#include "core_cmFunc.h"
+/* =============================
+ *          Defines
+ * =============================*/
+#define LOGGER_CRASHLOG_MAGIC 0x4C4F4743
+/* =============================
+ *   Internal module functions
+ * =============================*/
+uint8_t logger_crashlog_is_valid();
+void logger_crashlog_append(const char* data, uint16_t size);
+/* =============================
+ *       Internal types
+ * =============================*/
+typedef struct LoggerCrashlog
+{
+   uint32_t magic;         /**< LOGGER_CRASHLOG_MAGIC when content is valid */
+   uint32_t check;         /**< Inverted magic, random RAM content after power up is not taken as valid */
+   uint16_t head;          /**< Position of next byte */
+   uint16_t count;         /**< Number of stored bytes */
+   char data[LOGGER_CRASHLOG_SIZE];
+} LoggerCrashlog;
+/* =============================
+ *      Module variables
+ * =============================*/
+/* not cleared by startup code, so the content survives reset */
+LoggerCrashlog logger_crashlog __attribute__((section(".noinit")));
+
+
+void logger_crashlog_init()
+{
+	if (!logger_crashlog_is_valid())
+	{
+		logger_crashlog_clear();
+	}
+	logger_crashlog_write(LOGGER_CRASHLOG_RESET_MARKER);
+}
+
+RET_CODE logger_crashlog_write(const char* data)
+{
+	uint16_t size = strlen(data);
+	if (size > LOGGER_CRASHLOG_SIZE)
+	{
+		/* only the end of line fits */
+		data += size - LOGGER_CRASHLOG_SIZE;
+		size = LOGGER_CRASHLOG_SIZE;
+	}
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	logger_crashlog_append(data, size);
+	__set_PRIMASK(primask);
+	return RETURN_OK;
+}
+
+uint16_t logger_crashlog_read(char* buf, uint16_t offset, uint16_t size)
+{
+	uint16_t result = 0;
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if (offset < logger_crashlog.count)
+	{
+		uint16_t start = (logger_crashlog.head + LOGGER_CRASHLOG_SIZE - logger_crashlog.count + offset) % LOGGER_CRASHLOG_SIZE;
+		result = logger_crashlog.count - offset;
+		result = result > size? size : result;
+		uint16_t first = LOGGER_CRASHLOG_SIZE - start;
+		first = first > result? result : first;
+		memcpy(buf, &logger_crashlog.data[start], first);
+		memcpy(buf + first, logger_crashlog.data, result - first);
+	}
+	__set_PRIMASK(primask);
+	return result;
+}
+
+uint16_t logger_crashlog_size()
+{
+	return logger_crashlog.count;
+}
+
+void logger_crashlog_clear()
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	logger_crashlog.head = 0;
+	logger_crashlog.count = 0;
+	logger_crashlog.magic = LOGGER_CRASHLOG_MAGIC;
+	logger_crashlog.check = ~LOGGER_CRASHLOG_MAGIC;
+	__set_PRIMASK(primask);
+}
+
+uint8_t logger_crashlog_is_valid()
+{
+	return logger_crashlog.magic == LOGGER_CRASHLOG_MAGIC && logger_crashlog.check == (uint32_t)~LOGGER_CRASHLOG_MAGIC &&
+	       logger_crashlog.head < LOGGER_CRASHLOG_SIZE && logger_crashlog.count <= LOGGER_CRASHLOG_SIZE;
+}
+
+void logger_crashlog_append(const char* data, uint16_t size)
+{
+	uint16_t first = LOGGER_CRASHLOG_SIZE - logger_crashlog.head;
+	first = first > size? size : first;
+	memcpy(&logger_crashlog.data[logger_crashlog.head], data, first);
+	memcpy(logger_crashlog.data, data + first, size - first);
+	logger_crashlog.head = (logger_crashlog.head + size) % LOGGER_CRASHLOG_SIZE;
+	logger_crashlog.count = (logger_crashlog.count + size > LOGGER_CRASHLOG_SIZE)? LOGGER_CRASHLOG_SIZE : logger_crashlog.count + size;
+}
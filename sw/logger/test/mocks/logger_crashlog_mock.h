@@ -0,0 +1,53 @@
+#ifndef _LOGGER_CRASHLOG_MOCK_H_
+#define _LOGGER_CRASHLOG_MOCK_H_
+
+#include "logger_crashlog.h"
+#include "gmock/gmock.h"
+
+struct loggerCrashlogMock
+{
+	MOCK_METHOD0(logger_crashlog_init, void());
+	MOCK_METHOD1(logger_crashlog_write, RET_CODE(const char*));
+	MOCK_METHOD3(logger_crashlog_read, uint16_t(char*, uint16_t, uint16_t));
+	MOCK_METHOD0(logger_crashlog_size, uint16_t());
+	MOCK_METHOD0(logger_crashlog_clear, void());
+};
+
+::testing::NiceMock<loggerCrashlogMock>* crashlog_mock;
+
+void mock_crashlog_init()
+{
+	crashlog_mock = new ::testing::NiceMock<loggerCrashlogMock>;
+}
+
+void mock_crashlog_deinit()
+{
+	delete crashlog_mock;
+}
+
+void logger_crashlog_init()
+{
+	crashlog_mock->logger_crashlog_init();
+}
+
+RET_CODE logger_crashlog_write(const char* data)
+{
+	return crashlog_mock->logger_crashlog_write(data);
+}
+
+uint16_t logger_crashlog_read(char* buf, uint16_t offset, uint16_t size)
+{
+	return crashlog_mock->logger_crashlog_read(buf, offset, size);
+}
+
+uint16_t logger_crashlog_size()
+{
+	return crashlog_mock->logger_crashlog_size();
+}
+
+void logger_crashlog_clear()
+{
+	crashlog_mock->logger_crashlog_clear();
+}
+
+#endif
@@ -31,6 +31,9 @@ LOG_GROUP LOGGER_GROUPS[LOG_ENUM_MAX] = {
       {LOGGER_GROUP_ENABLE, LOG_NTF, "NTF"},
       {LOGGER_GROUP_ENABLE, LOG_SIM, "SIM"}};
 
+/* all groups active, so the logs from macro front-ends reach the mock */
+volatile uint32_t logger_active_groups = 0xFFFFFFFF;
+
 struct loggerMock
 {
 	MOCK_METHOD1(logger_initialize, RET_CODE(uint16_t));
@@ -42,6 +45,17 @@ struct loggerMock
 	MOCK_METHOD1(logger_get_group_state, uint8_t(LogGroup));
 	MOCK_METHOD1(logger_send, void(LogGroup));
 	MOCK_METHOD2(logger_send_if, void(uint8_t, LogGroup));
+	MOCK_METHOD1(logger_set_deferred, RET_CODE(uint8_t));
+	MOCK_METHOD0(logger_get_dropped_count, uint32_t());
+	MOCK_METHOD2(logger_set_rate_limit, RET_CODE(uint16_t, uint16_t));
+	MOCK_METHOD2(logger_get_rate_limit, void(uint16_t*, uint16_t*));
+	MOCK_METHOD1(logger_set_binary_sender, RET_CODE(RET_CODE(*)(const uint8_t*, uint16_t)));
+	MOCK_METHOD0(logger_watcher, void());
+	MOCK_METHOD1(logger_add_sink, LOGGER_SINK(const LoggerSinkConfig*));
+	MOCK_METHOD1(logger_remove_sink, RET_CODE(LOGGER_SINK));
+	MOCK_METHOD3(logger_set_sink_filter, RET_CODE(LOGGER_SINK, uint32_t, uint8_t));
+	MOCK_METHOD3(logger_get_sink_filter, RET_CODE(LOGGER_SINK, uint32_t*, uint8_t*));
+	MOCK_METHOD1(logger_get_sink_dropped, uint32_t(LOGGER_SINK));
 };
 
 ::testing::NiceMock<loggerMock>* logger_mock;
@@ -89,22 +103,32 @@ uint8_t logger_get_group_state(LogGroup group)
 	return logger_mock->logger_get_group_state(group);
 }
 
+void mock_logger_print(LogGroup group, const char* prefix, const char* fmt, va_list va)
+{
+	char buf[1024];
+	int offset = string_format(buf, "[0-0-0 0:0:0:0] - %s - %s:", logger_group_to_string(group), prefix);
+	int length = sf_format_string(buf+offset, fmt, va);
+	buf[offset + length++] = '\n';
+	buf[offset + length] = 0x00;
+	printf("%s", buf);
+}
+
 void logger_send(LogGroup group, const char* prefix, const char* fmt, ...)
 {
-	int length = 0;
 	va_list va;
 	va_start(va, fmt);
+	mock_logger_print(group, prefix, fmt, va);
+	va_end(va);
+	logger_mock->logger_send(group);
+}
+
+/* logs from macro front-ends are expected as logger_send */
+void logger_send_level(uint8_t level, LogGroup group, const char* prefix, const char* fmt, ...)
+{
+	va_list va;
+	va_start(va, fmt);
+	mock_logger_print(group, prefix, fmt, va);
 	va_end(va);
-	{
-		char buf[1024];
-		int offset = string_format(buf, "[0-0-0 0:0:0:0] - %s - %s:", logger_group_to_string(group), prefix);
-		va_start(va, fmt);
-		length = sf_format_string(buf+offset, fmt, va);
-		va_end(va);
-		buf[offset + length++] = '\n';
-		buf[offset + length] = 0x00;
-		printf("%s", buf);
-	}
 	logger_mock->logger_send(group);
 }
 
@@ -113,6 +137,61 @@ void logger_send_if(uint8_t cond_bool, LogGroup group, const char* prefix, const
 	logger_mock->logger_send_if(cond_bool, group);
 }
 
+RET_CODE logger_set_deferred(uint8_t state)
+{
+	return logger_mock->logger_set_deferred(state);
+}
+
+uint32_t logger_get_dropped_count()
+{
+	return logger_mock->logger_get_dropped_count();
+}
+
+RET_CODE logger_set_rate_limit(uint16_t burst, uint16_t rate)
+{
+	return logger_mock->logger_set_rate_limit(burst, rate);
+}
+
+void logger_get_rate_limit(uint16_t* burst, uint16_t* rate)
+{
+	logger_mock->logger_get_rate_limit(burst, rate);
+}
+
+RET_CODE logger_set_binary_sender(RET_CODE(*send_fnc)(const uint8_t*, uint16_t))
+{
+	return logger_mock->logger_set_binary_sender(send_fnc);
+}
+
+void logger_watcher()
+{
+	logger_mock->logger_watcher();
+}
+
+LOGGER_SINK logger_add_sink(const LoggerSinkConfig* config)
+{
+	return logger_mock->logger_add_sink(config);
+}
+
+RET_CODE logger_remove_sink(LOGGER_SINK sink)
+{
+	return logger_mock->logger_remove_sink(sink);
+}
+
+RET_CODE logger_set_sink_filter(LOGGER_SINK sink, uint32_t groups, uint8_t level)
+{
+	return logger_mock->logger_set_sink_filter(sink, groups, level);
+}
+
+RET_CODE logger_get_sink_filter(LOGGER_SINK sink, uint32_t* groups, uint8_t* level)
+{
+	return logger_mock->logger_get_sink_filter(sink, groups, level);
+}
+
+uint32_t logger_get_sink_dropped(LOGGER_SINK sink)
+{
+	return logger_mock->logger_get_sink_dropped(sink);
+}
+
 const char* logger_group_to_string(LogGroup group)
 {
    const char* result;
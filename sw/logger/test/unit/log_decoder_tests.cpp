@@ -0,0 +1,223 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdio>
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../tools/source/log_decoder.c"
+#ifdef __cplusplus
+}
+#endif
+
+/* ============================= */
+/**
+ * @file log_decoder_tests.cpp
+ *
+ * @brief Unit tests of log decoder tool
+ *
+ * @details
+ * This tests verifies decoding of binary log frames
+ */
+/* ============================= */
+
+using namespace ::testing;
+
+/* 01.02.2020 11:12:13:400 */
+const uint64_t TEST_EPOCH_MS = 633870733400ULL;
+const uint32_t TEST_FMT_ADDRESS = 0x08001000;
+const uint32_t TEST_PREFIX_ADDRESS = 0x08001100;
+
+const char* fake_lookup(uint32_t address, void* ctx)
+{
+	std::map<uint32_t, std::string>* strings = (std::map<uint32_t, std::string>*) ctx;
+	auto it = strings->find(address);
+	return it != strings->end()? it->second.c_str() : NULL;
+}
+
+struct logDecoderFixture : public ::testing::Test
+{
+	virtual void SetUp()
+	{
+		strings.clear();
+		strings[TEST_PREFIX_ADDRESS] = "FILE";
+	}
+
+	virtual void TearDown()
+	{
+	}
+
+	std::vector<uint8_t> build_frame(uint32_t fmt_address, uint8_t group, const std::vector<uint8_t>& args)
+	{
+		std::vector<uint8_t> payload;
+		for (uint8_t i = 0; i < 4; i++)
+		{
+			payload.push_back(fmt_address >> (8 * i));
+		}
+		for (uint8_t i = 0; i < 4; i++)
+		{
+			payload.push_back(TEST_PREFIX_ADDRESS >> (8 * i));
+		}
+		for (uint8_t i = 0; i < LOGGER_FRAME_TIMESTAMP_SIZE; i++)
+		{
+			payload.push_back(TEST_EPOCH_MS >> (8 * i));
+		}
+		payload.push_back(group);
+		payload.insert(payload.end(), args.begin(), args.end());
+
+		std::vector<uint8_t> frame = {LOGGER_FRAME_SYNC, (uint8_t)payload.size()};
+		frame.insert(frame.end(), payload.begin(), payload.end());
+		uint8_t checksum = 0;
+		for (uint8_t byte : payload)
+		{
+			checksum += byte;
+		}
+		frame.push_back(checksum);
+		return frame;
+	}
+
+	std::string decode(const std::vector<uint8_t>& frame)
+	{
+		char line[LOG_DECODER_LINE_SIZE];
+		int length = log_decoder_decode(line, frame.data(), &fake_lookup, &strings);
+		EXPECT_EQ(strlen(line), (size_t)length);
+		return line;
+	}
+
+	std::map<uint32_t, std::string> strings;
+};
+
+/**
+ * @test Frame validation
+ */
+TEST_F(logDecoderFixture, check_frame_test)
+{
+	std::vector<uint8_t> frame = build_frame(TEST_FMT_ADDRESS, LOG_ERROR, {0x01});
+
+	/**
+	 * <b>scenario</b>: Frame received byte by byte.<br>
+	 * <b>expected</b>: Frame incomplete until the checksum is received.<br>
+	 * ************************************************
+	 */
+	for (size_t i = 0; i < frame.size(); i++)
+	{
+		EXPECT_EQ(LOG_DECODER_FRAME_INCOMPLETE, log_decoder_check_frame(frame.data(), i));
+	}
+	EXPECT_EQ(LOG_DECODER_FRAME_OK, log_decoder_check_frame(frame.data(), frame.size()));
+
+	/**
+	 * <b>scenario</b>: Checksum mismatch.<br>
+	 * <b>expected</b>: Frame invalid.<br>
+	 * ************************************************
+	 */
+	frame[5]++;
+	EXPECT_EQ(LOG_DECODER_FRAME_INVALID, log_decoder_check_frame(frame.data(), frame.size()));
+
+	/**
+	 * <b>scenario</b>: Text instead of frame, payload shorter than fixed part.<br>
+	 * <b>expected</b>: Frame invalid.<br>
+	 * ************************************************
+	 */
+	const uint8_t text[] = "text";
+	EXPECT_EQ(LOG_DECODER_FRAME_INVALID, log_decoder_check_frame(text, sizeof(text)));
+	const uint8_t short_frame[] = {LOGGER_FRAME_SYNC, LOGGER_FRAME_FIXED_PAYLOAD - 1};
+	EXPECT_EQ(LOG_DECODER_FRAME_INVALID, log_decoder_check_frame(short_frame, sizeof(short_frame)));
+}
+
+/**
+ * @test Frame decoding
+ */
+TEST_F(logDecoderFixture, decode_test)
+{
+	strings[TEST_FMT_ADDRESS] = "v %u %s %d %.3u %c%% %X";
+
+	/**
+	 * <b>scenario</b>: Frame with all argument types.<br>
+	 * <b>expected</b>: Log line the same as formatted on target.<br>
+	 * ************************************************
+	 */
+	std::vector<uint8_t> frame = build_frame(TEST_FMT_ADDRESS, LOG_DEBUG,
+	                                         {0xAC, 0x02, 0x02, 'a', 'b', 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0x07, 'X', 0xAB, 0x01});
+	EXPECT_EQ("[01-02-2020 11:12:13:400] - DEBUG - FILE:v 300 ab -1 007 X% AB\n", decode(frame));
+
+	/**
+	 * <b>scenario</b>: Arguments dropped on target.<br>
+	 * <b>expected</b>: Missing arguments left empty.<br>
+	 * ************************************************
+	 */
+	frame = build_frame(TEST_FMT_ADDRESS, LOG_DEBUG, {0xAC, 0x02, 0x05, 'a'});
+	EXPECT_EQ("[01-02-2020 11:12:13:400] - DEBUG - FILE:v 300    % \n", decode(frame));
+
+	/**
+	 * <b>scenario</b>: Format not found in firmware, unknown group.<br>
+	 * <b>expected</b>: Address of format printed.<br>
+	 * ************************************************
+	 */
+	frame = build_frame(0x0800ABCD, LOG_ENUM_MAX, {});
+	EXPECT_EQ("[01-02-2020 11:12:13:400] - ? - FILE:<unknown format 0x800ABCD>\n", decode(frame));
+}
+
+/**
+ * @test Reading strings from ELF file
+ */
+TEST_F(logDecoderFixture, elf_lookup_test)
+{
+	const char RODATA[] = "first\0second";
+	struct
+	{
+		Elf32_Ehdr header;
+		Elf32_Shdr sections[2];
+		char rodata[sizeof(RODATA)];
+	} image = {};
+	memcpy(image.header.e_ident, ELFMAG, SELFMAG);
+	image.header.e_ident[EI_CLASS] = ELFCLASS32;
+	image.header.e_ident[EI_DATA] = ELFDATA2LSB;
+	image.header.e_shoff = offsetof(decltype(image), sections);
+	image.header.e_shnum = 2;
+	image.sections[1].sh_type = SHT_PROGBITS;
+	image.sections[1].sh_flags = SHF_ALLOC;
+	image.sections[1].sh_addr = TEST_FMT_ADDRESS;
+	image.sections[1].sh_offset = offsetof(decltype(image), rodata);
+	image.sections[1].sh_size = sizeof(RODATA);
+	memcpy(image.rodata, RODATA, sizeof(RODATA));
+
+	const char* path = "log_decoder_test.elf";
+	FILE* file = fopen(path, "wb");
+	ASSERT_NE(nullptr, file);
+	fwrite(&image, sizeof(image), 1, file);
+	fclose(file);
+
+	/**
+	 * <b>scenario</b>: ELF file loaded, strings read from allocated section.<br>
+	 * <b>expected</b>: Strings found by address.<br>
+	 * ************************************************
+	 */
+	LogDecoderElf elf;
+	ASSERT_EQ(RETURN_OK, log_decoder_load_elf(&elf, path));
+	EXPECT_STREQ("first", log_decoder_elf_lookup(TEST_FMT_ADDRESS, &elf));
+	EXPECT_STREQ("second", log_decoder_elf_lookup(TEST_FMT_ADDRESS + 6, &elf));
+	EXPECT_STREQ("irst", log_decoder_elf_lookup(TEST_FMT_ADDRESS + 1, &elf));
+
+	/**
+	 * <b>scenario</b>: Address outside of sections.<br>
+	 * <b>expected</b>: NULL returned.<br>
+	 * ************************************************
+	 */
+	EXPECT_EQ(NULL, log_decoder_elf_lookup(TEST_FMT_ADDRESS + sizeof(RODATA), &elf));
+	EXPECT_EQ(NULL, log_decoder_elf_lookup(0, &elf));
+	log_decoder_free_elf(&elf);
+
+	/**
+	 * <b>scenario</b>: Not an ELF file.<br>
+	 * <b>expected</b>: RETURN_NOK returned.<br>
+	 * ************************************************
+	 */
+	image.header.e_ident[0] = 0;
+	file = fopen(path, "wb");
+	fwrite(&image, sizeof(image), 1, file);
+	fclose(file);
+	EXPECT_EQ(RETURN_NOK, log_decoder_load_elf(&elf, path));
+	remove(path);
+}
@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <string>
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../source/logger_crashlog.c"
+#ifdef __cplusplus
+}
+#endif
+
+/* ============================= */
+/**
+ * @file logger_crashlog_tests.cpp
+ *
+ * @brief Unit tests of crash log
+ *
+ * @details
+ * This tests verifies behavior of RAM log kept across reset
+ */
+/* ============================= */
+
+using namespace ::testing;
+
+struct loggerCrashlogFixture : public ::testing::Test
+{
+	virtual void SetUp()
+	{
+		/* random RAM content after power up */
+		memset(&logger_crashlog, 0xA5, sizeof(logger_crashlog));
+	}
+
+	virtual void TearDown()
+	{
+	}
+
+	std::string read_all()
+	{
+		std::string result;
+		char buf[100];
+		uint16_t size;
+		while ((size = logger_crashlog_read(buf, result.size(), sizeof(buf))) > 0)
+		{
+			result.append(buf, size);
+		}
+		return result;
+	}
+};
+
+/**
+ * @test Crash log initialization
+ */
+TEST_F(loggerCrashlogFixture, init_tests)
+{
+	/**
+	 * <b>scenario</b>: Init after power up.<br>
+	 * <b>expected</b>: Random content cleared, only reset marker stored.<br>
+	 * ************************************************
+	 */
+	logger_crashlog_init();
+	EXPECT_EQ(LOGGER_CRASHLOG_RESET_MARKER, read_all());
+
+	/**
+	 * <b>scenario</b>: Lines written, then init after reset.<br>
+	 * <b>expected</b>: Lines kept, new reset marker added.<br>
+	 * ************************************************
+	 */
+	EXPECT_EQ(RETURN_OK, logger_crashlog_write("line 1\n"));
+	EXPECT_EQ(RETURN_OK, logger_crashlog_write("line 2\n"));
+	logger_crashlog_init();
+	EXPECT_EQ(std::string(LOGGER_CRASHLOG_RESET_MARKER) + "line 1\nline 2\n" + LOGGER_CRASHLOG_RESET_MARKER, read_all());
+
+	/**
+	 * <b>scenario</b>: Indexes corrupted, then init.<br>
+	 * <b>expected</b>: Content cleared.<br>
+	 * ************************************************
+	 */
+	logger_crashlog.head = LOGGER_CRASHLOG_SIZE;
+	logger_crashlog_init();
+	EXPECT_EQ(LOGGER_CRASHLOG_RESET_MARKER, read_all());
+
+	/**
+	 * <b>scenario</b>: Crash log cleared.<br>
+	 * <b>expected</b>: Nothing to read.<br>
+	 * ************************************************
+	 */
+	logger_crashlog_clear();
+	EXPECT_EQ(0, logger_crashlog_size());
+	EXPECT_EQ("", read_all());
+}
+
+/**
+ * @test Crash log overflow
+ */
+TEST_F(loggerCrashlogFixture, overflow_tests)
+{
+	logger_crashlog_init();
+	logger_crashlog_clear();
+
+	/**
+	 * <b>scenario</b>: More data written than crash log size.<br>
+	 * <b>expected</b>: The oldest bytes overwritten, the newest kept in order.<br>
+	 * ************************************************
+	 */
+	std::string written;
+	for (uint16_t i = 0; written.size() < 2 * LOGGER_CRASHLOG_SIZE; i++)
+	{
+		std::string line = "log " + std::to_string(i) + "\n";
+		EXPECT_EQ(RETURN_OK, logger_crashlog_write(line.c_str()));
+		written += line;
+	}
+	EXPECT_EQ(LOGGER_CRASHLOG_SIZE, logger_crashlog_size());
+	EXPECT_EQ(written.substr(written.size() - LOGGER_CRASHLOG_SIZE), read_all());
+
+	/**
+	 * <b>scenario</b>: Read with offset after the end.<br>
+	 * <b>expected</b>: Nothing read.<br>
+	 * ************************************************
+	 */
+	char buf[10];
+	EXPECT_EQ(0, logger_crashlog_read(buf, LOGGER_CRASHLOG_SIZE, sizeof(buf)));
+
+	/**
+	 * <b>scenario</b>: Line longer than crash log written.<br>
+	 * <b>expected</b>: Only the end of line kept.<br>
+	 * ************************************************
+	 */
+	std::string line(LOGGER_CRASHLOG_SIZE + 10, 'a');
+	line.back() = '\n';
+	EXPECT_EQ(RETURN_OK, logger_crashlog_write(line.c_str()));
+	EXPECT_EQ(line.substr(10), read_all());
+}
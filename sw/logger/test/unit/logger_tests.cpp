@@ -30,6 +30,7 @@ using namespace ::testing;
 struct callbackMock
 {
 	MOCK_METHOD1(callback, RET_CODE(const char*));
+	MOCK_METHOD1(sink_callback, RET_CODE(const char*));
 };
 
 callbackMock* callMock;
@@ -39,6 +40,11 @@ RET_CODE fake_callback(const char* data)
 	return callMock->callback(data);
 }
 
+RET_CODE fake_sink_callback(const char* data)
+{
+	return callMock->sink_callback(data);
+}
+
 struct loggerFixture : public ::testing::Test
 {
 	const uint16_t  LOGGER_BUFFER_SIZE = 512;
@@ -330,12 +336,14 @@ TEST_F(loggerFixture, setting_getting_group_states)
 TEST_F(loggerFixture, sender_add_remove_tests)
 {
 	/**
-	 * <b>scenario</b>: Register three sender functions<br>
-	 * <b>expected</b>: 2x RETURN_OK, 1x RETURN_NOK returned.<br>
+	 * <b>scenario</b>: Register more sender functions than sinks available<br>
+	 * <b>expected</b>: RETURN_OK for every sink, then RETURN_NOK returned.<br>
     * ************************************************
 	 */
-	EXPECT_EQ(RETURN_OK, logger_register_sender(&fake_callback));
-	EXPECT_EQ(RETURN_OK, logger_register_sender(&fake_callback));
+	for (uint8_t i = 0; i < LOGGER_MAX_SINKS; i++)
+	{
+		EXPECT_EQ(RETURN_OK, logger_register_sender(&fake_callback));
+	}
 	EXPECT_EQ(RETURN_NOK, logger_register_sender(&fake_callback));
 
 	/**
@@ -397,3 +405,611 @@ TEST_F(loggerFixture, string_to_group_conversion_tests)
     */
    EXPECT_EQ(LOG_DEBUG, logger_string_to_group("DEBUG"));
 }
+
+/**
+ * @test Sending deferred logs
+ */
+TEST_F(loggerFixture, deferred_log_tests)
+{
+	EXPECT_EQ(RETURN_OK, logger_enable());
+	EXPECT_EQ(RETURN_OK, logger_set_group_state(LOG_DEBUG, 1));
+	EXPECT_EQ(RETURN_OK, logger_register_sender(&fake_callback));
+	EXPECT_EQ(RETURN_OK, logger_set_deferred(1));
+	TimeItem t1 = {};
+	t1.day = 1; t1.month = 2, t1.year = 2020, t1.hour = 11, t1.minute = 12, t1.second = 13, t1.msecond = 400;
+	char name [] = "abc";
+
+	/**
+	 * <b>scenario</b>: Send debug strings in deferred mode.<br>
+	 * <b>expected</b>: Only timestamp read, callback not called.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*time_cnt_mock, time_get()).Times(0);
+	EXPECT_CALL(*time_cnt_mock, time_get_epoch_ms()).WillOnce(Return(1000)).WillOnce(Return(2000));
+	EXPECT_CALL(*callMock, callback(_)).Times(0);
+	logger_send(LOG_DEBUG, "FILE", "value %d %s %.3u %c%%", -5, name, 7, 'X');
+	logger_send_if(1==1, LOG_ERROR, "FILE", "DATA %x", 0xAB);
+	name[0] = 'x';
+
+	/**
+	 * <b>scenario</b>: Main loop handles deferred logs.<br>
+	 * <b>expected</b>: Logs formatted with captured arguments and timestamps, in order.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*time_cnt_mock, time_from_epoch_ms(1000, _)).WillOnce(SetArgPointee<1>(t1));
+	t1.msecond = 500;
+	EXPECT_CALL(*time_cnt_mock, time_from_epoch_ms(2000, _)).WillOnce(SetArgPointee<1>(t1));
+	{
+		InSequence seq;
+		EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:400] - DEBUG - FILE:value -5 abc 007 X%\n"))).WillOnce(Return(RETURN_OK));
+		EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:500] - ERROR - FILE:DATA AB\n"))).WillOnce(Return(RETURN_OK));
+	}
+	logger_watcher();
+
+	/**
+	 * <b>scenario</b>: Nothing pending.<br>
+	 * <b>expected</b>: Callback not called.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, callback(_)).Times(0);
+	logger_watcher();
+
+	/**
+	 * <b>scenario</b>: Deferred mode disabled with pending log.<br>
+	 * <b>expected</b>: Pending log sent.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*time_cnt_mock, time_get_epoch_ms()).WillOnce(Return(3000));
+	logger_send(LOG_DEBUG, "FILE", "DATA");
+	EXPECT_CALL(*time_cnt_mock, time_from_epoch_ms(3000, _)).WillOnce(SetArgPointee<1>(t1));
+	EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:500] - DEBUG - FILE:DATA\n"))).WillOnce(Return(RETURN_OK));
+	EXPECT_EQ(RETURN_OK, logger_set_deferred(0));
+}
+
+/**
+ * @test Deferred logs buffer overflow and wrap around
+ */
+TEST_F(loggerFixture, deferred_log_overflow_tests)
+{
+	const uint8_t LOGS_COUNT = 40;
+	EXPECT_EQ(RETURN_OK, logger_enable());
+	EXPECT_EQ(RETURN_OK, logger_register_sender(&fake_callback));
+	EXPECT_EQ(RETURN_OK, logger_set_deferred(1));
+	TimeItem t1 = {};
+	t1.day = 1; t1.month = 2, t1.year = 2020, t1.hour = 11, t1.minute = 12, t1.second = 13, t1.msecond = 400;
+	const char* long_string = "0123456789012345678901234567890123456789";
+	EXPECT_CALL(*time_cnt_mock, time_get_epoch_ms()).WillRepeatedly(Return(1000));
+	EXPECT_CALL(*time_cnt_mock, time_from_epoch_ms(_, _)).WillRepeatedly(SetArgPointee<1>(t1));
+	EXPECT_CALL(*time_cnt_mock, time_get()).WillRepeatedly(Return(&t1));
+
+	/**
+	 * <b>scenario</b>: More logs than buffer can keep.<br>
+	 * <b>expected</b>: Logs dropped and counted, kept logs sent in order, drop reported.<br>
+    * ************************************************
+	 */
+	for (uint8_t i = 0; i < LOGS_COUNT; i++)
+	{
+		logger_send(LOG_ERROR, "FILE", "%u %s", i, long_string);
+	}
+	uint32_t dropped = logger_get_dropped_count();
+	EXPECT_GT(dropped, 0);
+
+	std::vector<std::string> sent;
+	EXPECT_CALL(*callMock, callback(_)).WillRepeatedly(Invoke([&](const char* data) -> RET_CODE
+								{
+									sent.push_back(data);
+									return RETURN_OK;
+								}));
+	logger_watcher();
+	ASSERT_EQ(LOGS_COUNT - dropped + 1, sent.size());
+	/* string arguments are truncated */
+	EXPECT_EQ("[01-02-2020 11:12:13:400] - ERROR - FILE:0 01234567890123456789012345678901\n", sent[0]);
+	EXPECT_EQ("[01-02-2020 11:12:13:400] - ERROR - logger_watcher:" + std::to_string(dropped) + " logs dropped\n", sent.back());
+
+	/**
+	 * <b>scenario</b>: Logs sent many times through the whole buffer.<br>
+	 * <b>expected</b>: No log lost on buffer wrap around.<br>
+    * ************************************************
+	 */
+	sent.clear();
+	for (uint8_t i = 0; i < 200; i++)
+	{
+		logger_send(LOG_ERROR, "FILE", "%u %s", i, long_string + (i % 20));
+		logger_send(LOG_ERROR, "FILE", "%u", i);
+		logger_watcher();
+	}
+	ASSERT_EQ(400, sent.size());
+	EXPECT_EQ("[01-02-2020 11:12:13:400] - ERROR - FILE:199 901234567890123456789\n", sent[398]);
+	EXPECT_EQ("[01-02-2020 11:12:13:400] - ERROR - FILE:199\n", sent[399]);
+	EXPECT_EQ(dropped, logger_get_dropped_count());
+}
+
+/**
+ * @test Cached time prefix of log
+ */
+TEST_F(loggerFixture, time_prefix_tests)
+{
+	EXPECT_EQ(RETURN_OK, logger_enable());
+	EXPECT_EQ(RETURN_OK, logger_register_sender(&fake_callback));
+	TimeItem t1 = {};
+	t1.day = 31; t1.month = 12, t1.year = 2020, t1.hour = 23, t1.minute = 59, t1.second = 59, t1.msecond = 990;
+	EXPECT_CALL(*time_cnt_mock, time_get()).WillRepeatedly(Return(&t1));
+
+	/**
+	 * <b>scenario</b>: Logs sent in consecutive ticks.<br>
+	 * <b>expected</b>: Only milliseconds changed.<br>
+    * ************************************************
+	 */
+	{
+		InSequence seq;
+		EXPECT_CALL(*callMock, callback(StrEq("[31-12-2020 23:59:59:990] - ERROR - FILE:DATA\n"))).WillOnce(Return(RETURN_OK));
+		EXPECT_CALL(*callMock, callback(StrEq("[31-12-2020 23:59:59:007] - ERROR - FILE:DATA\n"))).WillOnce(Return(RETURN_OK));
+	}
+	logger_send(LOG_ERROR, "FILE", "DATA");
+	t1.msecond = 7;
+	logger_send(LOG_ERROR, "FILE", "DATA");
+
+	/**
+	 * <b>scenario</b>: New year.<br>
+	 * <b>expected</b>: All fields changed.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, callback(StrEq("[01-01-2021 00:00:00:000] - ERROR - FILE:DATA\n"))).WillOnce(Return(RETURN_OK));
+	t1 = {1, 1, 2021, 0, 0, 0, 0};
+	logger_send(LOG_ERROR, "FILE", "DATA");
+
+	/**
+	 * <b>scenario</b>: Year not fitting in 4 digits.<br>
+	 * <b>expected</b>: Time formatted without cache.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, callback(StrEq("[01-01-999 00:00:00:000] - ERROR - FILE:DATA\n"))).WillOnce(Return(RETURN_OK));
+	t1.year = 999;
+	logger_send(LOG_ERROR, "FILE", "DATA");
+
+	/**
+	 * <b>scenario</b>: Buffer too small for new line and NULL terminator.<br>
+	 * <b>expected</b>: Logger not initialized.<br>
+    * ************************************************
+	 */
+	logger_deinitialize();
+	EXPECT_EQ(RETURN_NOK, logger_initialize(1));
+
+	/**
+	 * <b>scenario</b>: Header longer than buffer.<br>
+	 * <b>expected</b>: Header truncated, new line and NULL terminator written within buffer.<br>
+    * ************************************************
+	 */
+	EXPECT_EQ(RETURN_OK, logger_initialize(32));
+	EXPECT_EQ(RETURN_OK, logger_enable());
+	logger_register_sender(&fake_callback);
+	{
+		InSequence seq;
+		EXPECT_CALL(*callMock, callback(StrEq("[01-01-999 00:00:00:000] - ERR\n"))).WillOnce(Return(RETURN_OK));
+		EXPECT_CALL(*callMock, callback(StrEq("[31-12-2020 23:59:59:990] - ER\n"))).WillOnce(Return(RETURN_OK));
+	}
+	logger_send(LOG_ERROR, "FILE", "DATA");
+	t1 = {31, 12, 2020, 23, 59, 59, 990};
+	logger_send(LOG_ERROR, "FILE", "DATA");
+}
+
+/**
+ * @test Rate limiting and repeated logs collapsing
+ */
+TEST_F(loggerFixture, rate_limit_tests)
+{
+	void(*tick)(TimeItem*) = NULL;
+	uint16_t burst = 0;
+	uint16_t rate = 0;
+	TimeItem t1 = {};
+	t1.day = 1; t1.month = 2, t1.year = 2020, t1.hour = 11, t1.minute = 12, t1.second = 13, t1.msecond = 400;
+	EXPECT_EQ(RETURN_OK, logger_enable());
+	EXPECT_EQ(RETURN_OK, logger_register_sender(&fake_callback));
+	EXPECT_CALL(*time_cnt_mock, time_get()).WillRepeatedly(Return(&t1));
+
+	/**
+	 * <b>scenario</b>: Rate limit set.<br>
+	 * <b>expected</b>: Callback registered in TIME module.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*time_cnt_mock, time_get_basetime()).WillOnce(Return(10));
+	EXPECT_CALL(*time_cnt_mock, time_register_callback(_, TIME_PRIORITY_HIGH)).WillOnce(DoAll(SaveArg<0>(&tick), Return(RETURN_OK)));
+	EXPECT_EQ(RETURN_OK, logger_set_rate_limit(2, 1));
+	logger_get_rate_limit(&burst, &rate);
+	EXPECT_EQ(2, burst);
+	EXPECT_EQ(1, rate);
+	ASSERT_NE(nullptr, tick);
+
+	/**
+	 * <b>scenario</b>: The same log sent many times.<br>
+	 * <b>expected</b>: Log sent once, repeated logs counted.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:400] - ERROR - FILE:no response from 3\n"))).WillOnce(Return(RETURN_OK));
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		logger_send(LOG_ERROR, "FILE", "no response from %u", 3);
+	}
+
+	/**
+	 * <b>scenario</b>: Different log from the same call site.<br>
+	 * <b>expected</b>: Repeated logs reported before the new log.<br>
+    * ************************************************
+	 */
+	{
+		InSequence seq;
+		EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:400] - ERROR - FILE:last message repeated 3 times\n"))).WillOnce(Return(RETURN_OK));
+		EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:400] - ERROR - FILE:no response from 4\n"))).WillOnce(Return(RETURN_OK));
+	}
+	logger_send(LOG_ERROR, "FILE", "no response from %u", 4);
+
+	/**
+	 * <b>scenario</b>: Burst used, more logs sent from the same call site.<br>
+	 * <b>expected</b>: Logs suppressed, other call sites not affected.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:400] - ERROR - FILE:other\n"))).WillOnce(Return(RETURN_OK));
+	logger_send(LOG_ERROR, "FILE", "no response from %u", 5);
+	logger_send_if(1, LOG_ERROR, "FILE", "no response from %u", 6);
+	logger_send(LOG_ERROR, "FILE", "other");
+
+	/**
+	 * <b>scenario</b>: Bucket refilled after one second.<br>
+	 * <b>expected</b>: Suppressed logs reported before the new log.<br>
+    * ************************************************
+	 */
+	for (uint8_t i = 0; i < 99; i++)
+	{
+		tick(&t1);
+	}
+	logger_send(LOG_ERROR, "FILE", "no response from %u", 7);
+	tick(&t1);
+	{
+		InSequence seq;
+		EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:400] - ERROR - FILE:3 messages suppressed\n"))).WillOnce(Return(RETURN_OK));
+		EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:400] - ERROR - FILE:no response from 8\n"))).WillOnce(Return(RETURN_OK));
+	}
+	logger_send(LOG_ERROR, "FILE", "no response from %u", 8);
+
+	/**
+	 * <b>scenario</b>: Log repeated, no more logs from the call site.<br>
+	 * <b>expected</b>: Repeated logs reported from logger_watcher after report period.<br>
+    * ************************************************
+	 */
+	logger_send(LOG_ERROR, "FILE", "no response from %u", 8);
+	logger_watcher();
+	EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:400] - ERROR - FILE:last message repeated 1 times\n"))).WillOnce(Return(RETURN_OK));
+	for (uint16_t i = 0; i < LOGGER_RATE_REPORT_MS / 10; i++)
+	{
+		tick(&t1);
+	}
+	logger_watcher();
+	logger_watcher();
+
+	/**
+	 * <b>scenario</b>: Rate limiting disabled.<br>
+	 * <b>expected</b>: Callback unregistered, all logs sent.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*time_cnt_mock, time_unregister_callback(tick)).WillOnce(Return(RETURN_OK));
+	EXPECT_EQ(RETURN_OK, logger_set_rate_limit(0, 0));
+	EXPECT_CALL(*callMock, callback(_)).Times(3).WillRepeatedly(Return(RETURN_OK));
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		logger_send(LOG_ERROR, "FILE", "no response from %u", 8);
+	}
+}
+
+std::vector<uint8_t> binary_frames;
+uint8_t binary_calls;
+RET_CODE fake_binary_callback(const uint8_t* data, uint16_t size)
+{
+	binary_calls++;
+	binary_frames.assign(data, data + size);
+	return RETURN_OK;
+}
+
+/**
+ * @test Binary log frames
+ */
+TEST_F(loggerFixture, binary_log_tests)
+{
+	const char* PREFIX = "FILE";
+	const char* FMT = "v %u %s %d";
+	const uint64_t EPOCH_MS = 0x0000060504030201;
+	binary_calls = 0;
+	EXPECT_EQ(RETURN_OK, logger_enable());
+	EXPECT_EQ(RETURN_OK, logger_set_deferred(1));
+	EXPECT_EQ(RETURN_OK, logger_set_binary_sender(&fake_binary_callback));
+
+	/**
+	 * <b>scenario</b>: Deferred log sent, only binary sender set.<br>
+	 * <b>expected</b>: Frame with addresses of strings and encoded arguments sent, log not formatted.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*time_cnt_mock, time_get_epoch_ms()).WillOnce(Return(EPOCH_MS));
+	EXPECT_CALL(*time_cnt_mock, time_from_epoch_ms(_, _)).Times(0);
+	logger_send(LOG_ERROR, PREFIX, FMT, 300, "ab", -1);
+	logger_watcher();
+	EXPECT_EQ(1, binary_calls);
+
+	uint32_t fmt_address = (uint32_t)(uintptr_t)FMT;
+	uint32_t prefix_address = (uint32_t)(uintptr_t)PREFIX;
+	std::vector<uint8_t> expected = {LOGGER_FRAME_SYNC, 25,
+	                                 (uint8_t)fmt_address, (uint8_t)(fmt_address >> 8), (uint8_t)(fmt_address >> 16), (uint8_t)(fmt_address >> 24),
+	                                 (uint8_t)prefix_address, (uint8_t)(prefix_address >> 8), (uint8_t)(prefix_address >> 16), (uint8_t)(prefix_address >> 24),
+	                                 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, LOG_ERROR,
+	                                 0xAC, 0x02,
+	                                 0x02, 'a', 'b',
+	                                 0xFF, 0xFF, 0xFF, 0xFF, 0x0F};
+	uint8_t checksum = 0;
+	for (size_t i = LOGGER_FRAME_HEADER_SIZE; i < expected.size(); i++)
+	{
+		checksum += expected[i];
+	}
+	expected.push_back(checksum);
+	EXPECT_EQ(expected, binary_frames);
+
+	/**
+	 * <b>scenario</b>: Binary and text senders set.<br>
+	 * <b>expected</b>: Both notified.<br>
+    * ************************************************
+	 */
+	TimeItem t1 = {};
+	t1.day = 1; t1.month = 2, t1.year = 2020, t1.hour = 11, t1.minute = 12, t1.second = 13, t1.msecond = 400;
+	EXPECT_EQ(RETURN_OK, logger_register_sender(&fake_callback));
+	EXPECT_CALL(*time_cnt_mock, time_get_epoch_ms()).WillOnce(Return(EPOCH_MS));
+	EXPECT_CALL(*time_cnt_mock, time_from_epoch_ms(EPOCH_MS, _)).WillOnce(SetArgPointee<1>(t1));
+	EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:400] - ERROR - FILE:v 300 ab -1\n"))).WillOnce(Return(RETURN_OK));
+	logger_send(LOG_ERROR, PREFIX, FMT, 300, "ab", -1);
+	logger_watcher();
+	EXPECT_EQ(2, binary_calls);
+	EXPECT_EQ(expected, binary_frames);
+
+	/**
+	 * <b>scenario</b>: Binary sender removed.<br>
+	 * <b>expected</b>: Only text sender notified.<br>
+    * ************************************************
+	 */
+	EXPECT_EQ(RETURN_OK, logger_set_binary_sender(NULL));
+	EXPECT_CALL(*time_cnt_mock, time_get_epoch_ms()).WillOnce(Return(EPOCH_MS));
+	EXPECT_CALL(*time_cnt_mock, time_from_epoch_ms(EPOCH_MS, _)).WillOnce(SetArgPointee<1>(t1));
+	EXPECT_CALL(*callMock, callback(_)).WillOnce(Return(RETURN_OK));
+	logger_send(LOG_ERROR, PREFIX, FMT, 300, "ab", -1);
+	logger_watcher();
+	EXPECT_EQ(2, binary_calls);
+}
+
+/**
+ * @test Macro front-ends
+ */
+TEST_F(loggerFixture, macro_front_end_tests)
+{
+	EXPECT_EQ(RETURN_OK, logger_register_sender(&fake_callback));
+	TimeItem t1 = {};
+	t1.day = 1; t1.month = 2, t1.year = 2020, t1.hour = 11, t1.minute = 12, t1.second = 13, t1.msecond = 400;
+	uint8_t evaluated = 0;
+
+	/**
+	 * <b>scenario</b>: Logger disabled.<br>
+	 * <b>expected</b>: No group active, arguments not evaluated.<br>
+    * ************************************************
+	 */
+	EXPECT_EQ(0, logger_active_groups);
+	EXPECT_CALL(*callMock, callback(_)).Times(0);
+	LOG_ERR("FILE", "DATA %u", ++evaluated);
+	EXPECT_EQ(0, evaluated);
+
+	/**
+	 * <b>scenario</b>: Logger enabled, DEBUG group disabled.<br>
+	 * <b>expected</b>: Only ERROR log sent, arguments of DEBUG log not evaluated.<br>
+    * ************************************************
+	 */
+	EXPECT_EQ(RETURN_OK, logger_enable());
+	EXPECT_EQ((uint32_t)1 << LOG_ERROR, logger_active_groups);
+	EXPECT_CALL(*time_cnt_mock, time_get()).WillOnce(Return(&t1));
+	EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:400] - ERROR - FILE:DATA 1\n"))).WillOnce(Return(RETURN_OK));
+	LOG_ERR("FILE", "DATA %u", ++evaluated);
+	LOG_INFO(LOG_DEBUG, "FILE", "DATA %u", ++evaluated);
+	LOG_INFO_IF(++evaluated, LOG_DEBUG, "FILE", "DATA");
+	EXPECT_EQ(1, evaluated);
+
+	/**
+	 * <b>scenario</b>: DEBUG group enabled, conditional log with false condition.<br>
+	 * <b>expected</b>: Log not sent.<br>
+    * ************************************************
+	 */
+	EXPECT_EQ(RETURN_OK, logger_set_group_state(LOG_DEBUG, 1));
+	EXPECT_TRUE(logger_active_groups & ((uint32_t)1 << LOG_DEBUG));
+	EXPECT_CALL(*callMock, callback(_)).Times(0);
+	LOG_INFO_IF(evaluated == 0, LOG_DEBUG, "FILE", "DATA");
+
+	/**
+	 * <b>scenario</b>: Log above compiled level.<br>
+	 * <b>expected</b>: Log not sent.<br>
+    * ************************************************
+	 */
+	LOGGER_SEND(LOGGER_COMPILED_LEVEL + 1, LOG_DEBUG, "FILE", "DATA %u", ++evaluated);
+	EXPECT_EQ(1, evaluated);
+
+	/**
+	 * <b>scenario</b>: Logger disabled again.<br>
+	 * <b>expected</b>: No group active.<br>
+    * ************************************************
+	 */
+	logger_disable();
+	EXPECT_EQ(0, logger_active_groups);
+}
+
+/**
+ * @test Sink filters
+ */
+TEST_F(loggerFixture, sink_filter_tests)
+{
+	TimeItem t1 = {};
+	t1.day = 1; t1.month = 2, t1.year = 2020, t1.hour = 11, t1.minute = 12, t1.second = 13, t1.msecond = 400;
+	EXPECT_EQ(RETURN_OK, logger_enable());
+	EXPECT_EQ(RETURN_OK, logger_set_group_state(LOG_DEBUG, 1));
+
+	/**
+	 * <b>scenario</b>: Sink with errors only and sink with DEBUG group added.<br>
+	 * <b>expected</b>: Sinks added, filters read back.<br>
+    * ************************************************
+	 */
+	LoggerSinkConfig errors = {&fake_callback, LOGGER_ALL_GROUPS, LOGGER_LEVEL_ERROR, 0};
+	LoggerSinkConfig debug = {&fake_sink_callback, (uint32_t)1 << LOG_DEBUG, LOGGER_LEVEL_TRACE, 0};
+	LOGGER_SINK errors_sink = logger_add_sink(&errors);
+	LOGGER_SINK debug_sink = logger_add_sink(&debug);
+	ASSERT_NE(LOGGER_INVALID_SINK, errors_sink);
+	ASSERT_NE(LOGGER_INVALID_SINK, debug_sink);
+	uint32_t groups;
+	uint8_t level;
+	EXPECT_EQ(RETURN_OK, logger_get_sink_filter(debug_sink, &groups, &level));
+	EXPECT_EQ((uint32_t)1 << LOG_DEBUG, groups);
+	EXPECT_EQ(LOGGER_LEVEL_TRACE, level);
+
+	/**
+	 * <b>scenario</b>: ERROR and DEBUG logs sent.<br>
+	 * <b>expected</b>: Every log sent only to sink accepting it.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*time_cnt_mock, time_get()).WillRepeatedly(Return(&t1));
+	EXPECT_CALL(*callMock, callback(StrEq("[01-02-2020 11:12:13:400] - ERROR - FILE:ERR\n"))).WillOnce(Return(RETURN_OK));
+	EXPECT_CALL(*callMock, sink_callback(StrEq("[01-02-2020 11:12:13:400] - DEBUG - FILE:TRACE\n"))).WillOnce(Return(RETURN_OK));
+	LOG_ERR("FILE", "ERR");
+	logger_send_level(LOGGER_LEVEL_TRACE, LOG_DEBUG, "FILE", "TRACE");
+	Mock::VerifyAndClearExpectations(callMock);
+	Mock::VerifyAndClearExpectations(time_cnt_mock);
+
+	/**
+	 * <b>scenario</b>: Level of DEBUG sink lowered to INFO, TRACE log sent.<br>
+	 * <b>expected</b>: No sink accepts the log, it is not formatted.<br>
+    * ************************************************
+	 */
+	EXPECT_EQ(RETURN_OK, logger_set_sink_filter(debug_sink, (uint32_t)1 << LOG_DEBUG, LOGGER_LEVEL_INFO));
+	EXPECT_CALL(*time_cnt_mock, time_get()).Times(0);
+	EXPECT_CALL(*callMock, callback(_)).Times(0);
+	EXPECT_CALL(*callMock, sink_callback(_)).Times(0);
+	logger_send_level(LOGGER_LEVEL_TRACE, LOG_DEBUG, "FILE", "TRACE");
+
+	/**
+	 * <b>scenario</b>: Sink removed, invalid handles used.<br>
+	 * <b>expected</b>: RETURN_NOK returned for removed and invalid sinks.<br>
+    * ************************************************
+	 */
+	EXPECT_EQ(RETURN_OK, logger_remove_sink(debug_sink));
+	EXPECT_EQ(RETURN_NOK, logger_remove_sink(debug_sink));
+	EXPECT_EQ(RETURN_NOK, logger_set_sink_filter(debug_sink, LOGGER_ALL_GROUPS, LOGGER_LEVEL_TRACE));
+	EXPECT_EQ(RETURN_NOK, logger_get_sink_filter(LOGGER_INVALID_SINK, &groups, &level));
+	LoggerSinkConfig invalid = {NULL, LOGGER_ALL_GROUPS, LOGGER_LEVEL_TRACE, 0};
+	EXPECT_EQ(LOGGER_INVALID_SINK, logger_add_sink(&invalid));
+}
+
+/**
+ * @test Sinks with queue
+ */
+TEST_F(loggerFixture, sink_queue_tests)
+{
+	TimeItem t1 = {};
+	t1.day = 1; t1.month = 2, t1.year = 2020, t1.hour = 11, t1.minute = 12, t1.second = 13, t1.msecond = 400;
+	const char* LINE_1 = "[01-02-2020 11:12:13:400] - ERROR - FILE:1\n";
+	const char* LINE_2 = "[01-02-2020 11:12:13:400] - ERROR - FILE:2\n";
+	const uint16_t LINE_SIZE = strlen(LINE_1) + 1;
+	EXPECT_EQ(RETURN_OK, logger_enable());
+	/* place for two lines, the last byte is never used */
+	LoggerSinkConfig config = {&fake_sink_callback, LOGGER_ALL_GROUPS, LOGGER_LEVEL_TRACE, (uint16_t)(2 * LINE_SIZE + 1)};
+	LOGGER_SINK sink = logger_add_sink(&config);
+	ASSERT_NE(LOGGER_INVALID_SINK, sink);
+	EXPECT_CALL(*time_cnt_mock, time_get()).WillRepeatedly(Return(&t1));
+
+	/**
+	 * <b>scenario</b>: Two logs sent.<br>
+	 * <b>expected</b>: Sink not called from log context, lines sent from logger_watcher().<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, sink_callback(_)).Times(0);
+	logger_send(LOG_ERROR, "FILE", "1");
+	logger_send(LOG_ERROR, "FILE", "2");
+	Mock::VerifyAndClearExpectations(callMock);
+	{
+		InSequence seq;
+		EXPECT_CALL(*callMock, sink_callback(StrEq(LINE_1))).WillOnce(Return(RETURN_OK));
+		EXPECT_CALL(*callMock, sink_callback(StrEq(LINE_2))).WillOnce(Return(RETURN_OK));
+	}
+	logger_watcher();
+	Mock::VerifyAndClearExpectations(callMock);
+
+	/**
+	 * <b>scenario</b>: Three logs sent to queue for two lines.<br>
+	 * <b>expected</b>: The last log dropped and counted.<br>
+    * ************************************************
+	 */
+	logger_send(LOG_ERROR, "FILE", "1");
+	logger_send(LOG_ERROR, "FILE", "2");
+	logger_send(LOG_ERROR, "FILE", "3");
+	EXPECT_EQ(1, logger_get_sink_dropped(sink));
+
+	/**
+	 * <b>scenario</b>: Sink busy.<br>
+	 * <b>expected</b>: Line kept in queue and sent again in next call.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, sink_callback(StrEq(LINE_1))).WillOnce(Return(RETURN_NOK));
+	logger_watcher();
+	Mock::VerifyAndClearExpectations(callMock);
+	EXPECT_CALL(*callMock, sink_callback(StrEq(LINE_1))).WillOnce(Return(RETURN_OK));
+	EXPECT_CALL(*callMock, sink_callback(StrEq(LINE_2))).WillOnce(Return(RETURN_NOK));
+	logger_watcher();
+	Mock::VerifyAndClearExpectations(callMock);
+
+	/**
+	 * <b>scenario</b>: Shorter log sent when the end of queue is occupied.<br>
+	 * <b>expected</b>: Line placed at the beginning of queue, order of lines kept.<br>
+    * ************************************************
+	 */
+	logger_send(LOG_ERROR, "FILE", "");
+	{
+		InSequence seq;
+		EXPECT_CALL(*callMock, sink_callback(StrEq(LINE_2))).WillOnce(Return(RETURN_OK));
+		EXPECT_CALL(*callMock, sink_callback(StrEq("[01-02-2020 11:12:13:400] - ERROR - FILE:\n"))).WillOnce(Return(RETURN_OK));
+	}
+	logger_watcher();
+	Mock::VerifyAndClearExpectations(callMock);
+	EXPECT_CALL(*callMock, sink_callback(_)).Times(0);
+	logger_watcher();
+	EXPECT_EQ(1, logger_get_sink_dropped(sink));
+	Mock::VerifyAndClearExpectations(callMock);
+
+	/**
+	 * <b>scenario</b>: Line rejected by sink with error.<br>
+	 * <b>expected</b>: Line dropped and counted, next line sent.<br>
+    * ************************************************
+	 */
+	logger_send(LOG_ERROR, "FILE", "1");
+	logger_send(LOG_ERROR, "FILE", "2");
+	{
+		InSequence seq;
+		EXPECT_CALL(*callMock, sink_callback(StrEq(LINE_1))).WillOnce(Return(RETURN_ERROR));
+		EXPECT_CALL(*callMock, sink_callback(StrEq(LINE_2))).WillOnce(Return(RETURN_OK));
+	}
+	logger_watcher();
+	EXPECT_EQ(2, logger_get_sink_dropped(sink));
+	Mock::VerifyAndClearExpectations(callMock);
+
+	/**
+	 * <b>scenario</b>: Sink with drain budget of one line.<br>
+	 * <b>expected</b>: One line sent in every logger_watcher() call.<br>
+    * ************************************************
+	 */
+	EXPECT_EQ(RETURN_OK, logger_remove_sink(sink));
+	config.drain_budget = 1;
+	sink = logger_add_sink(&config);
+	ASSERT_NE(LOGGER_INVALID_SINK, sink);
+	logger_send(LOG_ERROR, "FILE", "1");
+	logger_send(LOG_ERROR, "FILE", "2");
+	EXPECT_CALL(*callMock, sink_callback(StrEq(LINE_1))).WillOnce(Return(RETURN_OK));
+	logger_watcher();
+	Mock::VerifyAndClearExpectations(callMock);
+	EXPECT_CALL(*callMock, sink_callback(StrEq(LINE_2))).WillOnce(Return(RETURN_OK));
+	logger_watcher();
+}
@@ -0,0 +1,90 @@
+#ifndef _LOG_DECODER_H_
+#define _LOG_DECODER_H_
+
+/* ============================= */
+/**
+ * @file log_decoder.h
+ *
+ * @brief Host tool decoding binary log frames sent by Logger.
+ *
+ * @details
+ * Frame (see logger_frame.h) contains only addresses of format and prefix strings,
+ * the strings are read from ELF file of the firmware which sent the frames.
+ * Decoded log has the same form as log formatted on target, e.g.
+ * "[01-02-2020 11:12:13:400] - DEBUG - prefix:message\n".
+ */
+/* ============================= */
+/* =============================
+ *  Includes of common headers
+ * =============================*/
+#include <stdint.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "return_codes.h"
+#include "logger_frame.h"
+/* =============================
+ *          Defines
+ * =============================*/
+/** Size of buffer for decoded log line */
+#define LOG_DECODER_LINE_SIZE 4096
+/* =============================
+ *       Data structures
+ * =============================*/
+typedef enum
+{
+	LOG_DECODER_FRAME_OK,         /**< Complete frame with correct checksum */
+	LOG_DECODER_FRAME_INCOMPLETE, /**< More bytes needed */
+	LOG_DECODER_FRAME_INVALID,    /**< Not a frame or checksum mismatch */
+} LogDecoderFrameState;
+
+/** Returns string placed at given address of firmware or NULL when not found */
+typedef const char*(*LogDecoderLookup)(uint32_t address, void* ctx);
+
+typedef struct
+{
+	uint8_t* data;       /**< Content of ELF file */
+	uint32_t size;
+} LogDecoderElf;
+
+/**
+ * @brief Check if buffer starts with binary frame.
+ * @param[in] data - Received bytes, starting from sync byte
+ * @param[in] size - Number of received bytes
+ * @return See LogDecoderFrameState.
+ */
+LogDecoderFrameState log_decoder_check_frame(const uint8_t* data, uint32_t size);
+/**
+ * @brief Decode frame to log line.
+ * @details
+ * Frame has to be checked by log_decoder_check_frame() before.
+ * Missing arguments (dropped on target when frame was full) are left empty.
+ * @param[out] line - Buffer for log line, at least LOG_DECODER_LINE_SIZE bytes
+ * @param[in] frame - Complete frame
+ * @param[in] lookup - Function returning strings from firmware
+ * @param[in] ctx - Context passed to lookup function
+ * @return Length of log line.
+ */
+int log_decoder_decode(char* line, const uint8_t* frame, LogDecoderLookup lookup, void* ctx);
+/**
+ * @brief Load ELF file of firmware.
+ * @param[out] elf - Loaded file
+ * @param[in] path - Path to ELF file
+ * @return See RETURN_CODES.
+ */
+RET_CODE log_decoder_load_elf(LogDecoderElf* elf, const char* path);
+/**
+ * @brief Release loaded ELF file.
+ * @param[in] elf - Loaded file
+ * @return None.
+ */
+void log_decoder_free_elf(LogDecoderElf* elf);
+/**
+ * @brief Lookup function reading strings from allocated sections of ELF file.
+ * @param[in] address - Address of string in firmware
+ * @param[in] ctx - Pointer to LogDecoderElf
+ * @return String or NULL, when address is not in any section.
+ */
+const char* log_decoder_elf_lookup(uint32_t address, void* ctx);
+
+#endif
@@ -0,0 +1,305 @@
+/* =============================
+ *   Includes of common headers
+ * =============================*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <elf.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "log_decoder.h"
+#include "Logger.h"
+#include "string_formatter.h"
+/* =============================
+ *          Defines
+ * =============================*/
+/* firmware counts time from 01.01.2000, host from 01.01.1970 */
+#define LOG_DECODER_EPOCH_OFFSET_S 946684800ULL
+/* longer strings read from ELF are treated as not found */
+#define LOG_DECODER_STRING_MAX 256
+/* the longest format specifier handled by string formatter, e.g. "%.2d" */
+#define LOG_DECODER_SPEC_MAX 5
+/* =============================
+ *   Internal module functions
+ * =============================*/
+uint32_t log_decoder_read_u32(const uint8_t* data);
+uint8_t log_decoder_read_varint(const uint8_t** data, const uint8_t* end, uint32_t* value);
+int log_decoder_format_header(char* buf, uint64_t epoch_ms, uint8_t group, const char* prefix);
+int log_decoder_format_args(char* buf, const char* fmt, const uint8_t* args, const uint8_t* end);
+const char* log_decoder_elf32_lookup(const LogDecoderElf* elf, uint32_t address);
+const char* log_decoder_elf64_lookup(const LogDecoderElf* elf, uint32_t address);
+const char* log_decoder_section_string(const LogDecoderElf* elf, uint64_t offset, uint64_t size);
+/* =============================
+ *      Module variables
+ * =============================*/
+/* the same names as in Logger.c */
+const char* LOG_DECODER_GROUPS[] = {"ERROR", "WIFI_DRV", "TIME", "TASK_SCH", "DEBUG", "WIFI_MGR", "DHT_DRV",
+                                    "I2C_DRV", "INP", "REL", "FAN", "SLM", "ENV", "NTF", "SIM"};
+/* compilation fails when new group is added to LogGroup and not here */
+typedef char log_decoder_groups_check[(sizeof(LOG_DECODER_GROUPS) / sizeof(LOG_DECODER_GROUPS[0]) == LOG_ENUM_MAX)? 1 : -1];
+
+
+LogDecoderFrameState log_decoder_check_frame(const uint8_t* data, uint32_t size)
+{
+	if (size == 0)
+	{
+		return LOG_DECODER_FRAME_INCOMPLETE;
+	}
+	if (data[0] != LOGGER_FRAME_SYNC)
+	{
+		return LOG_DECODER_FRAME_INVALID;
+	}
+	if (size < LOGGER_FRAME_HEADER_SIZE)
+	{
+		return LOG_DECODER_FRAME_INCOMPLETE;
+	}
+	uint8_t length = data[1];
+	if (length < LOGGER_FRAME_FIXED_PAYLOAD)
+	{
+		return LOG_DECODER_FRAME_INVALID;
+	}
+	if (size < (uint32_t)LOGGER_FRAME_SIZE(length))
+	{
+		return LOG_DECODER_FRAME_INCOMPLETE;
+	}
+	uint8_t checksum = 0;
+	for (uint16_t i = 0; i < length; i++)
+	{
+		checksum += data[LOGGER_FRAME_HEADER_SIZE + i];
+	}
+	return checksum == data[LOGGER_FRAME_HEADER_SIZE + length]? LOG_DECODER_FRAME_OK : LOG_DECODER_FRAME_INVALID;
+}
+
+int log_decoder_decode(char* line, const uint8_t* frame, LogDecoderLookup lookup, void* ctx)
+{
+	const uint8_t* payload = &frame[LOGGER_FRAME_HEADER_SIZE];
+	const uint8_t* end = payload + frame[1];
+	uint32_t fmt_address = log_decoder_read_u32(payload);
+	uint32_t prefix_address = log_decoder_read_u32(payload + sizeof(uint32_t));
+	uint64_t epoch_ms = 0;
+	for (uint8_t i = 0; i < LOGGER_FRAME_TIMESTAMP_SIZE; i++)
+	{
+		epoch_ms |= (uint64_t)payload[2 * sizeof(uint32_t) + i] << (8 * i);
+	}
+	uint8_t group = payload[LOGGER_FRAME_FIXED_PAYLOAD - 1];
+
+	const char* prefix = lookup(prefix_address, ctx);
+	const char* fmt = lookup(fmt_address, ctx);
+	int length = log_decoder_format_header(line, epoch_ms, group, prefix? prefix : "?");
+	if (fmt)
+	{
+		length += log_decoder_format_args(line + length, fmt, payload + LOGGER_FRAME_FIXED_PAYLOAD, end);
+	}
+	else
+	{
+		length += string_format(line + length, "<unknown format 0x%X>", fmt_address);
+	}
+	line[length++] = '\n';
+	line[length] = 0x00;
+	return length;
+}
+
+RET_CODE log_decoder_load_elf(LogDecoderElf* elf, const char* path)
+{
+	RET_CODE result = RETURN_NOK;
+	elf->data = NULL;
+	elf->size = 0;
+	FILE* file = fopen(path, "rb");
+	if (file)
+	{
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		if (size > EI_NIDENT)
+		{
+			elf->data = (uint8_t*) malloc(size);
+			if (elf->data && fread(elf->data, 1, size, file) == (size_t)size)
+			{
+				elf->size = (uint32_t)size;
+				/* addresses and sizes are read directly, so ELF has to match host byte order */
+				result = (memcmp(elf->data, ELFMAG, SELFMAG) == 0 && elf->data[EI_DATA] == ELFDATA2LSB &&
+				          (elf->data[EI_CLASS] == ELFCLASS32 || elf->data[EI_CLASS] == ELFCLASS64))? RETURN_OK : RETURN_NOK;
+			}
+		}
+		fclose(file);
+	}
+	if (result != RETURN_OK)
+	{
+		log_decoder_free_elf(elf);
+	}
+	return result;
+}
+
+void log_decoder_free_elf(LogDecoderElf* elf)
+{
+	free(elf->data);
+	elf->data = NULL;
+	elf->size = 0;
+}
+
+const char* log_decoder_elf_lookup(uint32_t address, void* ctx)
+{
+	const LogDecoderElf* elf = (const LogDecoderElf*) ctx;
+	if (!elf || !elf->data)
+	{
+		return NULL;
+	}
+	return elf->data[EI_CLASS] == ELFCLASS32? log_decoder_elf32_lookup(elf, address) : log_decoder_elf64_lookup(elf, address);
+}
+
+uint32_t log_decoder_read_u32(const uint8_t* data)
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+uint8_t log_decoder_read_varint(const uint8_t** data, const uint8_t* end, uint32_t* value)
+{
+	*value = 0;
+	for (uint8_t shift = 0; *data < end && shift < 32; shift += 7)
+	{
+		uint8_t byte = *(*data)++;
+		*value |= (uint32_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int log_decoder_format_header(char* buf, uint64_t epoch_ms, uint8_t group, const char* prefix)
+{
+	/* timestamp is already local time, so it is not converted again */
+	time_t seconds = (time_t)(epoch_ms / 1000 + LOG_DECODER_EPOCH_OFFSET_S);
+	struct tm time;
+	gmtime_r(&seconds, &time);
+	return string_format(buf, "[%.2d-%.2d-%d %.2d:%.2d:%.2d:%.3d] - %s - %s:", time.tm_mday, time.tm_mon + 1, time.tm_year + 1900,
+	                     time.tm_hour, time.tm_min, time.tm_sec, (int)(epoch_ms % 1000),
+	                     group < LOG_ENUM_MAX? LOG_DECODER_GROUPS[group] : "?", prefix);
+}
+
+int log_decoder_format_args(char* buf, const char* fmt, const uint8_t* args, const uint8_t* end)
+{
+	/* the same rules as in logger_format_args, arguments are taken from frame */
+	char* start_buf = buf;
+	char spec[LOG_DECODER_SPEC_MAX + 1];
+	while (*fmt)
+	{
+		if (*fmt != '%')
+		{
+			*buf++ = *fmt++;
+			continue;
+		}
+		uint8_t spec_len = 1;
+		if (*(fmt + 1) == '.' && *(fmt + 2))
+		{
+			spec_len += 2;
+		}
+		if (*(fmt + spec_len))
+		{
+			spec_len++;
+		}
+		memcpy(spec, fmt, spec_len);
+		spec[spec_len] = 0x00;
+		fmt += spec_len;
+		switch (spec[spec_len - 1])
+		{
+		case 'c':
+		case 'd':
+		case 'i':
+		case 'u':
+		case 'x':
+		case 'X':
+			{
+				uint32_t value;
+				if (log_decoder_read_varint(&args, end, &value))
+				{
+					buf += string_format(buf, spec, value);
+				}
+			}
+			break;
+		case 's':
+			if (args < end && args + 1 + *args <= end)
+			{
+				char arg[UINT8_MAX + 1];
+				memcpy(arg, args + 1, *args);
+				arg[*args] = 0x00;
+				buf += string_format(buf, spec, arg);
+				args += 1 + *args;
+			}
+			else
+			{
+				/* truncated argument, the rest is not decoded */
+				args = end;
+			}
+			break;
+		case '%':
+			*buf++ = '%';
+			break;
+		}
+	}
+	*buf = 0x00;
+	return (int)(buf - start_buf);
+}
+
+const char* log_decoder_elf32_lookup(const LogDecoderElf* elf, uint32_t address)
+{
+	const Elf32_Ehdr* header = (const Elf32_Ehdr*) elf->data;
+	if (elf->size < sizeof(Elf32_Ehdr) || header->e_shoff + (uint64_t)header->e_shnum * sizeof(Elf32_Shdr) > elf->size)
+	{
+		return NULL;
+	}
+	const Elf32_Shdr* sections = (const Elf32_Shdr*) (elf->data + header->e_shoff);
+	for (uint16_t i = 0; i < header->e_shnum; i++)
+	{
+		/* strings are placed in sections loaded to memory, e.g. .rodata */
+		if ((sections[i].sh_flags & SHF_ALLOC) && sections[i].sh_type == SHT_PROGBITS &&
+		    address >= sections[i].sh_addr && address < sections[i].sh_addr + sections[i].sh_size)
+		{
+			uint32_t offset = address - sections[i].sh_addr;
+			return log_decoder_section_string(elf, sections[i].sh_offset + offset, sections[i].sh_size - offset);
+		}
+	}
+	return NULL;
+}
+
+const char* log_decoder_elf64_lookup(const LogDecoderElf* elf, uint32_t address)
+{
+	const Elf64_Ehdr* header = (const Elf64_Ehdr*) elf->data;
+	if (elf->size < sizeof(Elf64_Ehdr) || header->e_shoff + (uint64_t)header->e_shnum * sizeof(Elf64_Shdr) > elf->size)
+	{
+		return NULL;
+	}
+	const Elf64_Shdr* sections = (const Elf64_Shdr*) (elf->data + header->e_shoff);
+	for (uint16_t i = 0; i < header->e_shnum; i++)
+	{
+		/* logger sends 32-bit addresses */
+		if ((sections[i].sh_flags & SHF_ALLOC) && sections[i].sh_type == SHT_PROGBITS &&
+		    address >= sections[i].sh_addr && address < sections[i].sh_addr + sections[i].sh_size)
+		{
+			uint64_t offset = address - sections[i].sh_addr;
+			return log_decoder_section_string(elf, sections[i].sh_offset + offset, sections[i].sh_size - offset);
+		}
+	}
+	return NULL;
+}
+
+const char* log_decoder_section_string(const LogDecoderElf* elf, uint64_t offset, uint64_t size)
+{
+	if (offset >= elf->size)
+	{
+		return NULL;
+	}
+	if (size > elf->size - offset)
+	{
+		size = elf->size - offset;
+	}
+	if (size > LOG_DECODER_STRING_MAX)
+	{
+		size = LOG_DECODER_STRING_MAX;
+	}
+	const char* result = (const char*) (elf->data + offset);
+	return memchr(result, 0x00, size)? result : NULL;
+}
@@ -0,0 +1,85 @@
+/* =============================
+ *   Includes of common headers
+ * =============================*/
+#include <stdio.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "log_decoder.h"
+
+/* ============================= */
+/**
+ * @file log_decoder_main.c
+ *
+ * @brief Command line front-end of log decoder.
+ *
+ * @details
+ * Usage: log_decoder <firmware.elf> [capture file]
+ * Bytes are read from capture file or standard input (e.g. BT serial port), decoded logs
+ * are printed to standard output. Bytes outside of frames are printed unchanged, so text
+ * logs can be mixed with binary frames.
+ */
+/* ============================= */
+
+int main(int argc, char** argv)
+{
+	if (argc < 2 || argc > 3)
+	{
+		fprintf(stderr, "Usage: %s <firmware.elf> [capture file]\n", argv[0]);
+		return 1;
+	}
+	LogDecoderElf elf;
+	if (log_decoder_load_elf(&elf, argv[1]) != RETURN_OK)
+	{
+		fprintf(stderr, "Cannot load ELF file %s\n", argv[1]);
+		return 1;
+	}
+	FILE* input = argc == 3? fopen(argv[2], "rb") : stdin;
+	if (!input)
+	{
+		fprintf(stderr, "Cannot open %s\n", argv[2]);
+		log_decoder_free_elf(&elf);
+		return 1;
+	}
+
+	uint8_t frame[LOGGER_FRAME_SIZE(LOGGER_FRAME_MAX_PAYLOAD)];
+	char line[LOG_DECODER_LINE_SIZE];
+	uint16_t size = 0;
+	uint32_t invalid = 0;
+	int byte;
+	while ((byte = fgetc(input)) != EOF)
+	{
+		if (size == 0 && byte != LOGGER_FRAME_SYNC)
+		{
+			fputc(byte, stdout);
+			continue;
+		}
+		frame[size++] = (uint8_t)byte;
+		switch (log_decoder_check_frame(frame, size))
+		{
+		case LOG_DECODER_FRAME_INCOMPLETE:
+			continue;
+		case LOG_DECODER_FRAME_OK:
+			log_decoder_decode(line, frame, &log_decoder_elf_lookup, &elf);
+			fputs(line, stdout);
+			break;
+		default:
+			/* corrupted frame is dropped, decoding is synchronized on next sync byte */
+			invalid++;
+			break;
+		}
+		size = 0;
+		fflush(stdout);
+	}
+
+	if (invalid)
+	{
+		fprintf(stderr, "%u invalid frames dropped\n", invalid);
+	}
+	if (input != stdin)
+	{
+		fclose(input);
+	}
+	log_decoder_free_elf(&elf);
+	return 0;
+}
@@ -16,11 +16,14 @@
 #include "stairs_led_module.h"
 #include "Logger.h"
 #include "time_counter.h"
+#include "task_scheduler.h"
 #include "string_formatter.h"
 /* =============================
  *          Defines
  * =============================*/
 #define WIFI_BROADCAST_ID 0xFF
+/* scheduler statistics are not part of the NTF_CMD_ID enum in SmartHomeTypes yet */
+#define NTF_SCHEDULER_STATS ((NTF_CMD_ID)12)
 /* =============================
  *       Internal types
  * =============================*/
@@ -55,8 +58,11 @@ RET_CODE ntfmgr_handle_set_slm_state_cmd(const NTF_MESSAGE* msg);
 RET_CODE ntfmgr_handle_set_slm_program_id_cmd(const NTF_MESSAGE* msg);
 RET_CODE ntfmgr_handle_get_env_sensor_data_cmd(const NTF_MESSAGE* msg);
 RET_CODE ntfmgr_handle_get_env_sensor_rate_cmd(const NTF_MESSAGE* msg);
+RET_CODE ntfmgr_handle_get_scheduler_stats_cmd(const NTF_MESSAGE* msg);
 
 void ntfmgr_write_to_buffer(uint8_t byte);
+void ntfmgr_write_u16_to_buffer(uint16_t value);
+void ntfmgr_write_u32_to_buffer(uint32_t value);
 void ntfmgr_write_inputs_to_buffer(const INPUT_STATUS* inputs, uint8_t size);
 void ntfmgr_write_relays_to_buffer(const RELAY_STATUS* relays, uint8_t relays_no);
 void ntfmgr_write_env_to_buffer(ENV_ITEM_ID id, const DHT_SENSOR_DATA* sensor);
@@ -89,7 +95,8 @@ NTF_HANDLE_ITEM m_handlers[] = {{NTF_SYSTEM_TIME,      NTF_GET, &ntfmgr_handle_g
                                 {NTF_SLM_PROGRAM_ID,   NTF_SET, &ntfmgr_handle_set_slm_program_id_cmd},
                                 {NTF_SLM_PROGRAM_ID,   NTF_GET, &ntfmgr_handle_get_slm_program_id_cmd},
                                 {NTF_ENV_SENSOR_DATA,  NTF_GET, &ntfmgr_handle_get_env_sensor_data_cmd},
-                                {NTF_ENV_SENSOR_ERROR, NTF_GET, &ntfmgr_handle_get_env_sensor_rate_cmd}};
+                                {NTF_ENV_SENSOR_ERROR, NTF_GET, &ntfmgr_handle_get_env_sensor_rate_cmd},
+                                {NTF_SCHEDULER_STATS,  NTF_GET, &ntfmgr_handle_get_scheduler_stats_cmd}};
 
 uint8_t m_handlers_size;
 uint8_t m_buffer [NTF_MAX_MESSAGE_SIZE];
@@ -198,11 +205,21 @@ void ntfmgr_send_data(uint8_t clientID)
 void ntfmgr_prepare_header(NTF_CMD_ID id, NTF_REQ_TYPE req_type, uint8_t data_size)
 {
    m_bytes_count = 0;
-   m_bytes_count += string_format((char*)(m_buffer + m_bytes_count), "%.2u %.2u %.2u ", id, req_type, data_size);
+   m_bytes_count += string_format_n((char*)(m_buffer + m_bytes_count), NTF_MAX_MESSAGE_SIZE - m_bytes_count, "%.2u %.2u %.2u ", id, req_type, data_size);
 }
 void ntfmgr_write_to_buffer(uint8_t byte)
 {
-   m_bytes_count += string_format((char*)(m_buffer + m_bytes_count), "%.2u ", byte);
+   m_bytes_count += string_format_n((char*)(m_buffer + m_bytes_count), NTF_MAX_MESSAGE_SIZE - m_bytes_count, "%.2u ", byte);
+}
+void ntfmgr_write_u16_to_buffer(uint16_t value)
+{
+   ntfmgr_write_to_buffer((value >> 8) & 0xFF);
+   ntfmgr_write_to_buffer(value & 0xFF);
+}
+void ntfmgr_write_u32_to_buffer(uint32_t value)
+{
+   ntfmgr_write_u16_to_buffer((value >> 16) & 0xFFFF);
+   ntfmgr_write_u16_to_buffer(value & 0xFFFF);
 }
 void ntfmgr_write_inputs_to_buffer(const INPUT_STATUS* inputs, uint8_t input_no)
 {
@@ -561,3 +578,24 @@ RET_CODE ntfmgr_handle_get_env_sensor_rate_cmd(const NTF_MESSAGE* msg)
    }
    return result;
 }
+RET_CODE ntfmgr_handle_get_scheduler_stats_cmd(const NTF_MESSAGE* msg)
+{
+   RET_CODE result = RETURN_NOK;
+   SchTaskStats stats;
+   if (msg->data_size == 1 && sch_get_task_stats(msg->data[0], &stats) == RETURN_OK)
+   {
+      ntfmgr_prepare_header(NTF_SCHEDULER_STATS, NTF_GET, 27);
+      ntfmgr_write_to_buffer((uint8_t) NTF_REPLY_OK);
+      ntfmgr_write_to_buffer(msg->data[0]);
+      ntfmgr_write_to_buffer((uint8_t) stats.priority);
+      ntfmgr_write_u16_to_buffer(stats.period);
+      ntfmgr_write_u32_to_buffer(stats.calls);
+      ntfmgr_write_u32_to_buffer(stats.last_time_us);
+      ntfmgr_write_u32_to_buffer(stats.max_time_us);
+      ntfmgr_write_u32_to_buffer(stats.calls? stats.total_time_us / stats.calls : 0);
+      ntfmgr_write_u32_to_buffer(stats.max_latency_us);
+      ntfmgr_write_u16_to_buffer(stats.overruns);
+      result = RETURN_OK;
+   }
+   return result;
+}
@@ -14,6 +14,7 @@ extern "C" {
 #include "stairs_led_module_mock.h"
 #include "env_monitor_mock.h"
 #include "time_counter_mock.h"
+#include "task_scheduler_mock.h"
 #include "wifimanager_mock.h"
 #include "logger_mock.h"
 
@@ -44,6 +45,7 @@ struct ntfmgrFixture : public ::testing::Test
       mock_fan_init();
       mock_slm_init();
       mock_time_counter_init();
+      mock_sch_init();
       mock_wifimgr_init();
       mock_logger_init();
       EXPECT_CALL(*inp_mock, inp_add_input_listener(_)).WillOnce(Return(RETURN_OK));
@@ -63,6 +65,7 @@ struct ntfmgrFixture : public ::testing::Test
       mock_fan_deinit();
       mock_slm_deinit();
       mock_time_counter_deinit();
+      mock_sch_deinit();
       mock_wifimgr_deinit();
       mock_logger_deinit();
    }
@@ -738,3 +741,52 @@ TEST_F(ntfmgrFixture, system_status_commands)
       ntfmgr_parse_request(1, command);
    }
 }
+
+/**
+ * @test This test case covers commands related to task scheduler.
+ */
+TEST_F(ntfmgrFixture, scheduler_stats_commands)
+{
+   /**
+    * <b>scenario</b>: Get scheduler stats command received for existing task.<br>
+    * <b>expected</b>: Correct NTF message sent.<br>
+    * ************************************************
+    */
+   {
+      const char* command = "12 00 01 03";
+      const char* exp = "12 00 27 01 03 01 00 100 00 00 01 04 00 00 01 44 00 00 02 136 00 00 01 144 00 01 134 160 00 02\n";
+      SchTaskStats stats = {};
+      stats.priority = TASKPRIO_HIGH;
+      stats.period = 100;
+      stats.calls = 260;
+      stats.last_time_us = 300;
+      stats.max_time_us = 648;
+      stats.total_time_us = 260 * 400;
+      stats.max_latency_us = 100000;
+      stats.overruns = 2;
+      EXPECT_CALL(*wifimgr_mock, wifimgr_send_bytes(1, _,_)).WillOnce(Invoke([&](ServerClientID, const uint8_t* data, uint16_t size) -> RET_CODE
+      {
+         EXPECT_STREQ((char*)data, exp);
+         return RETURN_OK;
+      }));
+      EXPECT_CALL(*sch_mock, sch_get_task_stats(3, _)).WillOnce(DoAll(SetArgPointee<1>(stats), Return(RETURN_OK)));
+      ntfmgr_parse_request(1, (char*) command);
+   }
+
+   /**
+    * <b>scenario</b>: Get scheduler stats command received for not existing task.<br>
+    * <b>expected</b>: NOK reply sent.<br>
+    * ************************************************
+    */
+   {
+      const char* command = "12 00 01 20";
+      const char* exp = "12 00 01 02\n";
+      EXPECT_CALL(*wifimgr_mock, wifimgr_send_bytes(1, _,_)).WillOnce(Invoke([&](ServerClientID, const uint8_t* data, uint16_t size) -> RET_CODE
+      {
+         EXPECT_STREQ((char*)data, exp);
+         return RETURN_OK;
+      }));
+      EXPECT_CALL(*sch_mock, sch_get_task_stats(20, _)).WillOnce(Return(RETURN_NOK));
+      ntfmgr_parse_request(1, (char*) command);
+   }
+}
@@ -17,6 +17,11 @@
  * I2C_STATE_NTF:      [HW_STUB_EVENT_ID] [PAYLOAD_SIZE] [I2C_ADDRESS] [I2C_BYTE0] [I2C_BYTE N-1]
  * DHT_STATE_SET:      [HW_STUB_EVENT_ID] [PAYLOAD_SIZE] [SENSOR_ID] [SENSOR_TYPE] [TEMP_H] [TEMP_L] [HUM_H] [HUM_L]
  * I2C_INT_TRIGGER:    [HW_STUB_EVENT_ID] [PAYLOAD_SIZE]
+ * TIME_MODE_SET:      [HW_STUB_EVENT_ID] [PAYLOAD_SIZE] [TIME_SIM_MODE] [FACTOR_H] [FACTOR_L]
+ * TIME_STEP:          [HW_STUB_EVENT_ID] [PAYLOAD_SIZE] [MS_3] [MS_2] [MS_1] [MS_0]
+ * TIME_STEP_NTF:      [HW_STUB_EVENT_ID] [PAYLOAD_SIZE]
+ *
+ * TIME_STEP_NTF is sent when all requested steps of virtual time are handled, see time_counter_sim.h.
  *
  * @author Jacek Skowronek
  * @date 23/02/2021
@@ -44,6 +49,9 @@ typedef enum
    I2C_STATE_NTF = 2,       /*< Event sent to test framework to notify that new data was written to I2C device */
    DHT_STATE_SET = 3,       /*< Sets current state of DHT sensor */
    I2C_INT_TRIGGER = 4,     /*< Event to simulate I2C interrupt */
+   TIME_MODE_SET = 5,       /*< Sets mode of simulated time (real, accelerated, stepped) */
+   TIME_STEP = 6,           /*< Moves virtual time forward in stepped mode */
+   TIME_STEP_NTF = 7,       /*< Event sent to test framework when requested time step is completed */
    HW_STUB_EV_ENUM_COUNT,
 } HW_STUB_EVENT_ID;
 
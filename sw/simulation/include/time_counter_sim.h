@@ -0,0 +1,65 @@
+#ifndef _TIME_COUNTER_SIM_H
+#define _TIME_COUNTER_SIM_H
+
+/* ============================= */
+/**
+ * @file time_counter_sim.h
+ *
+ * @brief Virtual time control of simulated time counter.
+ *
+ * @details
+ * In simulation the time is driven by separate thread. By default it follows real time,
+ * but it can be switched to virtual time, so long scenarios can be executed faster:
+ * - TIME_SIM_ACCELERATED - virtual time runs factor times faster than real time,
+ * - TIME_SIM_STEPPED - virtual time is moved only on request (time_sim_step()), as fast as possible.
+ * Virtual time is calculated from absolute anchor point, so there is no drift.
+ * In stepped mode, time thread waits until the main loop handled the ticks before moving forward.
+ */
+/* ============================= */
+/* =============================
+ *  Includes of common headers
+ * =============================*/
+#include <stdint.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "return_codes.h"
+/* =============================
+ *       Data structures
+ * =============================*/
+typedef enum
+{
+/* Below enumerations are used by test framework, any change here must lead to change in both places*/
+   TIME_SIM_REALTIME = 0,     /*< Virtual time equal to real time */
+   TIME_SIM_ACCELERATED = 1,  /*< Virtual time is factor times faster than real time */
+   TIME_SIM_STEPPED = 2,      /*< Virtual time moved only on request */
+   TIME_SIM_MODE_COUNT,
+} TimeSimMode;
+
+/**
+ * @brief Set mode of simulated time.
+ * @param[in] mode - Requested mode
+ * @param[in] factor - Speed-up factor, used only in TIME_SIM_ACCELERATED mode
+ * @return See RETURN_CODES.
+ */
+RET_CODE time_sim_set_mode(TimeSimMode mode, uint16_t factor);
+/**
+ * @brief Get current mode of simulated time.
+ * @return Current mode.
+ */
+TimeSimMode time_sim_get_mode();
+/**
+ * @brief Move virtual time forward, only in TIME_SIM_STEPPED mode.
+ * @details
+ * Requests are accumulated, time is moved in basetime ticks.
+ * @param[in] ms - Time in milliseconds
+ * @return See RETURN_CODES.
+ */
+RET_CODE time_sim_step(uint32_t ms);
+/**
+ * @brief Get time left to complete requested steps.
+ * @return Time in milliseconds, 0 when all requested steps are handled by main loop.
+ */
+uint32_t time_sim_get_step_remaining();
+
+#endif
@@ -17,6 +17,8 @@
 #include "system_config_values.h"
 #include "Logger.h"
 #include "socket_driver.h"
+#include "event_queue.h"
+#include "ring_buffer.h"
 /* =============================
  *          Defines
  * =============================*/
@@ -27,25 +29,19 @@
 void btengine_notify_callbacks();
 RET_CODE btengine_get_string_from_buffer();
 void btengine_on_socket_data(SOCK_DRV_EV ev, const char* data);
-/* =============================
- *       Internal types
- * =============================*/
-typedef struct
-{
-   char * buf;
-   uint16_t tail;
-   uint16_t head;
-   uint8_t string_cnt;
-   uint16_t bytes_cnt;
-} BT_BUFFER;
+void btengine_on_string(uint32_t arg);
+uint8_t btengine_count_strings();
 /* =============================
  *      Module variables
  * =============================*/
 BT_Config config;
-volatile BT_BUFFER bt_rx_buf;
+RING_BUFFER bt_rx_buf;
+volatile uint8_t bt_rx_strings;  /**< Lines received, written in socket thread only */
+uint8_t bt_rx_strings_read;      /**< Lines read, written in main loop only */
 sock_id m_bt_sock_id;
 char* bt_rx_string;
 void (*BT_CALLBACKS[BT_ENGINE_CALLBACK_SIZE])(const char *);
+EVQ bt_rx_events;   /**< One event per received line, produced in socket thread */
 
 
 
@@ -54,15 +50,16 @@ RET_CODE btengine_initialize(BT_Config* cfg)
    RET_CODE result = RETURN_ERROR;
    config = *cfg;
 
-   bt_rx_buf.buf = (char*) malloc (sizeof(char)*config.buffer_size);
+   /* ring buffer needs power of 2 size */
+   uint16_t buffer_size = rb_align_size(config.buffer_size);
+   uint8_t* rx_buf = (uint8_t*) malloc (buffer_size);
    bt_rx_string = (char*) malloc (sizeof(char)*config.string_size);
+   bt_rx_strings = 0;
+   bt_rx_strings_read = 0;
+   evq_init(&bt_rx_events);
+   evq_register(&bt_rx_events);
 
-   bt_rx_buf.head = 0;
-   bt_rx_buf.tail = 0;
-   bt_rx_buf.string_cnt = 0;
-   bt_rx_buf.bytes_cnt = 0;
-
-   if (bt_rx_buf.buf && bt_rx_buf.buf && bt_rx_string)
+   if (rb_init(&bt_rx_buf, rx_buf, buffer_size) == RETURN_OK && bt_rx_string)
    {
       m_bt_sock_id = sockdrv_create(NULL, BLUETOOTH_FORWARDING_PORT);
       if (m_bt_sock_id < 0)
@@ -84,23 +81,25 @@ void btengine_on_socket_data(SOCK_DRV_EV ev, const char* data)
 {
    if (ev == SOCK_DRV_NEW_DATA && data)
    {
-      uint8_t bytes_handled = 0;
-      while(*data)
+      /* line is accepted only when it fits with '\n' */
+      uint16_t size = strlen(data);
+      if (rb_get_space(&bt_rx_buf) > size)
+      {
+         rb_push_n(&bt_rx_buf, (const uint8_t*)data, size);
+         rb_push(&bt_rx_buf, '\n');
+         bt_rx_strings++;
+         evq_push(&bt_rx_events, &btengine_on_string, 0);
+      }
+      else
       {
-         bt_rx_buf.buf[bt_rx_buf.head++] = *data;
-         if (bt_rx_buf.head == config.buffer_size)
-         {
-            bt_rx_buf.head = 0;
-         }
-         data++;
+         logger_send(LOG_ERROR, __func__, "rx buffer full");
       }
-      bt_rx_buf.buf[bt_rx_buf.head++] = '\n';
-      bt_rx_buf.string_cnt++;
    }
 }
 
 void btengine_deinitialize()
 {
+   evq_unregister(&bt_rx_events);
    sockdrv_close(m_bt_sock_id);
    sockdrv_remove_listener(m_bt_sock_id);
    free(bt_rx_buf.buf);
@@ -118,6 +117,12 @@ RET_CODE btengine_send_string(const char * buffer)
    return btengine_send_bytes((const uint8_t*)buffer, strlen(buffer));
 }
 
+RET_CODE btengine_try_send_string(const char * buffer)
+{
+   /* socket write does not wait for the other side */
+   return btengine_send_string(buffer);
+}
+
 RET_CODE btengine_send_bytes(const uint8_t* data, uint16_t size)
 {
    return sockdrv_write(m_bt_sock_id, data, size);
@@ -127,7 +132,7 @@ RET_CODE btengine_can_read_string()
 {
    RET_CODE result = RETURN_NOK;
 
-   if (bt_rx_buf.string_cnt > 0)
+   if (btengine_count_strings() > 0)
    {
       result = RETURN_OK;
    }
@@ -146,46 +151,52 @@ const char* btengine_get_string()
 
 void btengine_clear_rx()
 {
-   bt_rx_buf.tail = bt_rx_buf.head;
-   bt_rx_buf.string_cnt = 0;
-   bt_rx_buf.bytes_cnt = 0;
+   rb_flush(&bt_rx_buf);
+   bt_rx_strings_read = bt_rx_strings;
+}
+
+uint8_t btengine_count_strings()
+{
+   return (uint8_t)(bt_rx_strings - bt_rx_strings_read);
 }
 
 RET_CODE btengine_get_string_from_buffer()
 {
-   char* buffer = bt_rx_string;
-   if (!bt_rx_buf.buf || bt_rx_buf.string_cnt == 0 || !buffer)
+   if (!bt_rx_buf.buf || btengine_count_strings() == 0 || !bt_rx_string)
    {
       return RETURN_ERROR;
    }
 
-   char c;
-   while (1)
+   uint16_t length = 0;
+   uint8_t line_end = 0;
+   while (!line_end)
    {
-      c = bt_rx_buf.buf[bt_rx_buf.tail];
-      bt_rx_buf.tail++;
-      bt_rx_buf.bytes_cnt--;
-      if (bt_rx_buf.tail == config.buffer_size)
-      {
-         bt_rx_buf.tail = 0;
-      }
-      if (c != '\r' && c != '\n')
+      const uint8_t* data;
+      uint16_t size = rb_get_read_view(&bt_rx_buf, &data);
+      if (!size)
       {
-         *buffer = c;
+         break;
       }
-      else
+      const uint8_t* end = (const uint8_t*)memchr(data, '\n', size);
+      if (end)
       {
-         *buffer = 0x00;
+         size = end - data + 1;
+         line_end = 1;
       }
-      if (c == '\n')
+      /* the end of too long line is dropped */
+      uint16_t copy = size;
+      if (copy > config.string_size - 1 - length)
       {
-         *buffer = 0x00;
-         break;
+         copy = config.string_size - 1 - length;
       }
-      buffer++;
-
+      memcpy(bt_rx_string + length, data, copy);
+      length += copy;
+      rb_consume(&bt_rx_buf, size);
    }
-   bt_rx_buf.string_cnt--;
+   bt_rx_string[length] = 0x00;
+   /* line ends on first CR or LF */
+   bt_rx_string[strcspn(bt_rx_string, "\r\n")] = 0x00;
+   bt_rx_strings_read++;
    return RETURN_OK;
 }
 
@@ -243,6 +254,11 @@ void btengine_notify_callbacks()
 }
 
 void btengine_string_watcher()
+{
+   evq_dispatch(&bt_rx_events);
+}
+
+void btengine_on_string(uint32_t arg)
 {
    if (btengine_can_read_string())
    {
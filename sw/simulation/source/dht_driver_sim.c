@@ -8,6 +8,7 @@
 #include "dht_driver.h"
 #include "Logger.h"
 #include "hw_stub.h"
+#include "event_queue.h"
 /* =============================
  *          Defines
  * =============================*/
@@ -22,6 +23,7 @@
  *   Internal module functions
  * =============================*/
 RET_CODE dht_verify_timeout(uint16_t);
+void dht_on_measurement_end(uint32_t arg);
 /* =============================
  *       Internal types
  * =============================*/
@@ -53,7 +55,7 @@ typedef struct DHT_DRIVER
 uint32_t DHT_MEASURE_TIMESTAMPS[DHT_TIMESTAMPS_BUFFER_SIZE];
 DHT_SENSOR_MASKS DHT_REG_MAP[DHT_ENUM_MAX];
 volatile uint8_t dht_timestamp_idx;
-volatile uint8_t dht_measurement_ready;
+EVQ dht_events;
 DHT_DRIVER dht_driver;
 DHT_CALLBACK dht_callback;
 
@@ -64,7 +66,8 @@ RET_CODE dht_initialize()
    logger_send(LOG_DHT_DRV, __func__, "start");
    dht_driver.state = DHT_STATE_IDLE;
    dht_driver.timeout = DHT_DEFAULT_TIMEOUT_MS;
-   dht_measurement_ready = 0;
+   evq_init(&dht_events);
+   evq_register(&dht_events);
    result = RETURN_OK;
    logger_send(LOG_DHT_DRV, __func__, "end");
    return result;
@@ -76,7 +79,7 @@ RET_CODE dht_read_async(DHT_SENSOR_ID id, DHT_CALLBACK clb)
    if (hwstub_dht_read(id, &dht_driver.sensor) == DHT_STATUS_OK)
    {
       result = RETURN_OK;
-      dht_measurement_ready = 1;
+      evq_push(&dht_events, &dht_on_measurement_end, 0);
    }
    dht_callback = clb;
    logger_send(LOG_DHT_DRV, __func__, "read sync status %d", result);
@@ -120,13 +123,14 @@ uint16_t dht_get_timeout()
 
 void dht_data_watcher()
 {
-   if (dht_measurement_ready == 1)
+   evq_dispatch(&dht_events);
+}
+
+void dht_on_measurement_end(uint32_t arg)
+{
+   if (dht_callback)
    {
-      dht_measurement_ready = 0;
-      if (dht_callback)
-      {
-         dht_callback(DHT_STATUS_OK, &dht_driver.sensor);
-      }
-      dht_driver.state = DHT_STATE_IDLE;
+      dht_callback(DHT_STATUS_OK, &dht_driver.sensor);
    }
+   dht_driver.state = DHT_STATE_IDLE;
 }
@@ -4,6 +4,7 @@
 #include "Logger.h"
 #include "inputs_board.h"
 #include "system_config_values.h"
+#include "time_counter_sim.h"
 #include <string.h>
 
 #define I2C_BOARD_DATA_SIZE 2
@@ -50,6 +51,7 @@ typedef struct
    DHT_SENSORS_STUB dht_sensors;
    HWSTUB_BUFFER buffer;
    void(*notify_wifimgr)(ClientEvent ev, ServerClientID id, const char* data);
+   uint8_t time_step_pending;
 } HWSTUB;
 
 
@@ -61,6 +63,9 @@ I2C_BOARD* hwstub_get_board_by_address(I2C_ADDRESS addr);
 RET_CODE hwstub_set_i2c_device_state(I2C_ADDRESS addr, const uint8_t* data);
 RET_CODE hwstub_set_dht_device_state(DHT_SENSOR_ID id, const uint8_t* data);
 RET_CODE hwstub_handle_wifi_client_event();
+RET_CODE hwstub_set_time_mode(const uint8_t* data);
+RET_CODE hwstub_time_step(const uint8_t* data);
+void hwstub_send_time_step_notification();
 
 HWSTUB m_hw_stub;
 
@@ -80,6 +85,7 @@ void hwstub_init()
    m_hw_stub.led_board.state[0] = 0x00;
    m_hw_stub.led_board.state[1] = 0x00;
    m_hw_stub.notify_wifimgr = NULL;
+   m_hw_stub.time_step_pending = 0;
    pthread_mutex_init(&m_hw_stub.buffer.buffer_mutex, NULL);
    pthread_mutex_init(&m_hw_stub.wifi_board.last_event.mutex, NULL);
    m_hw_stub.buffer.buffer_changed = 0;
@@ -163,6 +169,11 @@ void hwstub_watcher()
    {
       hwstub_handle_wifi_client_event();
    }
+   if (m_hw_stub.time_step_pending && time_sim_get_step_remaining() == 0)
+   {
+      m_hw_stub.time_step_pending = 0;
+      hwstub_send_time_step_notification();
+   }
 }
 void hwstub_parse_command_from_buffer()
 {
@@ -182,6 +193,12 @@ void hwstub_parse_command_from_buffer()
       case I2C_INT_TRIGGER:
          inp_on_interrupt_recevied();
          break;
+      case TIME_MODE_SET:
+         hwstub_set_time_mode(buffer + HWSTUB_PAYLOAD_START_OFFSET);
+         break;
+      case TIME_STEP:
+         hwstub_time_step(buffer + HWSTUB_PAYLOAD_START_OFFSET);
+         break;
       default:
          logger_send(LOG_ERROR, __func__, "unsupported HWSTUB_EVENT");
          break;
@@ -278,6 +295,48 @@ RET_CODE hwstub_handle_wifi_client_event()
    }
    return result;
 }
+RET_CODE hwstub_set_time_mode(const uint8_t* data)
+{
+   uint16_t factor = ((uint16_t)data[1] << 8) | data[2];
+   RET_CODE result = time_sim_set_mode((TimeSimMode)data[0], factor);
+   if (result == RETURN_OK)
+   {
+      m_hw_stub.time_step_pending = 0;
+      logger_send(LOG_SIM, __func__, "Set time mode %u, factor %u", data[0], factor);
+   }
+   else
+   {
+      logger_send(LOG_ERROR, __func__, "Cannot set time mode %u, factor %u", data[0], factor);
+   }
+   return result;
+}
+RET_CODE hwstub_time_step(const uint8_t* data)
+{
+   uint32_t ms = ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+   RET_CODE result = time_sim_step(ms);
+   if (result == RETURN_OK)
+   {
+      m_hw_stub.time_step_pending = 1;
+      logger_send(LOG_SIM, __func__, "Time step %u ms", ms);
+   }
+   else
+   {
+      logger_send(LOG_ERROR, __func__, "Time step not possible in mode %u", time_sim_get_mode());
+   }
+   return result;
+}
+void hwstub_send_time_step_notification()
+{
+   uint16_t buf_idx = 0;
+   pthread_mutex_lock(&m_hw_stub.buffer.buffer_mutex);
+   buf_idx += string_format(&m_hw_stub.buffer.buffer[buf_idx], "%.2u %.2u\n", TIME_STEP_NTF, 0);
+
+   if (sockdrv_write(m_hw_stub.control_id, m_hw_stub.buffer.buffer, buf_idx) != RETURN_OK)
+   {
+      logger_send(LOG_ERROR, __func__, "cannot sent data");
+   }
+   pthread_mutex_unlock(&m_hw_stub.buffer.buffer_mutex);
+}
 void hwstub_on_new_app_data(SOCK_DRV_EV ev, const char* data)
 {
    /* this is called from another thread */
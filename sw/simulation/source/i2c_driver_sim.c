@@ -7,6 +7,7 @@
 #include "i2c_driver.h"
 #include "Logger.h"
 #include "hw_stub.h"
+#include "event_queue.h"
 /* =============================
  *          Defines
  * =============================*/
@@ -20,6 +21,7 @@
 RET_CODE i2c_validate_timeout(uint16_t timeout);
 void i2c_print_buffer(I2C_OP_TYPE type);
 I2C_STATUS i2c_get_status();
+void i2c_on_transaction_end(uint32_t arg);
 /* =============================
  *       Internal types
  * =============================*/
@@ -29,7 +31,6 @@ typedef struct I2C_DRIVER_TYPE
    I2C_STATUS status;
    I2C_OP_TYPE type;
    uint16_t timeout;
-   uint8_t transaction_ready;
    uint16_t bytes_handled;
 } I2C_DRIVER_TYPE;
 /* =============================
@@ -38,13 +39,15 @@ typedef struct I2C_DRIVER_TYPE
 uint8_t I2C_DRV_BUF[I2C_DRV_BUFFER_SIZE];
 volatile I2C_DRIVER_TYPE i2c_driver;
 I2C_CALLBACK i2c_drv_callback;
+EVQ i2c_events;
 
 RET_CODE i2c_initialize()
 {
    logger_send(LOG_SIM, __func__, "");
    i2c_driver.address = 0;
    i2c_driver.timeout = I2C_DEFAULT_TIMEOUT_MS;
-   i2c_driver.transaction_ready = 0;
+   evq_init(&i2c_events);
+   evq_register(&i2c_events);
    i2c_reset();
    return RETURN_OK;
 }
@@ -55,7 +58,7 @@ RET_CODE i2c_write_async(I2C_ADDRESS address, const uint8_t* data, uint8_t size,
    hwstub_i2c_write(address, data, size);
    i2c_driver.bytes_handled = size;
    i2c_driver.type = I2C_OP_WRITE;
-   i2c_driver.transaction_ready = 1;
+   evq_push(&i2c_events, &i2c_on_transaction_end, 0);
    return RETURN_OK;
 }
 I2C_STATUS i2c_write(I2C_ADDRESS address, const uint8_t* data, uint8_t size)
@@ -78,7 +81,7 @@ RET_CODE i2c_read_async(I2C_ADDRESS address, uint8_t size, I2C_CALLBACK callback
    {
       i2c_driver.bytes_handled = size;
       i2c_driver.type = I2C_OP_READ;
-      i2c_driver.transaction_ready = 1;
+      evq_push(&i2c_events, &i2c_on_transaction_end, 0);
    }
    return res;
 }
@@ -143,6 +146,7 @@ void i2c_reset()
 }
 void i2c_deinitialize()
 {
+   evq_unregister(&i2c_events);
 }
 
 I2C_STATUS i2c_get_status()
@@ -152,14 +156,15 @@ I2C_STATUS i2c_get_status()
 
 void i2c_watcher()
 {
-   if (i2c_driver.transaction_ready)
+   evq_dispatch(&i2c_events);
+}
+
+void i2c_on_transaction_end(uint32_t arg)
+{
+   logger_send(LOG_SIM, __func__, "transaction ready, calling callbacks");
+   i2c_print_buffer(i2c_driver.type);
+   if (i2c_drv_callback)
    {
-      logger_send(LOG_SIM, __func__, "transaction ready, calling callbacks");
-      i2c_driver.transaction_ready = 0;
-      i2c_print_buffer(i2c_driver.type);
-      if (i2c_drv_callback)
-      {
-         i2c_drv_callback(i2c_driver.type, I2C_STATUS_OK, I2C_DRV_BUF, i2c_driver.bytes_handled);
-      }
+      i2c_drv_callback(i2c_driver.type, I2C_STATUS_OK, I2C_DRV_BUF, i2c_driver.bytes_handled);
    }
 }
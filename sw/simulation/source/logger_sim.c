@@ -19,6 +19,8 @@
  *   Internal module functions
  * =============================*/
 void logger_notify_data(const char* data);
+void logger_send_va(LogGroup group, const char* prefix, const char* fmt, va_list va);
+void logger_update_active_groups();
 /* =============================
  *       Internal types
  * =============================*/
@@ -39,6 +41,7 @@ typedef struct LOG_GROUP
  *      Module variables
  * =============================*/
 Logger logger;
+volatile uint32_t logger_active_groups;
 RET_CODE (*LOGGER_SENDERS[LOGGER_MAX_SENDERS])(const char *);
 LOG_GROUP LOGGER_GROUPS[LOG_ENUM_MAX] = {
       {LOGGER_GROUP_ENABLE, LOG_ERROR, "ERROR"},
@@ -102,8 +105,54 @@ RET_CODE logger_unregister_sender(RET_CODE(*send_fnc)(const char*))
    return result;
 }
 
+LOGGER_SINK logger_add_sink(const LoggerSinkConfig* config)
+{
+   /* simulation sends every log immediately, filter and queue of sink are ignored */
+   LOGGER_SINK result = LOGGER_INVALID_SINK;
+   for (uint8_t i=0; config && config->send && i < LOGGER_MAX_SENDERS; i++)
+   {
+      if (LOGGER_SENDERS[i] == NULL)
+      {
+         LOGGER_SENDERS[i] = config->send;
+         result = i;
+         break;
+      }
+   }
+   return result;
+}
+
+RET_CODE logger_remove_sink(LOGGER_SINK sink)
+{
+   RET_CODE result = RETURN_NOK;
+   if (sink < LOGGER_MAX_SENDERS && LOGGER_SENDERS[sink] != NULL)
+   {
+      LOGGER_SENDERS[sink] = NULL;
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE logger_set_sink_filter(LOGGER_SINK sink, uint32_t groups, uint8_t level)
+{
+   return (sink < LOGGER_MAX_SENDERS && LOGGER_SENDERS[sink] != NULL)? RETURN_OK : RETURN_NOK;
+}
+
+RET_CODE logger_get_sink_filter(LOGGER_SINK sink, uint32_t* groups, uint8_t* level)
+{
+   *groups = LOGGER_ALL_GROUPS;
+   *level = LOGGER_LEVEL_TRACE;
+   return (sink < LOGGER_MAX_SENDERS && LOGGER_SENDERS[sink] != NULL)? RETURN_OK : RETURN_NOK;
+}
+
+uint32_t logger_get_sink_dropped(LOGGER_SINK sink)
+{
+   return 0;
+}
+
 void logger_deinitialize()
 {
+   logger.is_enabled = 0;
+   logger_update_active_groups();
    free(logger.buffer);
    logger.is_initialized = 0;
    for (uint8_t i = 0; i < LOGGER_MAX_SENDERS; i++)
@@ -118,6 +167,7 @@ RET_CODE logger_enable()
    if (logger.is_initialized)
    {
       logger.is_enabled = 1;
+      logger_update_active_groups();
       result = RETURN_OK;
    }
 
@@ -127,6 +177,7 @@ RET_CODE logger_enable()
 void logger_disable()
 {
    logger.is_enabled = 0;
+   logger_update_active_groups();
 }
 RET_CODE logger_set_group_state(LogGroup group, uint8_t state)
 {
@@ -137,6 +188,7 @@ RET_CODE logger_set_group_state(LogGroup group, uint8_t state)
       if (LOGGER_GROUPS[group].state != state)
       {
          LOGGER_GROUPS[group].state = state;
+         logger_update_active_groups();
          result = RETURN_OK;
       }
    }
@@ -175,6 +227,27 @@ void logger_send(LogGroup group, const char* prefix, const char* fmt, ...)
    }
 }
 
+void logger_send_level(uint8_t level, LogGroup group, const char* prefix, const char* fmt, ...)
+{
+   if (logger.is_enabled && group < LOG_ENUM_MAX && LOGGER_GROUPS[group].state == LOGGER_GROUP_ENABLE)
+   {
+      va_list va;
+      va_start(va, fmt);
+      logger_send_va(group, prefix, fmt, va);
+      va_end(va);
+   }
+}
+
+void logger_send_va(LogGroup group, const char* prefix, const char* fmt, va_list va)
+{
+   TimeItem* time = time_get();
+   int offset = string_format(logger.buffer, "[%.2d-%.2d-%d %.2d:%.2d:%.2d:%.3d] - %s - %s:", time->day, time->month, time->year, time->hour, time->minute, time->second, time->msecond,
+         LOGGER_GROUPS[group].name, prefix);
+   int length = sf_format_string(logger.buffer+offset, fmt, va);
+   logger.buffer[offset + length] = 0x00;
+   logger_notify_data(logger.buffer);
+}
+
 void logger_notify_data(const char* data)
 {
    for (uint8_t i = 0; i < LOGGER_MAX_SENDERS; i++)
@@ -210,6 +283,55 @@ void logger_send_if(uint8_t cond_bool, LogGroup group, const char* prefix, const
    }
 }
 
+RET_CODE logger_set_deferred(uint8_t state)
+{
+   /* simulation has no interrupts, logs are always sent immediately */
+   return state? RETURN_NOK : RETURN_OK;
+}
+
+uint32_t logger_get_dropped_count()
+{
+   return 0;
+}
+
+RET_CODE logger_set_rate_limit(uint16_t burst, uint16_t rate)
+{
+   /* simulation sends every log */
+   return burst? RETURN_NOK : RETURN_OK;
+}
+
+void logger_get_rate_limit(uint16_t* burst, uint16_t* rate)
+{
+   *burst = 0;
+   *rate = 0;
+}
+
+RET_CODE logger_set_binary_sender(RET_CODE(*send_fnc)(const uint8_t*, uint16_t))
+{
+   /* binary frames are sent only in deferred mode */
+   return send_fnc? RETURN_NOK : RETURN_OK;
+}
+
+void logger_watcher()
+{
+}
+
+void logger_update_active_groups()
+{
+   uint32_t mask = 0;
+   if (logger.is_enabled)
+   {
+      for (uint8_t i = 0; i < LOG_ENUM_MAX; i++)
+      {
+         if (LOGGER_GROUPS[i].state == LOGGER_GROUP_ENABLE)
+         {
+            mask |= (uint32_t)1 << i;
+         }
+      }
+   }
+   logger_active_groups = mask;
+}
+
 const char* logger_group_to_string(LogGroup group)
 {
    const char* result = "";
@@ -0,0 +1,172 @@
+/* =============================
+ *   Includes of common headers
+ * =============================*/
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "rtc_driver.h"
+#include "event_queue.h"
+/* =============================
+ *          Defines
+ * =============================*/
+/* host clock counts from 01.01.1970, calendar from 01.01.2000 */
+#define RTC_HOST_EPOCH_OFFSET_S 946684800ULL
+/* =============================
+ *   Internal module functions
+ * =============================*/
+int64_t rtc_get_host_ms();
+uint64_t rtc_get_epoch_ms();
+void *rtc_thread_execute(void* arg);
+void rtc_on_alarm(uint32_t arg);
+/* =============================
+ *      Module variables
+ * =============================*/
+/* Simulated RTC is battery backed: it follows host UTC clock, so calendar is valid from start */
+int64_t rtc_offset_ms;            /**< Difference between RTC and host clock */
+EVQ rtc_events;                   /**< Alarm notification, produced in RTC thread */
+void(*rtc_alarm_callback)(TimeItem*);
+uint64_t rtc_alarm_ms;            /**< Epoch time of alarm, 0 if disabled */
+uint8_t rtc_thread_running;
+pthread_t rtc_thread;
+pthread_mutex_t rtc_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t rtc_cond = PTHREAD_COND_INITIALIZER;
+
+
+RET_CODE rtc_initialize()
+{
+   rtc_alarm_callback = NULL;
+   rtc_alarm_ms = 0;
+   evq_init(&rtc_events);
+   evq_register(&rtc_events);
+   rtc_thread_running = 1;
+   return pthread_create(&rtc_thread, NULL, rtc_thread_execute, NULL) == 0? RETURN_OK : RETURN_NOK;
+}
+
+void rtc_deinitialize()
+{
+   pthread_mutex_lock(&rtc_mutex);
+   rtc_thread_running = 0;
+   rtc_alarm_ms = 0;
+   pthread_cond_signal(&rtc_cond);
+   pthread_mutex_unlock(&rtc_mutex);
+   pthread_join(rtc_thread, NULL);
+   evq_unregister(&rtc_events);
+}
+
+RET_CODE rtc_is_calendar_valid()
+{
+   return RETURN_OK;
+}
+
+RET_CODE rtc_set_calendar(const TimeItem* item)
+{
+   RET_CODE result = RETURN_NOK;
+   if (item)
+   {
+      pthread_mutex_lock(&rtc_mutex);
+      rtc_offset_ms = (int64_t)time_to_epoch_ms(item) - rtc_get_host_ms();
+      /* alarm deadline has to be recalculated */
+      pthread_cond_signal(&rtc_cond);
+      pthread_mutex_unlock(&rtc_mutex);
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE rtc_get_calendar(TimeItem* item)
+{
+   RET_CODE result = RETURN_NOK;
+   if (item)
+   {
+      pthread_mutex_lock(&rtc_mutex);
+      uint64_t now = rtc_get_epoch_ms();
+      pthread_mutex_unlock(&rtc_mutex);
+      /* hardware resolution is 1/256s */
+      uint32_t ms = now % 1000;
+      now = now - ms + (ms * RTC_SUBSECONDS_PER_SECOND / 1000) * 1000 / RTC_SUBSECONDS_PER_SECOND;
+      time_from_epoch_ms(now, item);
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE rtc_set_alarm(const TimeItem* item, void(*callback)(TimeItem*))
+{
+   RET_CODE result = RETURN_NOK;
+   if (item && callback)
+   {
+      pthread_mutex_lock(&rtc_mutex);
+      rtc_alarm_callback = callback;
+      rtc_alarm_ms = time_to_epoch_ms(item);
+      pthread_cond_signal(&rtc_cond);
+      pthread_mutex_unlock(&rtc_mutex);
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+void rtc_cancel_alarm()
+{
+   pthread_mutex_lock(&rtc_mutex);
+   rtc_alarm_ms = 0;
+   rtc_alarm_callback = NULL;
+   pthread_mutex_unlock(&rtc_mutex);
+}
+
+int64_t rtc_get_host_ms()
+{
+   struct timespec now;
+   clock_gettime(CLOCK_REALTIME, &now);
+   return ((int64_t)now.tv_sec - RTC_HOST_EPOCH_OFFSET_S) * 1000 + now.tv_nsec / 1000000;
+}
+
+uint64_t rtc_get_epoch_ms()
+{
+   int64_t result = rtc_get_host_ms() + rtc_offset_ms;
+   return result > 0? (uint64_t)result : 0;
+}
+
+void *rtc_thread_execute(void* arg)
+{
+   pthread_mutex_lock(&rtc_mutex);
+   while (rtc_thread_running)
+   {
+      if (rtc_alarm_ms == 0)
+      {
+         pthread_cond_wait(&rtc_cond, &rtc_mutex);
+      }
+      else if (rtc_get_epoch_ms() >= rtc_alarm_ms)
+      {
+         /* alarm interrupt */
+         rtc_alarm_ms = 0;
+         evq_push(&rtc_events, &rtc_on_alarm, 0);
+      }
+      else
+      {
+         /* host clock is used as RTC clock, so the deadline is absolute */
+         int64_t deadline_ms = (int64_t)rtc_alarm_ms - rtc_offset_ms + RTC_HOST_EPOCH_OFFSET_S * 1000;
+         struct timespec deadline = {deadline_ms / 1000, (deadline_ms % 1000) * 1000000};
+         pthread_cond_timedwait(&rtc_cond, &rtc_mutex, &deadline);
+      }
+   }
+   pthread_mutex_unlock(&rtc_mutex);
+   return NULL;
+}
+
+void rtc_on_alarm(uint32_t arg)
+{
+   /* alarm is one-shot */
+   pthread_mutex_lock(&rtc_mutex);
+   void(*callback)(TimeItem*) = rtc_alarm_callback;
+   rtc_alarm_callback = NULL;
+   pthread_mutex_unlock(&rtc_mutex);
+   if (callback)
+   {
+      TimeItem now;
+      rtc_get_calendar(&now);
+      callback(&now);
+   }
+}
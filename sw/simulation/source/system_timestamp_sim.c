@@ -1,18 +1,25 @@
 /* =============================
  *   Includes of common headers
  * =============================*/
+#include <time.h>
 /* =============================
  *  Includes of project headers
  * =============================*/
 #include "system_timestamp.h"
+/* =============================
+ *   Internal module functions
+ * =============================*/
+uint64_t ts_get_monotonic_us();
 /* =============================
  *      Module variables
  * =============================*/
 volatile uint16_t system_timestamp;
+uint64_t ts_start_us;
 
 
 void ts_init()
 {
+   ts_start_us = ts_get_monotonic_us();
 }
 void ts_deinit()
 {
@@ -29,3 +36,22 @@ uint16_t ts_get_diff(uint16_t timestamp)
 {
    return 0;
 }
+uint32_t ts_get_cycles()
+{
+   /* emulate CPU cycle counter, overflow is expected */
+   return (uint32_t)(ts_get_monotonic_us() * TS_CYCLES_PER_US);
+}
+uint64_t ts_get_us()
+{
+   return ts_get_monotonic_us() - ts_start_us;
+}
+uint64_t ts_elapsed_us(uint64_t timestamp_us)
+{
+   return ts_get_us() - timestamp_us;
+}
+uint64_t ts_get_monotonic_us()
+{
+   struct timespec now;
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
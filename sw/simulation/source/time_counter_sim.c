@@ -5,25 +5,46 @@
 #include <stdio.h>
 #include <pthread.h>
 #include <unistd.h>
+#include <time.h>
 /* =============================
  *  Includes of project headers
  * =============================*/
 #include "time_counter.h"
+#include "time_counter_sim.h"
+#include "event_queue.h"
 /* =============================
  *          Defines
  * =============================*/
 #define TIME_CNT_CALLBACK_MAX_SIZE 10
 #define TIME_BASETIME_MS 10
+#define TIME_TICKLESS_MAX_MS 1000
+#define TIME_EPOCH_YEAR 2000
+#define TIME_SECONDS_PER_DAY 86400
+/* every 4 years have the same number of days in range 2000-2099 */
+#define TIME_DAYS_PER_4_YEARS 1461
+/* local time is corrected from calendar backend (e.g. RTC) once per period */
+#define TIME_BACKEND_SYNC_PERIOD_S 3600
 /* =============================
  *   Internal module functions
  * =============================*/
 RET_CODE time_is_time_ok(TimeItem* item);
-RET_CODE time_is_leap_year();
+RET_CODE time_is_leap_year(uint16_t year);
+uint8_t time_get_month_days(uint8_t month, uint16_t year);
+uint32_t time_calendar_to_seconds(const TimeItem* item);
+void time_seconds_to_calendar(uint32_t seconds, TimeItem* item);
 void time_increment_time(unsigned int value);
 void time_call_low_prio_callbacks();
+void time_on_low_prio_tick(uint32_t arg);
+RET_CODE time_apply_utc(TimeItem* item);
+RET_CODE time_sync_from_backend();
 void time_call_high_prio_callbacks();
+void time_call_callbacks(TimeCallbackPriority prio);
+void time_remove_callback(uint8_t slot);
 void *time_thread_execute();
-unsigned int get_timediff_ms(struct timespec* start, struct timespec* end);
+uint64_t get_timediff_us(struct timespec* start, struct timespec* end);
+void time_add_us(struct timespec* item, uint64_t us);
+uint64_t time_sim_get_virtual_ms();
+unsigned int time_get_wait_ms();
 void SysTick_Handler(unsigned int value);
 /* =============================
  *       Internal types
@@ -32,59 +53,162 @@ typedef struct TimeCallbackItem
 {
    TimeCallbackPriority priority;
    void(*fnc)(TimeItem*);
+   uint8_t generation;  /**< Incremented on unregister to invalidate handles */
 } TimeCallbackItem;
+
+/** Registered callbacks of one priority, kept compact so the tick touches only them */
+typedef struct TimeDispatchList
+{
+   void(*fnc[TIME_CNT_CALLBACK_MAX_SIZE])(TimeItem*);
+   uint8_t slot[TIME_CNT_CALLBACK_MAX_SIZE];  /**< Index of callback in TIME_CALLBACKS */
+   uint8_t size;
+} TimeDispatchList;
 /* =============================
  *      Module variables
  * =============================*/
-TimeItem timestamp;
-volatile uint8_t time_time_changed;
+/* Local time is kept as seconds from 01.01.2000 00:00:00, calendar is converted only on request */
+volatile uint32_t time_seconds;
+volatile uint16_t time_mseconds;
+TimeItem timestamp;              /**< Calendar cache of time_cache_seconds */
+uint32_t time_cache_seconds;
+pthread_mutex_t m_time_mutex = PTHREAD_MUTEX_INITIALIZER;
+EVQ time_low_prio_events;   /**< Low priority callbacks request, produced in time thread */
 TimeCallbackItem TIME_CALLBACKS[TIME_CNT_CALLBACK_MAX_SIZE];
+TimeDispatchList time_dispatch[TIME_PRIORITY_UNKNOWN];
 uint8_t winter_time_active = 1;
+const TimeCalendarBackend* time_backend;
+uint32_t time_backend_sync_seconds;   /**< Local time of last synchronization with backend */
 uint8_t month_day_cnt[13] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 uint8_t m_thread_running = 0;
 pthread_t m_thread;
 pthread_mutex_t m_mutex;
+pthread_cond_t m_cond;
+/* Virtual time is mapped to real time by anchor point and speed-up factor, so deadlines are absolute */
+TimeSimMode m_sim_mode;
+uint16_t m_sim_factor;
+struct timespec m_anchor;          /**< Real time of anchor point */
+uint64_t m_anchor_virtual_ms;      /**< Virtual time at anchor point */
+uint64_t m_virtual_ms;             /**< Virtual time of the last handled tick */
+uint64_t m_step_target_ms;         /**< Virtual time allowed in stepped mode */
+uint8_t m_low_prio_handled;        /**< Set when main loop handled low priority callbacks */
+uint32_t(*time_next_event)();
 
 void time_init()
 {
-   timestamp.day = 1;
-   timestamp.month = 1;
-   timestamp.year = 2000;
-   timestamp.hour = 0;
-   timestamp.minute = 0;
-   timestamp.second = 0;
+   time_seconds = 0;
+   time_mseconds = 0;
+   time_cache_seconds = 0;
+   time_seconds_to_calendar(0, &timestamp);
    timestamp.msecond = 0;
+   evq_init(&time_low_prio_events);
+   evq_register(&time_low_prio_events);
 
    struct sched_param param;
    param.sched_priority = 99;
    pthread_setschedparam(m_thread, SCHED_RR, &param);
 
+   pthread_condattr_t cond_attr;
+   pthread_condattr_init(&cond_attr);
+   pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+   pthread_cond_init(&m_cond, &cond_attr);
+   pthread_condattr_destroy(&cond_attr);
+
    pthread_mutex_init(&m_mutex, NULL);
+   time_next_event = NULL;
+   m_sim_mode = TIME_SIM_REALTIME;
+   m_sim_factor = 1;
+   m_virtual_ms = 0;
+   m_step_target_ms = 0;
+   m_anchor_virtual_ms = 0;
+   clock_gettime(CLOCK_MONOTONIC, &m_anchor);
    m_thread_running = 1;
    pthread_create(&m_thread, NULL, time_thread_execute, &m_thread_running);
 
 }
-unsigned int get_timediff_ms(struct timespec* start, struct timespec* end)
+uint64_t get_timediff_us(struct timespec* start, struct timespec* end)
+{
+   long long result = (long long)(end->tv_sec - start->tv_sec) * 1000000;
+   result += (end->tv_nsec - start->tv_nsec) / 1000;
+   return result > 0? (uint64_t)result : 0;
+}
+void time_add_us(struct timespec* item, uint64_t us)
+{
+   item->tv_sec += us / 1000000;
+   item->tv_nsec += (long)(us % 1000000) * 1000;
+   if (item->tv_nsec >= 1000000000)
+   {
+      item->tv_sec++;
+      item->tv_nsec -= 1000000000;
+   }
+}
+uint64_t time_sim_get_virtual_ms()
+{
+   uint64_t result = m_step_target_ms;
+   if (m_sim_mode != TIME_SIM_STEPPED)
+   {
+      struct timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      result = m_anchor_virtual_ms + get_timediff_us(&m_anchor, &now) * m_sim_factor / 1000;
+   }
+   return result;
+}
+unsigned int time_get_wait_ms()
 {
-   unsigned long result = 0;
-   if ((end->tv_nsec-start->tv_nsec)<0) {
-      result = 1000000000+end->tv_nsec-start->tv_nsec;
-   } else {
-      result = end->tv_nsec-start->tv_nsec;
+   unsigned int result = TIME_BASETIME_MS;
+   if (time_next_event)
+   {
+      uint32_t next_event = time_next_event();
+      result = next_event < TIME_TICKLESS_MAX_MS? next_event : TIME_TICKLESS_MAX_MS;
+      result = ((result + TIME_BASETIME_MS - 1) / TIME_BASETIME_MS) * TIME_BASETIME_MS;
+      result = result > 0? result : TIME_BASETIME_MS;
    }
-   return result / 1000000;
+   return result;
 }
 void *time_thread_execute(uint8_t* m_thread_running)
 {
    uint8_t running_flag = *m_thread_running;
-   struct timespec tim_before, tim_after, tim_diff;
+   struct timespec wakeup;
    while (running_flag)
    {
-      clock_gettime(CLOCK_MONOTONIC, &tim_before);
-      usleep(TIME_BASETIME_MS * 1000);
-      clock_gettime(CLOCK_MONOTONIC, &tim_after);
-      SysTick_Handler(get_timediff_ms(&tim_before, &tim_after));
       pthread_mutex_lock(&m_mutex);
+      if (m_sim_mode == TIME_SIM_STEPPED)
+      {
+         if (m_step_target_ms - m_virtual_ms < TIME_BASETIME_MS)
+         {
+            pthread_cond_wait(&m_cond, &m_mutex);
+         }
+      }
+      else
+      {
+         /* wait for absolute deadline, so the waiting error is not accumulated */
+         uint64_t deadline = m_virtual_ms + time_get_wait_ms();
+         wakeup = m_anchor;
+         time_add_us(&wakeup, deadline > m_anchor_virtual_ms? (deadline - m_anchor_virtual_ms) * 1000 / m_sim_factor : 0);
+         pthread_cond_timedwait(&m_cond, &m_mutex, &wakeup);
+      }
+      uint64_t now = time_sim_get_virtual_ms();
+      if (m_sim_mode == TIME_SIM_STEPPED)
+      {
+         /* virtual time is moved by one period at once, so main loop can follow */
+         uint64_t next = m_virtual_ms + time_get_wait_ms();
+         now = next < now? next : now;
+      }
+      unsigned int ticks = now > m_virtual_ms? (now - m_virtual_ms) / TIME_BASETIME_MS : 0;
+      m_low_prio_handled = ticks? 0 : m_low_prio_handled;
+      pthread_mutex_unlock(&m_mutex);
+
+      for (unsigned int i = 0; i < ticks; i++)
+      {
+         SysTick_Handler(TIME_BASETIME_MS);
+      }
+
+      pthread_mutex_lock(&m_mutex);
+      m_virtual_ms += (uint64_t)ticks * TIME_BASETIME_MS;
+      /* in stepped mode main loop has to handle the ticks before virtual time moves on */
+      while (m_sim_mode == TIME_SIM_STEPPED && ticks && *m_thread_running && !m_low_prio_handled)
+      {
+         pthread_cond_wait(&m_cond, &m_mutex);
+      }
       running_flag = *m_thread_running;
       pthread_mutex_unlock(&m_mutex);
    }
@@ -93,12 +217,16 @@ void *time_thread_execute(uint8_t* m_thread_running)
 
 void time_deinit()
 {
+   time_backend = NULL;
+   evq_unregister(&time_low_prio_events);
    for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i ++)
    {
-      TIME_CALLBACKS[i].fnc = NULL;
+      time_remove_callback(i);
    }
    pthread_mutex_lock(&m_mutex);
    m_thread_running = 0;
+   time_next_event = NULL;
+   pthread_cond_signal(&m_cond);
    pthread_mutex_unlock(&m_mutex);
 
    pthread_join(m_thread, NULL);
@@ -107,10 +235,11 @@ void time_deinit()
 RET_CODE time_is_time_ok(TimeItem* item)
 {
    uint8_t result = 1;
-   result &= item->month <= 12;
+   result &= item->month >= 1 && item->month <= 12;
+   result &= item->year >= TIME_EPOCH_YEAR && item->year < TIME_EPOCH_YEAR + 100;
    if (result == RETURN_OK)
    {
-      result &= item->day <= month_day_cnt[item->month];
+      result &= item->day >= 1 && item->day <= time_get_month_days(item->month, item->year);
    }
    result &= item->hour <= 23;
    result &= item->minute <= 59;
@@ -127,58 +256,126 @@ void time_set_winter_time(uint8_t state)
 }
 
 RET_CODE time_set_utc(TimeItem* item)
+{
+   RET_CODE result = time_apply_utc(item);
+   if (result == RETURN_OK && time_backend)
+   {
+      /* backend keeps UTC, so it does not depend on winter time */
+      result = time_backend->set(item);
+   }
+   return result;
+}
+
+RET_CODE time_set_calendar_backend(const TimeCalendarBackend* backend)
+{
+   RET_CODE result = RETURN_NOK;
+   time_backend = NULL;
+   if (!backend)
+   {
+      result = RETURN_OK;
+   }
+   else if (backend->get && backend->set)
+   {
+      time_backend = backend;
+      /* backend may not be set yet (e.g. RTC after battery loss), it is still used for time_set_utc() */
+      time_sync_from_backend();
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE time_apply_utc(TimeItem* item)
 {
    RET_CODE result = RETURN_NOK;
    if (item)
    {
       if (time_is_time_ok(item))
       {
-         timestamp = *item;
-         if (winter_time_active)
-         {
-            timestamp.hour += 1;
-         }
-         else
-         {
-            timestamp.hour += 2;
-         }
-         if (timestamp.hour > 23)
-         {
-            timestamp.hour = timestamp.hour % 24;
-            timestamp.day++;
-            if (timestamp.day > month_day_cnt[timestamp.month])
-            {
-               timestamp.month++;
-               timestamp.day = 1;
-               if (timestamp.month > 12)
-               {
-                  timestamp.month = 1;
-                  timestamp.year++;
-               }
-            }
-         }
+         uint32_t seconds = time_calendar_to_seconds(item) + (winter_time_active? 1 : 2) * 3600;
+         pthread_mutex_lock(&m_time_mutex);
+         time_seconds = seconds;
+         time_backend_sync_seconds = seconds;
+         time_mseconds = item->msecond;
+         time_cache_seconds = seconds;
+         time_seconds_to_calendar(seconds, &timestamp);
+         pthread_mutex_unlock(&m_time_mutex);
          result = RETURN_OK;
       }
    }
    return result;
 }
 
+RET_CODE time_sync_from_backend()
+{
+   TimeItem utc;
+   /* when backend is not valid, next try is done after the whole period */
+   time_backend_sync_seconds = time_seconds;
+   RET_CODE result = time_backend->get(&utc);
+   if (result == RETURN_OK)
+   {
+      /* align to basetime */
+      utc.msecond -= utc.msecond % TIME_BASETIME_MS;
+      result = time_apply_utc(&utc);
+   }
+   return result;
+}
+
 TimeItem* time_get()
 {
+   /* called from time thread and main thread */
+   pthread_mutex_lock(&m_time_mutex);
+   if (time_cache_seconds != time_seconds)
+   {
+      time_cache_seconds = time_seconds;
+      time_seconds_to_calendar(time_cache_seconds, &timestamp);
+   }
+   timestamp.msecond = time_mseconds;
+   pthread_mutex_unlock(&m_time_mutex);
    return &timestamp;
 }
+
+uint64_t time_get_epoch_ms()
+{
+   pthread_mutex_lock(&m_time_mutex);
+   uint64_t result = (uint64_t)time_seconds * 1000 + time_mseconds;
+   pthread_mutex_unlock(&m_time_mutex);
+   return result;
+}
+
+uint64_t time_to_epoch_ms(const TimeItem* item)
+{
+   return (uint64_t)time_calendar_to_seconds(item) * 1000 + item->msecond;
+}
+
+void time_from_epoch_ms(uint64_t epoch_ms, TimeItem* item)
+{
+   time_seconds_to_calendar((uint32_t)(epoch_ms / 1000), item);
+   item->msecond = epoch_ms % 1000;
+}
 RET_CODE time_register_callback(void(*callback)(TimeItem*), TimeCallbackPriority prio)
 {
-   RET_CODE result = RETURN_NOK;
+   return time_register_callback_handle(callback, prio) != TIME_INVALID_HANDLE? RETURN_OK : RETURN_NOK;
+}
 
-   for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i++)
+TIME_HANDLE time_register_callback_handle(void(*callback)(TimeItem*), TimeCallbackPriority prio)
+{
+   TIME_HANDLE result = TIME_INVALID_HANDLE;
+   if (callback && prio < TIME_PRIORITY_UNKNOWN)
    {
-      if (TIME_CALLBACKS[i].fnc == NULL)
+      for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i++)
       {
-         TIME_CALLBACKS[i].priority = prio;
-         TIME_CALLBACKS[i].fnc = callback;
-         result = RETURN_OK;
-         break;
+         TimeCallbackItem* item = &TIME_CALLBACKS[i];
+         if (item->fnc == NULL)
+         {
+            TimeDispatchList* list = &time_dispatch[prio];
+            item->priority = prio;
+            item->fnc = callback;
+            list->fnc[list->size] = callback;
+            list->slot[list->size] = i;
+            list->size++;
+            result = (TIME_HANDLE)(((uint16_t)item->generation << 8) | i);
+            break;
+         }
       }
    }
    return result;
@@ -189,97 +386,259 @@ RET_CODE time_unregister_callback(void(*callback)(TimeItem*))
    RET_CODE result = RETURN_NOK;
    for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i++)
    {
-      if (TIME_CALLBACKS[i].fnc == callback)
+      if (callback && TIME_CALLBACKS[i].fnc == callback)
       {
-         TIME_CALLBACKS[i].fnc = NULL;
+         time_remove_callback(i);
          result = RETURN_OK;
       }
    }
    return result;
 }
 
-RET_CODE time_is_leap_year()
+RET_CODE time_unregister_callback_handle(TIME_HANDLE handle)
 {
-   return (timestamp.year % 4) == 0? RETURN_OK : RETURN_NOK;
+   RET_CODE result = RETURN_NOK;
+   uint8_t slot = handle & 0xFF;
+   if (handle != TIME_INVALID_HANDLE && slot < TIME_CNT_CALLBACK_MAX_SIZE &&
+       TIME_CALLBACKS[slot].fnc != NULL && TIME_CALLBACKS[slot].generation == (handle >> 8))
+   {
+      time_remove_callback(slot);
+      result = RETURN_OK;
+   }
+   return result;
 }
 
-void time_increment_time(unsigned int value)
+void time_remove_callback(uint8_t slot)
 {
-   timestamp.msecond += value;
-   if (timestamp.msecond >= 1000)
+   TimeCallbackItem* item = &TIME_CALLBACKS[slot];
+   if (item->fnc != NULL)
    {
-      timestamp.second++;
-      timestamp.msecond %= 1000;
+      /* registration order is kept, so callbacks are shifted */
+      TimeDispatchList* list = &time_dispatch[item->priority];
+      uint8_t pos = 0;
+      while (pos < list->size && list->slot[pos] != slot)
+      {
+         pos++;
+      }
+      for (; pos + 1 < list->size; pos++)
+      {
+         list->fnc[pos] = list->fnc[pos + 1];
+         list->slot[pos] = list->slot[pos + 1];
+      }
+      list->size--;
+      item->fnc = NULL;
+      item->generation++;
    }
-   if (timestamp.second == 60)
+}
+
+RET_CODE time_is_leap_year(uint16_t year)
+{
+   /* valid in range 2000-2099 */
+   return (year % 4) == 0? RETURN_OK : RETURN_NOK;
+}
+
+uint8_t time_get_month_days(uint8_t month, uint16_t year)
+{
+   return (month == 2 && time_is_leap_year(year) == RETURN_OK)? month_day_cnt[month] + 1 : month_day_cnt[month];
+}
+
+uint32_t time_calendar_to_seconds(const TimeItem* item)
+{
+   uint16_t years = item->year - TIME_EPOCH_YEAR;
+   /* leap years before given one, 2000 is a leap year */
+   uint32_t days = (uint32_t)years * 365 + (years + 3) / 4;
+   for (uint8_t month = 1; month < item->month; month++)
    {
-      timestamp.minute++;
-      timestamp.second = 0;
+      days += time_get_month_days(month, item->year);
    }
-   if (timestamp.minute == 60)
+   days += item->day - 1;
+   return days * TIME_SECONDS_PER_DAY + (uint32_t)item->hour * 3600 + (uint32_t)item->minute * 60 + item->second;
+}
+
+void time_seconds_to_calendar(uint32_t seconds, TimeItem* item)
+{
+   uint32_t days = seconds / TIME_SECONDS_PER_DAY;
+   uint32_t day_seconds = seconds % TIME_SECONDS_PER_DAY;
+   item->hour = day_seconds / 3600;
+   item->minute = (day_seconds / 60) % 60;
+   item->second = day_seconds % 60;
+
+   uint16_t year = TIME_EPOCH_YEAR + (days / TIME_DAYS_PER_4_YEARS) * 4;
+   days %= TIME_DAYS_PER_4_YEARS;
+   while (days >= (time_is_leap_year(year) == RETURN_OK? 366 : 365))
    {
-      timestamp.hour++;
-      timestamp.minute = 0;
+      days -= time_is_leap_year(year) == RETURN_OK? 366 : 365;
+      year++;
    }
-   if (timestamp.hour == 24)
+   uint8_t month = 1;
+   while (days >= time_get_month_days(month, year))
    {
-      timestamp.day++;
-      timestamp.hour = 0;
-      uint8_t exp_days = (time_is_leap_year() == RETURN_OK) && (timestamp.month == 2)? month_day_cnt[timestamp.month] +1 : month_day_cnt[timestamp.month];
-      if (timestamp.day >= exp_days)
-      {
-         timestamp.month++;
-         timestamp.day = 1;
-         if (timestamp.month > 12)
-         {
-            timestamp.year++;
-            timestamp.month = 1;
-         }
-      }
+      days -= time_get_month_days(month, year);
+      month++;
    }
+   item->year = year;
+   item->month = month;
+   item->day = days + 1;
+}
 
-
+void time_increment_time(unsigned int value)
+{
+   /* calendar is converted on request */
+   pthread_mutex_lock(&m_time_mutex);
+   time_mseconds += value;
+   while (time_mseconds >= 1000)
+   {
+      time_mseconds -= 1000;
+      time_seconds++;
+   }
+   pthread_mutex_unlock(&m_time_mutex);
 }
 
 void time_call_low_prio_callbacks()
 {
-   for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i++)
+   time_call_callbacks(TIME_PRIORITY_LOW);
+}
+
+void time_on_low_prio_tick(uint32_t arg)
+{
+   time_call_low_prio_callbacks();
+   /* virtual time is not synchronized, as it is not following the backend */
+   if (time_backend && m_sim_mode == TIME_SIM_REALTIME &&
+       (time_seconds - time_backend_sync_seconds) >= TIME_BACKEND_SYNC_PERIOD_S)
    {
-      if (TIME_CALLBACKS[i].fnc != NULL && TIME_CALLBACKS[i].priority == TIME_PRIORITY_LOW)
-      {
-         TIME_CALLBACKS[i].fnc(&timestamp);
-      }
+      time_sync_from_backend();
+   }
+   pthread_mutex_lock(&m_mutex);
+   m_low_prio_handled = 1;
+   if (m_sim_mode == TIME_SIM_STEPPED)
+   {
+      pthread_cond_signal(&m_cond);
    }
+   pthread_mutex_unlock(&m_mutex);
 }
 
 void time_call_high_prio_callbacks()
 {
-   for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i++)
+   time_call_callbacks(TIME_PRIORITY_HIGH);
+}
+
+void time_call_callbacks(TimeCallbackPriority prio)
+{
+   TimeDispatchList* list = &time_dispatch[prio];
+   if (list->size > 0)
    {
-      if (TIME_CALLBACKS[i].fnc != NULL && TIME_CALLBACKS[i].priority == TIME_PRIORITY_HIGH)
+      /* calendar cache is updated only when the second changed */
+      TimeItem* time = time_get();
+      for (uint8_t i = 0; i < list->size; i++)
       {
-         TIME_CALLBACKS[i].fnc(&timestamp);
+         list->fnc[i](time);
       }
    }
 }
 
 void time_watcher()
 {
-   if (time_time_changed)
-   {
-      time_time_changed = 0;
-      time_call_low_prio_callbacks();
-   }
+   evq_dispatch(&time_low_prio_events);
 }
 uint16_t time_get_basetime()
 {
    return TIME_BASETIME_MS;
 }
 
+void time_set_tickless(uint32_t(*next_event)())
+{
+   pthread_mutex_lock(&m_mutex);
+   time_next_event = next_event;
+   pthread_cond_signal(&m_cond);
+   pthread_mutex_unlock(&m_mutex);
+}
+
+void time_reschedule()
+{
+   if (time_next_event)
+   {
+      /* wakes up the time thread to recalculate the deadline */
+      pthread_cond_signal(&m_cond);
+   }
+}
+
+uint16_t time_get_pending_ticks()
+{
+   uint16_t result = 0;
+   /* in stepped mode virtual time is moved only by handled ticks */
+   if (time_next_event && m_sim_mode != TIME_SIM_STEPPED)
+   {
+      /* called also from time thread with mutex locked */
+      uint64_t now = time_sim_get_virtual_ms();
+      uint64_t pending = now > m_virtual_ms? (now - m_virtual_ms) / TIME_BASETIME_MS : 0;
+      result = pending < UINT16_MAX? (uint16_t)pending : UINT16_MAX;
+   }
+   return result;
+}
+
+RET_CODE time_sim_set_mode(TimeSimMode mode, uint16_t factor)
+{
+   RET_CODE result = RETURN_NOK;
+   if (mode < TIME_SIM_MODE_COUNT && (mode != TIME_SIM_ACCELERATED || factor > 0))
+   {
+      pthread_mutex_lock(&m_mutex);
+      /* virtual time elapsed so far is counted with previous settings */
+      uint64_t now = time_sim_get_virtual_ms();
+      now = now > m_virtual_ms? now : m_virtual_ms;
+      m_step_target_ms = now - (now - m_virtual_ms) % TIME_BASETIME_MS;
+      m_anchor_virtual_ms = now;
+      clock_gettime(CLOCK_MONOTONIC, &m_anchor);
+      m_sim_mode = mode;
+      m_sim_factor = mode == TIME_SIM_ACCELERATED? factor : 1;
+      pthread_cond_signal(&m_cond);
+      pthread_mutex_unlock(&m_mutex);
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+TimeSimMode time_sim_get_mode()
+{
+   return m_sim_mode;
+}
+
+RET_CODE time_sim_step(uint32_t ms)
+{
+   RET_CODE result = RETURN_NOK;
+   pthread_mutex_lock(&m_mutex);
+   if (m_sim_mode == TIME_SIM_STEPPED)
+   {
+      m_step_target_ms += ms;
+      pthread_cond_signal(&m_cond);
+      result = RETURN_OK;
+   }
+   pthread_mutex_unlock(&m_mutex);
+   return result;
+}
+
+uint32_t time_sim_get_step_remaining()
+{
+   uint32_t result = 0;
+   pthread_mutex_lock(&m_mutex);
+   if (m_sim_mode == TIME_SIM_STEPPED)
+   {
+      /* step is done when all full ticks are handled also by main loop */
+      uint64_t remaining = m_step_target_ms - m_virtual_ms;
+      result = remaining >= TIME_BASETIME_MS? (uint32_t)remaining : 0;
+      result = (result == 0 && !m_low_prio_handled)? 1 : result;
+   }
+   pthread_mutex_unlock(&m_mutex);
+   return result;
+}
+
 void SysTick_Handler(unsigned int value)
 {
    time_increment_time(value);
    time_call_high_prio_callbacks();
-   time_time_changed++;
+   /* low priority callbacks get the current time, so pending request is enough */
+   if (evq_get_count(&time_low_prio_events) == 0)
+   {
+      evq_push(&time_low_prio_events, &time_on_low_prio_tick, 0);
+   }
 }
 
@@ -96,6 +96,17 @@ RET_CODE wifi_send_bytes(ServerClientID id, const uint8_t* data, uint16_t size)
    return hwstub_wifi_send_bytes(id, data, size);
 }
 
+RET_CODE wifi_try_send_data(ServerClientID id, const char* data, uint16_t size)
+{
+   /* not logged, function is used by logger sink */
+   return hwstub_wifi_send_data(id, data, size);
+}
+
+RET_CODE wifi_is_sending()
+{
+   return RETURN_NOK;
+}
+
 RET_CODE wifi_connect_to_network(const char* ssid, const char* password)
 {
    return RETURN_OK;
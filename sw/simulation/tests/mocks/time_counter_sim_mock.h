@@ -0,0 +1,44 @@
+#ifndef _TIME_COUNTER_SIM_MOCK_H_
+#define _TIME_COUNTER_SIM_MOCK_H_
+
+#include "time_counter_sim.h"
+#include "gmock/gmock.h"
+
+struct timeCounterSimMock
+{
+   MOCK_METHOD2(time_sim_set_mode, RET_CODE(TimeSimMode, uint16_t));
+   MOCK_METHOD0(time_sim_get_mode, TimeSimMode());
+   MOCK_METHOD1(time_sim_step, RET_CODE(uint32_t));
+   MOCK_METHOD0(time_sim_get_step_remaining, uint32_t());
+};
+
+timeCounterSimMock* time_sim_mock;
+
+void mock_time_sim_init()
+{
+   time_sim_mock = new timeCounterSimMock;
+}
+
+void mock_time_sim_deinit()
+{
+   delete time_sim_mock;
+}
+RET_CODE time_sim_set_mode(TimeSimMode mode, uint16_t factor)
+{
+   return time_sim_mock->time_sim_set_mode(mode, factor);
+}
+TimeSimMode time_sim_get_mode()
+{
+   return time_sim_mock->time_sim_get_mode();
+}
+RET_CODE time_sim_step(uint32_t ms)
+{
+   return time_sim_mock->time_sim_step(ms);
+}
+uint32_t time_sim_get_step_remaining()
+{
+   return time_sim_mock->time_sim_get_step_remaining();
+}
+
+
+#endif
@@ -6,6 +6,7 @@ extern "C" {
 #include "../../source/dht_driver_sim.c"
 #include "socket_driver_mock.h"
 #include "inputs_board_mock.h"
+#include "time_counter_sim_mock.h"
 #ifdef __cplusplus
 }
 #endif
@@ -44,6 +45,7 @@ struct dhtdriverSimFixture : public ::testing::Test
    {
       mock_logger_init();
       mock_sockdrv_init();
+      mock_time_sim_init();
 
       EXPECT_CALL(*sockdrv_mock, sockdrv_create(_,_)).WillOnce(Return(control_if_fd))
                                                      .WillOnce(Return(app_id_fd));
@@ -59,6 +61,7 @@ struct dhtdriverSimFixture : public ::testing::Test
       EXPECT_CALL(*sockdrv_mock, sockdrv_remove_listener(_)).Times(2);
       hwstub_deinit();
       mock_sockdrv_deinit();
+      mock_time_sim_deinit();
       mock_logger_deinit();
       delete callMock;
    }
@@ -6,6 +6,7 @@ extern "C" {
 #include "../../source/i2c_driver_sim.c"
 #include "socket_driver_mock.h"
 #include "inputs_board_mock.h"
+#include "time_counter_sim_mock.h"
 #ifdef __cplusplus
 }
 #endif
@@ -44,6 +45,7 @@ struct i2cdriverSimFixture : public ::testing::Test
    {
       mock_logger_init();
       mock_sockdrv_init();
+      mock_time_sim_init();
       mock_inp_init();
 
       EXPECT_CALL(*sockdrv_mock, sockdrv_create(_,_)).WillOnce(Return(control_if_fd))
@@ -61,6 +63,7 @@ struct i2cdriverSimFixture : public ::testing::Test
       EXPECT_CALL(*sockdrv_mock, sockdrv_remove_listener(_)).Times(2);
       hwstub_deinit();
       mock_sockdrv_deinit();
+      mock_time_sim_deinit();
       mock_logger_deinit();
       mock_inp_deinit();
       delete callMock;
@@ -320,3 +323,53 @@ TEST_F(i2cdriverSimFixture, i2c_interrupt_simulation_test)
    hwstub_on_new_command(SOCK_DRV_NEW_DATA, i2c_state_ok);
    hwstub_watcher();
 }
+
+/**
+ * @test Test of simulated time control from test framework
+ */
+TEST_F(i2cdriverSimFixture, time_simulation_control_test)
+{
+   /**
+    * <b>scenario</b>:  Stepped mode requested <br>
+    * <b>expected</b>:  Time mode set <br>
+    * ************************************************
+    */
+   EXPECT_CALL(*time_sim_mock, time_sim_set_mode(TIME_SIM_STEPPED, 0)).WillOnce(Return(RETURN_OK));
+   hwstub_on_new_command(SOCK_DRV_NEW_DATA, "05 03 2 0 0");
+   hwstub_watcher();
+
+   /**
+    * <b>scenario</b>:  Accelerated mode with factor 1000 requested <br>
+    * <b>expected</b>:  Time mode set with correct factor <br>
+    * ************************************************
+    */
+   EXPECT_CALL(*time_sim_mock, time_sim_set_mode(TIME_SIM_ACCELERATED, 1000)).WillOnce(Return(RETURN_OK));
+   hwstub_on_new_command(SOCK_DRV_NEW_DATA, "05 03 1 3 232");
+   hwstub_watcher();
+
+   /**
+    * <b>scenario</b>:  Time step requested, but not accepted <br>
+    * <b>expected</b>:  Notification not sent <br>
+    * ************************************************
+    */
+   EXPECT_CALL(*time_sim_mock, time_sim_step(7200000)).WillOnce(Return(RETURN_NOK));
+   EXPECT_CALL(*time_sim_mock, time_sim_get_mode()).WillOnce(Return(TIME_SIM_REALTIME));
+   EXPECT_CALL(*time_sim_mock, time_sim_get_step_remaining()).Times(0);
+   hwstub_on_new_command(SOCK_DRV_NEW_DATA, "06 04 0 109 221 0");
+   hwstub_watcher();
+   Mock::VerifyAndClearExpectations(time_sim_mock);
+
+   /**
+    * <b>scenario</b>:  Time step of 2 hours requested and completed <br>
+    * <b>expected</b>:  Notification sent once, when step is completed <br>
+    * ************************************************
+    */
+   EXPECT_CALL(*time_sim_mock, time_sim_step(7200000)).WillOnce(Return(RETURN_OK));
+   EXPECT_CALL(*time_sim_mock, time_sim_get_step_remaining()).WillOnce(Return(10))
+                                                             .WillOnce(Return(0));
+   EXPECT_CALL(*sockdrv_mock, sockdrv_write(control_if_fd, StrEq("07 00\n"), 6)).WillOnce(Return(RETURN_OK));
+   hwstub_on_new_command(SOCK_DRV_NEW_DATA, "06 04 0 109 221 0");
+   hwstub_watcher();
+   hwstub_watcher();
+   hwstub_watcher();
+}
@@ -45,17 +45,63 @@ typedef enum SchTaskState
 	TASKSTATE_STOPPED,      /**< Task stopped and waiting for start */
 	TASKSTATE_UNKNOWN,      /**< Unknown task state - enums count */
 } SchTaskState;
+/**
+ * Priority levels, from the most urgent: HIGH, SOFTIRQ, NORMAL, LOW.
+ * Values are not ordered by urgency - LOW and HIGH keep their original values,
+ * because priority is reported to external applications.
+ */
 typedef enum SchTaskPriority
 {
-   TASKPRIO_LOW,     /**< This task will be called in main thread */
+   TASKPRIO_LOW,     /**< This task will be called in main thread, after NORMAL tasks */
    TASKPRIO_HIGH,    /**< This task will be called from interrupt routine */
+   TASKPRIO_SOFTIRQ, /**< This task will be called from PendSV interrupt, right after SysTick returns */
+   TASKPRIO_NORMAL,  /**< This task will be called in main thread, before LOW tasks */
    TASKPRIO_UNKNOWN, /**< Unknown task priorty - enums count */
 } SchTaskPriority;
+/**
+ * Behavior of periodic task, when its call is late - e.g. main loop was blocked
+ * and low priority ticks were queued.
+ */
+typedef enum SchCatchupPolicy
+{
+   CATCHUP_BURST,    /**< Every missed period is called, one by one (default) */
+   CATCHUP_SKIP,     /**< Called once, next period is counted from now */
+   CATCHUP_COALESCE, /**< Called once, missed periods are dropped, task phase is kept */
+   CATCHUP_UNKNOWN,  /**< Unknown policy - enums count */
+} SchCatchupPolicy;
 /* =============================
  *          Defines
  * =============================*/
+/** Maximal number of subscribed tasks, may be overridden in build configuration */
+#ifndef SCH_TASK_POOL_SIZE
+#define SCH_TASK_POOL_SIZE 20
+#endif
 typedef uint16_t TASK_PERIOD;
 typedef void(*TASK) ();
+/** Task called with user context, allows to use one function for many module instances */
+typedef void(*TASK_CTX) (void* ctx);
+/** Opaque handle to subscribed task, see sch_subscribe_handle() */
+typedef uint16_t SCH_HANDLE;
+#define SCH_INVALID_HANDLE 0xFFFF
+/** Returned by sch_get_next_deadline() when no task is running */
+#define SCH_NO_DEADLINE 0xFFFFFFFF
+
+/** Runtime statistics of the task, collected only when enabled by sch_enable_stats() */
+typedef struct SchTaskStats
+{
+   TASK task;                 /**< Task callback (context task callback casted to TASK) */
+   SchTaskPriority priority;  /**< Task priority */
+   TASK_PERIOD period;        /**< Task period */
+   uint32_t calls;            /**< Number of calls */
+   uint32_t last_time_us;     /**< Execution time of the last call */
+   uint32_t max_time_us;      /**< Longest execution time */
+   uint32_t total_time_us;    /**< Sum of all execution times */
+   uint32_t last_latency_us;  /**< Delay between due time and start of the last call */
+   uint32_t max_latency_us;   /**< Longest delay between due time and start of the call */
+   uint16_t overruns;         /**< Number of calls longer than the task period */
+   uint32_t late_calls;       /**< Number of calls started at least one basetime after due time */
+   uint32_t dropped_calls;    /**< Number of periods not called because of catch-up policy */
+} SchTaskStats;
 
 
 /**
@@ -86,6 +132,35 @@ RET_CODE sch_subscribe (TASK task);
  * @return See RETURN_CODES.
  */
 RET_CODE sch_subscribe_and_set(TASK task, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type);
+/**
+ * @brief Subscribe permanent task to scheduler, set all properties and return handle to it.
+ * @details
+ * Handle allows to control the task without searching it in the task list, so
+ * calls on handle are cheap and can be done from interrupts.
+ * The same function can be subscribed many times, each time with new handle.
+ * Handle becomes invalid after task is unsubscribed.
+ * @param[in] task - Pointer to function
+ * @param[in] prio - Task priority
+ * @param[in] period - Task period
+ * @param[in] state - Task state
+ * @param[in] type - Task type
+ * @return Handle to task or SCH_INVALID_HANDLE on error.
+ */
+SCH_HANDLE sch_subscribe_handle(TASK task, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type);
+/**
+ * @brief Subscribe task called with user context, set all properties and return handle to it.
+ * @details
+ * Context is stored in the task slot and passed to every call, so the same function can
+ * serve many instances of the module. Task can be controlled only by returned handle.
+ * @param[in] task - Pointer to function
+ * @param[in] ctx - Context passed to task, e.g. module instance
+ * @param[in] prio - Task priority
+ * @param[in] period - Task period
+ * @param[in] state - Task state
+ * @param[in] type - Task type
+ * @return Handle to task or SCH_INVALID_HANDLE on error.
+ */
+SCH_HANDLE sch_subscribe_ctx(TASK_CTX task, void* ctx, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type);
 /**
  * @brief Unsubscribe permanent task.
  * @param[in] task - Pointer to function
@@ -131,6 +206,13 @@ RET_CODE sch_set_task_type (TASK task, SchTaskType type);
  * @return See RETURN_CODES.
  */
 RET_CODE sch_set_task_priority (TASK task, SchTaskPriority prio);
+/**
+ * @brief Set behavior of the task when its calls are late.
+ * @param[in] task - Pointer to task
+ * @param[in] policy - catch-up policy
+ * @return See RETURN_CODES.
+ */
+RET_CODE sch_set_task_catchup (TASK task, SchCatchupPolicy policy);
 /**
  * @brief Starts task which type is ONCE.
  * @param[in] task - Pointer to task.
@@ -156,10 +238,143 @@ SchTaskState sch_get_task_state (TASK task);
  */
 SchTaskType sch_get_task_type (TASK task);
 /**
- * @brief Watcher - need to be called in main thread loop to call tasks on timeout.
+ * @brief Get catch-up policy of the task.
+ * @param[in] task - Pointer to task
+ * @return Task catch-up policy.
+ */
+SchCatchupPolicy sch_get_task_catchup (TASK task);
+/**
+ * @brief Unsubscribe task by handle.
+ * @param[in] handle - Task handle
+ * @return See RETURN_CODES.
+ */
+RET_CODE sch_handle_unsubscribe (SCH_HANDLE handle);
+/**
+ * @brief Set period of task by handle.
+ * @param[in] handle - Task handle
+ * @param[in] period - task period
+ * @return See RETURN_CODES.
+ */
+RET_CODE sch_handle_set_period (SCH_HANDLE handle, TASK_PERIOD period);
+/**
+ * @brief Set task state by handle.
+ * @param[in] handle - Task handle
+ * @param[in] state - task state
+ * @return See RETURN_CODES.
+ */
+RET_CODE sch_handle_set_state (SCH_HANDLE handle, SchTaskState state);
+/**
+ * @brief Set task type by handle.
+ * @param[in] handle - Task handle
+ * @param[in] type - task type
+ * @return See RETURN_CODES.
+ */
+RET_CODE sch_handle_set_type (SCH_HANDLE handle, SchTaskType type);
+/**
+ * @brief Set task priority by handle.
+ * @param[in] handle - Task handle
+ * @param[in] prio - task priority
+ * @return See RETURN_CODES.
+ */
+RET_CODE sch_handle_set_priority (SCH_HANDLE handle, SchTaskPriority prio);
+/**
+ * @brief Set behavior of the task when its calls are late, by handle.
+ * @param[in] handle - Task handle
+ * @param[in] policy - catch-up policy
+ * @return See RETURN_CODES.
+ */
+RET_CODE sch_handle_set_catchup (SCH_HANDLE handle, SchCatchupPolicy policy);
+/**
+ * @brief Starts task which type is TRIGGER by handle.
+ * @param[in] handle - Task handle
+ * @return See RETURN_CODES.
+ */
+RET_CODE sch_handle_trigger (SCH_HANDLE handle);
+/**
+ * @brief Get period of the task by handle.
+ * @param[in] handle - Task handle
+ * @return Task period.
+ */
+TASK_PERIOD sch_handle_get_period (SCH_HANDLE handle);
+/**
+ * @brief Get state of the task by handle.
+ * @param[in] handle - Task handle
+ * @return Task state.
+ */
+SchTaskState sch_handle_get_state (SCH_HANDLE handle);
+/**
+ * @brief Get type of the task by handle.
+ * @param[in] handle - Task handle
+ * @return Task type.
+ */
+SchTaskType sch_handle_get_type (SCH_HANDLE handle);
+/**
+ * @brief Get catch-up policy of the task by handle.
+ * @param[in] handle - Task handle
+ * @return Task catch-up policy.
+ */
+SchCatchupPolicy sch_handle_get_catchup (SCH_HANDLE handle);
+/**
+ * @brief Watcher - handles one pending tick of low priority tasks.
+ * @details Ticks are queued in SysTick interrupt, main loop drains them all with evq_dispatch_all().
  * @return None.
  */
 void sch_task_watcher ();
+/**
+ * @brief Soft interrupt handler - calls SOFTIRQ tasks for all ticks counted since its last call.
+ * @details
+ * Called from PendSV interrupt, pended by SysTick after HIGH tasks are handled.
+ * PendSV has the lowest interrupt priority, so SOFTIRQ tasks do not delay other interrupts,
+ * but they are still called before main loop continues. Synchronous drivers API cannot be
+ * called from SOFTIRQ tasks.
+ * @return None.
+ */
+void sch_on_soft_irq();
+/**
+ * @brief Get time to the earliest running task.
+ * @details Used by TIME module in tickless mode to set the next timer interrupt.
+ * @return Time in ms to next task call, 0 if any task is already due or SCH_NO_DEADLINE if nothing is running.
+ */
+uint32_t sch_get_next_deadline();
+/**
+ * @brief Enable collecting of tasks runtime statistics.
+ * @return None.
+ */
+void sch_enable_stats();
+/**
+ * @brief Disable collecting of tasks runtime statistics.
+ * @return None.
+ */
+void sch_disable_stats();
+/**
+ * @brief Clear runtime statistics of all tasks.
+ * @return None.
+ */
+void sch_reset_stats();
+/**
+ * @brief Get runtime statistics of the task.
+ * @param[in] idx - Index of subscribed task, counted from 0
+ * @param[out] buffer - Place where statistics will be written
+ * @return RETURN_NOK if there is no task with such index.
+ */
+RET_CODE sch_get_task_stats(uint8_t idx, SchTaskStats* buffer);
+/**
+ * @brief Get number of low priority ticks dropped, because main loop was not handling them.
+ * @details Dropped ticks are not replayed, low priority time jumps to the current time.
+ * @return Number of dropped ticks.
+ */
+uint32_t sch_get_dropped_ticks();
+/**
+ * @brief Get number of subscribed tasks.
+ * @return Number of tasks.
+ */
+uint8_t sch_get_tasks_count();
+/**
+ * @brief Get maximal number of tasks subscribed at the same time since initialization.
+ * @details Helps to adjust SCH_TASK_POOL_SIZE to the real needs.
+ * @return High water mark of the task pool.
+ */
+uint8_t sch_get_pool_high_water();
 /**
  * @brief Shuts down task scheduler.
  * @return None.
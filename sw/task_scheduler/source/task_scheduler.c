@@ -1,136 +1,177 @@
 /* =============================
  *   Includes of common headers
  * =============================*/
-#include <stdlib.h>
+#include <string.h>
 /* =============================
  *  Includes of project headers
  * =============================*/
+#include "stm32f4xx.h"
+#include "core_cmFunc.h"
 #include "task_scheduler.h"
 #include "time_counter.h"
+#include "system_timestamp.h"
+#include "event_queue.h"
 #include "Logger.h"
 /* =============================
  *          Defines
  * =============================*/
-const uint8_t DEFAULT_TASKLIST_SIZE = 20;
-const uint8_t DEFAULT_TASK_INCR = 5;
+#define SCH_NOT_QUEUED 0xFF
+#define SCH_NO_FREE_ITEM 0xFF
+#if SCH_TASK_POOL_SIZE > 254
+#error "SCH_TASK_POOL_SIZE is limited by 8-bit task index"
+#endif
 /* =============================
  *       Internal types
  * =============================*/
+typedef struct SchProfile
+{
+   uint32_t calls;
+   uint32_t last_time_us;
+   uint32_t max_time_us;
+   uint32_t total_time_us;
+   uint32_t last_latency_us;
+   uint32_t max_latency_us;
+   uint16_t overruns;
+   uint32_t late_calls;
+   uint32_t dropped_calls;
+}SchProfile;
+
 typedef struct SchItem
 {
 	TASK callback;
+	TASK_CTX ctx_callback;  /**< Used instead of callback by context tasks */
+	void* ctx;
 	SchTaskState state;
 	SchTaskType type;
 	SchTaskPriority priority;
+	SchCatchupPolicy catchup;
 	TASK_PERIOD period;
-	TASK_PERIOD count;
+	TASK_PERIOD count;   /**< Time elapsed from last call, valid only when task is not queued */
+	uint32_t due;        /**< Absolute time of next call, valid only when task is queued */
+	uint8_t queue_pos;   /**< Position in priority queue heap or SCH_NOT_QUEUED */
+	uint8_t generation;  /**< Incremented on unsubscribe to invalidate handles */
+	uint8_t next_free;   /**< Next item in free list, valid only when task is empty */
+	SchProfile profile;  /**< Runtime statistics, updated only when enabled (late and dropped calls always) */
 }SchItem;
 
 typedef struct SchList
 {
-	SchItem* list;
+	SchItem list[SCH_TASK_POOL_SIZE];
 	uint8_t size;
-	uint8_t capacity;
+	uint8_t first_free;  /**< Head of empty items list or SCH_NO_FREE_ITEM */
+	uint8_t high_water;  /**< Maximal number of tasks subscribed at the same time */
 }SchList;
 
+/**
+ * Running tasks of one priority, kept as binary min-heap ordered by due time.
+ * Each priority has its own time, because low priority tasks are called from
+ * main loop, so their time is moving only when sch_task_watcher() is called.
+ */
+typedef struct SchQueue
+{
+   uint8_t heap[SCH_TASK_POOL_SIZE];
+   uint8_t size;
+   uint32_t now;
+}SchQueue;
+
 /* =============================
  *   Internal module functions
  * =============================*/
 void sch_on_time_change(TimeItem* item);
-void sch_realloc_data(SchItem* source, SchItem* dest);
+void sch_on_low_prio_tick(uint32_t arg);
+void sch_reset_pool();
 SchItem* sch_get_item(TASK task);
+SchItem* sch_get_item_by_handle(SCH_HANDLE handle);
+SCH_HANDLE sch_item_to_handle(SchItem* item);
+SchItem* sch_add_item(TASK task, TASK_CTX ctx_task, void* ctx);
+SCH_HANDLE sch_add_handle_item(SchItem* item, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type);
+RET_CODE sch_set_item(SchItem* item, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type);
+RET_CODE sch_item_unsubscribe(SchItem* item);
+RET_CODE sch_item_set_period(SchItem* item, TASK_PERIOD period);
+RET_CODE sch_item_set_state(SchItem* item, SchTaskState state);
+RET_CODE sch_item_set_type(SchItem* item, SchTaskType type);
+RET_CODE sch_item_set_priority(SchItem* item, SchTaskPriority prio);
+RET_CODE sch_item_trigger(SchItem* item);
+RET_CODE sch_item_set_catchup(SchItem* item, SchCatchupPolicy policy);
 RET_CODE sch_is_period_correct(TASK_PERIOD period);
 void sch_call_tasks (SchTaskPriority prio);
+uint8_t sch_is_main_loop_prio(SchTaskPriority prio);
+uint32_t sch_get_lag(SchTaskPriority prio);
+void sch_catch_up_main_loop_time(SchTaskPriority prio);
+void sch_request_soft_irq();
+SchItem* sch_take_due_item(SchQueue* queue, uint32_t lag, uint16_t basetime, uint32_t* late_ms);
+void sch_reschedule_item(SchItem* item, uint32_t now, uint32_t lag, uint16_t basetime);
+uint8_t sch_is_due(SchQueue* queue, SchItem* item);
+void sch_queue_swap(SchQueue* queue, uint8_t pos1, uint8_t pos2);
+void sch_queue_sift_up(SchQueue* queue, uint8_t pos);
+void sch_queue_sift_down(SchQueue* queue, uint8_t pos);
+void sch_queue_push(SchItem* item);
+void sch_queue_remove(SchItem* item);
+void sch_queue_update(SchItem* item);
+void sch_start_item(SchItem* item);
+void sch_stop_item(SchItem* item);
+uint32_t sch_get_queue_time(SchQueue* queue);
+void sch_update_stats(SchItem* item, uint32_t latency_us, uint32_t exec_time_us);
 /* =============================
  *      Module variables
  * =============================*/
 SchList items_list;
-volatile uint8_t sch_time_changed;
+SchQueue sch_queues[TASKPRIO_UNKNOWN];
+EVQ sch_low_prio_events;   /**< One event per tick, produced in SysTick interrupt */
+uint8_t sch_stats_enabled;
 
 
 
 void sch_initialize ()
 {
-	items_list.size = 0;
-	items_list.list = (SchItem*) calloc(DEFAULT_TASKLIST_SIZE, sizeof(SchItem));
-	items_list.capacity = DEFAULT_TASKLIST_SIZE;
-	if (items_list.list)
-	{
-		time_register_callback(&sch_on_time_change, TIME_PRIORITY_HIGH);
-		items_list.capacity = DEFAULT_TASKLIST_SIZE;
-	}
-	else
-	{
-		logger_send(LOG_ERROR, __func__, "Cannot allocate buffer!");
-	}
+	sch_stats_enabled = 0;
+	sch_reset_pool();
+	evq_init(&sch_low_prio_events);
+	evq_register(&sch_low_prio_events);
+	time_register_callback(&sch_on_time_change, TIME_PRIORITY_HIGH);
 }
 RET_CODE sch_subscribe (TASK task)
 {
-	RET_CODE result = RETURN_OK;
-	if (task)
-	{
-		if (items_list.size == items_list.capacity)
-		{
-			SchItem* new_loc = (SchItem*) calloc((items_list.size + DEFAULT_TASK_INCR), sizeof(SchItem));
-			if (!new_loc)
-			{
-				return RETURN_NOK;
-			}
-			sch_realloc_data(items_list.list, new_loc);
-			items_list.list = new_loc;
-			items_list.capacity = items_list.size + DEFAULT_TASK_INCR;
-		}
-
-		for (uint8_t i = 0; i < items_list.capacity; i++)
-		{
-			if (items_list.list[i].state == TASKSTATE_EMPTY)
-			{
-				items_list.list[i].callback = task;
-				items_list.list[i].count = 0;
-				items_list.list[i].period = 0;
-				items_list.list[i].priority = TASKPRIO_LOW;
-				items_list.list[i].state = TASKSTATE_STOPPED;
-				items_list.size++;
-				break;
-			}
-		}
-	}
-	else
-	{
-		result = RETURN_NOK;
-	}
-	return result;
+	return sch_add_item(task, NULL, NULL)? RETURN_OK : RETURN_NOK;
 }
 
 RET_CODE sch_subscribe_and_set(TASK task, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type)
 {
    RET_CODE result = RETURN_NOK;
-   do
+   SchItem* item = sch_add_item(task, NULL, NULL);
+   if (item)
    {
-      if (sch_subscribe(task) != RETURN_OK){break;}
-      if (sch_set_task_priority(task, prio) != RETURN_OK){break;}
-      if (sch_set_task_period(task, period) != RETURN_OK){break;}
-      if (sch_set_task_state(task, state) != RETURN_OK){break;}
-      if (sch_set_task_type(task, type) != RETURN_OK){break;}
-      result = RETURN_OK;
-   }while(0);
-
+      result = sch_set_item(item, prio, period, state, type);
+   }
+   return result;
+}
+SCH_HANDLE sch_subscribe_handle(TASK task, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type)
+{
+   return sch_add_handle_item(sch_add_item(task, NULL, NULL), prio, period, state, type);
+}
+SCH_HANDLE sch_subscribe_ctx(TASK_CTX task, void* ctx, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type)
+{
+   return sch_add_handle_item(sch_add_item(NULL, task, ctx), prio, period, state, type);
+}
+SCH_HANDLE sch_add_handle_item(SchItem* item, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type)
+{
+   SCH_HANDLE result = SCH_INVALID_HANDLE;
+   if (item)
+   {
+      if (sch_set_item(item, prio, period, state, type) == RETURN_OK)
+      {
+         result = sch_item_to_handle(item);
+      }
+      else
+      {
+         sch_item_unsubscribe(item);
+      }
+   }
    return result;
 }
 RET_CODE sch_unsubscribe (TASK task)
 {
-	RET_CODE result = RETURN_NOK;
-
-	SchItem* item = sch_get_item(task);
-	if (item)
-	{
-		item->state = TASKSTATE_EMPTY;
-		item->callback = NULL;
-		items_list.size--;
-		result = RETURN_OK;
-	}
-
-	return result;
+	return sch_item_unsubscribe(sch_get_item(task));
 }
 RET_CODE sch_schedule_task (TASK task, TASK_PERIOD period)
 {
@@ -160,72 +201,27 @@ RET_CODE sch_schedule_task (TASK task, TASK_PERIOD period)
 }
 RET_CODE sch_set_task_period (TASK task, TASK_PERIOD period)
 {
-	RET_CODE result = RETURN_NOK;
-
-	if (sch_is_period_correct (period) == RETURN_OK)
-	{
-		SchItem* item = sch_get_item(task);
-		if (item)
-		{
-			item->period = period;
-			item->count = 0;
-			result = RETURN_OK;
-		}
-	}
-
-	return result;
+	return sch_item_set_period(sch_get_item(task), period);
 }
 RET_CODE sch_set_task_state (TASK task, enum SchTaskState state)
 {
-	RET_CODE result = RETURN_NOK;
-
-	SchItem* item = sch_get_item(task);
-	if (item && state != TASKSTATE_UNKNOWN)
-	{
-		item->state = state;
-		result = RETURN_OK;
-	}
-	return result;
+	return sch_item_set_state(sch_get_item(task), state);
 }
 RET_CODE sch_set_task_type (TASK task, enum SchTaskType type)
 {
-	RET_CODE result = RETURN_NOK;
-
-	SchItem* item = sch_get_item(task);
-	if (item && type != TASKTYPE_UNKNOWN)
-	{
-		item->type = type;
-		result = RETURN_OK;
-	}
-	return result;
+	return sch_item_set_type(sch_get_item(task), type);
 }
 RET_CODE sch_set_task_priority (TASK task, SchTaskPriority prio)
 {
-   RET_CODE result = RETURN_NOK;
-
-   SchItem* item = sch_get_item(task);
-   if (item && prio < TASKPRIO_UNKNOWN)
-   {
-      item->priority = prio;
-      result = RETURN_OK;
-   }
-   return result;
+   return sch_item_set_priority(sch_get_item(task), prio);
+}
+RET_CODE sch_set_task_catchup (TASK task, SchCatchupPolicy policy)
+{
+   return sch_item_set_catchup(sch_get_item(task), policy);
 }
 RET_CODE sch_trigger_task (TASK task)
 {
-	RET_CODE result = RETURN_NOK;
-
-	SchItem* item = sch_get_item(task);
-	if (item)
-	{
-		if(item->type == TASKTYPE_TRIGGER)
-		{
-		   item->count = 0;
-			item->state = TASKSTATE_RUNNING;
-			result = RETURN_OK;
-		}
-	}
-	return result;
+	return sch_item_trigger(sch_get_item(task));
 }
 TASK_PERIOD sch_get_task_period (TASK task)
 {
@@ -260,54 +256,235 @@ enum SchTaskType sch_get_task_type (TASK task)
 	}
 	return result;
 }
+SchCatchupPolicy sch_get_task_catchup (TASK task)
+{
+   SchItem* item = sch_get_item(task);
+   return item? item->catchup : CATCHUP_UNKNOWN;
+}
+RET_CODE sch_handle_unsubscribe (SCH_HANDLE handle)
+{
+   return sch_item_unsubscribe(sch_get_item_by_handle(handle));
+}
+RET_CODE sch_handle_set_period (SCH_HANDLE handle, TASK_PERIOD period)
+{
+   return sch_item_set_period(sch_get_item_by_handle(handle), period);
+}
+RET_CODE sch_handle_set_state (SCH_HANDLE handle, SchTaskState state)
+{
+   return sch_item_set_state(sch_get_item_by_handle(handle), state);
+}
+RET_CODE sch_handle_set_type (SCH_HANDLE handle, SchTaskType type)
+{
+   return sch_item_set_type(sch_get_item_by_handle(handle), type);
+}
+RET_CODE sch_handle_set_priority (SCH_HANDLE handle, SchTaskPriority prio)
+{
+   return sch_item_set_priority(sch_get_item_by_handle(handle), prio);
+}
+RET_CODE sch_handle_trigger (SCH_HANDLE handle)
+{
+   return sch_item_trigger(sch_get_item_by_handle(handle));
+}
+TASK_PERIOD sch_handle_get_period (SCH_HANDLE handle)
+{
+   SchItem* item = sch_get_item_by_handle(handle);
+   return item? item->period : 0;
+}
+SchTaskState sch_handle_get_state (SCH_HANDLE handle)
+{
+   SchItem* item = sch_get_item_by_handle(handle);
+   return item? item->state : TASKSTATE_UNKNOWN;
+}
+SchTaskType sch_handle_get_type (SCH_HANDLE handle)
+{
+   SchItem* item = sch_get_item_by_handle(handle);
+   return item? item->type : TASKTYPE_UNKNOWN;
+}
+RET_CODE sch_handle_set_catchup (SCH_HANDLE handle, SchCatchupPolicy policy)
+{
+   return sch_item_set_catchup(sch_get_item_by_handle(handle), policy);
+}
+SchCatchupPolicy sch_handle_get_catchup (SCH_HANDLE handle)
+{
+   SchItem* item = sch_get_item_by_handle(handle);
+   return item? item->catchup : CATCHUP_UNKNOWN;
+}
 void sch_task_watcher ()
 {
-	if (sch_time_changed)
+	/* one tick per call, main loop drains the rest with evq_dispatch_all() */
+	EVQ_EVENT event;
+	if (evq_pop(&sch_low_prio_events, &event) == RETURN_OK)
 	{
-		sch_time_changed--;
-		sch_call_tasks(TASKPRIO_LOW);
+		event.handler(event.arg);
 	}
 }
 
 void sch_call_tasks (SchTaskPriority prio)
 {
-   for (uint8_t i = 0; i < items_list.capacity; i++)
+   SchQueue* queue = &sch_queues[prio];
+   uint16_t basetime = time_get_basetime();
+   queue->now += basetime;
+   if (sch_is_main_loop_prio(prio))
    {
-      SchItem* item = &items_list.list[i];
-      if (item->state == TASKSTATE_RUNNING && item->priority == prio)
+      sch_catch_up_main_loop_time(prio);
+   }
+   /* empty levels are visited on every tick, so they do not read the cycle counter */
+   uint32_t tick_cycles = (sch_stats_enabled && queue->size > 0)? ts_get_cycles() : 0;
+
+   SchItem* item;
+   uint32_t late_ms;
+   /* main loop and soft interrupt time is behind until queued ticks are handled */
+   while ((item = sch_take_due_item(queue, sch_get_lag(prio), basetime, &late_ms)) != NULL)
+   {
+      uint8_t generation = item->generation;
+      uint8_t stats_enabled = sch_stats_enabled;
+      uint32_t start_cycles = stats_enabled? ts_get_cycles() : 0;
+      if (item->callback) item->callback();
+      else if (item->ctx_callback) item->ctx_callback(item->ctx);
+      if (stats_enabled && item->generation == generation)
       {
-         item->count += time_get_basetime();
-         if (item->count >= item->period)
-         {
-            item->count = 0;
-            if (item->type == TASKTYPE_TRIGGER)
-            {
-               item->state = TASKSTATE_STOPPED;
-            }
-            if (item->callback) item->callback();
-            if (item->type == TASKTYPE_ONCE)
-            {
-               sch_unsubscribe(item->callback);
-            }
-         }
+         uint32_t end_cycles = ts_get_cycles();
+         uint32_t latency_us = late_ms * 1000 + (start_cycles - tick_cycles) / TS_CYCLES_PER_US;
+         sch_update_stats(item, latency_us, (end_cycles - start_cycles) / TS_CYCLES_PER_US);
+      }
+      if (item->type == TASKTYPE_ONCE && item->generation == generation)
+      {
+         sch_item_unsubscribe(item);
       }
    }
 }
 
+SchItem* sch_take_due_item(SchQueue* queue, uint32_t lag, uint16_t basetime, uint32_t* late_ms)
+{
+   SchItem* result = NULL;
+   /* heap top is read with interrupts disabled, ISR-safe setters can reorder the queue in the meantime */
+   uint32_t primask = __get_PRIMASK();
+   __disable_irq();
+   /* only the earliest task has to be checked, when it is not due, nothing else is */
+   if (queue->size > 0 && sch_is_due(queue, &items_list.list[queue->heap[0]]))
+   {
+      result = &items_list.list[queue->heap[0]];
+      *late_ms = (queue->now - result->due) + lag;
+      if (*late_ms >= basetime)
+      {
+         result->profile.late_calls++;
+      }
+      if (result->type == TASKTYPE_TRIGGER)
+      {
+         result->state = TASKSTATE_STOPPED;
+         result->count = 0;
+         sch_queue_remove(result);
+      }
+      else
+      {
+         sch_reschedule_item(result, queue->now, lag, basetime);
+         sch_queue_sift_down(queue, 0);
+      }
+   }
+   __set_PRIMASK(primask);
+   return result;
+}
+
+void sch_reschedule_item(SchItem* item, uint32_t now, uint32_t lag, uint16_t basetime)
+{
+   /* task with period shorter than basetime is called once per tick */
+   uint32_t period = item->period > basetime? item->period : basetime;
+   uint32_t late_ms = now + lag - item->due;
+   uint32_t missed = 0;
+   switch (item->catchup)
+   {
+   case CATCHUP_SKIP:
+      missed = late_ms / period;
+      item->due = now + lag + period;
+      break;
+   case CATCHUP_COALESCE:
+      missed = late_ms / period;
+      item->due += (missed + 1) * period;
+      break;
+   default:
+      /* missed periods are called while the queued ticks are handled */
+      item->due = now + period;
+      break;
+   }
+   item->profile.dropped_calls += missed;
+}
+
+uint8_t sch_is_main_loop_prio(SchTaskPriority prio)
+{
+   return prio == TASKPRIO_NORMAL || prio == TASKPRIO_LOW;
+}
+
+uint32_t sch_get_lag(SchTaskPriority prio)
+{
+   /* high priority time is moved in SysTick interrupt, so it is not delayed by anything */
+   return prio != TASKPRIO_HIGH? sch_queues[TASKPRIO_HIGH].now - sch_queues[prio].now : 0;
+}
+
+void sch_catch_up_main_loop_time(SchTaskPriority prio)
+{
+   uint32_t primask = __get_PRIMASK();
+   __disable_irq();
+   if (evq_get_count(&sch_low_prio_events) == 0)
+   {
+      /* ticks dropped on full queue are not replayed, time jumps to the current one */
+      sch_queues[prio].now = sch_queues[TASKPRIO_HIGH].now;
+   }
+   __set_PRIMASK(primask);
+}
+
 void sch_on_time_change(TimeItem* item)
 {
    /* This is called from TIME module interrupt, do not place here so many stuff */
 	sch_call_tasks(TASKPRIO_HIGH);
-	sch_time_changed++;
+	sch_request_soft_irq();
+	evq_push(&sch_low_prio_events, &sch_on_low_prio_tick, 0);
 }
 
-void sch_realloc_data(SchItem* source, SchItem* dest)
+void sch_request_soft_irq()
 {
-	for (uint8_t i = 0; i < items_list.capacity; i++)
-	{
-		dest[i] = source[i];
-	}
-	free(source);
+#ifdef SIMULATION
+   /* there is no PendSV in simulation, time thread is handling soft interrupt directly */
+   sch_on_soft_irq();
+#else
+   SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+#endif
+}
+
+void sch_on_soft_irq()
+{
+   /* tickless SysTick may count many ticks, every one is handled */
+   while (sch_queues[TASKPRIO_SOFTIRQ].now != sch_queues[TASKPRIO_HIGH].now)
+   {
+      sch_call_tasks(TASKPRIO_SOFTIRQ);
+   }
+}
+
+void PendSV_Handler(void)
+{
+   sch_on_soft_irq();
+}
+
+void sch_on_low_prio_tick(uint32_t arg)
+{
+   /* both main loop levels are handled on the same tick, NORMAL tasks first */
+	sch_call_tasks(TASKPRIO_NORMAL);
+	sch_call_tasks(TASKPRIO_LOW);
+}
+
+void sch_reset_pool()
+{
+   memset(&items_list, 0, sizeof(items_list));
+   /* all items are chained in free list */
+   for (uint8_t i = 0; i < SCH_TASK_POOL_SIZE; i++)
+   {
+      items_list.list[i].next_free = i + 1 < SCH_TASK_POOL_SIZE? i + 1 : SCH_NO_FREE_ITEM;
+   }
+   items_list.first_free = 0;
+   for (uint8_t i = 0; i < TASKPRIO_UNKNOWN; i++)
+   {
+      sch_queues[i].size = 0;
+      sch_queues[i].now = 0;
+   }
 }
 
 RET_CODE sch_is_period_correct(TASK_PERIOD period)
@@ -318,9 +495,10 @@ RET_CODE sch_is_period_correct(TASK_PERIOD period)
 SchItem* sch_get_item(TASK task)
 {
 	SchItem* result = NULL;
-	for (uint8_t i = 0; i < items_list.capacity; i++)
+	for (uint8_t i = 0; i < SCH_TASK_POOL_SIZE; i++)
 	{
-		if (items_list.list[i].callback == task)
+		/* context tasks have no callback, so they are not found here */
+		if (task && items_list.list[i].state != TASKSTATE_EMPTY && items_list.list[i].callback == task)
 		{
 			result = &items_list.list[i];
 			break;
@@ -329,10 +507,484 @@ SchItem* sch_get_item(TASK task)
 	return result;
 }
 
+SchItem* sch_get_item_by_handle(SCH_HANDLE handle)
+{
+   SchItem* result = NULL;
+   uint8_t idx = handle & 0xFF;
+   if (handle != SCH_INVALID_HANDLE && idx < SCH_TASK_POOL_SIZE)
+   {
+      SchItem* item = &items_list.list[idx];
+      /* generation differs when task was unsubscribed in the meantime */
+      if (item->state != TASKSTATE_EMPTY && item->generation == (handle >> 8))
+      {
+         result = item;
+      }
+   }
+   return result;
+}
+
+SCH_HANDLE sch_item_to_handle(SchItem* item)
+{
+   return (SCH_HANDLE)(((uint16_t)item->generation << 8) | (uint8_t)(item - items_list.list));
+}
+
+SchItem* sch_add_item(TASK task, TASK_CTX ctx_task, void* ctx)
+{
+   SchItem* result = NULL;
+   if (task || ctx_task)
+   {
+      uint32_t primask = __get_PRIMASK();
+      __disable_irq();
+      if (items_list.first_free != SCH_NO_FREE_ITEM)
+      {
+         result = &items_list.list[items_list.first_free];
+         items_list.first_free = result->next_free;
+         result->callback = task;
+         result->ctx_callback = ctx_task;
+         result->ctx = ctx;
+         result->count = 0;
+         result->period = 0;
+         result->priority = TASKPRIO_LOW;
+         result->catchup = CATCHUP_BURST;
+         result->queue_pos = SCH_NOT_QUEUED;
+         result->state = TASKSTATE_STOPPED;
+         memset(&result->profile, 0, sizeof(SchProfile));
+         items_list.size++;
+         if (items_list.size > items_list.high_water)
+         {
+            items_list.high_water = items_list.size;
+         }
+      }
+      __set_PRIMASK(primask);
+      if (!result)
+      {
+         logger_send(LOG_ERROR, __func__, "Task pool exhausted!");
+      }
+   }
+   return result;
+}
+
+RET_CODE sch_set_item(SchItem* item, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type)
+{
+   RET_CODE result = RETURN_NOK;
+   do
+   {
+      if (sch_item_set_priority(item, prio) != RETURN_OK){break;}
+      if (sch_item_set_period(item, period) != RETURN_OK){break;}
+      if (sch_item_set_state(item, state) != RETURN_OK){break;}
+      if (sch_item_set_type(item, type) != RETURN_OK){break;}
+      result = RETURN_OK;
+   }while(0);
+
+   return result;
+}
+
+RET_CODE sch_item_unsubscribe(SchItem* item)
+{
+   RET_CODE result = RETURN_NOK;
+   if (item)
+   {
+      uint32_t primask = __get_PRIMASK();
+      __disable_irq();
+      sch_queue_remove(item);
+      item->state = TASKSTATE_EMPTY;
+      item->callback = NULL;
+      item->ctx_callback = NULL;
+      item->generation++;
+      item->next_free = items_list.first_free;
+      items_list.first_free = (uint8_t)(item - items_list.list);
+      items_list.size--;
+      __set_PRIMASK(primask);
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE sch_item_set_period(SchItem* item, TASK_PERIOD period)
+{
+   RET_CODE result = RETURN_NOK;
+
+   if (sch_is_period_correct (period) == RETURN_OK && item)
+   {
+      uint32_t primask = __get_PRIMASK();
+      __disable_irq();
+      item->period = period;
+      item->count = 0;
+      if (item->queue_pos != SCH_NOT_QUEUED)
+      {
+         item->due = sch_get_queue_time(&sch_queues[item->priority]) + period;
+         sch_queue_update(item);
+      }
+      __set_PRIMASK(primask);
+      time_reschedule();
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE sch_item_set_state(SchItem* item, SchTaskState state)
+{
+   RET_CODE result = RETURN_NOK;
+
+   if (item && state != TASKSTATE_UNKNOWN)
+   {
+      uint32_t primask = __get_PRIMASK();
+      __disable_irq();
+      if (item->state == TASKSTATE_RUNNING && state != TASKSTATE_RUNNING)
+      {
+         sch_stop_item(item);
+      }
+      else if (item->state != TASKSTATE_RUNNING && state == TASKSTATE_RUNNING)
+      {
+         sch_start_item(item);
+      }
+      item->state = state;
+      __set_PRIMASK(primask);
+      time_reschedule();
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE sch_item_set_type(SchItem* item, SchTaskType type)
+{
+   RET_CODE result = RETURN_NOK;
+
+   if (item && type != TASKTYPE_UNKNOWN)
+   {
+      item->type = type;
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE sch_item_set_priority(SchItem* item, SchTaskPriority prio)
+{
+   RET_CODE result = RETURN_NOK;
+
+   if (item && prio < TASKPRIO_UNKNOWN)
+   {
+      uint32_t primask = __get_PRIMASK();
+      __disable_irq();
+      if (item->queue_pos != SCH_NOT_QUEUED)
+      {
+         /* keep the remaining time, but count it on the new priority time */
+         sch_stop_item(item);
+         item->priority = prio;
+         sch_start_item(item);
+      }
+      else
+      {
+         item->priority = prio;
+      }
+      __set_PRIMASK(primask);
+      time_reschedule();
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE sch_item_set_catchup(SchItem* item, SchCatchupPolicy policy)
+{
+   RET_CODE result = RETURN_NOK;
+
+   if (item && policy < CATCHUP_UNKNOWN)
+   {
+      item->catchup = policy;
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE sch_item_trigger(SchItem* item)
+{
+   RET_CODE result = RETURN_NOK;
+
+   if (item && item->type == TASKTYPE_TRIGGER)
+   {
+      uint32_t primask = __get_PRIMASK();
+      __disable_irq();
+      item->count = 0;
+      if (item->queue_pos != SCH_NOT_QUEUED)
+      {
+         item->due = sch_get_queue_time(&sch_queues[item->priority]) + item->period;
+         sch_queue_update(item);
+      }
+      else
+      {
+         sch_start_item(item);
+      }
+      item->state = TASKSTATE_RUNNING;
+      __set_PRIMASK(primask);
+      time_reschedule();
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+uint8_t sch_is_due(SchQueue* queue, SchItem* item)
+{
+   /* signed difference keeps the comparison correct when time overflows */
+   return (int32_t)(item->due - queue->now) <= 0;
+}
+
+void sch_queue_swap(SchQueue* queue, uint8_t pos1, uint8_t pos2)
+{
+   uint8_t idx = queue->heap[pos1];
+   queue->heap[pos1] = queue->heap[pos2];
+   queue->heap[pos2] = idx;
+   items_list.list[queue->heap[pos1]].queue_pos = pos1;
+   items_list.list[queue->heap[pos2]].queue_pos = pos2;
+}
+
+void sch_queue_sift_up(SchQueue* queue, uint8_t pos)
+{
+   while (pos > 0)
+   {
+      uint8_t parent = (pos - 1) / 2;
+      SchItem* item = &items_list.list[queue->heap[pos]];
+      SchItem* parent_item = &items_list.list[queue->heap[parent]];
+      if ((int32_t)(item->due - parent_item->due) >= 0)
+      {
+         break;
+      }
+      sch_queue_swap(queue, pos, parent);
+      pos = parent;
+   }
+}
+
+void sch_queue_sift_down(SchQueue* queue, uint8_t pos)
+{
+   while (1)
+   {
+      uint16_t left = 2 * pos + 1;
+      uint16_t right = left + 1;
+      uint8_t smallest = pos;
+
+      if (left < queue->size &&
+          (int32_t)(items_list.list[queue->heap[left]].due - items_list.list[queue->heap[smallest]].due) < 0)
+      {
+         smallest = left;
+      }
+      if (right < queue->size &&
+          (int32_t)(items_list.list[queue->heap[right]].due - items_list.list[queue->heap[smallest]].due) < 0)
+      {
+         smallest = right;
+      }
+      if (smallest == pos)
+      {
+         break;
+      }
+      sch_queue_swap(queue, pos, smallest);
+      pos = smallest;
+   }
+}
+
+void sch_queue_push(SchItem* item)
+{
+   SchQueue* queue = &sch_queues[item->priority];
+   uint8_t pos = queue->size;
+   queue->heap[pos] = (uint8_t)(item - items_list.list);
+   item->queue_pos = pos;
+   queue->size++;
+   sch_queue_sift_up(queue, pos);
+}
+
+void sch_queue_remove(SchItem* item)
+{
+   if (item->queue_pos != SCH_NOT_QUEUED)
+   {
+      SchQueue* queue = &sch_queues[item->priority];
+      uint8_t pos = item->queue_pos;
+      uint8_t last = queue->size - 1;
+
+      item->queue_pos = SCH_NOT_QUEUED;
+      queue->size--;
+      if (pos != last)
+      {
+         queue->heap[pos] = queue->heap[last];
+         items_list.list[queue->heap[pos]].queue_pos = pos;
+         sch_queue_update(&items_list.list[queue->heap[pos]]);
+      }
+   }
+}
+
+void sch_queue_update(SchItem* item)
+{
+   SchQueue* queue = &sch_queues[item->priority];
+   uint8_t pos = item->queue_pos;
+   sch_queue_sift_up(queue, pos);
+   if (item->queue_pos == pos)
+   {
+      sch_queue_sift_down(queue, pos);
+   }
+}
+
+void sch_start_item(SchItem* item)
+{
+   if (item->queue_pos == SCH_NOT_QUEUED)
+   {
+      TASK_PERIOD remaining = item->count < item->period? item->period - item->count : 0;
+      item->due = sch_get_queue_time(&sch_queues[item->priority]) + remaining;
+      sch_queue_push(item);
+   }
+}
+
+void sch_stop_item(SchItem* item)
+{
+   if (item->queue_pos != SCH_NOT_QUEUED)
+   {
+      int32_t remaining = (int32_t)(item->due - sch_get_queue_time(&sch_queues[item->priority]));
+      if (remaining <= 0)
+      {
+         item->count = item->period;
+      }
+      else
+      {
+         item->count = remaining < item->period? item->period - remaining : 0;
+      }
+      sch_queue_remove(item);
+   }
+}
+
+void sch_enable_stats()
+{
+   sch_stats_enabled = 1;
+}
+
+void sch_disable_stats()
+{
+   sch_stats_enabled = 0;
+}
+
+void sch_reset_stats()
+{
+   for (uint8_t i = 0; i < SCH_TASK_POOL_SIZE; i++)
+   {
+      uint32_t primask = __get_PRIMASK();
+      __disable_irq();
+      memset(&items_list.list[i].profile, 0, sizeof(SchProfile));
+      __set_PRIMASK(primask);
+   }
+}
+
+RET_CODE sch_get_task_stats(uint8_t idx, SchTaskStats* buffer)
+{
+   RET_CODE result = RETURN_NOK;
+   uint8_t task_no = 0;
+   for (uint8_t i = 0; i < SCH_TASK_POOL_SIZE && buffer; i++)
+   {
+      SchItem* item = &items_list.list[i];
+      if (item->state != TASKSTATE_EMPTY)
+      {
+         if (task_no == idx)
+         {
+            /* high priority task may update statistics in the meantime */
+            uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+            buffer->task = item->callback? item->callback : (TASK)item->ctx_callback;
+            buffer->priority = item->priority;
+            buffer->period = item->period;
+            buffer->calls = item->profile.calls;
+            buffer->last_time_us = item->profile.last_time_us;
+            buffer->max_time_us = item->profile.max_time_us;
+            buffer->total_time_us = item->profile.total_time_us;
+            buffer->last_latency_us = item->profile.last_latency_us;
+            buffer->max_latency_us = item->profile.max_latency_us;
+            buffer->overruns = item->profile.overruns;
+            buffer->late_calls = item->profile.late_calls;
+            buffer->dropped_calls = item->profile.dropped_calls;
+            __set_PRIMASK(primask);
+            result = RETURN_OK;
+            break;
+         }
+         task_no++;
+      }
+   }
+   return result;
+}
+
+uint32_t sch_get_dropped_ticks()
+{
+   return evq_get_overflows(&sch_low_prio_events);
+}
+
+uint8_t sch_get_tasks_count()
+{
+   return items_list.size;
+}
+
+uint8_t sch_get_pool_high_water()
+{
+   return items_list.high_water;
+}
+
+void sch_update_stats(SchItem* item, uint32_t latency_us, uint32_t exec_time_us)
+{
+   SchProfile* profile = &item->profile;
+   profile->calls++;
+   profile->last_time_us = exec_time_us;
+   profile->total_time_us += exec_time_us;
+   if (exec_time_us > profile->max_time_us)
+   {
+      profile->max_time_us = exec_time_us;
+   }
+   profile->last_latency_us = latency_us;
+   if (latency_us > profile->max_latency_us)
+   {
+      profile->max_latency_us = latency_us;
+   }
+   if (exec_time_us > (uint32_t)item->period * 1000)
+   {
+      profile->overruns++;
+   }
+}
+
+uint32_t sch_get_queue_time(SchQueue* queue)
+{
+   uint32_t result = queue->now;
+   /* in tickless mode the ticks elapsed from last interrupt are not counted yet */
+   uint16_t pending = time_get_pending_ticks();
+   if (pending)
+   {
+      result += (uint32_t)pending * time_get_basetime();
+   }
+   return result;
+}
+
+uint32_t sch_get_next_deadline()
+{
+   uint32_t result = SCH_NO_DEADLINE;
+   uint16_t basetime = time_get_basetime();
+   uint16_t pending = time_get_pending_ticks();
+
+   uint32_t primask = __get_PRIMASK();
+   __disable_irq();
+   for (uint8_t i = 0; i < TASKPRIO_UNKNOWN; i++)
+   {
+      SchQueue* queue = &sch_queues[i];
+      if (queue->size > 0)
+      {
+         /* main loop and soft interrupt time is behind until the ticks are handled */
+         uint32_t lag = sch_get_lag((SchTaskPriority)i) + (uint32_t)pending * basetime;
+         int32_t remaining = (int32_t)(items_list.list[queue->heap[0]].due - queue->now - lag);
+         if (remaining < 0)
+         {
+            remaining = 0;
+         }
+         if ((uint32_t)remaining < result)
+         {
+            result = (uint32_t)remaining;
+         }
+      }
+   }
+   __set_PRIMASK(primask);
+   return result;
+}
+
 void sch_deinitialize()
 {
 	time_unregister_callback(&sch_on_time_change);
-	free(items_list.list);
-	items_list.size = 0;
-	items_list.capacity = 0;
+	evq_unregister(&sch_low_prio_events);
+	sch_reset_pool();
 }
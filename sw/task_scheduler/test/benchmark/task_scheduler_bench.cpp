@@ -0,0 +1,149 @@
+#include <chrono>
+#include <cstdio>
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../source/task_scheduler.c"
+#ifdef __cplusplus
+}
+#endif
+
+/* ============================= */
+/**
+ * @file task_scheduler_bench.cpp
+ *
+ * @brief Host benchmark of Task Scheduler module
+ *
+ * @details
+ * Measures cost of the scheduler tick and of the task control API for
+ * different numbers of subscribed tasks. Scheduler dependencies are replaced
+ * by trivial fakes, so only the scheduler itself is measured.
+ * Results are printed as ns per tick/operation, run it on idle machine.
+ */
+/* ============================= */
+
+/* =============================
+ *   Fakes of module dependencies
+ * =============================*/
+RET_CODE time_register_callback(void(*callback)(TimeItem*), TimeCallbackPriority prio) { return RETURN_OK; }
+RET_CODE time_unregister_callback(void(*callback)(TimeItem*)) { return RETURN_OK; }
+uint16_t time_get_basetime() { return 10; }
+uint16_t time_get_pending_ticks() { return 0; }
+void time_reschedule() {}
+uint32_t ts_get_cycles() { return 0; }
+void logger_send(LogGroup group, const char* prefix, const char* fmt, ...) {}
+void logger_send_if(uint8_t cond_bool, LogGroup group, const char* prefix, const char* fmt, ...) {}
+
+/* =============================
+ *          Benchmark
+ * =============================*/
+typedef std::chrono::steady_clock bench_clock;
+
+static const uint16_t BENCH_TASK_COUNTS[] = {10, 100, SCH_TASK_POOL_SIZE - 4};
+static const uint32_t BENCH_TICKS = 100000;
+static const uint32_t BENCH_OPERATIONS = 100000;
+static const TASK_PERIOD BENCH_PERIODS[] = {10, 20, 50, 100, 250, 1000, 5000};
+
+volatile uint32_t bench_calls;
+volatile uint32_t bench_sink;   /**< Keeps results of measured functions from being optimized out */
+void bench_task()
+{
+   bench_calls++;
+}
+
+static double bench_ns_per(bench_clock::time_point start, uint32_t count)
+{
+   return std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / count;
+}
+
+/**
+ * Subscribes tasks with mixed properties:
+ * every 4th is HIGH priority, every 8th is stopped and every 10th is TRIGGER type.
+ */
+static void bench_subscribe_tasks(uint16_t count, SCH_HANDLE* triggers, uint16_t* triggers_count)
+{
+   *triggers_count = 0;
+   for (uint16_t i = 0; i < count; i++)
+   {
+      SchTaskPriority prio = (i % 4 == 0)? TASKPRIO_HIGH : TASKPRIO_LOW;
+      SchTaskType type = (i % 10 == 0)? TASKTYPE_TRIGGER : TASKTYPE_PERIODIC;
+      SchTaskState state = (i % 8 == 0)? TASKSTATE_STOPPED : TASKSTATE_RUNNING;
+      TASK_PERIOD period = BENCH_PERIODS[i % (sizeof(BENCH_PERIODS) / sizeof(BENCH_PERIODS[0]))];
+      SCH_HANDLE handle = sch_subscribe_handle(&bench_task, prio, period, state, type);
+      if (type == TASKTYPE_TRIGGER)
+      {
+         triggers[(*triggers_count)++] = handle;
+      }
+   }
+}
+
+static void bench_run(uint16_t count)
+{
+   TimeItem item = {};
+   SCH_HANDLE triggers [SCH_TASK_POOL_SIZE];
+   uint16_t triggers_count;
+
+   sch_initialize();
+   bench_subscribe_tasks(count, triggers, &triggers_count);
+
+   /* SysTick part and main loop part of the tick, the same as on target */
+   bench_calls = 0;
+   bench_clock::time_point start = bench_clock::now();
+   for (uint32_t i = 0; i < BENCH_TICKS; i++)
+   {
+      sch_on_time_change(&item);
+      sch_on_soft_irq();
+      evq_dispatch_all();
+   }
+   double tick_ns = bench_ns_per(start, BENCH_TICKS);
+   double calls_per_tick = (double)bench_calls / BENCH_TICKS;
+
+   start = bench_clock::now();
+   for (uint32_t i = 0; i < BENCH_OPERATIONS; i++)
+   {
+      sch_handle_trigger(triggers[i % triggers_count]);
+   }
+   double trigger_ns = bench_ns_per(start, BENCH_OPERATIONS);
+
+   start = bench_clock::now();
+   for (uint32_t i = 0; i < BENCH_OPERATIONS; i++)
+   {
+      bench_sink = sch_get_next_deadline();
+   }
+   double deadline_ns = bench_ns_per(start, BENCH_OPERATIONS);
+
+   /* one slot is kept free for subscribe/unsubscribe pair */
+   start = bench_clock::now();
+   for (uint32_t i = 0; i < BENCH_OPERATIONS; i++)
+   {
+      SCH_HANDLE handle = sch_subscribe_handle(&bench_task, TASKPRIO_LOW, 100, TASKSTATE_RUNNING, TASKTYPE_PERIODIC);
+      sch_handle_unsubscribe(handle);
+   }
+   double subscribe_ns = bench_ns_per(start, BENCH_OPERATIONS);
+
+   start = bench_clock::now();
+   for (uint32_t i = 0; i < BENCH_OPERATIONS; i++)
+   {
+      sch_set_task_state(&bench_task, (i & 0x01)? TASKSTATE_RUNNING : TASKSTATE_STOPPED);
+   }
+   double lookup_ns = bench_ns_per(start, BENCH_OPERATIONS);
+
+   printf("%6u %10.1f %10.2f %12.1f %12.1f %12.1f %12.1f\n", count, tick_ns, calls_per_tick,
+          subscribe_ns, trigger_ns, deadline_ns, lookup_ns);
+   sch_deinitialize();
+}
+
+int main()
+{
+   stm_stub_init();
+   printf("Task scheduler benchmark, pool size %u, %u ticks, %u operations\n",
+          SCH_TASK_POOL_SIZE, BENCH_TICKS, BENCH_OPERATIONS);
+   printf("%6s %10s %10s %12s %12s %12s %12s\n", "tasks", "ns/tick", "calls/tick",
+          "ns/sub+unsub", "ns/trigger", "ns/deadline", "ns/by_func");
+   for (uint16_t count : BENCH_TASK_COUNTS)
+   {
+      bench_run(count);
+   }
+   stm_stub_deinit();
+   return 0;
+}
@@ -19,6 +19,29 @@ struct taskSchedulerMock
 	MOCK_METHOD1(sch_get_task_period, TASK_PERIOD(TASK));
 	MOCK_METHOD1(sch_get_task_state, SchTaskState(TASK));
 	MOCK_METHOD1(sch_get_task_type, SchTaskType(TASK));
+	MOCK_METHOD2(sch_set_task_catchup, RET_CODE(TASK, SchCatchupPolicy));
+	MOCK_METHOD1(sch_get_task_catchup, SchCatchupPolicy(TASK));
+	MOCK_METHOD5(sch_subscribe_handle, SCH_HANDLE(TASK, SchTaskPriority, TASK_PERIOD, SchTaskState, SchTaskType));
+	MOCK_METHOD6(sch_subscribe_ctx, SCH_HANDLE(TASK_CTX, void*, SchTaskPriority, TASK_PERIOD, SchTaskState, SchTaskType));
+	MOCK_METHOD1(sch_handle_unsubscribe, RET_CODE(SCH_HANDLE));
+	MOCK_METHOD2(sch_handle_set_period, RET_CODE(SCH_HANDLE, TASK_PERIOD));
+	MOCK_METHOD2(sch_handle_set_state, RET_CODE(SCH_HANDLE, SchTaskState));
+	MOCK_METHOD2(sch_handle_set_type, RET_CODE(SCH_HANDLE, SchTaskType));
+	MOCK_METHOD2(sch_handle_set_priority, RET_CODE(SCH_HANDLE, SchTaskPriority));
+	MOCK_METHOD1(sch_handle_trigger, RET_CODE(SCH_HANDLE));
+	MOCK_METHOD1(sch_handle_get_period, TASK_PERIOD(SCH_HANDLE));
+	MOCK_METHOD1(sch_handle_get_state, SchTaskState(SCH_HANDLE));
+	MOCK_METHOD1(sch_handle_get_type, SchTaskType(SCH_HANDLE));
+	MOCK_METHOD2(sch_handle_set_catchup, RET_CODE(SCH_HANDLE, SchCatchupPolicy));
+	MOCK_METHOD1(sch_handle_get_catchup, SchCatchupPolicy(SCH_HANDLE));
+	MOCK_METHOD0(sch_get_next_deadline, uint32_t());
+	MOCK_METHOD0(sch_enable_stats, void());
+	MOCK_METHOD0(sch_disable_stats, void());
+	MOCK_METHOD0(sch_reset_stats, void());
+	MOCK_METHOD2(sch_get_task_stats, RET_CODE(uint8_t, SchTaskStats*));
+	MOCK_METHOD0(sch_get_dropped_ticks, uint32_t());
+	MOCK_METHOD0(sch_get_tasks_count, uint8_t());
+	MOCK_METHOD0(sch_get_pool_high_water, uint8_t());
 	MOCK_METHOD0(sch_deinitialize, void());
 };
 
@@ -86,9 +109,105 @@ SchTaskType sch_get_task_type (TASK task)
 {
 	return sch_mock->sch_get_task_type(task);
 }
+RET_CODE sch_set_task_catchup (TASK task, SchCatchupPolicy policy)
+{
+   return sch_mock->sch_set_task_catchup(task, policy);
+}
+SchCatchupPolicy sch_get_task_catchup (TASK task)
+{
+   return sch_mock->sch_get_task_catchup(task);
+}
+SCH_HANDLE sch_subscribe_handle(TASK task, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type)
+{
+   return sch_mock->sch_subscribe_handle(task, prio, period, state, type);
+}
+SCH_HANDLE sch_subscribe_ctx(TASK_CTX task, void* ctx, SchTaskPriority prio, TASK_PERIOD period, SchTaskState state, SchTaskType type)
+{
+   return sch_mock->sch_subscribe_ctx(task, ctx, prio, period, state, type);
+}
+RET_CODE sch_handle_unsubscribe (SCH_HANDLE handle)
+{
+   return sch_mock->sch_handle_unsubscribe(handle);
+}
+RET_CODE sch_handle_set_period (SCH_HANDLE handle, TASK_PERIOD period)
+{
+   return sch_mock->sch_handle_set_period(handle, period);
+}
+RET_CODE sch_handle_set_state (SCH_HANDLE handle, SchTaskState state)
+{
+   return sch_mock->sch_handle_set_state(handle, state);
+}
+RET_CODE sch_handle_set_type (SCH_HANDLE handle, SchTaskType type)
+{
+   return sch_mock->sch_handle_set_type(handle, type);
+}
+RET_CODE sch_handle_set_priority (SCH_HANDLE handle, SchTaskPriority prio)
+{
+   return sch_mock->sch_handle_set_priority(handle, prio);
+}
+RET_CODE sch_handle_trigger (SCH_HANDLE handle)
+{
+   return sch_mock->sch_handle_trigger(handle);
+}
+TASK_PERIOD sch_handle_get_period (SCH_HANDLE handle)
+{
+   return sch_mock->sch_handle_get_period(handle);
+}
+SchTaskState sch_handle_get_state (SCH_HANDLE handle)
+{
+   return sch_mock->sch_handle_get_state(handle);
+}
+SchTaskType sch_handle_get_type (SCH_HANDLE handle)
+{
+   return sch_mock->sch_handle_get_type(handle);
+}
+RET_CODE sch_handle_set_catchup (SCH_HANDLE handle, SchCatchupPolicy policy)
+{
+   return sch_mock->sch_handle_set_catchup(handle, policy);
+}
+SchCatchupPolicy sch_handle_get_catchup (SCH_HANDLE handle)
+{
+   return sch_mock->sch_handle_get_catchup(handle);
+}
 void sch_task_watcher()
 {
 
+}
+void sch_on_soft_irq()
+{
+
+}
+uint32_t sch_get_next_deadline()
+{
+	return sch_mock->sch_get_next_deadline();
+}
+void sch_enable_stats()
+{
+	sch_mock->sch_enable_stats();
+}
+void sch_disable_stats()
+{
+	sch_mock->sch_disable_stats();
+}
+void sch_reset_stats()
+{
+	sch_mock->sch_reset_stats();
+}
+RET_CODE sch_get_task_stats(uint8_t idx, SchTaskStats* buffer)
+{
+	return sch_mock->sch_get_task_stats(idx, buffer);
+}
+uint32_t sch_get_dropped_ticks()
+{
+	return sch_mock->sch_get_dropped_ticks();
+}
+uint8_t sch_get_tasks_count()
+{
+	return sch_mock->sch_get_tasks_count();
+}
+uint8_t sch_get_pool_high_water()
+{
+	return sch_mock->sch_get_pool_high_water();
 }
 void sch_deinitialize()
 {
@@ -9,6 +9,7 @@ extern "C" {
 #endif
 
 #include "time_counter_mock.h"
+#include "system_timestamp_mock.h"
 #include "logger_mock.h"
 
 /* ============================= */
@@ -32,6 +33,7 @@ struct callbackMock
 	MOCK_METHOD0(task1_callback, void());
 	MOCK_METHOD0(task2_callback, void());
 	MOCK_METHOD0(task3_callback, void());
+	MOCK_METHOD1(ctx_callback, void(void*));
 };
 
 callbackMock* callMock;
@@ -48,20 +50,30 @@ void fake_callback3()
 {
 	callMock->task3_callback();
 }
+void fake_ctx_callback(void* ctx)
+{
+	callMock->ctx_callback(ctx);
+}
 
 struct timeFixture : public ::testing::Test
 {
 	virtual void SetUp()
 	{
+		stm_stub_init();
 		mock_time_counter_init();
+		mock_ts_init();
 		mock_logger_init();
 		callMock = new callbackMock();
+		EXPECT_CALL(*time_cnt_mock, time_get_pending_ticks()).WillRepeatedly(Return(0));
+		EXPECT_CALL(*time_cnt_mock, time_reschedule()).Times(AnyNumber());
 	}
 
 	virtual void TearDown()
 	{
 		mock_time_counter_deinit();
+		mock_ts_deinit();
 		mock_logger_deinit();
+		stm_stub_deinit();
 		delete callMock;
 	}
 };
@@ -117,24 +129,42 @@ TEST_F(timeFixture, task_add_remove_test)
 	 */
 
 	EXPECT_EQ(items_list.size, 0);
-	EXPECT_EQ(items_list.capacity, DEFAULT_TASKLIST_SIZE);
+	EXPECT_EQ(0, sch_get_pool_high_water());
 
-	for (uint8_t i = 0; i < DEFAULT_TASKLIST_SIZE; i++)
+	for (uint8_t i = 0; i < SCH_TASK_POOL_SIZE; i++)
 	{
 		EXPECT_EQ(RETURN_OK, sch_subscribe(&fake_callback1));
 	}
 
-	EXPECT_EQ(items_list.size, DEFAULT_TASKLIST_SIZE);
-	EXPECT_EQ(items_list.capacity, DEFAULT_TASKLIST_SIZE);
+	EXPECT_EQ(items_list.size, SCH_TASK_POOL_SIZE);
+	EXPECT_EQ(SCH_TASK_POOL_SIZE, sch_get_tasks_count());
+	EXPECT_EQ(SCH_TASK_POOL_SIZE, sch_get_pool_high_water());
 
 	/**
-	 * <b>scenario</b>: List is full, task is added.<br>
-	 * <b>expected</b>: List should be reallocated and resized with DEFAULT_TASK_INCR step.<br>
+	 * <b>scenario</b>: Pool is full, task is added.<br>
+	 * <b>expected</b>: Task not added.<br>
     * ************************************************
 	 */
-	EXPECT_EQ(RETURN_OK, sch_subscribe(&fake_callback1));
-	EXPECT_EQ(items_list.size, DEFAULT_TASKLIST_SIZE + 1);
-	EXPECT_EQ(items_list.capacity, DEFAULT_TASKLIST_SIZE + DEFAULT_TASK_INCR);
+	EXPECT_EQ(RETURN_NOK, sch_subscribe(&fake_callback2));
+	EXPECT_EQ(SCH_INVALID_HANDLE, sch_subscribe_handle(&fake_callback2, TASKPRIO_LOW, 100, TASKSTATE_STOPPED, TASKTYPE_PERIODIC));
+	EXPECT_EQ(items_list.size, SCH_TASK_POOL_SIZE);
+
+	/**
+	 * <b>scenario</b>: Tasks removed from the middle of the pool and added again.<br>
+	 * <b>expected</b>: Released slots reused, high water mark not changed.<br>
+    * ************************************************
+	 */
+	SchItem* item1 = &items_list.list[5];
+	SchItem* item2 = &items_list.list[12];
+	EXPECT_EQ(RETURN_OK, sch_item_unsubscribe(item1));
+	EXPECT_EQ(RETURN_OK, sch_item_unsubscribe(item2));
+	EXPECT_EQ(SCH_TASK_POOL_SIZE - 2, sch_get_tasks_count());
+	EXPECT_EQ(RETURN_OK, sch_subscribe(&fake_callback2));
+	EXPECT_EQ(RETURN_OK, sch_subscribe(&fake_callback3));
+	EXPECT_EQ(&fake_callback3, item1->callback);
+	EXPECT_EQ(&fake_callback2, item2->callback);
+	EXPECT_EQ(RETURN_NOK, sch_subscribe(&fake_callback2));
+	EXPECT_EQ(SCH_TASK_POOL_SIZE, sch_get_pool_high_water());
 
 	EXPECT_CALL(*time_cnt_mock, time_unregister_callback(_));
 	sch_deinitialize();
@@ -638,3 +668,607 @@ TEST_F(timeFixture, task_low_high_priority_calling_test)
    sch_deinitialize();
 }
 
+/**
+ * @test Soft interrupt and normal priority tasks calling order
+ */
+TEST_F(timeFixture, task_softirq_normal_priority_calling_test)
+{
+   TimeItem item = {};
+   EXPECT_CALL(*time_cnt_mock, time_register_callback(_,TIME_PRIORITY_HIGH));
+   EXPECT_CALL(*time_cnt_mock, time_get_basetime()).WillRepeatedly(Return(10));
+   sch_initialize();
+
+   EXPECT_EQ(RETURN_OK, sch_subscribe_and_set(&fake_callback1, TASKPRIO_LOW, 20,
+                         TASKSTATE_RUNNING, TASKTYPE_PERIODIC));
+   EXPECT_EQ(RETURN_OK, sch_subscribe_and_set(&fake_callback2, TASKPRIO_NORMAL, 20,
+                         TASKSTATE_RUNNING, TASKTYPE_PERIODIC));
+   EXPECT_EQ(RETURN_OK, sch_subscribe_and_set(&fake_callback3, TASKPRIO_SOFTIRQ, 20,
+                         TASKSTATE_RUNNING, TASKTYPE_PERIODIC));
+
+   /**
+    * <b>scenario</b>: Two ticks counted in SysTick interrupt.<br>
+    * <b>expected</b>: PendSV requested after every tick, soft interrupt task not called yet.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, task3_callback()).Times(0);
+   sch_on_time_change(&item);
+   EXPECT_EQ(SCB_ICSR_PENDSVSET_Msk, SCB->ICSR & SCB_ICSR_PENDSVSET_Msk);
+   SCB->ICSR = 0;
+   sch_on_time_change(&item);
+   EXPECT_EQ(SCB_ICSR_PENDSVSET_Msk, SCB->ICSR & SCB_ICSR_PENDSVSET_Msk);
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /**
+    * <b>scenario</b>: PendSV interrupt handled.<br>
+    * <b>expected</b>: Soft interrupt task called, main loop tasks not called.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, task3_callback()).Times(1);
+   PendSV_Handler();
+   Mock::VerifyAndClearExpectations(callMock);
+   EXPECT_EQ(sch_queues[TASKPRIO_HIGH].now, sch_queues[TASKPRIO_SOFTIRQ].now);
+
+   /**
+    * <b>scenario</b>: Main loop handles queued ticks.<br>
+    * <b>expected</b>: Normal priority task called before low priority task.<br>
+    * ************************************************
+    */
+   {
+      InSequence seq;
+      EXPECT_CALL(*callMock, task2_callback());
+      EXPECT_CALL(*callMock, task1_callback());
+   }
+   evq_dispatch_all();
+   Mock::VerifyAndClearExpectations(callMock);
+   EXPECT_EQ(sch_queues[TASKPRIO_HIGH].now, sch_queues[TASKPRIO_NORMAL].now);
+   EXPECT_EQ(sch_queues[TASKPRIO_HIGH].now, sch_queues[TASKPRIO_LOW].now);
+
+   /**
+    * <b>scenario</b>: Soft interrupt handled late, after many ticks (e.g. tickless mode).<br>
+    * <b>expected</b>: Soft interrupt task called for every missed period.<br>
+    * ************************************************
+    */
+   for (uint8_t i = 0; i < 6; i++)
+   {
+      sch_on_time_change(&item);
+   }
+   EXPECT_CALL(*callMock, task3_callback()).Times(3);
+   sch_on_soft_irq();
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /**
+    * <b>scenario</b>: Next deadline requested when soft interrupt is pending.<br>
+    * <b>expected</b>: Pending soft interrupt ticks counted - task due now.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, task1_callback()).Times(3);
+   EXPECT_CALL(*callMock, task2_callback()).Times(3);
+   evq_dispatch_all();
+   sch_on_time_change(&item);
+   sch_on_time_change(&item);
+   EXPECT_EQ(0, sch_get_next_deadline());
+
+   EXPECT_CALL(*time_cnt_mock, time_unregister_callback(_));
+   sch_deinitialize();
+}
+
+/**
+ * @test Stopped task keeps the time elapsed before stop
+ */
+TEST_F(timeFixture, task_stop_resume_keeps_elapsed_time)
+{
+   TimeItem item = {};
+   EXPECT_CALL(*time_cnt_mock, time_register_callback(_,TIME_PRIORITY_HIGH));
+   EXPECT_CALL(*time_cnt_mock, time_get_basetime()).WillRepeatedly(Return(10));
+   sch_initialize();
+
+   EXPECT_EQ(RETURN_OK, sch_subscribe_and_set(&fake_callback1, TASKPRIO_LOW, 50,
+                         TASKSTATE_RUNNING, TASKTYPE_PERIODIC));
+   /**
+    * <b>scenario</b>: Task stopped after 30ms of 50ms period, then started again.<br>
+    * <b>expected</b>: Task called 20ms after restart.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, task1_callback()).Times(0);
+   for (uint8_t i = 0; i < 3; i++)
+   {
+      sch_on_time_change(&item);
+      sch_task_watcher();
+   }
+   EXPECT_EQ(RETURN_OK, sch_set_task_state(&fake_callback1, TASKSTATE_STOPPED));
+   for (uint8_t i = 0; i < 10; i++)
+   {
+      sch_on_time_change(&item);
+      sch_task_watcher();
+   }
+   EXPECT_EQ(RETURN_OK, sch_set_task_state(&fake_callback1, TASKSTATE_RUNNING));
+   sch_on_time_change(&item);
+   sch_task_watcher();
+   Mock::VerifyAndClearExpectations(callMock);
+
+   EXPECT_CALL(*callMock, task1_callback()).Times(1);
+   sch_on_time_change(&item);
+   sch_task_watcher();
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /**
+    * <b>scenario</b>: Task priority changed to high when 20ms of period elapsed.<br>
+    * <b>expected</b>: Task called from interrupt after remaining 30ms.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, task1_callback()).Times(0);
+   for (uint8_t i = 0; i < 2; i++)
+   {
+      sch_on_time_change(&item);
+      sch_task_watcher();
+   }
+   EXPECT_EQ(RETURN_OK, sch_set_task_priority(&fake_callback1, TASKPRIO_HIGH));
+   for (uint8_t i = 0; i < 2; i++)
+   {
+      sch_on_time_change(&item);
+   }
+   Mock::VerifyAndClearExpectations(callMock);
+
+   EXPECT_CALL(*callMock, task1_callback()).Times(1);
+   sch_on_time_change(&item);
+   Mock::VerifyAndClearExpectations(callMock);
+
+   EXPECT_CALL(*time_cnt_mock, time_unregister_callback(_));
+   sch_deinitialize();
+}
+
+/**
+ * @test Many tasks with different periods
+ */
+TEST_F(timeFixture, many_tasks_with_different_periods)
+{
+   TimeItem item = {};
+   EXPECT_CALL(*time_cnt_mock, time_register_callback(_,TIME_PRIORITY_HIGH));
+   EXPECT_CALL(*time_cnt_mock, time_get_basetime()).WillRepeatedly(Return(10));
+   sch_initialize();
+
+   /**
+    * <b>scenario</b>: List filled with tasks of different periods, only some of them are running.<br>
+    * <b>expected</b>: Running tasks called according to own period.<br>
+    * ************************************************
+    */
+   for (uint8_t i = 0; i < SCH_TASK_POOL_SIZE - 3; i++)
+   {
+      EXPECT_EQ(RETURN_OK, sch_subscribe_and_set(&fake_callback3, TASKPRIO_LOW, 1000,
+                            TASKSTATE_STOPPED, TASKTYPE_PERIODIC));
+   }
+   EXPECT_EQ(RETURN_OK, sch_subscribe_and_set(&fake_callback1, TASKPRIO_LOW, 70,
+                         TASKSTATE_RUNNING, TASKTYPE_PERIODIC));
+   EXPECT_EQ(RETURN_OK, sch_subscribe_and_set(&fake_callback2, TASKPRIO_LOW, 30,
+                         TASKSTATE_RUNNING, TASKTYPE_PERIODIC));
+
+   EXPECT_CALL(*callMock, task1_callback()).Times(3);
+   EXPECT_CALL(*callMock, task2_callback()).Times(7);
+   EXPECT_CALL(*callMock, task3_callback()).Times(0);
+
+   for (uint8_t i = 0; i < 21; i++)
+   {
+      sch_on_time_change(&item);
+      sch_task_watcher();
+   }
+
+   EXPECT_CALL(*time_cnt_mock, time_unregister_callback(_));
+   sch_deinitialize();
+}
+
+/**
+ * @test Controlling tasks using handles
+ */
+TEST_F(timeFixture, task_handle_tests)
+{
+   TimeItem item = {};
+   EXPECT_CALL(*time_cnt_mock, time_register_callback(_,TIME_PRIORITY_HIGH));
+   EXPECT_CALL(*time_cnt_mock, time_get_basetime()).WillRepeatedly(Return(10));
+   sch_initialize();
+
+   /**
+    * <b>scenario</b>: Invalid task data.<br>
+    * <b>expected</b>: Invalid handle returned, task not added.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(SCH_INVALID_HANDLE, sch_subscribe_handle(NULL, TASKPRIO_LOW, 100, TASKSTATE_RUNNING, TASKTYPE_PERIODIC));
+   EXPECT_EQ(SCH_INVALID_HANDLE, sch_subscribe_handle(&fake_callback1, TASKPRIO_LOW, 1, TASKSTATE_RUNNING, TASKTYPE_PERIODIC));
+   EXPECT_EQ(items_list.size, 0);
+   EXPECT_EQ(RETURN_NOK, sch_handle_set_state(SCH_INVALID_HANDLE, TASKSTATE_RUNNING));
+
+   /**
+    * <b>scenario</b>: The same function subscribed twice with different periods.<br>
+    * <b>expected</b>: Both tasks called independently.<br>
+    * ************************************************
+    */
+   SCH_HANDLE handle1 = sch_subscribe_handle(&fake_callback1, TASKPRIO_LOW, 20, TASKSTATE_RUNNING, TASKTYPE_PERIODIC);
+   SCH_HANDLE handle2 = sch_subscribe_handle(&fake_callback1, TASKPRIO_HIGH, 40, TASKSTATE_RUNNING, TASKTYPE_PERIODIC);
+   EXPECT_NE(SCH_INVALID_HANDLE, handle1);
+   EXPECT_NE(SCH_INVALID_HANDLE, handle2);
+   EXPECT_NE(handle1, handle2);
+   EXPECT_EQ(20, sch_handle_get_period(handle1));
+   EXPECT_EQ(40, sch_handle_get_period(handle2));
+   EXPECT_EQ(TASKTYPE_PERIODIC, sch_handle_get_type(handle2));
+
+   EXPECT_CALL(*callMock, task1_callback()).Times(6);
+   for (uint8_t i = 0; i < 8; i++)
+   {
+      sch_on_time_change(&item);
+      sch_task_watcher();
+   }
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /**
+    * <b>scenario</b>: One of the tasks changed to trigger type and triggered.<br>
+    * <b>expected</b>: Task called once.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, sch_handle_set_state(handle1, TASKSTATE_STOPPED));
+   EXPECT_EQ(RETURN_OK, sch_handle_set_type(handle2, TASKTYPE_TRIGGER));
+   EXPECT_EQ(RETURN_OK, sch_handle_set_period(handle2, 30));
+   EXPECT_EQ(RETURN_OK, sch_handle_trigger(handle2));
+   EXPECT_CALL(*callMock, task1_callback()).Times(1);
+   for (uint8_t i = 0; i < 8; i++)
+   {
+      sch_on_time_change(&item);
+      sch_task_watcher();
+   }
+   Mock::VerifyAndClearExpectations(callMock);
+   EXPECT_EQ(TASKSTATE_STOPPED, sch_handle_get_state(handle2));
+
+   /**
+    * <b>scenario</b>: Task unsubscribed and slot reused by other task.<br>
+    * <b>expected</b>: Old handle is not valid anymore.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, sch_handle_unsubscribe(handle1));
+   EXPECT_EQ(RETURN_NOK, sch_handle_unsubscribe(handle1));
+   SCH_HANDLE handle3 = sch_subscribe_handle(&fake_callback2, TASKPRIO_LOW, 20, TASKSTATE_STOPPED, TASKTYPE_PERIODIC);
+   EXPECT_NE(SCH_INVALID_HANDLE, handle3);
+   EXPECT_NE(handle1, handle3);
+   EXPECT_EQ(RETURN_NOK, sch_handle_set_state(handle1, TASKSTATE_RUNNING));
+   EXPECT_EQ(TASKSTATE_UNKNOWN, sch_handle_get_state(handle1));
+   EXPECT_EQ(TASKSTATE_STOPPED, sch_handle_get_state(handle3));
+
+   EXPECT_CALL(*time_cnt_mock, time_unregister_callback(_));
+   sch_deinitialize();
+}
+
+/**
+ * @test Tasks called with user context
+ */
+TEST_F(timeFixture, task_context_tests)
+{
+   TimeItem item = {};
+   uint8_t instance1 = 0;
+   uint8_t instance2 = 0;
+   EXPECT_CALL(*time_cnt_mock, time_register_callback(_,TIME_PRIORITY_HIGH));
+   EXPECT_CALL(*time_cnt_mock, time_get_basetime()).WillRepeatedly(Return(10));
+   sch_initialize();
+
+   /**
+    * <b>scenario</b>: Invalid task data.<br>
+    * <b>expected</b>: Invalid handle returned, task not added.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(SCH_INVALID_HANDLE, sch_subscribe_ctx(NULL, &instance1, TASKPRIO_LOW, 100, TASKSTATE_RUNNING, TASKTYPE_PERIODIC));
+   EXPECT_EQ(SCH_INVALID_HANDLE, sch_subscribe_ctx(&fake_ctx_callback, &instance1, TASKPRIO_LOW, 1, TASKSTATE_RUNNING, TASKTYPE_PERIODIC));
+   EXPECT_EQ(items_list.size, 0);
+
+   /**
+    * <b>scenario</b>: The same function subscribed for two instances.<br>
+    * <b>expected</b>: Function called with context of the instance.<br>
+    * ************************************************
+    */
+   SCH_HANDLE handle1 = sch_subscribe_ctx(&fake_ctx_callback, &instance1, TASKPRIO_LOW, 20, TASKSTATE_RUNNING, TASKTYPE_PERIODIC);
+   SCH_HANDLE handle2 = sch_subscribe_ctx(&fake_ctx_callback, &instance2, TASKPRIO_HIGH, 40, TASKSTATE_RUNNING, TASKTYPE_PERIODIC);
+   EXPECT_NE(SCH_INVALID_HANDLE, handle1);
+   EXPECT_NE(SCH_INVALID_HANDLE, handle2);
+
+   EXPECT_CALL(*callMock, ctx_callback(&instance1)).Times(2);
+   EXPECT_CALL(*callMock, ctx_callback(&instance2)).Times(1);
+   for (uint8_t i = 0; i < 4; i++)
+   {
+      sch_on_time_change(&item);
+      sch_task_watcher();
+   }
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /**
+    * <b>scenario</b>: Tasks searched by NULL function.<br>
+    * <b>expected</b>: Context tasks not found.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_NOK, sch_unsubscribe(NULL));
+   EXPECT_EQ(RETURN_NOK, sch_set_task_state(NULL, TASKSTATE_STOPPED));
+   EXPECT_EQ(2, sch_get_tasks_count());
+
+   /**
+    * <b>scenario</b>: One instance unsubscribed.<br>
+    * <b>expected</b>: Only the second instance called.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, sch_handle_unsubscribe(handle2));
+   EXPECT_CALL(*callMock, ctx_callback(&instance1)).Times(2);
+   EXPECT_CALL(*callMock, ctx_callback(&instance2)).Times(0);
+   for (uint8_t i = 0; i < 4; i++)
+   {
+      sch_on_time_change(&item);
+      sch_task_watcher();
+   }
+
+   EXPECT_CALL(*time_cnt_mock, time_unregister_callback(_));
+   sch_deinitialize();
+}
+
+/**
+ * @test Next deadline calculation for tickless mode
+ */
+TEST_F(timeFixture, next_deadline_tests)
+{
+   TimeItem item;
+   EXPECT_CALL(*time_cnt_mock, time_register_callback(_,TIME_PRIORITY_HIGH));
+   EXPECT_CALL(*time_cnt_mock, time_get_basetime()).WillRepeatedly(Return(10));
+   sch_initialize();
+
+   /**
+    * <b>scenario</b>: No task running.<br>
+    * <b>expected</b>: No deadline returned.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(SCH_NO_DEADLINE, sch_get_next_deadline());
+   SCH_HANDLE handle1 = sch_subscribe_handle(&fake_callback1, TASKPRIO_LOW, 100, TASKSTATE_STOPPED, TASKTYPE_PERIODIC);
+   EXPECT_EQ(SCH_NO_DEADLINE, sch_get_next_deadline());
+
+   /**
+    * <b>scenario</b>: Tasks with different priorities started.<br>
+    * <b>expected</b>: Time to the earliest task returned.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, sch_handle_set_state(handle1, TASKSTATE_RUNNING));
+   EXPECT_EQ(100, sch_get_next_deadline());
+   SCH_HANDLE handle2 = sch_subscribe_handle(&fake_callback2, TASKPRIO_HIGH, 50, TASKSTATE_RUNNING, TASKTYPE_PERIODIC);
+   EXPECT_EQ(50, sch_get_next_deadline());
+
+   /**
+    * <b>scenario</b>: Time elapsed, low priority ticks not handled in main loop yet.<br>
+    * <b>expected</b>: Low priority deadline counted from current time.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, sch_handle_set_state(handle2, TASKSTATE_STOPPED));
+   for (uint8_t i = 0; i < 4; i++)
+   {
+      sch_on_time_change(&item);
+   }
+   EXPECT_EQ(60, sch_get_next_deadline());
+   for (uint8_t i = 0; i < 6; i++)
+   {
+      sch_on_time_change(&item);
+   }
+   EXPECT_EQ(0, sch_get_next_deadline());
+
+   /**
+    * <b>scenario</b>: Main loop handles all ticks.<br>
+    * <b>expected</b>: Task called, next period returned.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*callMock, task1_callback()).Times(1);
+   for (uint8_t i = 0; i < 10; i++)
+   {
+      sch_task_watcher();
+   }
+   EXPECT_EQ(100, sch_get_next_deadline());
+
+   /**
+    * <b>scenario</b>: Task started when ticks are pending in tickless mode.<br>
+    * <b>expected</b>: Pending ticks are not counted to the new task.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*time_cnt_mock, time_get_pending_ticks()).WillRepeatedly(Return(2));
+   EXPECT_EQ(RETURN_OK, sch_handle_set_state(handle2, TASKSTATE_RUNNING));
+   EXPECT_EQ(50, sch_get_next_deadline());
+
+   EXPECT_CALL(*time_cnt_mock, time_unregister_callback(_));
+   sch_deinitialize();
+}
+
+/**
+ * @test Tasks runtime statistics
+ */
+TEST_F(timeFixture, task_stats_tests)
+{
+   TimeItem item;
+   SchTaskStats stats = {};
+   EXPECT_CALL(*time_cnt_mock, time_register_callback(_,TIME_PRIORITY_HIGH));
+   EXPECT_CALL(*time_cnt_mock, time_get_basetime()).WillRepeatedly(Return(10));
+   sch_initialize();
+
+   SCH_HANDLE handle1 = sch_subscribe_handle(&fake_callback1, TASKPRIO_HIGH, 20, TASKSTATE_RUNNING, TASKTYPE_PERIODIC);
+   SCH_HANDLE handle2 = sch_subscribe_handle(&fake_callback2, TASKPRIO_LOW, 10, TASKSTATE_RUNNING, TASKTYPE_PERIODIC);
+   EXPECT_NE(SCH_INVALID_HANDLE, handle1);
+   EXPECT_NE(SCH_INVALID_HANDLE, handle2);
+
+   /**
+    * <b>scenario</b>: Tasks called when statistics disabled.<br>
+    * <b>expected</b>: Cycle counter not used, statistics empty.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*ts_mock, ts_get_cycles()).Times(0);
+   EXPECT_CALL(*callMock, task1_callback());
+   EXPECT_CALL(*callMock, task2_callback()).Times(2);
+   for (uint8_t i = 0; i < 2; i++)
+   {
+      sch_on_time_change(&item);
+      sch_task_watcher();
+   }
+   EXPECT_EQ(RETURN_OK, sch_get_task_stats(0, &stats));
+   EXPECT_EQ(&fake_callback1, stats.task);
+   EXPECT_EQ(TASKPRIO_HIGH, stats.priority);
+   EXPECT_EQ(20, stats.period);
+   EXPECT_EQ(0, stats.calls);
+   EXPECT_EQ(RETURN_NOK, sch_get_task_stats(2, &stats));
+   Mock::VerifyAndClearExpectations(ts_mock);
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /**
+    * <b>scenario</b>: High priority task called when statistics enabled.<br>
+    * <b>expected</b>: Execution time and latency from the tick calculated.<br>
+    * ************************************************
+    */
+   sch_enable_stats();
+   EXPECT_CALL(*ts_mock, ts_get_cycles()).WillOnce(Return(0))
+                                         .WillOnce(Return(1000))
+                                         .WillOnce(Return(1000 + 5 * TS_CYCLES_PER_US))
+                                         .WillOnce(Return(1000 + 305 * TS_CYCLES_PER_US));
+   EXPECT_CALL(*callMock, task1_callback());
+   sch_on_time_change(&item);
+   sch_on_time_change(&item);
+   EXPECT_EQ(RETURN_OK, sch_get_task_stats(0, &stats));
+   EXPECT_EQ(1, stats.calls);
+   EXPECT_EQ(300, stats.last_time_us);
+   EXPECT_EQ(300, stats.max_time_us);
+   EXPECT_EQ(300, stats.total_time_us);
+   EXPECT_EQ(5, stats.last_latency_us);
+   EXPECT_EQ(0, stats.overruns);
+   Mock::VerifyAndClearExpectations(ts_mock);
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /**
+    * <b>scenario</b>: Low priority task called late, because main loop was blocked; task takes longer than period.<br>
+    * <b>expected</b>: Latency includes not handled ticks, overrun counted.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*ts_mock, ts_get_cycles()).WillOnce(Return(0))
+                                         .WillOnce(Return(0))
+                                         .WillOnce(Return(12000 * TS_CYCLES_PER_US));
+   EXPECT_CALL(*callMock, task2_callback());
+   sch_task_watcher();
+   EXPECT_EQ(RETURN_OK, sch_get_task_stats(1, &stats));
+   EXPECT_EQ(1, stats.calls);
+   EXPECT_EQ(12000, stats.last_time_us);
+   EXPECT_EQ(10000, stats.last_latency_us);
+   EXPECT_EQ(1, stats.overruns);
+   Mock::VerifyAndClearExpectations(ts_mock);
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /**
+    * <b>scenario</b>: Statistics reset and disabled.<br>
+    * <b>expected</b>: Statistics cleared.<br>
+    * ************************************************
+    */
+   sch_disable_stats();
+   sch_reset_stats();
+   EXPECT_EQ(RETURN_OK, sch_get_task_stats(1, &stats));
+   EXPECT_EQ(0, stats.calls);
+   EXPECT_EQ(0, stats.max_time_us);
+   EXPECT_EQ(0, stats.overruns);
+
+   EXPECT_CALL(*time_cnt_mock, time_unregister_callback(_));
+   sch_deinitialize();
+}
+
+/**
+ * @test Catch-up of low priority tasks after main loop was blocked
+ */
+TEST_F(timeFixture, task_catchup_policy_tests)
+{
+   TimeItem item;
+   SchTaskStats stats = {};
+   EXPECT_CALL(*time_cnt_mock, time_register_callback(_,TIME_PRIORITY_HIGH));
+   EXPECT_CALL(*time_cnt_mock, time_get_basetime()).WillRepeatedly(Return(10));
+   sch_initialize();
+
+   SCH_HANDLE handle1 = sch_subscribe_handle(&fake_callback1, TASKPRIO_LOW, 30, TASKSTATE_RUNNING, TASKTYPE_PERIODIC);
+   SCH_HANDLE handle2 = sch_subscribe_handle(&fake_callback2, TASKPRIO_LOW, 30, TASKSTATE_RUNNING, TASKTYPE_PERIODIC);
+   SCH_HANDLE handle3 = sch_subscribe_handle(&fake_callback3, TASKPRIO_LOW, 30, TASKSTATE_RUNNING, TASKTYPE_PERIODIC);
+
+   /**
+    * <b>scenario</b>: Policies set, incorrect policy requested.<br>
+    * <b>expected</b>: Burst is default, incorrect policy rejected.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(CATCHUP_BURST, sch_handle_get_catchup(handle1));
+   EXPECT_EQ(RETURN_OK, sch_handle_set_catchup(handle2, CATCHUP_SKIP));
+   EXPECT_EQ(RETURN_OK, sch_set_task_catchup(&fake_callback3, CATCHUP_COALESCE));
+   EXPECT_EQ(RETURN_NOK, sch_handle_set_catchup(handle3, CATCHUP_UNKNOWN));
+   EXPECT_EQ(RETURN_NOK, sch_handle_set_catchup(SCH_INVALID_HANDLE, CATCHUP_SKIP));
+   EXPECT_EQ(CATCHUP_SKIP, sch_handle_get_catchup(handle2));
+   EXPECT_EQ(CATCHUP_COALESCE, sch_get_task_catchup(&fake_callback3));
+   EXPECT_EQ(CATCHUP_UNKNOWN, sch_handle_get_catchup(SCH_INVALID_HANDLE));
+
+   /**
+    * <b>scenario</b>: Main loop blocked for 300ms, then queued ticks handled.<br>
+    * <b>expected</b>: Burst task called for every missed period, others once with missed periods dropped.<br>
+    * ************************************************
+    */
+   for (uint8_t i = 0; i < 30; i++)
+   {
+      sch_on_time_change(&item);
+   }
+   EXPECT_CALL(*callMock, task1_callback()).Times(10);
+   EXPECT_CALL(*callMock, task2_callback()).Times(1);
+   EXPECT_CALL(*callMock, task3_callback()).Times(1);
+   EXPECT_EQ(30, evq_dispatch_all());
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /* the last period is called on time */
+   EXPECT_EQ(RETURN_OK, sch_get_task_stats(0, &stats));
+   EXPECT_EQ(9, stats.late_calls);
+   EXPECT_EQ(0, stats.dropped_calls);
+   EXPECT_EQ(RETURN_OK, sch_get_task_stats(1, &stats));
+   EXPECT_EQ(1, stats.late_calls);
+   EXPECT_EQ(9, stats.dropped_calls);
+   EXPECT_EQ(RETURN_OK, sch_get_task_stats(2, &stats));
+   EXPECT_EQ(1, stats.late_calls);
+   EXPECT_EQ(9, stats.dropped_calls);
+
+   /**
+    * <b>scenario</b>: Main loop blocked for 250ms - not a multiple of the period.<br>
+    * <b>expected</b>: Skip task period counted from now, coalesce task keeps its phase.<br>
+    * ************************************************
+    */
+   sch_reset_stats();
+   for (uint8_t i = 0; i < 25; i++)
+   {
+      sch_on_time_change(&item);
+   }
+   EXPECT_CALL(*callMock, task1_callback()).Times(8);
+   EXPECT_CALL(*callMock, task2_callback()).Times(1);
+   EXPECT_CALL(*callMock, task3_callback()).Times(1);
+   evq_dispatch_all();
+   Mock::VerifyAndClearExpectations(callMock);
+   EXPECT_EQ(RETURN_OK, sch_get_task_stats(1, &stats));
+   EXPECT_EQ(7, stats.dropped_calls);
+
+   /* time 550ms: coalesce task due at 570, skip task due at 330 + 220 + 30 */
+   sch_on_time_change(&item);
+   sch_on_time_change(&item);
+   EXPECT_CALL(*callMock, task1_callback()).Times(1);
+   EXPECT_CALL(*callMock, task3_callback()).Times(1);
+   evq_dispatch_all();
+   Mock::VerifyAndClearExpectations(callMock);
+   sch_on_time_change(&item);
+   EXPECT_CALL(*callMock, task2_callback()).Times(1);
+   evq_dispatch_all();
+   Mock::VerifyAndClearExpectations(callMock);
+
+   /**
+    * <b>scenario</b>: Main loop blocked longer than low priority tick queue depth.<br>
+    * <b>expected</b>: Dropped ticks counted, low priority time jumps to the current time.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(0, sch_get_dropped_ticks());
+   for (uint8_t i = 0; i < EVQ_DEPTH + 3; i++)
+   {
+      sch_on_time_change(&item);
+   }
+   EXPECT_EQ(3, sch_get_dropped_ticks());
+   EXPECT_CALL(*callMock, task1_callback()).Times(AtLeast(1));
+   EXPECT_CALL(*callMock, task2_callback()).Times(1);
+   EXPECT_CALL(*callMock, task3_callback()).Times(1);
+   evq_dispatch_all();
+   EXPECT_EQ(sch_queues[TASKPRIO_HIGH].now, sch_queues[TASKPRIO_LOW].now);
+
+   EXPECT_CALL(*time_cnt_mock, time_unregister_callback(_));
+   sch_deinitialize();
+}
@@ -0,0 +1,78 @@
+#ifndef _RTC_DRIVER_H_
+#define _RTC_DRIVER_H_
+
+/* ============================= */
+/**
+ * @file rtc_driver.h
+ *
+ * @brief Driver of RTC peripheral, keeps UTC calendar during reset.
+ *
+ * @details
+ * RTC is clocked from LSE (32.768kHz) and placed in backup domain, so the calendar is
+ * not lost on MCU reset (and on power loss, when VBAT is supplied).
+ * Calendar is read with subseconds resolution of 1/256s.
+ * Alarm A is used to call the callback at requested time (date, time and subseconds are compared).
+ * Alarm callback is called from main loop (deferred from RTC Alarm interrupt), alarm is one-shot.
+ */
+/* ============================= */
+/* =============================
+ *  Includes of common headers
+ * =============================*/
+#include <stdint.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "return_codes.h"
+#include "time_counter.h"
+/* =============================
+ *          Defines
+ * =============================*/
+/** Subseconds counter resolution */
+#define RTC_SUBSECONDS_PER_SECOND 256
+
+/**
+ * @brief Initialize module.
+ * @details
+ * On first power up the RTC clock is configured, after reset only the shadow registers are synchronized.
+ * @return See RETURN_CODES.
+ */
+RET_CODE rtc_initialize();
+/**
+ * @brief Deinitialize module.
+ * @details RTC is still counting, only the alarm is disabled.
+ * @return None.
+ */
+void rtc_deinitialize();
+/**
+ * @brief Check if calendar was set, e.g. before reset.
+ * @return RETURN_OK if calendar is valid.
+ */
+RET_CODE rtc_is_calendar_valid();
+/**
+ * @brief Set calendar.
+ * @param[in] item - UTC time
+ * @return See RETURN_CODES.
+ */
+RET_CODE rtc_set_calendar(const TimeItem* item);
+/**
+ * @brief Read calendar.
+ * @param[out] item - UTC time, msecond field is converted from subseconds
+ * @return RETURN_NOK when calendar is not valid.
+ */
+RET_CODE rtc_get_calendar(TimeItem* item);
+/**
+ * @brief Set alarm.
+ * @details
+ * Previous alarm is overwritten. Callback is called once, from main loop.
+ * @param[in] item - UTC time of alarm
+ * @param[in] callback - Function to call, the current RTC time is passed
+ * @return See RETURN_CODES.
+ */
+RET_CODE rtc_set_alarm(const TimeItem* item, void(*callback)(TimeItem*));
+/**
+ * @brief Cancel alarm.
+ * @return None.
+ */
+void rtc_cancel_alarm();
+
+#endif
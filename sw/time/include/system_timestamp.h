@@ -21,6 +21,11 @@
  *  Includes of common headers
  * =============================*/
 #include <stdint.h>
+/* =============================
+ *          Defines
+ * =============================*/
+/** Number of CPU cycles in one microsecond */
+#define TS_CYCLES_PER_US 100
 
 /**
  * @brief Initialize module.
@@ -47,6 +52,24 @@ uint16_t ts_get_diff(uint16_t timestamp);
  * @return None.
  */
 void ts_wait(uint16_t ms);
+/**
+ * @brief Get CPU cycle counter.
+ * @details Counter is 32-bit wide and overflows every ~42s, use it only to measure short time periods.
+ * @return Current value of cycle counter.
+ */
+uint32_t ts_get_cycles();
+/**
+ * @brief Get microseconds elapsed since module initialization.
+ * @details Monotonic, 64-bit wide, so it never overflows in practice. Can be called from interrupts.
+ * @return Current timestamp in microseconds.
+ */
+uint64_t ts_get_us();
+/**
+ * @brief Get microseconds elapsed since given timestamp.
+ * @param[in] timestamp_us - Timestamp returned by ts_get_us()
+ * @return Elapsed time in microseconds.
+ */
+uint64_t ts_elapsed_us(uint64_t timestamp_us);
 
 
 #endif
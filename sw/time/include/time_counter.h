@@ -12,6 +12,13 @@
  * @details
  * Module has basetime of 10ms. It is using SysTick to measure time period.
  * There is possibility to set current time (obtained e.g. from NTP server).
+ * Local time is counted as milliseconds from 01.01.2000 00:00:00 (epoch), so the
+ * interrupt is only adding basetime. Calendar is converted on request and cached
+ * until the next second. Calendar is valid in range 2000-2099.
+ * In tickless mode the interrupt is not fired every basetime, but only when the
+ * next event (e.g. task from scheduler) is expected. All basetime periods elapsed
+ * in meantime are handled at once.
+ * Calendar can be backed by external source (e.g. RTC), which keeps it during reset.
  *
  *
  * @author Jacek Skowronek
@@ -44,8 +51,20 @@ typedef enum TimeCallbackPriority
 {
    TIME_PRIORITY_HIGH, /**< Callback with this priority will be called directly from interrupt handler */
    TIME_PRIORITY_LOW,  /**< Callback with this priority will be called from main loop */
+   TIME_PRIORITY_UNKNOWN,
 } TimeCallbackPriority;
 
+/** Handle to registered callback, valid until the callback is unregistered */
+typedef uint16_t TIME_HANDLE;
+#define TIME_INVALID_HANDLE 0xFFFF
+
+/** Source of calendar kept outside of the module, e.g. hardware RTC. Calendar is UTC. */
+typedef struct TimeCalendarBackend
+{
+   RET_CODE(*get)(TimeItem*);
+   RET_CODE(*set)(const TimeItem*);
+} TimeCalendarBackend;
+
 
 /**
  * @brief Initialize module.
@@ -65,6 +84,16 @@ void time_deinit();
  * @return See RETURN_CODES.
  */
 RET_CODE time_set_utc(TimeItem* item);
+/**
+ * @brief Set source of calendar.
+ * @details
+ * Local time is read from backend immediately and then corrected once per hour,
+ * so the calendar survives reset and SysTick drift is limited.
+ * time_set_utc() is writing the time also to backend.
+ * @param[in] backend - Backend functions, NULL to disable
+ * @return See RETURN_CODES.
+ */
+RET_CODE time_set_calendar_backend(const TimeCalendarBackend* backend);
 /**
  * @brief Set winter time flag.
  * @return None.
@@ -72,9 +101,29 @@ RET_CODE time_set_utc(TimeItem* item);
 void time_set_winter_time(uint8_t state);
 /**
  * @brief Returns current time.
+ * @details Returned item is the module calendar cache, it is updated on every call.
  * @return Current time.
  */
 TimeItem* time_get();
+/**
+ * @brief Returns current local time as milliseconds from epoch (01.01.2000 00:00:00).
+ * @details Cheap, no calendar conversion. Useful for time differences.
+ * @return Milliseconds from epoch.
+ */
+uint64_t time_get_epoch_ms();
+/**
+ * @brief Convert calendar time to milliseconds from epoch.
+ * @param[in] item - Valid calendar time, year 2000-2099
+ * @return Milliseconds from epoch.
+ */
+uint64_t time_to_epoch_ms(const TimeItem* item);
+/**
+ * @brief Convert milliseconds from epoch to calendar time.
+ * @param[in] epoch_ms - Milliseconds from epoch
+ * @param[out] item - Calendar time
+ * @return None.
+ */
+void time_from_epoch_ms(uint64_t epoch_ms, TimeItem* item);
 /**
  * @brief Register callback to be called on time change.
  * @param[in] callback - Pointer to function
@@ -89,7 +138,25 @@ RET_CODE time_register_callback(void(*callback)(TimeItem*), TimeCallbackPriority
  */
 RET_CODE time_unregister_callback(void(*callback)(TimeItem*));
 /**
- * @brief Watcher to be called in main thread loop - responsible for calling callbacks.
+ * @brief Register callback to be called on time change.
+ * @details
+ * Callbacks are kept in separate list per priority, so the tick is calling only
+ * registered callbacks. The same function can be registered many times, each
+ * registration gets own handle.
+ * @param[in] callback - Pointer to function
+ * @param[in] prio - priority of the callback
+ * @return Handle to callback or TIME_INVALID_HANDLE on error.
+ */
+TIME_HANDLE time_register_callback_handle(void(*callback)(TimeItem*), TimeCallbackPriority prio);
+/**
+ * @brief Unregister callback by handle.
+ * @param[in] handle - Handle returned from time_register_callback_handle
+ * @return See RETURN_CODES.
+ */
+RET_CODE time_unregister_callback_handle(TIME_HANDLE handle);
+/**
+ * @brief Watcher responsible for calling low priority callbacks.
+ * @details Drains module event queue, which is also drained by evq_dispatch_all() in main loop.
  * @return None.
  */
 void time_watcher();
@@ -98,6 +165,32 @@ void time_watcher();
  * @return Time counter basetime.
  */
 uint16_t time_get_basetime();
+/**
+ * @brief Enable tickless mode.
+ * @details
+ * Time interrupt is armed once for the time returned by next_event function.
+ * When it fires, time and high priority callbacks are updated for every basetime
+ * elapsed since last interrupt.
+ * @param[in] next_event - Function returning time to next event in ms, counted from last handled basetime.
+ *                         NULL disables tickless mode.
+ * @return None.
+ */
+void time_set_tickless(uint32_t(*next_event)());
+/**
+ * @brief Rearm time interrupt in tickless mode.
+ * @details
+ * Has to be called when next event time became shorter (e.g. new task started).
+ * Does nothing when tickless mode is disabled.
+ * @return None.
+ */
+void time_reschedule();
+/**
+ * @brief Returns number of basetime periods elapsed, but not handled yet.
+ * @details
+ * Always 0 when tickless mode is disabled.
+ * @return Number of pending basetime periods.
+ */
+uint16_t time_get_pending_ticks();
 
 
 
@@ -0,0 +1,282 @@
+/* =============================
+ *   Includes of common headers
+ * =============================*/
+#include <stdlib.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "rtc_driver.h"
+#include "event_queue.h"
+#include "stm32f4xx.h"
+/* =============================
+ *          Defines
+ * =============================*/
+/* LSE 32768Hz / (127 + 1) / (255 + 1) = 1Hz */
+#define RTC_PREDIV_A 127
+#define RTC_PREDIV_S (RTC_SUBSECONDS_PER_SECOND - 1)
+/* written to backup register when calendar is set */
+#define RTC_CALENDAR_MAGIC 0x5348A5A5
+/* LSE startup takes up to 2s, synchronization few RTC clock cycles */
+#define RTC_WAIT_LOOPS 0x01000000
+#define RTC_EPOCH_YEAR 2000
+/* 01.01.2000 was Saturday, weekday in RTC is 1 (Monday) - 7 (Sunday) */
+#define RTC_EPOCH_WEEKDAY 6
+/* compare SS[7:0] of alarm, the whole PREDIV_S range */
+#define RTC_ALARM_MASKSS 8
+#define RTC_ALRMASSR_MASKSS_POS 24
+/* =============================
+ *   Internal module functions
+ * =============================*/
+RET_CODE rtc_wait_flag(volatile uint32_t* reg, uint32_t mask, uint8_t state);
+void rtc_write_protect(uint8_t state);
+RET_CODE rtc_enter_init_mode();
+uint8_t rtc_to_bcd(uint8_t value);
+uint8_t rtc_from_bcd(uint8_t value);
+uint32_t rtc_ms_to_subseconds(uint16_t ms);
+RET_CODE rtc_is_time_ok(const TimeItem* item);
+void rtc_on_alarm(uint32_t arg);
+/* =============================
+ *      Module variables
+ * =============================*/
+EVQ rtc_events;   /**< Alarm notification, produced in RTC Alarm interrupt */
+void(*rtc_alarm_callback)(TimeItem*);
+
+
+RET_CODE rtc_initialize()
+{
+   RET_CODE result = RETURN_OK;
+   rtc_alarm_callback = NULL;
+   evq_init(&rtc_events);
+   evq_register(&rtc_events);
+
+   /* access to backup domain */
+   RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+   __DSB();
+   PWR->CR |= PWR_CR_DBP;
+
+   if (!(RCC->BDCR & RCC_BDCR_RTCEN))
+   {
+      /* first power up, RTC has to be configured */
+      RCC->BDCR |= RCC_BDCR_LSEON;
+      result = rtc_wait_flag(&RCC->BDCR, RCC_BDCR_LSERDY, 1);
+      if (result == RETURN_OK)
+      {
+         RCC->BDCR = (RCC->BDCR & ~RCC_BDCR_RTCSEL) | RCC_BDCR_RTCSEL_0;
+         RCC->BDCR |= RCC_BDCR_RTCEN;
+
+         rtc_write_protect(0);
+         result = rtc_enter_init_mode();
+         if (result == RETURN_OK)
+         {
+            /* both prescalers have to be written separately */
+            RTC->PRER = RTC_PREDIV_S;
+            RTC->PRER |= (uint32_t)RTC_PREDIV_A << 16;
+            RTC->CR &= ~RTC_CR_FMT;
+            RTC->ISR &= ~RTC_ISR_INIT;
+         }
+         rtc_write_protect(1);
+      }
+   }
+   if (result == RETURN_OK)
+   {
+      /* RSF is cleared by system reset, shadow registers have to be synchronized before reading */
+      result = rtc_wait_flag(&RTC->ISR, RTC_ISR_RSF, 1);
+   }
+   if (result == RETURN_OK)
+   {
+      /* alarm interrupt is connected to EXTI line 17 */
+      EXTI->IMR |= EXTI_IMR_MR17;
+      EXTI->RTSR |= EXTI_RTSR_TR17;
+      NVIC_EnableIRQ(RTC_Alarm_IRQn);
+   }
+   return result;
+}
+
+void rtc_deinitialize()
+{
+   rtc_cancel_alarm();
+   NVIC_DisableIRQ(RTC_Alarm_IRQn);
+   EXTI->IMR &= ~EXTI_IMR_MR17;
+   evq_unregister(&rtc_events);
+}
+
+RET_CODE rtc_is_calendar_valid()
+{
+   return ((RTC->ISR & RTC_ISR_INITS) && RTC->BKP0R == RTC_CALENDAR_MAGIC)? RETURN_OK : RETURN_NOK;
+}
+
+RET_CODE rtc_set_calendar(const TimeItem* item)
+{
+   RET_CODE result = RETURN_NOK;
+   if (item && rtc_is_time_ok(item) == RETURN_OK)
+   {
+      uint32_t days = (uint32_t)(time_to_epoch_ms(item) / 1000 / 86400);
+      uint8_t weekday = ((days + RTC_EPOCH_WEEKDAY - 1) % 7) + 1;
+      uint32_t tr = ((uint32_t)rtc_to_bcd(item->hour) << 16) | ((uint32_t)rtc_to_bcd(item->minute) << 8) | rtc_to_bcd(item->second);
+      uint32_t dr = ((uint32_t)rtc_to_bcd(item->year - RTC_EPOCH_YEAR) << 16) | ((uint32_t)weekday << 13) |
+                    ((uint32_t)rtc_to_bcd(item->month) << 8) | rtc_to_bcd(item->day);
+
+      rtc_write_protect(0);
+      result = rtc_enter_init_mode();
+      if (result == RETURN_OK)
+      {
+         RTC->TR = tr;
+         RTC->DR = dr;
+         RTC->ISR &= ~RTC_ISR_INIT;
+         RTC->BKP0R = RTC_CALENDAR_MAGIC;
+         /* subseconds counter starts from 0 - the milliseconds are added by shifting the clock */
+         if (item->msecond > 0 && rtc_wait_flag(&RTC->ISR, RTC_ISR_SHPF, 0) == RETURN_OK)
+         {
+            RTC->SHIFTR = RTC_SHIFTR_ADD1S | (RTC_SUBSECONDS_PER_SECOND - rtc_ms_to_subseconds(item->msecond));
+         }
+      }
+      rtc_write_protect(1);
+   }
+   return result;
+}
+
+RET_CODE rtc_get_calendar(TimeItem* item)
+{
+   RET_CODE result = RETURN_NOK;
+   if (item && rtc_is_calendar_valid() == RETURN_OK)
+   {
+      /* reading SSR locks TR and DR until DR is read */
+      uint32_t ssr = RTC->SSR & 0xFFFF;
+      uint32_t tr = RTC->TR;
+      uint32_t dr = RTC->DR;
+      item->hour = rtc_from_bcd((tr >> 16) & 0x3F);
+      item->minute = rtc_from_bcd((tr >> 8) & 0x7F);
+      item->second = rtc_from_bcd(tr & 0x7F);
+      item->year = RTC_EPOCH_YEAR + rtc_from_bcd((dr >> 16) & 0xFF);
+      item->month = rtc_from_bcd((dr >> 8) & 0x1F);
+      item->day = rtc_from_bcd(dr & 0x3F);
+      if (ssr > RTC_PREDIV_S)
+      {
+         /* after shift operation, before the next second tick, calendar is already one second ahead */
+         item->msecond = 0;
+         time_from_epoch_ms(time_to_epoch_ms(item) - 1000, item);
+         ssr -= RTC_PREDIV_S + 1;
+      }
+      item->msecond = (uint16_t)(((RTC_PREDIV_S - ssr) * 1000) / RTC_SUBSECONDS_PER_SECOND);
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+RET_CODE rtc_set_alarm(const TimeItem* item, void(*callback)(TimeItem*))
+{
+   RET_CODE result = RETURN_NOK;
+   if (item && callback && rtc_is_time_ok(item) == RETURN_OK)
+   {
+      rtc_write_protect(0);
+      RTC->CR &= ~(RTC_CR_ALRAE | RTC_CR_ALRAIE);
+      result = rtc_wait_flag(&RTC->ISR, RTC_ISR_ALRAWF, 1);
+      if (result == RETURN_OK)
+      {
+         rtc_alarm_callback = callback;
+         /* all fields are compared (mask bits cleared), day of month is used instead of weekday */
+         RTC->ALRMAR = ((uint32_t)rtc_to_bcd(item->day) << 24) | ((uint32_t)rtc_to_bcd(item->hour) << 16) |
+                       ((uint32_t)rtc_to_bcd(item->minute) << 8) | rtc_to_bcd(item->second);
+         RTC->ALRMASSR = ((uint32_t)RTC_ALARM_MASKSS << RTC_ALRMASSR_MASKSS_POS) |
+                         (RTC_PREDIV_S - rtc_ms_to_subseconds(item->msecond));
+         RTC->ISR &= ~RTC_ISR_ALRAF;
+         RTC->CR |= RTC_CR_ALRAE | RTC_CR_ALRAIE;
+      }
+      rtc_write_protect(1);
+   }
+   return result;
+}
+
+void rtc_cancel_alarm()
+{
+   rtc_write_protect(0);
+   RTC->CR &= ~(RTC_CR_ALRAE | RTC_CR_ALRAIE);
+   rtc_write_protect(1);
+   RTC->ISR &= ~RTC_ISR_ALRAF;
+   rtc_alarm_callback = NULL;
+}
+
+RET_CODE rtc_wait_flag(volatile uint32_t* reg, uint32_t mask, uint8_t state)
+{
+   uint32_t loops = 0;
+   while (((*reg & mask) != 0) != (state != 0))
+   {
+      if (++loops >= RTC_WAIT_LOOPS)
+      {
+         return RETURN_NOK;
+      }
+   }
+   return RETURN_OK;
+}
+
+void rtc_write_protect(uint8_t state)
+{
+   if (state)
+   {
+      RTC->WPR = 0xFF;
+   }
+   else
+   {
+      RTC->WPR = 0xCA;
+      RTC->WPR = 0x53;
+   }
+}
+
+RET_CODE rtc_enter_init_mode()
+{
+   RTC->ISR |= RTC_ISR_INIT;
+   return rtc_wait_flag(&RTC->ISR, RTC_ISR_INITF, 1);
+}
+
+uint8_t rtc_to_bcd(uint8_t value)
+{
+   return ((value / 10) << 4) | (value % 10);
+}
+
+uint8_t rtc_from_bcd(uint8_t value)
+{
+   return (value >> 4) * 10 + (value & 0x0F);
+}
+
+uint32_t rtc_ms_to_subseconds(uint16_t ms)
+{
+   return ((uint32_t)ms * RTC_SUBSECONDS_PER_SECOND) / 1000;
+}
+
+RET_CODE rtc_is_time_ok(const TimeItem* item)
+{
+   uint8_t result = 1;
+   result &= item->year >= RTC_EPOCH_YEAR && item->year < RTC_EPOCH_YEAR + 100;
+   result &= item->month >= 1 && item->month <= 12;
+   result &= item->day >= 1 && item->day <= 31;
+   result &= item->hour <= 23;
+   result &= item->minute <= 59;
+   result &= item->second <= 59;
+   result &= item->msecond <= 999;
+   return result? RETURN_OK : RETURN_NOK;
+}
+
+void rtc_on_alarm(uint32_t arg)
+{
+   /* alarm is one-shot */
+   void(*callback)(TimeItem*) = rtc_alarm_callback;
+   rtc_cancel_alarm();
+   if (callback)
+   {
+      TimeItem now;
+      if (rtc_get_calendar(&now) == RETURN_OK)
+      {
+         callback(&now);
+      }
+   }
+}
+
+void RTC_Alarm_IRQHandler()
+{
+   if (RTC->ISR & RTC_ISR_ALRAF)
+   {
+      RTC->ISR &= ~RTC_ISR_ALRAF;
+      evq_push(&rtc_events, &rtc_on_alarm, 0);
+   }
+   EXTI->PR = EXTI_PR_PR17;
+}
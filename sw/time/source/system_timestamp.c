@@ -6,10 +6,17 @@
  * =============================*/
 #include "system_timestamp.h"
 #include "stm32f4xx.h"
+#include "core_cmFunc.h"
+/* =============================
+ *          Defines
+ * =============================*/
+/** TIM5 is clocked with 100MHz (APB1 x2), counting every 1us */
+#define TS_US_TIMER_PRESCALER 99
 /* =============================
  *      Module variables
  * =============================*/
 volatile uint16_t system_timestamp;
+volatile uint32_t ts_us_overflows;   /**< Upper 32 bits of microseconds counter */
 
 
 
@@ -25,6 +32,24 @@ void ts_init()
    TIM4->DIER |= TIM_DIER_UIE;
    system_timestamp = 0;
    NVIC_EnableIRQ(TIM4_IRQn);
+
+   /* 32-bit free running microseconds counter, overflow interrupt extends it to 64 bits */
+   RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;
+   __DSB();
+   TIM5->PSC = TS_US_TIMER_PRESCALER;
+   TIM5->ARR = 0xFFFFFFFF;
+   TIM5->EGR = TIM_EGR_UG;
+   TIM5->SR &= ~TIM_SR_UIF;
+   TIM5->CNT = 0;
+   ts_us_overflows = 0;
+   TIM5->DIER |= TIM_DIER_UIE;
+   TIM5->CR1 |= TIM_CR1_CEN;
+   NVIC_EnableIRQ(TIM5_IRQn);
+
+   /* enable DWT cycle counter */
+   CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+   DWT->CYCCNT = 0;
+   DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 void ts_deinit()
 {
@@ -32,6 +57,11 @@ void ts_deinit()
    TIM4->CR1 &= ~TIM_CR1_CEN;
    TIM4->CNT = 0;
    system_timestamp = 0;
+   NVIC_DisableIRQ(TIM5_IRQn);
+   TIM5->CR1 &= ~TIM_CR1_CEN;
+   TIM5->CNT = 0;
+   TIM5->SR &= ~TIM_SR_UIF;
+   ts_us_overflows = 0;
 }
 uint16_t ts_get()
 {
@@ -56,6 +86,29 @@ uint16_t ts_get_diff(uint16_t timestamp)
    }
    return result * 100;
 }
+uint32_t ts_get_cycles()
+{
+   return DWT->CYCCNT;
+}
+uint64_t ts_get_us()
+{
+   /* caller may already run with interrupts disabled - restore previous state */
+   uint32_t primask = __get_PRIMASK();
+   __disable_irq();
+   uint32_t high = ts_us_overflows;
+   uint32_t low = TIM5->CNT;
+   /* counter already wrapped, but interrupt not handled yet (e.g. called from interrupt) */
+   if ((TIM5->SR & TIM_SR_UIF) && low < 0x80000000)
+   {
+      high++;
+   }
+   __set_PRIMASK(primask);
+   return ((uint64_t)high << 32) | low;
+}
+uint64_t ts_elapsed_us(uint64_t timestamp_us)
+{
+   return ts_get_us() - timestamp_us;
+}
 void TIM4_IRQHandler()
 {
    if (TIM4->SR & TIM_SR_UIF){
@@ -63,3 +116,10 @@ void TIM4_IRQHandler()
       system_timestamp++;
    }
 }
+void TIM5_IRQHandler()
+{
+   if (TIM5->SR & TIM_SR_UIF){
+      TIM5->SR &= ~TIM_SR_UIF;
+      ts_us_overflows++;
+   }
+}
@@ -9,19 +9,41 @@
 #include "time_counter.h"
 #include "core_cmFunc.h"
 #include "Logger.h"
+#include "event_queue.h"
 /* =============================
  *          Defines
  * =============================*/
 #define TIME_CNT_CALLBACK_MAX_SIZE 10
 #define TIME_BASETIME_MS 10
+#define TIME_CPU_FREQUENCY_HZ 100000000
+#define TIME_CYCLES_PER_TICK (TIME_CPU_FREQUENCY_HZ/(1000/TIME_BASETIME_MS))
+/* SysTick reload register is 24-bit wide, so it can count up to ~167ms */
+#define TIME_TICKLESS_MAX_TICKS 16
+#define TIME_EPOCH_YEAR 2000
+#define TIME_SECONDS_PER_DAY 86400
+/* every 4 years have the same number of days in range 2000-2099 */
+#define TIME_DAYS_PER_4_YEARS 1461
+/* local time is corrected from calendar backend (e.g. RTC) once per period */
+#define TIME_BACKEND_SYNC_PERIOD_S 3600
 /* =============================
  *   Internal module functions
  * =============================*/
 RET_CODE time_is_time_ok(TimeItem* item);
-RET_CODE time_is_leap_year();
+RET_CODE time_is_leap_year(uint16_t year);
+uint8_t time_get_month_days(uint8_t month, uint16_t year);
+uint32_t time_calendar_to_seconds(const TimeItem* item);
+void time_seconds_to_calendar(uint32_t seconds, TimeItem* item);
 void time_increment_time();
 void time_call_low_prio_callbacks();
+void time_on_low_prio_tick(uint32_t arg);
+RET_CODE time_apply_utc(TimeItem* item);
+RET_CODE time_sync_from_backend();
 void time_call_high_prio_callbacks();
+void time_call_callbacks(TimeCallbackPriority prio);
+void time_remove_callback(uint8_t slot);
+uint32_t time_get_window_elapsed();
+uint32_t time_get_ticks_to_next_event();
+void time_arm_tickless(uint32_t ticks);
 /* =============================
  *       Internal types
  * =============================*/
@@ -29,47 +51,72 @@ typedef struct TimeCallbackItem
 {
    TimeCallbackPriority priority;
    void(*fnc)(TimeItem*);
+   uint8_t generation;  /**< Incremented on unregister to invalidate handles */
 } TimeCallbackItem;
+
+/** Registered callbacks of one priority, kept compact so the tick touches only them */
+typedef struct TimeDispatchList
+{
+   void(*fnc[TIME_CNT_CALLBACK_MAX_SIZE])(TimeItem*);
+   uint8_t slot[TIME_CNT_CALLBACK_MAX_SIZE];  /**< Index of callback in TIME_CALLBACKS */
+   uint8_t size;
+} TimeDispatchList;
 /* =============================
  *      Module variables
  * =============================*/
-TimeItem timestamp;
-volatile uint8_t time_time_changed;
+/* Local time is kept as seconds from 01.01.2000 00:00:00, calendar is converted only on request */
+volatile uint32_t time_seconds;
+volatile uint16_t time_mseconds;
+TimeItem timestamp;              /**< Calendar cache of time_cache_seconds */
+uint32_t time_cache_seconds;
+EVQ time_low_prio_events;   /**< Low priority callbacks request, produced in SysTick interrupt */
 TimeCallbackItem TIME_CALLBACKS[TIME_CNT_CALLBACK_MAX_SIZE];
+TimeDispatchList time_dispatch[TIME_PRIORITY_UNKNOWN];
 uint8_t winter_time_active = 1;
+const TimeCalendarBackend* time_backend;
+uint32_t time_backend_sync_seconds;   /**< Local time of last synchronization with backend */
 uint8_t month_day_cnt[13] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+uint32_t(*time_next_event)();
+volatile uint8_t time_armed_ticks = 1;
+volatile uint32_t time_window_offset;
 
 
 
 void time_init()
 {
-	timestamp.day = 1;
-	timestamp.month = 1;
-	timestamp.year = 2000;
-	timestamp.hour = 0;
-	timestamp.minute = 0;
-	timestamp.second = 0;
+	time_seconds = 0;
+	time_mseconds = 0;
+	time_cache_seconds = 0;
+	time_seconds_to_calendar(0, &timestamp);
 	timestamp.msecond = 0;
 	/* systick_value = F_CPU/(100/PERIOD[ms]) */
-	SysTick_Config(100000000/(1000/TIME_BASETIME_MS));
-
+	SysTick_Config(TIME_CYCLES_PER_TICK);
+	time_next_event = NULL;
+	time_armed_ticks = 1;
+	time_window_offset = 0;
+	evq_init(&time_low_prio_events);
+	evq_register(&time_low_prio_events);
 }
 
 void time_deinit()
 {
+	time_backend = NULL;
+	time_next_event = NULL;
+	evq_unregister(&time_low_prio_events);
 	for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i ++)
 	{
-	   TIME_CALLBACKS[i].fnc = NULL;
+	   time_remove_callback(i);
 	}
 }
 
 RET_CODE time_is_time_ok(TimeItem* item)
 {
 	uint8_t result = 1;
-	result &= item->month <= 12;
+	result &= item->month >= 1 && item->month <= 12;
+	result &= item->year >= TIME_EPOCH_YEAR && item->year < TIME_EPOCH_YEAR + 100;
 	if (result == RETURN_OK)
 	{
-		result &= item->day <= month_day_cnt[item->month];
+		result &= item->day >= 1 && item->day <= time_get_month_days(item->month, item->year);
 	}
 	result &= item->hour <= 23;
 	result &= item->minute <= 59;
@@ -86,161 +133,394 @@ void time_set_winter_time(uint8_t state)
 }
 
 RET_CODE time_set_utc(TimeItem* item)
+{
+	RET_CODE result = time_apply_utc(item);
+	if (result == RETURN_OK && time_backend)
+	{
+		/* backend keeps UTC, so it does not depend on winter time */
+		result = time_backend->set(item);
+	}
+	return result;
+}
+
+RET_CODE time_set_calendar_backend(const TimeCalendarBackend* backend)
+{
+	RET_CODE result = RETURN_NOK;
+	time_backend = NULL;
+	if (!backend)
+	{
+		result = RETURN_OK;
+	}
+	else if (backend->get && backend->set)
+	{
+		time_backend = backend;
+		/* backend may not be set yet (e.g. RTC after battery loss), it is still used for time_set_utc() */
+		time_sync_from_backend();
+		result = RETURN_OK;
+	}
+	return result;
+}
+
+RET_CODE time_apply_utc(TimeItem* item)
 {
 	RET_CODE result = RETURN_NOK;
 	if (item)
 	{
 		if (time_is_time_ok(item))
 		{
+			uint32_t seconds = time_calendar_to_seconds(item) + (winter_time_active? 1 : 2) * 3600;
+			uint32_t primask = __get_PRIMASK();
 			__disable_irq();
-			timestamp = *item;
-			if (winter_time_active)
-			{
-				timestamp.hour += 1;
-			}
-			else
-			{
-				timestamp.hour += 2;
-			}
-			if (timestamp.hour > 23)
-			{
-				timestamp.hour = timestamp.hour % 24;
-				timestamp.day++;
-				if (timestamp.day > month_day_cnt[timestamp.month])
-				{
-					timestamp.month++;
-					timestamp.day = 1;
-					if (timestamp.month > 12)
-					{
-						timestamp.month = 1;
-						timestamp.year++;
-					}
-				}
-			}
-			__enable_irq();
+			time_seconds = seconds;
+			time_backend_sync_seconds = seconds;
+			time_mseconds = item->msecond;
+			time_cache_seconds = seconds;
+			time_seconds_to_calendar(seconds, &timestamp);
+			__set_PRIMASK(primask);
 			result = RETURN_OK;
 		}
 	}
 	return result;
 }
 
+RET_CODE time_sync_from_backend()
+{
+	TimeItem utc;
+	/* when backend is not valid, next try is done after the whole period */
+	time_backend_sync_seconds = time_seconds;
+	RET_CODE result = time_backend->get(&utc);
+	if (result == RETURN_OK)
+	{
+		/* align to basetime */
+		utc.msecond -= utc.msecond % TIME_BASETIME_MS;
+		result = time_apply_utc(&utc);
+	}
+	return result;
+}
+
 TimeItem* time_get()
 {
+	/* can be called from interrupts and critical sections, so cache is updated with previous mask restored */
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if (time_cache_seconds != time_seconds)
+	{
+		time_cache_seconds = time_seconds;
+		time_seconds_to_calendar(time_cache_seconds, &timestamp);
+	}
+	timestamp.msecond = time_mseconds;
+	__set_PRIMASK(primask);
 	return &timestamp;
 }
+
+uint64_t time_get_epoch_ms()
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint64_t result = (uint64_t)time_seconds * 1000 + time_mseconds;
+	__set_PRIMASK(primask);
+	return result;
+}
+
+uint64_t time_to_epoch_ms(const TimeItem* item)
+{
+	return (uint64_t)time_calendar_to_seconds(item) * 1000 + item->msecond;
+}
+
+void time_from_epoch_ms(uint64_t epoch_ms, TimeItem* item)
+{
+	time_seconds_to_calendar((uint32_t)(epoch_ms / 1000), item);
+	item->msecond = epoch_ms % 1000;
+}
 RET_CODE time_register_callback(void(*callback)(TimeItem*), TimeCallbackPriority prio)
 {
-	RET_CODE result = RETURN_NOK;
+   return time_register_callback_handle(callback, prio) != TIME_INVALID_HANDLE? RETURN_OK : RETURN_NOK;
+}
 
-	for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i++)
-	{
-		if (TIME_CALLBACKS[i].fnc == NULL)
-		{
-		   TIME_CALLBACKS[i].priority = prio;
-		   TIME_CALLBACKS[i].fnc = callback;
-			result = RETURN_OK;
-			break;
-		}
-	}
-	return result;
+TIME_HANDLE time_register_callback_handle(void(*callback)(TimeItem*), TimeCallbackPriority prio)
+{
+   TIME_HANDLE result = TIME_INVALID_HANDLE;
+   if (callback && prio < TIME_PRIORITY_UNKNOWN)
+   {
+      /* callbacks lists are used in SysTick interrupt */
+      uint32_t primask = __get_PRIMASK();
+      __disable_irq();
+      for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i++)
+      {
+         TimeCallbackItem* item = &TIME_CALLBACKS[i];
+         if (item->fnc == NULL)
+         {
+            TimeDispatchList* list = &time_dispatch[prio];
+            item->priority = prio;
+            item->fnc = callback;
+            list->fnc[list->size] = callback;
+            list->slot[list->size] = i;
+            list->size++;
+            result = (TIME_HANDLE)(((uint16_t)item->generation << 8) | i);
+            break;
+         }
+      }
+      __set_PRIMASK(primask);
+   }
+   return result;
 }
 
 RET_CODE time_unregister_callback(void(*callback)(TimeItem*))
 {
-	RET_CODE result = RETURN_NOK;
-	for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i++)
-	{
-		if (TIME_CALLBACKS[i].fnc == callback)
-		{
-		   TIME_CALLBACKS[i].fnc = NULL;
-			result = RETURN_OK;
-		}
-	}
-	return result;
+   RET_CODE result = RETURN_NOK;
+   for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i++)
+   {
+      if (callback && TIME_CALLBACKS[i].fnc == callback)
+      {
+         time_remove_callback(i);
+         result = RETURN_OK;
+      }
+   }
+   return result;
 }
 
-RET_CODE time_is_leap_year()
+RET_CODE time_unregister_callback_handle(TIME_HANDLE handle)
 {
-	return (timestamp.year % 4) == 0? RETURN_OK : RETURN_NOK;
+   RET_CODE result = RETURN_NOK;
+   uint8_t slot = handle & 0xFF;
+   if (handle != TIME_INVALID_HANDLE && slot < TIME_CNT_CALLBACK_MAX_SIZE &&
+       TIME_CALLBACKS[slot].fnc != NULL && TIME_CALLBACKS[slot].generation == (handle >> 8))
+   {
+      time_remove_callback(slot);
+      result = RETURN_OK;
+   }
+   return result;
 }
 
-void time_increment_time()
+void time_remove_callback(uint8_t slot)
 {
-	timestamp.msecond += TIME_BASETIME_MS;
-	if (timestamp.msecond >= 1000)
+   TimeCallbackItem* item = &TIME_CALLBACKS[slot];
+   /* callbacks lists are used in SysTick interrupt */
+   uint32_t primask = __get_PRIMASK();
+   __disable_irq();
+   if (item->fnc != NULL)
+   {
+      /* registration order is kept, so callbacks are shifted */
+      TimeDispatchList* list = &time_dispatch[item->priority];
+      uint8_t pos = 0;
+      while (pos < list->size && list->slot[pos] != slot)
+      {
+         pos++;
+      }
+      for (; pos + 1 < list->size; pos++)
+      {
+         list->fnc[pos] = list->fnc[pos + 1];
+         list->slot[pos] = list->slot[pos + 1];
+      }
+      list->size--;
+      item->fnc = NULL;
+      item->generation++;
+   }
+   __set_PRIMASK(primask);
+}
+
+RET_CODE time_is_leap_year(uint16_t year)
+{
+	/* valid in range 2000-2099 */
+	return (year % 4) == 0? RETURN_OK : RETURN_NOK;
+}
+
+uint8_t time_get_month_days(uint8_t month, uint16_t year)
+{
+	return (month == 2 && time_is_leap_year(year) == RETURN_OK)? month_day_cnt[month] + 1 : month_day_cnt[month];
+}
+
+uint32_t time_calendar_to_seconds(const TimeItem* item)
+{
+	uint16_t years = item->year - TIME_EPOCH_YEAR;
+	/* leap years before given one, 2000 is a leap year */
+	uint32_t days = (uint32_t)years * 365 + (years + 3) / 4;
+	for (uint8_t month = 1; month < item->month; month++)
 	{
-		timestamp.second++;
-		timestamp.msecond %= 1000;
+		days += time_get_month_days(month, item->year);
 	}
-	if (timestamp.second == 60)
+	days += item->day - 1;
+	return days * TIME_SECONDS_PER_DAY + (uint32_t)item->hour * 3600 + (uint32_t)item->minute * 60 + item->second;
+}
+
+void time_seconds_to_calendar(uint32_t seconds, TimeItem* item)
+{
+	uint32_t days = seconds / TIME_SECONDS_PER_DAY;
+	uint32_t day_seconds = seconds % TIME_SECONDS_PER_DAY;
+	item->hour = day_seconds / 3600;
+	item->minute = (day_seconds / 60) % 60;
+	item->second = day_seconds % 60;
+
+	uint16_t year = TIME_EPOCH_YEAR + (days / TIME_DAYS_PER_4_YEARS) * 4;
+	days %= TIME_DAYS_PER_4_YEARS;
+	while (days >= (time_is_leap_year(year) == RETURN_OK? 366 : 365))
 	{
-		timestamp.minute++;
-		timestamp.second = 0;
+		days -= time_is_leap_year(year) == RETURN_OK? 366 : 365;
+		year++;
 	}
-	if (timestamp.minute == 60)
+	uint8_t month = 1;
+	while (days >= time_get_month_days(month, year))
 	{
-		timestamp.hour++;
-		timestamp.minute = 0;
+		days -= time_get_month_days(month, year);
+		month++;
 	}
-	if (timestamp.hour == 24)
+	item->year = year;
+	item->month = month;
+	item->day = days + 1;
+}
+
+void time_increment_time()
+{
+	/* the only time update done in interrupt, calendar is converted on request */
+	time_mseconds += TIME_BASETIME_MS;
+	if (time_mseconds >= 1000)
 	{
-		timestamp.day++;
-		timestamp.hour = 0;
-		uint8_t exp_days = (time_is_leap_year() == RETURN_OK) && (timestamp.month == 2)? month_day_cnt[timestamp.month] +1 : month_day_cnt[timestamp.month];
-		if (timestamp.day >= exp_days)
-		{
-			timestamp.month++;
-			timestamp.day = 1;
-			if (timestamp.month > 12)
-			{
-				timestamp.year++;
-				timestamp.month = 1;
-			}
-		}
+		time_mseconds -= 1000;
+		time_seconds++;
 	}
-
-
 }
 
 void time_call_low_prio_callbacks()
 {
-	for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i++)
-	{
-		if (TIME_CALLBACKS[i].fnc != NULL && TIME_CALLBACKS[i].priority == TIME_PRIORITY_LOW)
-		{
-		   TIME_CALLBACKS[i].fnc(&timestamp);
-		}
-	}
+   time_call_callbacks(TIME_PRIORITY_LOW);
+}
+
+void time_on_low_prio_tick(uint32_t arg)
+{
+   time_call_low_prio_callbacks();
+   if (time_backend && (time_seconds - time_backend_sync_seconds) >= TIME_BACKEND_SYNC_PERIOD_S)
+   {
+      time_sync_from_backend();
+   }
 }
 
 void time_call_high_prio_callbacks()
 {
-   for (uint8_t i = 0; i < TIME_CNT_CALLBACK_MAX_SIZE; i++)
+   time_call_callbacks(TIME_PRIORITY_HIGH);
+}
+
+void time_call_callbacks(TimeCallbackPriority prio)
+{
+   TimeDispatchList* list = &time_dispatch[prio];
+   if (list->size > 0)
    {
-      if (TIME_CALLBACKS[i].fnc != NULL && TIME_CALLBACKS[i].priority == TIME_PRIORITY_HIGH)
+      /* calendar cache is updated only when the second changed */
+      TimeItem* time = time_get();
+      for (uint8_t i = 0; i < list->size; i++)
       {
-         TIME_CALLBACKS[i].fnc(&timestamp);
+         list->fnc[i](time);
       }
    }
 }
 
 void time_watcher()
 {
-	if (time_time_changed)
-	{
-		time_time_changed = 0;
-		time_call_low_prio_callbacks();
-	}
+	evq_dispatch(&time_low_prio_events);
 }
 uint16_t time_get_basetime()
 {
 	return TIME_BASETIME_MS;
 }
 
+void time_set_tickless(uint32_t(*next_event)())
+{
+   uint32_t primask = __get_PRIMASK();
+   __disable_irq();
+   time_next_event = next_event;
+   if (next_event)
+   {
+      time_arm_tickless(time_get_ticks_to_next_event());
+   }
+   else
+   {
+      /* back to periodic interrupt, ticks elapsed in current window are lost */
+      time_armed_ticks = 1;
+      time_window_offset = 0;
+      SysTick->LOAD = TIME_CYCLES_PER_TICK - 1;
+      SysTick->VAL = 0;
+   }
+   __set_PRIMASK(primask);
+}
+
+void time_reschedule()
+{
+   if (time_next_event)
+   {
+      uint32_t primask = __get_PRIMASK();
+      __disable_irq();
+      /* when interrupt is already pending, it will arm the timer by itself */
+      if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) == 0)
+      {
+         uint32_t ticks = time_get_ticks_to_next_event();
+         if (ticks < time_armed_ticks)
+         {
+            time_arm_tickless(ticks);
+         }
+      }
+      __set_PRIMASK(primask);
+   }
+}
+
+uint16_t time_get_pending_ticks()
+{
+   uint16_t result = 0;
+   if (time_next_event)
+   {
+      /* counter already reloaded, but interrupt not handled yet */
+      result = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)? time_armed_ticks : time_get_window_elapsed() / TIME_CYCLES_PER_TICK;
+   }
+   return result;
+}
+
+uint32_t time_get_window_elapsed()
+{
+   /* SysTick is counting down from LOAD */
+   return time_window_offset + (SysTick->LOAD - SysTick->VAL);
+}
+
+uint32_t time_get_ticks_to_next_event()
+{
+   uint32_t next_event_ms = time_next_event();
+   uint32_t result = TIME_TICKLESS_MAX_TICKS;
+   if (next_event_ms < TIME_TICKLESS_MAX_TICKS * TIME_BASETIME_MS)
+   {
+      result = (next_event_ms + TIME_BASETIME_MS - 1) / TIME_BASETIME_MS;
+   }
+   return result > 0? result : 1;
+}
+
+void time_arm_tickless(uint32_t ticks)
+{
+   uint32_t elapsed = time_get_window_elapsed();
+   if (ticks * TIME_CYCLES_PER_TICK <= elapsed)
+   {
+      /* requested event is in the past - fire at the nearest tick */
+      ticks = elapsed / TIME_CYCLES_PER_TICK + 1;
+   }
+   /* part of the window already elapsed is deducted, so there is no drift */
+   time_armed_ticks = ticks;
+   time_window_offset = elapsed;
+   SysTick->LOAD = (ticks * TIME_CYCLES_PER_TICK - elapsed - 1) & SysTick_LOAD_RELOAD_Msk;
+   SysTick->VAL = 0;
+}
+
 void SysTick_Handler(void)
 {
-	time_increment_time();
-	time_call_high_prio_callbacks();
-   time_time_changed++;
+   uint8_t ticks = time_armed_ticks;
+   time_window_offset = 0;
+   for (uint8_t i = 0; i < ticks; i++)
+   {
+      time_increment_time();
+      time_call_high_prio_callbacks();
+   }
+   /* low priority callbacks get the current time, so pending request is enough */
+   if (evq_get_count(&time_low_prio_events) == 0)
+   {
+      evq_push(&time_low_prio_events, &time_on_low_prio_tick, 0);
+   }
+   if (time_next_event)
+   {
+      time_arm_tickless(time_get_ticks_to_next_event());
+   }
 }
 
@@ -1,7 +1,7 @@
-#ifndef _TIME_COUNTER_MOCK_H_
-#define _TIME_COUNTER_MOCK_H_
+#ifndef _SYSTEM_TIMESTAMP_MOCK_H_
+#define _SYSTEM_TIMESTAMP_MOCK_H_
 
-#include "time_counter.h"
+#include "system_timestamp.h"
 #include "gmock/gmock.h"
 
 struct timestampMock
@@ -11,6 +11,9 @@ struct timestampMock
 	MOCK_METHOD0(ts_get, uint16_t());
 	MOCK_METHOD1(ts_get_diff, uint16_t(uint16_t));
 	MOCK_METHOD1(ts_wait, void(uint16_t));
+	MOCK_METHOD0(ts_get_cycles, uint32_t());
+	MOCK_METHOD0(ts_get_us, uint64_t());
+	MOCK_METHOD1(ts_elapsed_us, uint64_t(uint64_t));
 };
 
 
@@ -38,4 +41,16 @@ void ts_wait(uint16_t period)
 {
    ts_mock->ts_wait(period);
 }
+uint32_t ts_get_cycles()
+{
+   return ts_mock->ts_get_cycles();
+}
+uint64_t ts_get_us()
+{
+   return ts_mock->ts_get_us();
+}
+uint64_t ts_elapsed_us(uint64_t timestamp_us)
+{
+   return ts_mock->ts_elapsed_us(timestamp_us);
+}
 #endif
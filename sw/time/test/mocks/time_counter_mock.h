@@ -8,12 +8,21 @@ struct timeCounerMock
 {
 	MOCK_METHOD0(time_init, void());
 	MOCK_METHOD1(time_set_utc, RET_CODE(TimeItem*));
+	MOCK_METHOD1(time_set_calendar_backend, RET_CODE(const TimeCalendarBackend*));
 	MOCK_METHOD1(time_set_winter_time, void(uint8_t state));
 	MOCK_METHOD0(time_get, TimeItem*());
+	MOCK_METHOD0(time_get_epoch_ms, uint64_t());
+	MOCK_METHOD1(time_to_epoch_ms, uint64_t(const TimeItem*));
+	MOCK_METHOD2(time_from_epoch_ms, void(uint64_t, TimeItem*));
 	MOCK_METHOD2(time_register_callback, RET_CODE(void(*callback)(TimeItem*), TimeCallbackPriority));
 	MOCK_METHOD1(time_unregister_callback, RET_CODE(void(*callback)(TimeItem*)));
+	MOCK_METHOD2(time_register_callback_handle, TIME_HANDLE(void(*callback)(TimeItem*), TimeCallbackPriority));
+	MOCK_METHOD1(time_unregister_callback_handle, RET_CODE(TIME_HANDLE));
 	MOCK_METHOD0(time_watcher, void());
 	MOCK_METHOD0(time_get_basetime, uint16_t());
+	MOCK_METHOD1(time_set_tickless, void(uint32_t(*)()));
+	MOCK_METHOD0(time_reschedule, void());
+	MOCK_METHOD0(time_get_pending_ticks, uint16_t());
 };
 
 
@@ -41,10 +50,26 @@ RET_CODE time_set_utc(TimeItem* item)
 {
 	return time_cnt_mock->time_set_utc(item);
 }
+RET_CODE time_set_calendar_backend(const TimeCalendarBackend* backend)
+{
+	return time_cnt_mock->time_set_calendar_backend(backend);
+}
 TimeItem* time_get()
 {
 	return time_cnt_mock->time_get();
 }
+uint64_t time_get_epoch_ms()
+{
+	return time_cnt_mock->time_get_epoch_ms();
+}
+uint64_t time_to_epoch_ms(const TimeItem* item)
+{
+	return time_cnt_mock->time_to_epoch_ms(item);
+}
+void time_from_epoch_ms(uint64_t epoch_ms, TimeItem* item)
+{
+	time_cnt_mock->time_from_epoch_ms(epoch_ms, item);
+}
 RET_CODE time_register_callback(void(*callback)(TimeItem*), TimeCallbackPriority prio)
 {
 	return time_cnt_mock->time_register_callback(callback, prio);
@@ -53,12 +78,35 @@ RET_CODE time_unregister_callback(void(*callback)(TimeItem*))
 {
 	return time_cnt_mock->time_unregister_callback(callback);
 }
+TIME_HANDLE time_register_callback_handle(void(*callback)(TimeItem*), TimeCallbackPriority prio)
+{
+	return time_cnt_mock->time_register_callback_handle(callback, prio);
+}
+RET_CODE time_unregister_callback_handle(TIME_HANDLE handle)
+{
+	return time_cnt_mock->time_unregister_callback_handle(handle);
+}
 
 uint16_t time_get_basetime()
 {
 	return time_cnt_mock->time_get_basetime();
 }
 
+void time_set_tickless(uint32_t(*next_event)())
+{
+	time_cnt_mock->time_set_tickless(next_event);
+}
+
+void time_reschedule()
+{
+	time_cnt_mock->time_reschedule();
+}
+
+uint16_t time_get_pending_ticks()
+{
+	return time_cnt_mock->time_get_pending_ticks();
+}
+
 void time_watcher()
 {
 	time_cnt_mock->time_init();
@@ -0,0 +1,233 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../source/rtc_driver.c"
+#include "../../../../ext_lib/CMSIS/stubs/device/stm32f4xx.h"
+#ifdef __cplusplus
+}
+#endif
+#include "../mocks/time_counter_mock.h"
+
+/* ============================= */
+/**
+ * @file rtc_driver_tests.cpp
+ *
+ * @brief Unit tests of RTC driver
+ *
+ * @details
+ * This tests verifies behavior of RTC driver
+ */
+/* ============================= */
+
+using namespace ::testing;
+
+/* 17.10.2026 is 9786 days after 01.01.2000 */
+const uint64_t TEST_EPOCH_MS = 9786ULL * 86400 * 1000;
+
+uint8_t alarm_calls;
+TimeItem alarm_time;
+void fake_alarm_callback(TimeItem* item)
+{
+   alarm_calls++;
+   alarm_time = *item;
+}
+
+struct rtcFixture : public ::testing::Test
+{
+   virtual void SetUp()
+   {
+      stm_stub_init();
+      mock_time_counter_init();
+      alarm_calls = 0;
+      /* hardware flags, which are set immediately in stub */
+      RCC->BDCR |= RCC_BDCR_LSERDY;
+      RTC->ISR |= RTC_ISR_INITF | RTC_ISR_RSF | RTC_ISR_ALRAWF;
+      EXPECT_EQ(RETURN_OK, rtc_initialize());
+   }
+
+   virtual void TearDown()
+   {
+      rtc_deinitialize();
+      mock_time_counter_deinit();
+      stm_stub_deinit();
+   }
+};
+
+/**
+ * @test RTC initialization
+ */
+TEST_F(rtcFixture, rtc_initialize_test)
+{
+   /**
+    * <b>scenario</b>: First power up.<br>
+    * <b>expected</b>: LSE selected as RTC clock, prescalers set to 1Hz, alarm interrupt enabled.<br>
+    * ************************************************
+    */
+   EXPECT_TRUE(PWR->CR & PWR_CR_DBP);
+   EXPECT_TRUE(RCC->BDCR & RCC_BDCR_LSEON);
+   EXPECT_EQ(RCC_BDCR_RTCSEL_0, RCC->BDCR & RCC_BDCR_RTCSEL);
+   EXPECT_TRUE(RCC->BDCR & RCC_BDCR_RTCEN);
+   EXPECT_EQ(((uint32_t)127 << 16) | 255, RTC->PRER);
+   EXPECT_EQ(0xFF, RTC->WPR);
+   EXPECT_TRUE(EXTI->IMR & EXTI_IMR_MR17);
+   EXPECT_TRUE(EXTI->RTSR & EXTI_RTSR_TR17);
+   EXPECT_EQ(1, stm_stub_check_irq(RTC_Alarm_IRQn, 1));
+
+   /**
+    * <b>scenario</b>: Initialization after reset, RTC is already running.<br>
+    * <b>expected</b>: Configuration not touched.<br>
+    * ************************************************
+    */
+   rtc_deinitialize();
+   RTC->PRER = 0x12;
+   EXPECT_EQ(RETURN_OK, rtc_initialize());
+   EXPECT_EQ(0x12, RTC->PRER);
+
+   /**
+    * <b>scenario</b>: First power up, LSE not starting.<br>
+    * <b>expected</b>: RETURN_NOK returned.<br>
+    * ************************************************
+    */
+   rtc_deinitialize();
+   RCC->BDCR = 0;
+   EXPECT_EQ(RETURN_NOK, rtc_initialize());
+}
+
+/**
+ * @test Setting and reading calendar
+ */
+TEST_F(rtcFixture, rtc_calendar_test)
+{
+   TimeItem item = {17, 10, 2026, 13, 45, 30, 500};
+   TimeItem result = {};
+
+   /**
+    * <b>scenario</b>: Calendar read before set.<br>
+    * <b>expected</b>: RETURN_NOK returned.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_NOK, rtc_is_calendar_valid());
+   EXPECT_EQ(RETURN_NOK, rtc_get_calendar(&result));
+
+   /**
+    * <b>scenario</b>: Incorrect time set.<br>
+    * <b>expected</b>: RETURN_NOK returned.<br>
+    * ************************************************
+    */
+   item.hour = 24;
+   EXPECT_EQ(RETURN_NOK, rtc_set_calendar(&item));
+   item.hour = 13;
+
+   /**
+    * <b>scenario</b>: Calendar set.<br>
+    * <b>expected</b>: BCD values written with weekday, milliseconds added by shift.<br>
+    * ************************************************
+    */
+   EXPECT_CALL(*time_cnt_mock, time_to_epoch_ms(_)).WillOnce(Return(TEST_EPOCH_MS));
+   EXPECT_EQ(RETURN_OK, rtc_set_calendar(&item));
+   EXPECT_EQ(0x134530, RTC->TR);
+   /* Saturday */
+   EXPECT_EQ(((uint32_t)0x26 << 16) | (6 << 13) | (0x10 << 8) | 0x17, RTC->DR);
+   EXPECT_EQ(RTC_SHIFTR_ADD1S | (256 - 128), RTC->SHIFTR);
+   EXPECT_FALSE(RTC->ISR & RTC_ISR_INIT);
+   EXPECT_EQ(0xFF, RTC->WPR);
+
+   /**
+    * <b>scenario</b>: Calendar read.<br>
+    * <b>expected</b>: Values converted from BCD, milliseconds from subseconds.<br>
+    * ************************************************
+    */
+   RTC->ISR |= RTC_ISR_INITS;
+   RTC->SSR = 255 - 128;
+   EXPECT_EQ(RETURN_OK, rtc_is_calendar_valid());
+   EXPECT_EQ(RETURN_OK, rtc_get_calendar(&result));
+   EXPECT_EQ(17, result.day);
+   EXPECT_EQ(10, result.month);
+   EXPECT_EQ(2026, result.year);
+   EXPECT_EQ(13, result.hour);
+   EXPECT_EQ(45, result.minute);
+   EXPECT_EQ(30, result.second);
+   EXPECT_EQ(500, result.msecond);
+
+   /**
+    * <b>scenario</b>: Calendar read after shift, before the next second tick (SSR above PREDIV_S).<br>
+    * <b>expected</b>: One second subtracted, milliseconds counted in the previous second.<br>
+    * ************************************************
+    */
+   RTC->TR = 0x000000;
+   RTC->DR = ((uint32_t)0x26 << 16) | (6 << 13) | (0x10 << 8) | 0x18;
+   RTC->SSR = 255 + 64;
+   EXPECT_CALL(*time_cnt_mock, time_to_epoch_ms(_)).WillOnce(Return(TEST_EPOCH_MS + 86400000));
+   EXPECT_CALL(*time_cnt_mock, time_from_epoch_ms(TEST_EPOCH_MS + 86400000 - 1000, _)).WillOnce(Invoke([](uint64_t, TimeItem* item)
+            {
+               *item = {17, 10, 2026, 23, 59, 59, 0};
+            }));
+   EXPECT_EQ(RETURN_OK, rtc_get_calendar(&result));
+   EXPECT_EQ(17, result.day);
+   EXPECT_EQ(23, result.hour);
+   EXPECT_EQ(59, result.minute);
+   EXPECT_EQ(59, result.second);
+   EXPECT_EQ(750, result.msecond);
+}
+
+/**
+ * @test Alarm handling
+ */
+TEST_F(rtcFixture, rtc_alarm_test)
+{
+   TimeItem item = {17, 10, 2026, 13, 45, 31, 250};
+   RTC->ISR |= RTC_ISR_INITS;
+   RTC->BKP0R = RTC_CALENDAR_MAGIC;
+   RTC->TR = 0x134531;
+   RTC->DR = ((uint32_t)0x26 << 16) | (6 << 13) | (0x10 << 8) | 0x17;
+   RTC->SSR = 255 - 64;
+
+   /**
+    * <b>scenario</b>: Alarm set.<br>
+    * <b>expected</b>: Date, time and subseconds compared, interrupt enabled.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, rtc_set_alarm(&item, &fake_alarm_callback));
+   EXPECT_EQ(((uint32_t)0x17 << 24) | 0x134531, RTC->ALRMAR);
+   EXPECT_EQ(((uint32_t)8 << 24) | (255 - 64), RTC->ALRMASSR);
+   EXPECT_TRUE(RTC->CR & RTC_CR_ALRAE);
+   EXPECT_TRUE(RTC->CR & RTC_CR_ALRAIE);
+
+   /**
+    * <b>scenario</b>: Alarm interrupt.<br>
+    * <b>expected</b>: Flags cleared, callback not called in interrupt.<br>
+    * ************************************************
+    */
+   RTC->ISR |= RTC_ISR_ALRAF;
+   RTC_Alarm_IRQHandler();
+   EXPECT_FALSE(RTC->ISR & RTC_ISR_ALRAF);
+   EXPECT_EQ(EXTI_PR_PR17, EXTI->PR);
+   EXPECT_EQ(0, alarm_calls);
+
+   /**
+    * <b>scenario</b>: Main loop handles events.<br>
+    * <b>expected</b>: Callback called once with current time, alarm disabled.<br>
+    * ************************************************
+    */
+   evq_dispatch_all();
+   EXPECT_EQ(1, alarm_calls);
+   EXPECT_EQ(31, alarm_time.second);
+   EXPECT_EQ(250, alarm_time.msecond);
+   EXPECT_FALSE(RTC->CR & RTC_CR_ALRAE);
+   EXPECT_FALSE(RTC->CR & RTC_CR_ALRAIE);
+   evq_dispatch_all();
+   EXPECT_EQ(1, alarm_calls);
+
+   /**
+    * <b>scenario</b>: Alarm cancelled before interrupt.<br>
+    * <b>expected</b>: Callback not called.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, rtc_set_alarm(&item, &fake_alarm_callback));
+   rtc_cancel_alarm();
+   EXPECT_FALSE(RTC->CR & RTC_CR_ALRAE);
+   evq_dispatch_all();
+   EXPECT_EQ(1, alarm_calls);
+}
@@ -53,6 +53,16 @@ TEST_F(tsFixture, ts_init_tests)
    EXPECT_EQ(TIM4->CNT, 0);
    EXPECT_TRUE(TIM4->CR1 & TIM_CR1_CEN);
 
+   /**
+    * <b>scenario</b>: Cycle counter read.<br>
+    * <b>expected</b>: DWT counter enabled and returned.<br>
+    * ************************************************
+    */
+   EXPECT_TRUE(CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk);
+   EXPECT_TRUE(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk);
+   DWT->CYCCNT = 12345;
+   EXPECT_EQ(12345, ts_get_cycles());
+
 }
 
 /**
@@ -124,3 +134,66 @@ TEST_F(tsFixture, iterrupt_handling_tests)
    EXPECT_EQ(system_timestamp, 1);
 
 }
+
+/**
+ * @test Microseconds timestamp tests
+ */
+TEST_F(tsFixture, ts_us_tests)
+{
+   /**
+    * <b>scenario</b>: Module initialization.<br>
+    * <b>expected</b>: Microseconds timer started with 1us resolution.<br>
+    * ************************************************
+    */
+   ts_init();
+   EXPECT_TRUE(RCC->APB1ENR & RCC_APB1ENR_TIM5EN);
+   EXPECT_TRUE(TIM5->CR1 & TIM_CR1_CEN);
+   EXPECT_TRUE(TIM5->DIER & TIM_DIER_UIE);
+   EXPECT_EQ(99, TIM5->PSC);
+   EXPECT_EQ(0xFFFFFFFF, TIM5->ARR);
+   EXPECT_EQ(0, ts_get_us());
+
+   /**
+    * <b>scenario</b>: Timer counting.<br>
+    * <b>expected</b>: Timestamp and elapsed time returned.<br>
+    * ************************************************
+    */
+   TIM5->CNT = 1500;
+   uint64_t timestamp = ts_get_us();
+   EXPECT_EQ(1500, timestamp);
+   TIM5->CNT = 4000;
+   EXPECT_EQ(2500, ts_elapsed_us(timestamp));
+
+   /**
+    * <b>scenario</b>: Timer overflow handled in interrupt.<br>
+    * <b>expected</b>: Upper part of timestamp incremented, elapsed time correct across overflow.<br>
+    * ************************************************
+    */
+   TIM5->CNT = 0xFFFFFF00;
+   timestamp = ts_get_us();
+   TIM5->SR |= TIM_SR_UIF;
+   TIM5_IRQHandler();
+   TIM5->CNT = 0x100;
+   EXPECT_EQ(0x100000100ULL, ts_get_us());
+   EXPECT_EQ(0x200, ts_elapsed_us(timestamp));
+
+   /**
+    * <b>scenario</b>: Timer overflowed, but interrupt not handled yet.<br>
+    * <b>expected</b>: Pending overflow counted.<br>
+    * ************************************************
+    */
+   TIM5->SR |= TIM_SR_UIF;
+   TIM5->CNT = 0x10;
+   EXPECT_EQ(0x200000010ULL, ts_get_us());
+   TIM5->CNT = 0xFFFFFFF0;
+   EXPECT_EQ(0x1FFFFFFF0ULL, ts_get_us());
+
+   /**
+    * <b>scenario</b>: Module deinitialization.<br>
+    * <b>expected</b>: Timer stopped.<br>
+    * ************************************************
+    */
+   ts_deinit();
+   EXPECT_FALSE(TIM5->CR1 & TIM_CR1_CEN);
+   EXPECT_EQ(0, ts_get_us());
+}
@@ -30,6 +30,9 @@ using namespace ::testing;
 struct callbackMock
 {
 	MOCK_METHOD1(callback, void(TimeItem*));
+	MOCK_METHOD1(callback_high, void(TimeItem*));
+	MOCK_METHOD1(backend_get, RET_CODE(TimeItem*));
+	MOCK_METHOD1(backend_set, RET_CODE(const TimeItem*));
 };
 
 callbackMock* callMock;
@@ -39,6 +42,27 @@ void fake_callback(TimeItem* item)
 	callMock->callback(item);
 }
 
+uint32_t fake_next_event_ms;
+uint32_t fake_next_event()
+{
+	return fake_next_event_ms;
+}
+
+void fake_callback_high(TimeItem* item)
+{
+	callMock->callback_high(item);
+}
+
+RET_CODE fake_backend_get(TimeItem* item)
+{
+	return callMock->backend_get(item);
+}
+
+RET_CODE fake_backend_set(const TimeItem* item)
+{
+	return callMock->backend_set(item);
+}
+
 struct timeFixture : public ::testing::Test
 {
 	virtual void SetUp()
@@ -54,6 +78,25 @@ struct timeFixture : public ::testing::Test
 	}
 };
 
+void set_local_time(uint8_t day, uint8_t month, uint16_t year, uint8_t hour, uint8_t minute, uint8_t second, uint16_t msecond)
+{
+	TimeItem t = {day, month, year, hour, minute, second, msecond};
+	time_seconds = time_calendar_to_seconds(&t);
+	time_mseconds = msecond;
+}
+
+void expect_time(uint8_t day, uint8_t month, uint16_t year, uint8_t hour, uint8_t minute, uint8_t second, uint16_t msecond)
+{
+	TimeItem* t = time_get();
+	EXPECT_EQ(t->day, day);
+	EXPECT_EQ(t->month, month);
+	EXPECT_EQ(t->year, year);
+	EXPECT_EQ(t->hour, hour);
+	EXPECT_EQ(t->minute, minute);
+	EXPECT_EQ(t->second, second);
+	EXPECT_EQ(t->msecond, msecond);
+}
+
 /**
  * @test Time incrementing test
  */
@@ -69,16 +112,7 @@ TEST_F(timeFixture, time_increment_test)
 	/* interrupt fired */
 	SysTick_Handler();
 	time_watcher();
-
-	TimeItem* t = time_get();
-
-	EXPECT_EQ(t->day, 1);
-	EXPECT_EQ(t->month, 1);
-	EXPECT_EQ(t->year, 2000);
-	EXPECT_EQ(t->hour, 0);
-	EXPECT_EQ(t->minute, 0);
-	EXPECT_EQ(t->second, 0);
-	EXPECT_EQ(t->msecond, 10);
+	expect_time(1, 1, 2000, 0, 0, 0, 10);
 
 	/**
 	 * <b>scenario</b>: Switching from msecond to seconds.<br>
@@ -91,177 +125,154 @@ TEST_F(timeFixture, time_increment_test)
 		SysTick_Handler();
 		time_watcher();
 	}
-
-	EXPECT_EQ(t->day, 1);
-	EXPECT_EQ(t->month, 1);
-	EXPECT_EQ(t->year, 2000);
-	EXPECT_EQ(t->hour, 0);
-	EXPECT_EQ(t->minute, 0);
-	EXPECT_EQ(t->second, 1);
-	EXPECT_EQ(t->msecond, 0);
+	expect_time(1, 1, 2000, 0, 0, 1, 0);
 
 	/**
 	 * <b>scenario</b>: Switching from seconds to minutes.<br>
 	 * <b>expected</b>: Correct time.<br>
     * ************************************************
 	 */
-
-	t->second = 59;
-	t->msecond = 990;
-
+	set_local_time(1, 1, 2000, 0, 0, 59, 990);
 	SysTick_Handler();
 	time_watcher();
-
-	EXPECT_EQ(t->day, 1);
-	EXPECT_EQ(t->month, 1);
-	EXPECT_EQ(t->year, 2000);
-	EXPECT_EQ(t->hour, 0);
-	EXPECT_EQ(t->minute, 1);
-	EXPECT_EQ(t->second, 0);
-	EXPECT_EQ(t->msecond, 0);
+	expect_time(1, 1, 2000, 0, 1, 0, 0);
 
 	/**
 	 * <b>scenario</b>: Switching from minutes to hours.<br>
 	 * <b>expected</b>: Correct time.<br>
     * ************************************************
 	 */
-
-	t->minute = 59;
-	t->second = 59;
-	t->msecond = 990;
-
+	set_local_time(1, 1, 2000, 0, 59, 59, 990);
 	SysTick_Handler();
 	time_watcher();
-
-	EXPECT_EQ(t->day, 1);
-	EXPECT_EQ(t->month, 1);
-	EXPECT_EQ(t->year, 2000);
-	EXPECT_EQ(t->hour, 1);
-	EXPECT_EQ(t->minute, 0);
-	EXPECT_EQ(t->second, 0);
-	EXPECT_EQ(t->msecond, 0);
+	expect_time(1, 1, 2000, 1, 0, 0, 0);
 
 	/**
 	 * <b>scenario</b>: Switching from hours to days.<br>
 	 * <b>expected</b>: Correct time.<br>
     * ************************************************
 	 */
-
-	t->hour = 23;
-	t->minute = 59;
-	t->second = 59;
-	t->msecond = 990;
-
+	set_local_time(1, 1, 2000, 23, 59, 59, 990);
 	SysTick_Handler();
 	time_watcher();
-
-	EXPECT_EQ(t->day, 2);
-	EXPECT_EQ(t->month, 1);
-	EXPECT_EQ(t->year, 2000);
-	EXPECT_EQ(t->hour, 0);
-	EXPECT_EQ(t->minute, 0);
-	EXPECT_EQ(t->second, 0);
-	EXPECT_EQ(t->msecond, 0);
+	expect_time(2, 1, 2000, 0, 0, 0, 0);
 
 	/**
 	 * <b>scenario</b>: Switching from days to months.<br>
-	 * <b>expected</b>: Correct time.<br>
+	 * <b>expected</b>: Correct time, last day of month not skipped.<br>
     * ************************************************
 	 */
-
-	t->day = 31;
-	t->month = 1;
-	t->hour = 23;
-	t->minute = 59;
-	t->second = 59;
-	t->msecond = 990;
-
+	set_local_time(30, 1, 2000, 23, 59, 59, 990);
 	SysTick_Handler();
 	time_watcher();
+	expect_time(31, 1, 2000, 0, 0, 0, 0);
 
-	EXPECT_EQ(t->day, 1);
-	EXPECT_EQ(t->month, 2);
-	EXPECT_EQ(t->year, 2000);
-	EXPECT_EQ(t->hour, 0);
-	EXPECT_EQ(t->minute, 0);
-	EXPECT_EQ(t->second, 0);
-	EXPECT_EQ(t->msecond, 0);
+	set_local_time(31, 1, 2000, 23, 59, 59, 990);
+	SysTick_Handler();
+	time_watcher();
+	expect_time(1, 2, 2000, 0, 0, 0, 0);
 
 	/**
 	 * <b>scenario</b>: Switching from months to years.<br>
 	 * <b>expected</b>: Correct time.<br>
     * ************************************************
 	 */
-
-	t->day = 31;
-	t->month = 12;
-	t->hour = 23;
-	t->minute = 59;
-	t->second = 59;
-	t->msecond = 990;
-
+	set_local_time(31, 12, 2000, 23, 59, 59, 990);
 	SysTick_Handler();
 	time_watcher();
-
-	EXPECT_EQ(t->day, 1);
-	EXPECT_EQ(t->month, 1);
-	EXPECT_EQ(t->year, 2001);
-	EXPECT_EQ(t->hour, 0);
-	EXPECT_EQ(t->minute, 0);
-	EXPECT_EQ(t->second, 0);
-	EXPECT_EQ(t->msecond, 0);
+	expect_time(1, 1, 2001, 0, 0, 0, 0);
 
 	/**
 	 * <b>scenario</b>: Switching from days to month - non-leap year.<br>
 	 * <b>expected</b>: Correct time.<br>
     * ************************************************
 	 */
-
-	t->day = 28;
-	t->month = 2;
-	t->year = 2019;
-	t->hour = 23;
-	t->minute = 59;
-	t->second = 59;
-	t->msecond = 990;
-
+	set_local_time(28, 2, 2019, 23, 59, 59, 990);
 	SysTick_Handler();
 	time_watcher();
+	expect_time(1, 3, 2019, 0, 0, 0, 0);
 
-	EXPECT_EQ(t->day, 1);
-	EXPECT_EQ(t->month, 3);
-	EXPECT_EQ(t->year, 2019);
-	EXPECT_EQ(t->hour, 0);
-	EXPECT_EQ(t->minute, 0);
-	EXPECT_EQ(t->second, 0);
-	EXPECT_EQ(t->msecond, 0);
+	/**
+	 * <b>scenario</b>: Switching from days to month - leap year.<br>
+	 * <b>expected</b>: 29th of February.<br>
+    * ************************************************
+	 */
+	set_local_time(28, 2, 2020, 23, 59, 59, 990);
+	SysTick_Handler();
+	time_watcher();
+	expect_time(29, 2, 2020, 0, 0, 0, 0);
 }
 
-TEST_F(timeFixture, leap_year_tests)
+/**
+ * @test Conversions between calendar and epoch time
+ */
+TEST_F(timeFixture, epoch_conversion_tests)
 {
-	uint16_t non_leap_years[] = {2001, 2002, 2003, 2005, 2006, 2006, 2009, 2010, 2011, 2013, 2014, 2015, 2017, 2018, 2019, 2021, 2022, 2023};
-	uint16_t leap_years[] = {2000, 2004, 2008, 2012, 2016, 2020};
+	TimeItem t = {};
+	time_init();
 	/**
-	 * <b>scenario</b>: Non-leap years checked<br>
-	 * <b>expected</b>: Correct leap-ness.<br>
+	 * <b>scenario</b>: Epoch converted to calendar.<br>
+	 * <b>expected</b>: 01.01.2000 00:00:00.000.<br>
     * ************************************************
 	 */
-	for (auto year : non_leap_years)
+	time_from_epoch_ms(0, &t);
+	EXPECT_EQ(1, t.day);
+	EXPECT_EQ(1, t.month);
+	EXPECT_EQ(2000, t.year);
+	EXPECT_EQ(0, time_get_epoch_ms());
+
+	/**
+	 * <b>scenario</b>: Every day of years 2000-2099 converted to epoch and back.<br>
+	 * <b>expected</b>: The same calendar time, epoch growing by one day.<br>
+    * ************************************************
+	 */
+	uint64_t expected_ms = 0;
+	for (uint16_t year = 2000; year < 2100; year++)
 	{
-		timestamp.year = year;
-		EXPECT_EQ(RETURN_NOK, time_is_leap_year());
+		for (uint8_t month = 1; month <= 12; month++)
+		{
+			for (uint8_t day = 1; day <= time_get_month_days(month, year); day++)
+			{
+				TimeItem in = {day, month, year, 13, 14, 15, 160};
+				TimeItem out = {};
+				uint64_t epoch_ms = time_to_epoch_ms(&in);
+				ASSERT_EQ(expected_ms + (13 * 3600 + 14 * 60 + 15) * 1000 + 160, epoch_ms);
+				time_from_epoch_ms(epoch_ms, &out);
+				ASSERT_EQ(0, memcmp(&in, &out, sizeof(TimeItem)));
+				expected_ms += 86400000ULL;
+			}
+		}
 	}
 
 	/**
-	 * <b>scenario</b>: Leap years checked<br>
-	 * <b>expected</b>: Correct leap-ness.<br>
+	 * <b>scenario</b>: Time set and interrupts fired.<br>
+	 * <b>expected</b>: Epoch time moving by basetime, difference is cheap to calculate.<br>
     * ************************************************
 	 */
-	for (auto year : leap_years)
+	t = {20, 12, 2020, 12, 20, 30, 30};
+	time_set_winter_time(1);
+	EXPECT_EQ(RETURN_OK, time_set_utc(&t));
+	uint64_t start = time_get_epoch_ms();
+	t.hour = 13;
+	EXPECT_EQ(time_to_epoch_ms(&t), start);
+	for (uint8_t i = 0; i < 150; i++)
 	{
-		timestamp.year = year;
-		EXPECT_EQ(RETURN_OK, time_is_leap_year());
+		SysTick_Handler();
 	}
+	EXPECT_EQ(1500, time_get_epoch_ms() - start);
+	expect_time(20, 12, 2020, 13, 20, 31, 530);
+
+	/**
+	 * <b>scenario</b>: Setting 29th of February.<br>
+	 * <b>expected</b>: Accepted only in leap year.<br>
+    * ************************************************
+	 */
+	t = {29, 2, 2021, 12, 0, 0, 0};
+	EXPECT_EQ(RETURN_NOK, time_set_utc(&t));
+	t.year = 2024;
+	EXPECT_EQ(RETURN_OK, time_set_utc(&t));
+
+	time_deinit();
 }
 
 /**
@@ -344,6 +355,93 @@ TEST_F(timeFixture, callback_tests)
 	time_deinit();
 }
 
+/**
+ * @test Callback handles and priority lists tests
+ */
+TEST_F(timeFixture, callback_handle_tests)
+{
+	time_init();
+	/**
+	 * <b>scenario</b>: Callbacks registered with invalid arguments.<br>
+	 * <b>expected</b>: Invalid handle returned.<br>
+    * ************************************************
+	 */
+	EXPECT_EQ(TIME_INVALID_HANDLE, time_register_callback_handle(NULL, TIME_PRIORITY_LOW));
+	EXPECT_EQ(TIME_INVALID_HANDLE, time_register_callback_handle(&fake_callback, TIME_PRIORITY_UNKNOWN));
+	EXPECT_EQ(RETURN_NOK, time_unregister_callback_handle(TIME_INVALID_HANDLE));
+
+	/**
+	 * <b>scenario</b>: Callbacks of both priorities registered, interrupt fired.<br>
+	 * <b>expected</b>: High priority callback called from interrupt, low priority from watcher.<br>
+    * ************************************************
+	 */
+	TIME_HANDLE low = time_register_callback_handle(&fake_callback, TIME_PRIORITY_LOW);
+	TIME_HANDLE high = time_register_callback_handle(&fake_callback_high, TIME_PRIORITY_HIGH);
+	EXPECT_NE(TIME_INVALID_HANDLE, low);
+	EXPECT_NE(TIME_INVALID_HANDLE, high);
+	EXPECT_EQ(1, time_dispatch[TIME_PRIORITY_LOW].size);
+	EXPECT_EQ(1, time_dispatch[TIME_PRIORITY_HIGH].size);
+
+	EXPECT_CALL(*callMock, callback_high(_));
+	EXPECT_CALL(*callMock, callback(_)).Times(0);
+	SysTick_Handler();
+	Mock::VerifyAndClearExpectations(callMock);
+
+	EXPECT_CALL(*callMock, callback(_));
+	time_watcher();
+	Mock::VerifyAndClearExpectations(callMock);
+
+	/**
+	 * <b>scenario</b>: High priority callback unregistered by handle, handle used again.<br>
+	 * <b>expected</b>: Callback not called anymore, stale handle rejected.<br>
+    * ************************************************
+	 */
+	EXPECT_EQ(RETURN_OK, time_unregister_callback_handle(high));
+	EXPECT_EQ(RETURN_NOK, time_unregister_callback_handle(high));
+	EXPECT_EQ(0, time_dispatch[TIME_PRIORITY_HIGH].size);
+	EXPECT_CALL(*callMock, callback_high(_)).Times(0);
+	EXPECT_CALL(*callMock, callback(_));
+	SysTick_Handler();
+	time_watcher();
+	Mock::VerifyAndClearExpectations(callMock);
+
+	/**
+	 * <b>scenario</b>: Slot reused by new registration.<br>
+	 * <b>expected</b>: New handle differs from stale one, stale handle does not remove new callback.<br>
+    * ************************************************
+	 */
+	TIME_HANDLE reused = time_register_callback_handle(&fake_callback_high, TIME_PRIORITY_HIGH);
+	EXPECT_NE(TIME_INVALID_HANDLE, reused);
+	EXPECT_NE(high, reused);
+	EXPECT_EQ(RETURN_NOK, time_unregister_callback_handle(high));
+	EXPECT_EQ(1, time_dispatch[TIME_PRIORITY_HIGH].size);
+
+	/**
+	 * <b>scenario</b>: The same function registered twice and removed by one handle.<br>
+	 * <b>expected</b>: Remaining registration still called once.<br>
+    * ************************************************
+	 */
+	TIME_HANDLE low2 = time_register_callback_handle(&fake_callback, TIME_PRIORITY_LOW);
+	EXPECT_EQ(2, time_dispatch[TIME_PRIORITY_LOW].size);
+	EXPECT_EQ(RETURN_OK, time_unregister_callback_handle(low));
+	EXPECT_EQ(1, time_dispatch[TIME_PRIORITY_LOW].size);
+	EXPECT_CALL(*callMock, callback_high(_));
+	EXPECT_CALL(*callMock, callback(_));
+	SysTick_Handler();
+	time_watcher();
+	Mock::VerifyAndClearExpectations(callMock);
+
+	/**
+	 * <b>scenario</b>: Module deinitialized.<br>
+	 * <b>expected</b>: All lists empty.<br>
+    * ************************************************
+	 */
+	time_deinit();
+	EXPECT_EQ(RETURN_NOK, time_unregister_callback_handle(low2));
+	EXPECT_EQ(0, time_dispatch[TIME_PRIORITY_LOW].size);
+	EXPECT_EQ(0, time_dispatch[TIME_PRIORITY_HIGH].size);
+}
+
 /**
  * @test Setting/Getting time test
  */
@@ -696,3 +794,153 @@ TEST_F(timeFixture, time_set_utc)
 
 	EXPECT_EQ(RETURN_OK, time_unregister_callback(&fake_callback));
 }
+
+/**
+ * @test Tickless mode tests
+ */
+TEST_F(timeFixture, tickless_tests)
+{
+	time_init();
+	TimeItem t = {};
+	t.day = 1;
+	t.month = 1;
+	t.year = 2020;
+	time_set_utc(&t);
+	const uint32_t cycles_per_tick = SysTick->LOAD + 1;
+
+	/**
+	 * <b>scenario</b>: Tickless mode disabled.<br>
+	 * <b>expected</b>: No pending ticks reported.<br>
+    * ************************************************
+	 */
+	SysTick->VAL = 0;
+	EXPECT_EQ(0, time_get_pending_ticks());
+
+	/**
+	 * <b>scenario</b>: Tickless mode enabled at the beginning of the tick, next event in 55ms.<br>
+	 * <b>expected</b>: Timer armed for 6 ticks, all of them handled in one interrupt.<br>
+    * ************************************************
+	 */
+	fake_next_event_ms = 55;
+	SysTick->VAL = SysTick->LOAD;
+	time_set_tickless(&fake_next_event);
+	EXPECT_EQ(6 * cycles_per_tick - 1, SysTick->LOAD);
+
+	SysTick->VAL = SysTick->LOAD - 2 * cycles_per_tick;
+	EXPECT_EQ(2, time_get_pending_ticks());
+
+	fake_next_event_ms = 10000;
+	SysTick->VAL = SysTick->LOAD;
+	SysTick_Handler();
+	EXPECT_EQ(60, time_get()->msecond);
+	EXPECT_EQ(16 * cycles_per_tick - 1, SysTick->LOAD);
+
+	/**
+	 * <b>scenario</b>: Earlier event requested when 3 ticks of window elapsed.<br>
+	 * <b>expected</b>: Timer re-armed, elapsed part of the window deducted.<br>
+    * ************************************************
+	 */
+	SysTick->VAL = SysTick->LOAD - 3 * cycles_per_tick;
+	fake_next_event_ms = 50;
+	time_reschedule();
+	EXPECT_EQ(2 * cycles_per_tick - 1, SysTick->LOAD);
+	SysTick->VAL = SysTick->LOAD;
+	EXPECT_EQ(3, time_get_pending_ticks());
+	SysTick_Handler();
+	EXPECT_EQ(110, time_get()->msecond);
+
+	/**
+	 * <b>scenario</b>: Tickless mode disabled.<br>
+	 * <b>expected</b>: Periodic interrupt restored.<br>
+    * ************************************************
+	 */
+	time_set_tickless(NULL);
+	EXPECT_EQ(cycles_per_tick - 1, SysTick->LOAD);
+	SysTick_Handler();
+	EXPECT_EQ(120, time_get()->msecond);
+
+	time_deinit();
+}
+
+/**
+ * @test Calendar backend tests
+ */
+TEST_F(timeFixture, calendar_backend_tests)
+{
+	time_init();
+	time_set_winter_time(1);
+	const TimeCalendarBackend backend = {&fake_backend_get, &fake_backend_set};
+	const TimeCalendarBackend incomplete_backend = {&fake_backend_get, NULL};
+	TimeItem backend_time = {17, 10, 2026, 13, 45, 30, 507};
+	TimeItem t = {18, 10, 2026, 8, 0, 0, 0};
+
+	/**
+	 * <b>scenario</b>: Backend without set function.<br>
+	 * <b>expected</b>: RETURN_NOK returned, backend not used.<br>
+    * ************************************************
+	 */
+	EXPECT_EQ(RETURN_NOK, time_set_calendar_backend(&incomplete_backend));
+
+	/**
+	 * <b>scenario</b>: Backend set, calendar is not valid.<br>
+	 * <b>expected</b>: Local time not changed.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, backend_get(_)).WillOnce(Return(RETURN_NOK));
+	EXPECT_EQ(RETURN_OK, time_set_calendar_backend(&backend));
+	expect_time(1, 1, 2000, 0, 0, 0, 0);
+
+	/**
+	 * <b>scenario</b>: Backend set, calendar is valid.<br>
+	 * <b>expected</b>: Local time read from backend, aligned to basetime.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, backend_get(_)).WillOnce(DoAll(SetArgPointee<0>(backend_time), Return(RETURN_OK)));
+	EXPECT_EQ(RETURN_OK, time_set_calendar_backend(&backend));
+	expect_time(17, 10, 2026, 14, 45, 30, 500);
+
+	/**
+	 * <b>scenario</b>: UTC time set.<br>
+	 * <b>expected</b>: UTC time written to backend.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, backend_set(_)).WillOnce(Invoke([&](const TimeItem* item) -> RET_CODE
+			{
+				EXPECT_EQ(item->day, 18);
+				EXPECT_EQ(item->hour, 8);
+				return RETURN_OK;
+			}));
+	EXPECT_EQ(RETURN_OK, time_set_utc(&t));
+	expect_time(18, 10, 2026, 9, 0, 0, 0);
+
+	/**
+	 * <b>scenario</b>: Less than synchronization period elapsed.<br>
+	 * <b>expected</b>: Backend not read.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, backend_get(_)).Times(0);
+	time_seconds += TIME_BACKEND_SYNC_PERIOD_S - 1;
+	time_on_low_prio_tick(0);
+
+	/**
+	 * <b>scenario</b>: Synchronization period elapsed, local time drifted.<br>
+	 * <b>expected</b>: Local time corrected from backend.<br>
+    * ************************************************
+	 */
+	backend_time = {18, 10, 2026, 9, 0, 2, 0};
+	EXPECT_CALL(*callMock, backend_get(_)).WillOnce(DoAll(SetArgPointee<0>(backend_time), Return(RETURN_OK)));
+	time_seconds += 1;
+	time_on_low_prio_tick(0);
+	expect_time(18, 10, 2026, 10, 0, 2, 0);
+
+	/**
+	 * <b>scenario</b>: Backend disabled.<br>
+	 * <b>expected</b>: Time set only locally.<br>
+    * ************************************************
+	 */
+	EXPECT_CALL(*callMock, backend_set(_)).Times(0);
+	EXPECT_EQ(RETURN_OK, time_set_calendar_backend(NULL));
+	EXPECT_EQ(RETURN_OK, time_set_utc(&t));
+
+	time_deinit();
+}
@@ -0,0 +1,140 @@
+#ifndef _EVENT_QUEUE_H_
+#define _EVENT_QUEUE_H_
+
+/* ============================= */
+/**
+ * @file event_queue.h
+ *
+ * @brief Lock-free queue for work deferred from interrupts to the main loop.
+ *
+ * @details
+ * Every queue is single-producer/single-consumer - exactly one context (one interrupt
+ * handler) may call evq_push() and only the main loop may pop events. Producer writes
+ * only the head index and consumer writes only the tail index, so no interrupt
+ * masking is needed on any side.
+ * Interrupts in this system are running on different preemption levels, so every
+ * producer owns a separate queue. Queues are registered in module and the main
+ * loop drains all of them with single evq_dispatch_all() call.
+ * When queue is full, event is dropped and overflow counter is incremented.
+ */
+/* ============================= */
+
+/* =============================
+ *  Includes of common headers
+ * =============================*/
+#include <stdint.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "return_codes.h"
+/* =============================
+ *          Defines
+ * =============================*/
+/** Number of events in every queue - can be overridden at build time, has to be a power of 2 */
+#ifndef EVQ_DEPTH
+#define EVQ_DEPTH 32
+#endif
+#if (EVQ_DEPTH & (EVQ_DEPTH - 1)) != 0 || EVQ_DEPTH < 2 || EVQ_DEPTH > 32768
+#error "EVQ_DEPTH has to be a power of 2 in range 2-32768"
+#endif
+/** Maximum number of queues drained by evq_dispatch_all() */
+#ifndef EVQ_MAX_QUEUES
+#define EVQ_MAX_QUEUES 12
+#endif
+/* =============================
+ *       Data structures
+ * =============================*/
+typedef void(*EVQ_HANDLER)(uint32_t arg);
+
+typedef struct EVQ_EVENT
+{
+   EVQ_HANDLER handler;    /**< Function called from main loop context */
+   uint32_t arg;           /**< Argument passed to handler */
+} EVQ_EVENT;
+
+typedef struct EVQ
+{
+   volatile uint16_t head;          /**< Written by producer only */
+   volatile uint16_t tail;          /**< Written by consumer only */
+   volatile uint32_t overflows;     /**< Number of events dropped because of full queue */
+   uint16_t high_water;             /**< Maximum number of pending events seen by consumer */
+   EVQ_EVENT events[EVQ_DEPTH];
+} EVQ;
+
+/**
+ * @brief Initialize queue - all pending events are dropped and counters are cleared.
+ * @details Has to be called before producer is enabled.
+ * @param[in] queue - queue to initialize
+ * @return None.
+ */
+void evq_init(EVQ* queue);
+/**
+ * @brief Put event into queue. Producer side, can be called from interrupt.
+ * @param[in] queue - queue to write
+ * @param[in] handler - function to call from main loop
+ * @param[in] arg - argument for handler
+ * @return RETURN_OK when event queued, RETURN_NOK when queue is full (overflow counted).
+ */
+RET_CODE evq_push(EVQ* queue, EVQ_HANDLER handler, uint32_t arg);
+/**
+ * @brief Take the oldest event from queue. Consumer side.
+ * @param[in] queue - queue to read
+ * @param[out] event - place to store the event
+ * @return RETURN_OK when event read, RETURN_NOK when queue is empty.
+ */
+RET_CODE evq_pop(EVQ* queue, EVQ_EVENT* event);
+/**
+ * @brief Drop all pending events. Consumer side.
+ * @param[in] queue - queue to flush
+ * @return None.
+ */
+void evq_flush(EVQ* queue);
+/**
+ * @brief Call handlers of all events pending in queue. Consumer side.
+ * @details Event is removed from queue before its handler is called.
+ * @param[in] queue - queue to drain
+ * @return Number of handled events.
+ */
+uint16_t evq_dispatch(EVQ* queue);
+/**
+ * @brief Get number of pending events.
+ * @param[in] queue - queue to check
+ * @return Number of events.
+ */
+uint16_t evq_get_count(const EVQ* queue);
+/**
+ * @brief Get number of events dropped because of full queue.
+ * @param[in] queue - queue to check
+ * @return Number of dropped events.
+ */
+uint32_t evq_get_overflows(const EVQ* queue);
+/**
+ * @brief Get maximum number of pending events seen by consumer.
+ * @param[in] queue - queue to check
+ * @return Number of events.
+ */
+uint16_t evq_get_high_water(const EVQ* queue);
+/**
+ * @brief Add queue to the set drained by evq_dispatch_all().
+ * @param[in] queue - queue to register
+ * @return RETURN_OK when registered (or already registered), RETURN_NOK otherwise.
+ */
+RET_CODE evq_register(EVQ* queue);
+/**
+ * @brief Remove queue from the set drained by evq_dispatch_all().
+ * @param[in] queue - queue to unregister
+ * @return RETURN_OK when removed, RETURN_NOK when not found.
+ */
+RET_CODE evq_unregister(EVQ* queue);
+/**
+ * @brief Drain all registered queues. Should be called from main loop.
+ * @return Number of handled events.
+ */
+uint16_t evq_dispatch_all();
+/**
+ * @brief Get sum of overflow counters of all registered queues.
+ * @return Number of dropped events.
+ */
+uint32_t evq_get_total_overflows();
+
+#endif
@@ -2,10 +2,11 @@
 #define _LIST_GENERIC_H_
 
 #include <stdint.h>
+#include <stddef.h>
 #include "return_codes.h"
 
 /**
- * 	Implementation of one-directional linked list.
+ * 	Implementation of double-linked list.
  * 	It allows dynamic allocation of objects.
  * 	List size is restricted to 255.
  *
@@ -23,6 +24,7 @@ typedef struct L_LIST
 {
 	uint8_t size;
 	LIST_ITEM* head;
+	LIST_ITEM* tail;
 } L_LIST;
 
 L_LIST* list_init();
@@ -31,9 +33,142 @@ RET_CODE list_add(L_LIST*, void*);
 RET_CODE list_remove(L_LIST*, void*);
 uint8_t list_get_size(L_LIST*);
 
+/**
+ * 	Intrusive double-linked list - no heap allocation at runtime.
+ * 	LIST_NODE is a member of user structure, list only links nodes together.
+ * 	Append, prepend, pop and remove are O(1), iteration with ILIST_FOR_EACH macros.
+ *
+ * 	List created with capacity > 0 accepts at most capacity nodes.
+ * 	List created with ILIST_ISR_SAFE flag modifies links with interrupts disabled,
+ * 	so it can be shared between interrupt and main loop.
+ *
+ * 	USAGE: ilist_init on static I_LIST, then add nodes embedded in user objects.
+ * 	Object is taken back from node with LIST_CONTAINER_OF.
+ */
+
+/** List links are modified in critical section */
+#define ILIST_ISR_SAFE 0x01
+
+typedef struct LIST_NODE
+{
+	struct LIST_NODE* next;
+	struct LIST_NODE* prev;
+} LIST_NODE;
+
+typedef struct I_LIST
+{
+	LIST_NODE* head;
+	LIST_NODE* tail;
+	uint16_t size;
+	uint16_t capacity;  /**< Maximum number of nodes, 0 - not limited */
+	uint8_t flags;      /**< ILIST_ISR_SAFE */
+} I_LIST;
 
+/**
+ * Pool item used by lists of pointers, when object cannot embed LIST_NODE.
+ * Node has to be the first member.
+ */
+typedef struct LIST_POOL_ITEM
+{
+	LIST_NODE node;
+	void* data;
+} LIST_POOL_ITEM;
 
+typedef struct LIST_POOL
+{
+	I_LIST free;        /**< Items not used by any list */
+} LIST_POOL;
 
+/** Get pointer to object from pointer to its LIST_NODE member */
+#define LIST_CONTAINER_OF(node, type, member) ((type*)((char*)(node) - offsetof(type, member)))
+/** Get data stored by list_pool_add() from list node */
+#define LIST_POOL_DATA(node) (((LIST_POOL_ITEM*)(node))->data)
+/** Iterate over all nodes, current node must not be removed */
+#define ILIST_FOR_EACH(list, node) \
+	for ((node) = (list)->head; (node) != NULL; (node) = (node)->next)
+/** Iterate over all nodes, current node can be removed */
+#define ILIST_FOR_EACH_SAFE(list, node, tmp) \
+	for ((node) = (list)->head, (tmp) = (node)? (node)->next : NULL; (node) != NULL; (node) = (tmp), (tmp) = (node)? (node)->next : NULL)
 
+/**
+ * @brief Initialize empty list.
+ * @param[in] list - list to initialize
+ * @param[in] capacity - maximum number of nodes, 0 for not limited
+ * @param[in] flags - ILIST_ISR_SAFE or 0
+ * @return None.
+ */
+void ilist_init(I_LIST* list, uint16_t capacity, uint8_t flags);
+/**
+ * @brief Add node at the end of list.
+ * @param[in] list - list to modify
+ * @param[in] node - node not linked to any list
+ * @return RETURN_OK when added, RETURN_NOK when list is full.
+ */
+RET_CODE ilist_push_back(I_LIST* list, LIST_NODE* node);
+/**
+ * @brief Add node at the beginning of list.
+ * @param[in] list - list to modify
+ * @param[in] node - node not linked to any list
+ * @return RETURN_OK when added, RETURN_NOK when list is full.
+ */
+RET_CODE ilist_push_front(I_LIST* list, LIST_NODE* node);
+/**
+ * @brief Unlink node from list.
+ * @param[in] list - list to modify
+ * @param[in] node - node linked to this list
+ * @return RETURN_OK when removed, RETURN_NOK when list is empty.
+ */
+RET_CODE ilist_remove(I_LIST* list, LIST_NODE* node);
+/**
+ * @brief Unlink the first node from list.
+ * @param[in] list - list to modify
+ * @return Removed node, NULL when list is empty.
+ */
+LIST_NODE* ilist_pop_front(I_LIST* list);
+/**
+ * @brief Get number of nodes.
+ * @param[in] list - list to check
+ * @return Number of nodes.
+ */
+uint16_t ilist_get_size(const I_LIST* list);
+/**
+ * @brief Initialize pool with items provided by user (e.g. static array).
+ * @param[in] pool - pool to initialize
+ * @param[in] items - items to use
+ * @param[in] count - number of items
+ * @param[in] flags - ILIST_ISR_SAFE or 0
+ * @return None.
+ */
+void list_pool_init(LIST_POOL* pool, LIST_POOL_ITEM* items, uint16_t count, uint8_t flags);
+/**
+ * @brief Take item from pool and add it at the end of list.
+ * @param[in] pool - pool to take item from
+ * @param[in] list - list to modify
+ * @param[in] data - pointer to store
+ * @return RETURN_OK when added, RETURN_NOK when pool is empty or list is full.
+ */
+RET_CODE list_pool_add(LIST_POOL* pool, I_LIST* list, void* data);
+/**
+ * @brief Remove the first item with given data from list and give it back to pool.
+ * @details Search is O(n), use list_pool_pop() for queues.
+ * @param[in] pool - pool to give item back
+ * @param[in] list - list to modify
+ * @param[in] data - pointer to find
+ * @return RETURN_OK when removed, RETURN_NOK when not found.
+ */
+RET_CODE list_pool_remove(LIST_POOL* pool, I_LIST* list, void* data);
+/**
+ * @brief Remove the first item from list and give it back to pool.
+ * @param[in] pool - pool to give item back
+ * @param[in] list - list to modify
+ * @return Data of removed item, NULL when list is empty.
+ */
+void* list_pool_pop(LIST_POOL* pool, I_LIST* list);
+/**
+ * @brief Get number of items not used by any list.
+ * @param[in] pool - pool to check
+ * @return Number of items.
+ */
+uint16_t list_pool_get_free(const LIST_POOL* pool);
 
 #endif
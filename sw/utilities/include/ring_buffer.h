@@ -0,0 +1,159 @@
+#ifndef _RING_BUFFER_H_
+#define _RING_BUFFER_H_
+
+/* ============================= */
+/**
+ * @file ring_buffer.h
+ *
+ * @brief Lock-free byte ring buffer used by serial engines.
+ *
+ * @details
+ * Buffer is single-producer/single-consumer - e.g. interrupt handler writes received
+ * bytes and main loop reads them (or the other way round for transmission).
+ * Producer writes only the head index and consumer writes only the tail index, so
+ * no interrupt masking is needed on any side.
+ * Indexes are free running, size has to be a power of 2, so position in memory
+ * is taken with mask and full buffer can be distinguished from empty one.
+ * When buffer is full, new bytes are rejected and overflow counter is incremented.
+ *
+ * Bulk functions copy data with at most two memcpy calls (before and after wrap).
+ * Contiguous views allow to process data in place, without copying it.
+ */
+/* ============================= */
+
+/* =============================
+ *  Includes of common headers
+ * =============================*/
+#include <stdint.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "return_codes.h"
+/* =============================
+ *          Defines
+ * =============================*/
+/** Maximum buffer size - indexes are 16-bit */
+#define RB_MAX_SIZE 32768
+/* =============================
+ *       Data structures
+ * =============================*/
+typedef struct RING_BUFFER
+{
+   uint8_t* buf;                    /**< Memory provided by user */
+   uint16_t mask;                   /**< Size - 1 */
+   volatile uint16_t head;          /**< Written by producer only */
+   volatile uint16_t tail;          /**< Written by consumer only */
+   volatile uint32_t overflows;     /**< Number of bytes dropped because of full buffer */
+} RING_BUFFER;
+
+/**
+ * @brief Initialize empty buffer.
+ * @details Has to be called before producer is enabled.
+ * @param[in] rb - buffer to initialize
+ * @param[in] buf - memory for data
+ * @param[in] size - size of memory, power of 2 in range 2-RB_MAX_SIZE
+ * @return RETURN_OK when initialized, RETURN_NOK when size is not valid.
+ */
+RET_CODE rb_init(RING_BUFFER* rb, uint8_t* buf, uint16_t size);
+/**
+ * @brief Get the smallest valid buffer size not less than requested.
+ * @param[in] size - requested size
+ * @return Power of 2 in range 2-RB_MAX_SIZE.
+ */
+uint16_t rb_align_size(uint16_t size);
+/**
+ * @brief Put byte into buffer. Producer side.
+ * @param[in] rb - buffer to write
+ * @param[in] byte - data
+ * @return RETURN_OK when written, RETURN_NOK when buffer is full (overflow counted).
+ */
+RET_CODE rb_push(RING_BUFFER* rb, uint8_t byte);
+/**
+ * @brief Put bytes into buffer. Producer side.
+ * @details Only bytes which fit are written, rest is not counted as overflow.
+ * @param[in] rb - buffer to write
+ * @param[in] data - data to write
+ * @param[in] size - number of bytes
+ * @return Number of written bytes.
+ */
+uint16_t rb_push_n(RING_BUFFER* rb, const uint8_t* data, uint16_t size);
+/**
+ * @brief Get contiguous free space at write position. Producer side.
+ * @details Data written there becomes visible to consumer after rb_commit().
+ * @param[in] rb - buffer to check
+ * @param[out] data - write position
+ * @return Number of bytes which can be written.
+ */
+uint16_t rb_get_write_view(RING_BUFFER* rb, uint8_t** data);
+/**
+ * @brief Publish bytes written directly to write view. Producer side.
+ * @param[in] rb - buffer to modify
+ * @param[in] size - number of bytes, not more than returned by rb_get_write_view()
+ * @return None.
+ */
+void rb_commit(RING_BUFFER* rb, uint16_t size);
+/**
+ * @brief Take the oldest byte from buffer. Consumer side.
+ * @param[in] rb - buffer to read
+ * @param[out] byte - place for data
+ * @return RETURN_OK when read, RETURN_NOK when buffer is empty.
+ */
+RET_CODE rb_pop(RING_BUFFER* rb, uint8_t* byte);
+/**
+ * @brief Take the oldest bytes from buffer. Consumer side.
+ * @param[in] rb - buffer to read
+ * @param[out] data - place for data
+ * @param[in] size - maximum number of bytes
+ * @return Number of read bytes.
+ */
+uint16_t rb_pop_n(RING_BUFFER* rb, uint8_t* data, uint16_t size);
+/**
+ * @brief Read byte without removing it. Consumer side.
+ * @param[in] rb - buffer to read
+ * @param[in] offset - position counted from the oldest byte
+ * @param[out] byte - place for data
+ * @return RETURN_OK when read, RETURN_NOK when there is no byte at offset.
+ */
+RET_CODE rb_peek(const RING_BUFFER* rb, uint16_t offset, uint8_t* byte);
+/**
+ * @brief Get contiguous data at read position. Consumer side.
+ * @details Data is removed from buffer with rb_consume(). When data wraps, second
+ * part is available after the first one is consumed.
+ * @param[in] rb - buffer to check
+ * @param[out] data - read position
+ * @return Number of bytes which can be read.
+ */
+uint16_t rb_get_read_view(const RING_BUFFER* rb, const uint8_t** data);
+/**
+ * @brief Remove bytes from buffer. Consumer side.
+ * @param[in] rb - buffer to modify
+ * @param[in] size - number of bytes, not more than rb_get_count()
+ * @return None.
+ */
+void rb_consume(RING_BUFFER* rb, uint16_t size);
+/**
+ * @brief Drop all pending bytes. Consumer side.
+ * @param[in] rb - buffer to flush
+ * @return None.
+ */
+void rb_flush(RING_BUFFER* rb);
+/**
+ * @brief Get number of pending bytes.
+ * @param[in] rb - buffer to check
+ * @return Number of bytes.
+ */
+uint16_t rb_get_count(const RING_BUFFER* rb);
+/**
+ * @brief Get number of bytes which can be written.
+ * @param[in] rb - buffer to check
+ * @return Number of bytes.
+ */
+uint16_t rb_get_space(const RING_BUFFER* rb);
+/**
+ * @brief Get number of bytes dropped because of full buffer.
+ * @param[in] rb - buffer to check
+ * @return Number of bytes.
+ */
+uint32_t rb_get_overflows(const RING_BUFFER* rb);
+
+#endif
@@ -4,6 +4,7 @@
  *   Includes of common headers
  * =============================*/
 #include <stdarg.h>
+#include <stddef.h>
 
 /* ============================= */
 /**
@@ -11,6 +12,10 @@
  *
  * @brief Set of functions which allows to format strings
  *
+ * @details
+ * Supported conversions: %c, %d, %i, %u, %x, %X, %s and %%, with optional precision (e.g. "%.2u").
+ * Functions with _n suffix never write more than given size of buffer (like snprintf).
+ *
  * @author Jacek Skowronek
  * @date 13/12/2020
  */
@@ -32,6 +37,16 @@ void sf_itoa(char **buf, unsigned int d, int base);
  * @return How many bytes written.
  */
 int sf_format_string(char *buf, const char *fmt, va_list va);
+/**
+ * @brief Format string according to provided format, output limited to size of buffer.
+ * @param[out] buf - Place to store prepared string
+ * @param[in] size - Size of buffer, including NULL terminator
+ * @param[in] fmt - Desired format
+ * @param[in] va - list of arguments
+ * @return How many bytes written (without NULL terminator). String is truncated when it does not fit,
+ *         so unlike snprintf the result is never bigger than size - 1.
+ */
+int sf_format_string_n(char* buf, size_t size, const char* fmt, va_list va);
 /**
  * @brief Check length of formatted string.
  * @param[in] fmt - Desired format
@@ -47,6 +62,15 @@ int sf_format_string(char *buf, const char *fmt, va_list va);
  * @return Length of formatted string.
  */
 int string_format (char* buffer, const char *fmt, ...);
+/**
+ * @brief Format string with variable arguments, output limited to size of buffer.
+ * @param[out] buf - Place to store prepared string
+ * @param[in] size - Size of buffer, including NULL terminator
+ * @param[in] fmt - Desired format
+ * @param[in] ... - arguments
+ * @return Length of formatted string, see sf_format_string_n().
+ */
+int string_format_n(char* buffer, size_t size, const char* fmt, ...);
 
 
 #endif
@@ -0,0 +1,173 @@
+/* =============================
+ *   Includes of common headers
+ * =============================*/
+#include <stdlib.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "event_queue.h"
+/* =============================
+ *          Defines
+ * =============================*/
+#define EVQ_MASK (EVQ_DEPTH - 1)
+/**
+ * Event has to be visible in memory before index is published (and read before
+ * the slot is released). On Cortex-M4 this is DMB, on host full barrier.
+ */
+#define EVQ_BARRIER() __sync_synchronize()
+/* =============================
+ *      Module variables
+ * =============================*/
+EVQ* EVQ_REGISTERED[EVQ_MAX_QUEUES];
+
+
+void evq_init(EVQ* queue)
+{
+   if (queue)
+   {
+      queue->head = 0;
+      queue->tail = 0;
+      queue->overflows = 0;
+      queue->high_water = 0;
+   }
+}
+
+RET_CODE evq_push(EVQ* queue, EVQ_HANDLER handler, uint32_t arg)
+{
+   RET_CODE result = RETURN_NOK;
+   uint16_t head = queue->head;
+   if ((uint16_t)(head - queue->tail) < EVQ_DEPTH)
+   {
+      queue->events[head & EVQ_MASK].handler = handler;
+      queue->events[head & EVQ_MASK].arg = arg;
+      EVQ_BARRIER();
+      queue->head = head + 1;
+      result = RETURN_OK;
+   }
+   else
+   {
+      /* only producer writes this counter */
+      queue->overflows++;
+   }
+   return result;
+}
+
+RET_CODE evq_pop(EVQ* queue, EVQ_EVENT* event)
+{
+   RET_CODE result = RETURN_NOK;
+   uint16_t tail = queue->tail;
+   uint16_t pending = queue->head - tail;
+   if (pending > 0)
+   {
+      if (pending > queue->high_water)
+      {
+         queue->high_water = pending;
+      }
+      EVQ_BARRIER();
+      *event = queue->events[tail & EVQ_MASK];
+      EVQ_BARRIER();
+      queue->tail = tail + 1;
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+void evq_flush(EVQ* queue)
+{
+   queue->tail = queue->head;
+}
+
+uint16_t evq_dispatch(EVQ* queue)
+{
+   uint16_t result = 0;
+   EVQ_EVENT event;
+   while (evq_pop(queue, &event) == RETURN_OK)
+   {
+      if (event.handler)
+      {
+         event.handler(event.arg);
+      }
+      result++;
+   }
+   return result;
+}
+
+uint16_t evq_get_count(const EVQ* queue)
+{
+   return queue->head - queue->tail;
+}
+
+uint32_t evq_get_overflows(const EVQ* queue)
+{
+   return queue->overflows;
+}
+
+uint16_t evq_get_high_water(const EVQ* queue)
+{
+   return queue->high_water;
+}
+
+RET_CODE evq_register(EVQ* queue)
+{
+   RET_CODE result = RETURN_NOK;
+   if (queue)
+   {
+      for (uint8_t i = 0; i < EVQ_MAX_QUEUES; i++)
+      {
+         if (EVQ_REGISTERED[i] == queue)
+         {
+            return RETURN_OK;
+         }
+      }
+      for (uint8_t i = 0; i < EVQ_MAX_QUEUES; i++)
+      {
+         if (EVQ_REGISTERED[i] == NULL)
+         {
+            EVQ_REGISTERED[i] = queue;
+            result = RETURN_OK;
+            break;
+         }
+      }
+   }
+   return result;
+}
+
+RET_CODE evq_unregister(EVQ* queue)
+{
+   RET_CODE result = RETURN_NOK;
+   for (uint8_t i = 0; i < EVQ_MAX_QUEUES; i++)
+   {
+      if (queue && EVQ_REGISTERED[i] == queue)
+      {
+         EVQ_REGISTERED[i] = NULL;
+         result = RETURN_OK;
+      }
+   }
+   return result;
+}
+
+uint16_t evq_dispatch_all()
+{
+   uint16_t result = 0;
+   for (uint8_t i = 0; i < EVQ_MAX_QUEUES; i++)
+   {
+      if (EVQ_REGISTERED[i])
+      {
+         result += evq_dispatch(EVQ_REGISTERED[i]);
+      }
+   }
+   return result;
+}
+
+uint32_t evq_get_total_overflows()
+{
+   uint32_t result = 0;
+   for (uint8_t i = 0; i < EVQ_MAX_QUEUES; i++)
+   {
+      if (EVQ_REGISTERED[i])
+      {
+         result += EVQ_REGISTERED[i]->overflows;
+      }
+   }
+   return result;
+}
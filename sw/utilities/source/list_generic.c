@@ -1,7 +1,14 @@
 #include "list_generic.h"
+#include "core_cmFunc.h"
 
 #include <stdlib.h>
 
+uint32_t ilist_lock(const I_LIST* list);
+void ilist_unlock(const I_LIST* list, uint32_t primask);
+void ilist_link_back(I_LIST* list, LIST_NODE* node);
+void ilist_link_front(I_LIST* list, LIST_NODE* node);
+void ilist_unlink(I_LIST* list, LIST_NODE* node);
+
 
 const uint8_t DEFAULT_LIST_SIZE = 20;
 
@@ -13,6 +20,7 @@ L_LIST* list_init()
 	if (list)
 	{
 		list->head = NULL;
+		list->tail = NULL;
 		list->size = 0;
 	}
 	return list;
@@ -22,14 +30,12 @@ void list_deinit(L_LIST* list)
 {
 	if (!list) return;
 	LIST_ITEM* item = list->head;
-	if (list->size > 0)
+	while (item)
 	{
-		while(item->next != NULL)
-		{
-			free(item->data);
-			item = item->next;
-			free (item->prev);
-		}
+		LIST_ITEM* next = item->next;
+		free(item->data);
+		free(item);
+		item = next;
 	}
 
 	free(list);
@@ -45,21 +51,17 @@ RET_CODE list_add(L_LIST* list, void* data)
 		{
 			item->data = data;
 			item->next = NULL;
+			item->prev = list->tail;
 
-			LIST_ITEM* last_element = list->head;
-			if (!last_element)
+			if (!list->tail)
 			{
 				list->head = item;
 			}
 			else
 			{
-				while (last_element->next != NULL)
-				{
-					last_element = last_element->next;
-				}
-				last_element->next = item;
-				item->prev = last_element;
+				list->tail->next = item;
 			}
+			list->tail = item;
 			list->size++;
 			result = RETURN_OK;
 		}
@@ -81,6 +83,10 @@ RET_CODE list_remove(L_LIST* list, void* data)
 				{
 					list->head = list->head->next;
 				}
+				if (last_element == list->tail)
+				{
+					list->tail = list->tail->prev;
+				}
 				if (last_element->prev) last_element->prev->next = last_element->next;
 				if (last_element->next) last_element->next->prev = last_element->prev;
 
@@ -90,6 +96,7 @@ RET_CODE list_remove(L_LIST* list, void* data)
 				if (list->size == 0)
 				{
 					list->head = NULL;
+					list->tail = NULL;
 				}
 				break;
 			}
@@ -108,3 +115,207 @@ uint8_t list_get_size(L_LIST* list)
 	return list->size;
 }
 
+
+uint32_t ilist_lock(const I_LIST* list)
+{
+	uint32_t primask = __get_PRIMASK();
+	if (list->flags & ILIST_ISR_SAFE)
+	{
+		__disable_irq();
+	}
+	return primask;
+}
+
+void ilist_unlock(const I_LIST* list, uint32_t primask)
+{
+	if (list->flags & ILIST_ISR_SAFE)
+	{
+		__set_PRIMASK(primask);
+	}
+}
+
+void ilist_link_back(I_LIST* list, LIST_NODE* node)
+{
+	node->next = NULL;
+	node->prev = list->tail;
+	if (list->tail)
+	{
+		list->tail->next = node;
+	}
+	else
+	{
+		list->head = node;
+	}
+	list->tail = node;
+	list->size++;
+}
+
+void ilist_link_front(I_LIST* list, LIST_NODE* node)
+{
+	node->prev = NULL;
+	node->next = list->head;
+	if (list->head)
+	{
+		list->head->prev = node;
+	}
+	else
+	{
+		list->tail = node;
+	}
+	list->head = node;
+	list->size++;
+}
+
+void ilist_unlink(I_LIST* list, LIST_NODE* node)
+{
+	if (node->prev)
+	{
+		node->prev->next = node->next;
+	}
+	else
+	{
+		list->head = node->next;
+	}
+	if (node->next)
+	{
+		node->next->prev = node->prev;
+	}
+	else
+	{
+		list->tail = node->prev;
+	}
+	node->next = NULL;
+	node->prev = NULL;
+	list->size--;
+}
+
+void ilist_init(I_LIST* list, uint16_t capacity, uint8_t flags)
+{
+	list->head = NULL;
+	list->tail = NULL;
+	list->size = 0;
+	list->capacity = capacity;
+	list->flags = flags;
+}
+
+RET_CODE ilist_push_back(I_LIST* list, LIST_NODE* node)
+{
+	RET_CODE result = RETURN_NOK;
+	uint32_t primask = ilist_lock(list);
+	if (!list->capacity || list->size < list->capacity)
+	{
+		ilist_link_back(list, node);
+		result = RETURN_OK;
+	}
+	ilist_unlock(list, primask);
+	return result;
+}
+
+RET_CODE ilist_push_front(I_LIST* list, LIST_NODE* node)
+{
+	RET_CODE result = RETURN_NOK;
+	uint32_t primask = ilist_lock(list);
+	if (!list->capacity || list->size < list->capacity)
+	{
+		ilist_link_front(list, node);
+		result = RETURN_OK;
+	}
+	ilist_unlock(list, primask);
+	return result;
+}
+
+RET_CODE ilist_remove(I_LIST* list, LIST_NODE* node)
+{
+	RET_CODE result = RETURN_NOK;
+	uint32_t primask = ilist_lock(list);
+	if (list->size > 0)
+	{
+		ilist_unlink(list, node);
+		result = RETURN_OK;
+	}
+	ilist_unlock(list, primask);
+	return result;
+}
+
+LIST_NODE* ilist_pop_front(I_LIST* list)
+{
+	uint32_t primask = ilist_lock(list);
+	LIST_NODE* node = list->head;
+	if (node)
+	{
+		ilist_unlink(list, node);
+	}
+	ilist_unlock(list, primask);
+	return node;
+}
+
+uint16_t ilist_get_size(const I_LIST* list)
+{
+	return list->size;
+}
+
+void list_pool_init(LIST_POOL* pool, LIST_POOL_ITEM* items, uint16_t count, uint8_t flags)
+{
+	ilist_init(&pool->free, count, flags);
+	for (uint16_t i = 0; i < count; i++)
+	{
+		items[i].data = NULL;
+		ilist_link_back(&pool->free, &items[i].node);
+	}
+}
+
+RET_CODE list_pool_add(LIST_POOL* pool, I_LIST* list, void* data)
+{
+	RET_CODE result = RETURN_NOK;
+	LIST_POOL_ITEM* item = (LIST_POOL_ITEM*) ilist_pop_front(&pool->free);
+	if (item)
+	{
+		item->data = data;
+		result = ilist_push_back(list, &item->node);
+		if (result != RETURN_OK)
+		{
+			ilist_push_back(&pool->free, &item->node);
+		}
+	}
+	return result;
+}
+
+RET_CODE list_pool_remove(LIST_POOL* pool, I_LIST* list, void* data)
+{
+	LIST_NODE* found = NULL;
+	LIST_NODE* node;
+	uint32_t primask = ilist_lock(list);
+	ILIST_FOR_EACH(list, node)
+	{
+		if (LIST_POOL_DATA(node) == data)
+		{
+			ilist_unlink(list, node);
+			found = node;
+			break;
+		}
+	}
+	ilist_unlock(list, primask);
+
+	if (!found)
+	{
+		return RETURN_NOK;
+	}
+	return ilist_push_back(&pool->free, found);
+}
+
+void* list_pool_pop(LIST_POOL* pool, I_LIST* list)
+{
+	void* data = NULL;
+	LIST_NODE* node = ilist_pop_front(list);
+	if (node)
+	{
+		data = LIST_POOL_DATA(node);
+		ilist_push_back(&pool->free, node);
+	}
+	return data;
+}
+
+uint16_t list_pool_get_free(const LIST_POOL* pool)
+{
+	return ilist_get_size(&pool->free);
+}
@@ -0,0 +1,183 @@
+/* =============================
+ *   Includes of common headers
+ * =============================*/
+#include <string.h>
+/* =============================
+ *  Includes of project headers
+ * =============================*/
+#include "ring_buffer.h"
+/* =============================
+ *          Defines
+ * =============================*/
+/**
+ * Data has to be visible in memory before index is published (and read before
+ * the space is released). On Cortex-M4 this is DMB, on host full barrier.
+ */
+#define RB_BARRIER() __sync_synchronize()
+
+
+RET_CODE rb_init(RING_BUFFER* rb, uint8_t* buf, uint16_t size)
+{
+   RET_CODE result = RETURN_NOK;
+   if (rb && buf && size >= 2 && size <= RB_MAX_SIZE && !(size & (size - 1)))
+   {
+      rb->buf = buf;
+      rb->mask = size - 1;
+      rb->head = 0;
+      rb->tail = 0;
+      rb->overflows = 0;
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+uint16_t rb_align_size(uint16_t size)
+{
+   uint16_t result = 2;
+   while (result < size && result < RB_MAX_SIZE)
+   {
+      result <<= 1;
+   }
+   return result;
+}
+
+RET_CODE rb_push(RING_BUFFER* rb, uint8_t byte)
+{
+   RET_CODE result = RETURN_NOK;
+   uint16_t head = rb->head;
+   if ((uint16_t)(head - rb->tail) <= rb->mask)
+   {
+      rb->buf[head & rb->mask] = byte;
+      RB_BARRIER();
+      rb->head = head + 1;
+      result = RETURN_OK;
+   }
+   else
+   {
+      /* only producer writes this counter */
+      rb->overflows++;
+   }
+   return result;
+}
+
+uint16_t rb_push_n(RING_BUFFER* rb, const uint8_t* data, uint16_t size)
+{
+   uint16_t head = rb->head;
+   uint16_t space = rb->mask + 1 - (uint16_t)(head - rb->tail);
+   if (size > space)
+   {
+      size = space;
+   }
+   uint16_t pos = head & rb->mask;
+   uint16_t first = rb->mask + 1 - pos;
+   if (first > size)
+   {
+      first = size;
+   }
+   memcpy(rb->buf + pos, data, first);
+   memcpy(rb->buf, data + first, size - first);
+   RB_BARRIER();
+   rb->head = head + size;
+   return size;
+}
+
+uint16_t rb_get_write_view(RING_BUFFER* rb, uint8_t** data)
+{
+   uint16_t pos = rb->head & rb->mask;
+   uint16_t space = rb_get_space(rb);
+   uint16_t contiguous = rb->mask + 1 - pos;
+   *data = rb->buf + pos;
+   return space < contiguous? space : contiguous;
+}
+
+void rb_commit(RING_BUFFER* rb, uint16_t size)
+{
+   RB_BARRIER();
+   rb->head = rb->head + size;
+}
+
+RET_CODE rb_pop(RING_BUFFER* rb, uint8_t* byte)
+{
+   RET_CODE result = RETURN_NOK;
+   uint16_t tail = rb->tail;
+   if (rb->head != tail)
+   {
+      RB_BARRIER();
+      *byte = rb->buf[tail & rb->mask];
+      RB_BARRIER();
+      rb->tail = tail + 1;
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+uint16_t rb_pop_n(RING_BUFFER* rb, uint8_t* data, uint16_t size)
+{
+   uint16_t tail = rb->tail;
+   uint16_t count = rb->head - tail;
+   if (size > count)
+   {
+      size = count;
+   }
+   uint16_t pos = tail & rb->mask;
+   uint16_t first = rb->mask + 1 - pos;
+   if (first > size)
+   {
+      first = size;
+   }
+   RB_BARRIER();
+   memcpy(data, rb->buf + pos, first);
+   memcpy(data + first, rb->buf, size - first);
+   RB_BARRIER();
+   rb->tail = tail + size;
+   return size;
+}
+
+RET_CODE rb_peek(const RING_BUFFER* rb, uint16_t offset, uint8_t* byte)
+{
+   RET_CODE result = RETURN_NOK;
+   uint16_t tail = rb->tail;
+   if ((uint16_t)(rb->head - tail) > offset)
+   {
+      RB_BARRIER();
+      *byte = rb->buf[(uint16_t)(tail + offset) & rb->mask];
+      result = RETURN_OK;
+   }
+   return result;
+}
+
+uint16_t rb_get_read_view(const RING_BUFFER* rb, const uint8_t** data)
+{
+   uint16_t pos = rb->tail & rb->mask;
+   uint16_t count = rb_get_count(rb);
+   uint16_t contiguous = rb->mask + 1 - pos;
+   RB_BARRIER();
+   *data = rb->buf + pos;
+   return count < contiguous? count : contiguous;
+}
+
+void rb_consume(RING_BUFFER* rb, uint16_t size)
+{
+   RB_BARRIER();
+   rb->tail = rb->tail + size;
+}
+
+void rb_flush(RING_BUFFER* rb)
+{
+   rb->tail = rb->head;
+}
+
+uint16_t rb_get_count(const RING_BUFFER* rb)
+{
+   return rb->head - rb->tail;
+}
+
+uint16_t rb_get_space(const RING_BUFFER* rb)
+{
+   return rb->mask + 1 - (uint16_t)(rb->head - rb->tail);
+}
+
+uint32_t rb_get_overflows(const RING_BUFFER* rb)
+{
+   return rb->overflows;
+}
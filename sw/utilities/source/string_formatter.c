@@ -1,24 +1,45 @@
+/* =============================
+ *   Includes of common headers
+ * =============================*/
+#include <stdint.h>
 /* =============================
  *  Includes of project headers
  * =============================*/
 #include "string_formatter.h"
+/* =============================
+ *          Defines
+ * =============================*/
+/* the longest number - 32-bit value in base 2 */
+#define SF_NUMBER_MAX 32
+/* no bound for sf_format_string() and string_format() */
+#define SF_UNBOUNDED ((size_t)-1)
+/* =============================
+ *   Internal module functions
+ * =============================*/
+int sf_atoi(const char *string);
+int sf_format(char* buf, size_t max_length, const char* fmt, va_list va);
+char* sf_utoa(char* end, unsigned int d, unsigned int base);
+void sf_put_number(char* buf, size_t* length, size_t max_length, unsigned int value, unsigned int base, unsigned int precision, char sign);
+/* =============================
+ *      Module variables
+ * =============================*/
+/* two digits are converted at once, so there is only one division per two digits */
+const char SF_DIGIT_PAIRS[] = "0001020304050607080910111213141516171819"
+                              "2021222324252627282930313233343536373839"
+                              "4041424344454647484950515253545556575859"
+                              "6061626364656667686970717273747576777879"
+                              "8081828384858687888990919293949596979899";
+const char SF_DIGITS[] = "0123456789ABCDEF";
 
 
 void sf_itoa(char **buf, unsigned int d, int base)
 {
-	int div = 1;
-	while (d/div >= base)
-		div *= base;
-
-	while (div != 0)
+	char number[SF_NUMBER_MAX];
+	char* end = number + SF_NUMBER_MAX;
+	char* digit = sf_utoa(end, d, base);
+	while (digit != end)
 	{
-		int num = d/div;
-		d = d%div;
-		div /= base;
-		if (num > 9)
-			*((*buf)++) = (num-10) + 'A';
-		else
-			*((*buf)++) = num + '0';
+		*((*buf)++) = *digit++;
 	}
 }
 
@@ -41,102 +62,161 @@ int sf_atoi(const char *string)
     return (sign < 0) ? (-res) : res;
 }
 
-int sf_count_number(int n)
+char* sf_utoa(char* end, unsigned int d, unsigned int base)
 {
-	int count = 0;
-	if (n == 0)
+	/* digits are written backwards, from the end of buffer */
+	if (base == 10)
+	{
+		while (d >= 100)
+		{
+			unsigned int pair = (d % 100) * 2;
+			d /= 100;
+			*--end = SF_DIGIT_PAIRS[pair + 1];
+			*--end = SF_DIGIT_PAIRS[pair];
+		}
+		if (d >= 10)
+		{
+			*--end = SF_DIGIT_PAIRS[d * 2 + 1];
+			*--end = SF_DIGIT_PAIRS[d * 2];
+		}
+		else
+		{
+			*--end = '0' + d;
+		}
+	}
+	else if (base == 16)
 	{
-		count = 1;
+		do
+		{
+			*--end = SF_DIGITS[d & 0x0F];
+			d >>= 4;
+		} while (d);
 	}
 	else
 	{
-		while (n != 0)
+		do
+		{
+			*--end = SF_DIGITS[d % base];
+			d /= base;
+		} while (d);
+	}
+	return end;
+}
+
+void sf_put_number(char* buf, size_t* length, size_t max_length, unsigned int value, unsigned int base, unsigned int precision, char sign)
+{
+	size_t pos = *length;
+	if (!sign && base == 10 && value < 100 && precision <= 2 && max_length - pos >= 2)
+	{
+		/* fast path for bytes, e.g. "%.2u" used for every byte of notification */
+		if (value >= 10 || precision == 2)
 		{
-			count++;
-			n /= 10;
+			buf[pos++] = SF_DIGIT_PAIRS[value * 2];
 		}
+		buf[pos++] = SF_DIGIT_PAIRS[value * 2 + 1];
+		*length = pos;
+		return;
+	}
+
+	char number[SF_NUMBER_MAX];
+	char* end = number + SF_NUMBER_MAX;
+	char* digit = sf_utoa(end, value, base);
+	unsigned int digits = end - digit;
+	if (sign && pos < max_length)
+	{
+		buf[pos++] = sign;
+	}
+	while (precision > digits && pos < max_length)
+	{
+		buf[pos++] = '0';
+		precision--;
+	}
+	while (digit != end && pos < max_length)
+	{
+		buf[pos++] = *digit++;
 	}
-    return count;
+	*length = pos;
 }
 
-int sf_format_string(char *buf, const char *fmt, va_list va)
+int sf_format(char* buf, size_t max_length, const char* fmt, va_list va)
 {
-	char *start_buf = buf;
-	unsigned int precision = 0;
-	while(*fmt)
+	size_t length = 0;
+	while (*fmt && length < max_length)
 	{
 		/* Character needs formating? */
-		if (*fmt == '%')
+		if (*fmt != '%')
+		{
+			buf[length++] = *fmt++;
+			continue;
+		}
+		++fmt;
+		unsigned int precision = 0;
+		if (*fmt == '.')
 		{
-		    ++fmt;
-		    if (*(fmt) == '.')
-		    {
-		        ++fmt;
-		        //means that precision requested
-		        precision = sf_atoi(fmt);
-		        fmt++;
-		    }
-		    switch (*(fmt))
+			/* means that precision requested */
+			++fmt;
+			precision = sf_atoi(fmt);
+			while (*fmt >= '0' && *fmt <= '9')
 			{
-			  case 'c':
-				*buf++ = va_arg(va, int);
-				break;
-			  case 'd':
-			  case 'i':
-				{
-					signed int val = va_arg(va, signed int);
-					while (precision > (unsigned int)sf_count_number(val))
-					{
-					    *buf++ = '0';
-					    precision--;
-					}
-					if (val < 0)
-					{
-						val *= -1;
-						*buf++ = '-';
-					}
-					sf_itoa(&buf, val, 10);
-				}
-				break;
-			  case 's':
-				{
-					char * arg = va_arg(va, char *);
-					while (*arg)
-					{
-						*buf++ = *arg++;
-					}
-				}
-				break;
-			  case 'u':
-			  {
-			        unsigned int val = va_arg(va, unsigned int);
-			        while (precision > (unsigned int)sf_count_number(val))
-					{
-					    *buf++ = '0';
-					    precision--;
-					}
-					sf_itoa(&buf, val, 10);
-			  }
-				break;
-			  case 'x':
-			  case 'X':
-					sf_itoa(&buf, va_arg(va, int), 16);
-				break;
-			  case '%':
-				  *buf++ = '%';
-				  break;
+				fmt++;
 			}
-			fmt++;
 		}
-		/* Else just copy */
-		else
+		switch (*fmt)
 		{
-			*buf++ = *fmt++;
+		case 'c':
+			buf[length++] = va_arg(va, int);
+			break;
+		case 'd':
+		case 'i':
+			{
+				signed int val = va_arg(va, signed int);
+				/* negation in unsigned type, so INT_MIN is handled too */
+				unsigned int abs = val < 0? 0U - (unsigned int)val : (unsigned int)val;
+				sf_put_number(buf, &length, max_length, abs, 10, precision, val < 0? '-' : 0);
+			}
+			break;
+		case 'u':
+			sf_put_number(buf, &length, max_length, va_arg(va, unsigned int), 10, precision, 0);
+			break;
+		case 'x':
+		case 'X':
+			sf_put_number(buf, &length, max_length, va_arg(va, unsigned int), 16, precision, 0);
+			break;
+		case 's':
+			{
+				const char* arg = va_arg(va, const char*);
+				while (*arg && length < max_length)
+				{
+					buf[length++] = *arg++;
+				}
+			}
+			break;
+		case '%':
+			buf[length++] = '%';
+			break;
+		case 0x00:
+			/* format ends with '%' */
+			continue;
 		}
+		fmt++;
 	}
-	*buf = 0;
+	buf[length] = 0x00;
+
+	return (int)length;
+}
+
+int sf_format_string(char *buf, const char *fmt, va_list va)
+{
+	return sf_format(buf, SF_UNBOUNDED, fmt, va);
+}
 
-	return (int)(buf - start_buf);
+int sf_format_string_n(char* buf, size_t size, const char* fmt, va_list va)
+{
+	if (!size)
+	{
+		return 0;
+	}
+	return sf_format(buf, size - 1, fmt, va);
 }
 
 int string_format (char* buffer, const char *fmt, ...)
@@ -148,3 +228,13 @@ int string_format (char* buffer, const char *fmt, ...)
 	va_end(va);
 	return result;
 }
+
+int string_format_n(char* buffer, size_t size, const char* fmt, ...)
+{
+	int result = 0;
+	va_list va;
+	va_start(va, fmt);
+	result = sf_format_string_n(buffer, size, fmt, va);
+	va_end(va);
+	return result;
+}
@@ -0,0 +1,106 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../source/string_formatter.c"
+#ifdef __cplusplus
+}
+#endif
+
+/* ============================= */
+/**
+ * @file string_formatter_bench.cpp
+ *
+ * @brief Host benchmark of String Formatter utility
+ *
+ * @details
+ * Measures string_format() with the formats used by firmware (logger prefix,
+ * notification bytes, AT commands) against snprintf() from C library.
+ * Output of every case is compared with snprintf() before measurement, the
+ * benchmark fails when they differ.
+ * Results are printed as ns per call, run it on idle machine.
+ */
+/* ============================= */
+
+typedef std::chrono::steady_clock bench_clock;
+
+static const uint32_t BENCH_CALLS = 1000000;
+static const size_t BENCH_BUFFER_SIZE = 256;
+
+volatile uint32_t bench_sink;   /**< Keeps results of measured functions from being optimized out */
+volatile int bench_value = 7;   /**< Arguments are not known at compile time */
+
+typedef struct
+{
+   const char* name;
+   int (*sf)(char* buf);
+   int (*libc)(char* buf);
+} BenchCase;
+
+static const BenchCase BENCH_CASES[] = {
+   {"logger prefix",
+    [](char* buf) { return string_format(buf, "[%.2d-%.2d-%d %.2d:%.2d:%.2d:%.3d] - %s - %s:", bench_value, 2, 2020, 11, 12, 13, 400, "DEBUG", "main"); },
+    [](char* buf) { return snprintf(buf, BENCH_BUFFER_SIZE, "[%.2d-%.2d-%d %.2d:%.2d:%.2d:%.3d] - %s - %s:", bench_value, 2, 2020, 11, 12, 13, 400, "DEBUG", "main"); }},
+   {"ntf header",
+    [](char* buf) { return string_format(buf, "%.2u %.2u %.2u ", bench_value, 1, 12); },
+    [](char* buf) { return snprintf(buf, BENCH_BUFFER_SIZE, "%.2u %.2u %.2u ", bench_value, 1, 12); }},
+   {"ntf byte",
+    [](char* buf) { return string_format(buf, "%.2u ", bench_value); },
+    [](char* buf) { return snprintf(buf, BENCH_BUFFER_SIZE, "%.2u ", bench_value); }},
+   {"AT+CIPSEND",
+    [](char* buf) { return string_format(buf, "AT+CIPSEND=%d,%d\r\n", bench_value % 4, 1460); },
+    [](char* buf) { return snprintf(buf, BENCH_BUFFER_SIZE, "AT+CIPSEND=%d,%d\r\n", bench_value % 4, 1460); }},
+   {"AT+CIPSTA_CUR",
+    [](char* buf) { return string_format(buf, "AT+CIPSTA_CUR=\"%d.%d.%d.%d\"\r\n", 192, 168, 1, bench_value); },
+    [](char* buf) { return snprintf(buf, BENCH_BUFFER_SIZE, "AT+CIPSTA_CUR=\"%d.%d.%d.%d\"\r\n", 192, 168, 1, bench_value); }},
+   {"AT+CWJAP_CUR",
+    [](char* buf) { return string_format(buf, "AT+CWJAP_CUR=\"%s\",\"%s\"\r\n", "home_network", "password123"); },
+    [](char* buf) { return snprintf(buf, BENCH_BUFFER_SIZE, "AT+CWJAP_CUR=\"%s\",\"%s\"\r\n", "home_network", "password123"); }},
+   {"cmd reply",
+    [](char* buf) { return string_format(buf, "TASK%d:%X calls:%u max:%uus\n", bench_value, 0x08001234, 123456, 4294967295U); },
+    [](char* buf) { return snprintf(buf, BENCH_BUFFER_SIZE, "TASK%d:%X calls:%u max:%uus\n", bench_value, 0x08001234, 123456, 4294967295U); }},
+};
+
+static double bench_ns_per(bench_clock::time_point start, uint32_t count)
+{
+   return std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / count;
+}
+
+int main()
+{
+   char sf_buf[BENCH_BUFFER_SIZE];
+   char libc_buf[BENCH_BUFFER_SIZE];
+   int result = 0;
+   printf("String formatter benchmark, %u calls per case\n", BENCH_CALLS);
+   printf("%-16s %10s %10s %8s\n", "case", "ns/sf", "ns/libc", "ratio");
+   for (const BenchCase& item : BENCH_CASES)
+   {
+      int sf_length = item.sf(sf_buf);
+      int libc_length = item.libc(libc_buf);
+      if (sf_length != libc_length || strcmp(sf_buf, libc_buf))
+      {
+         printf("%-16s MISMATCH: \"%s\" (%d) != \"%s\" (%d)\n", item.name, sf_buf, sf_length, libc_buf, libc_length);
+         result = 1;
+         continue;
+      }
+
+      bench_clock::time_point start = bench_clock::now();
+      for (uint32_t i = 0; i < BENCH_CALLS; i++)
+      {
+         bench_sink = item.sf(sf_buf);
+      }
+      double sf_ns = bench_ns_per(start, BENCH_CALLS);
+
+      start = bench_clock::now();
+      for (uint32_t i = 0; i < BENCH_CALLS; i++)
+      {
+         bench_sink = item.libc(libc_buf);
+      }
+      double libc_ns = bench_ns_per(start, BENCH_CALLS);
+
+      printf("%-16s %10.1f %10.1f %8.2f\n", item.name, sf_ns, libc_ns, sf_ns / libc_ns);
+   }
+   return result;
+}
@@ -0,0 +1,220 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../source/event_queue.c"
+#ifdef __cplusplus
+}
+#endif
+
+/* ============================= */
+/**
+ * @file event_queue_tests.cpp
+ *
+ * @brief Unit tests of Event Queue utility
+ *
+ * @details
+ * This tests verifies behavior of Event Queue utility
+ */
+/* ============================= */
+
+
+using namespace ::testing;
+
+struct handlerMock
+{
+   MOCK_METHOD1(handler1, void(uint32_t));
+   MOCK_METHOD1(handler2, void(uint32_t));
+};
+handlerMock* handler_mock;
+void fake_handler1(uint32_t arg)
+{
+   handler_mock->handler1(arg);
+}
+void fake_handler2(uint32_t arg)
+{
+   handler_mock->handler2(arg);
+}
+
+struct eventQueueFixture : public ::testing::Test
+{
+   virtual void SetUp()
+   {
+      handler_mock = new handlerMock;
+      evq_init(&queue);
+      evq_init(&queue2);
+      for (uint8_t i = 0; i < EVQ_MAX_QUEUES; i++)
+      {
+         EVQ_REGISTERED[i] = NULL;
+      }
+   }
+
+   virtual void TearDown()
+   {
+      delete handler_mock;
+   }
+   EVQ queue;
+   EVQ queue2;
+};
+
+/**
+ * @test Pushing and popping events in FIFO order
+ */
+TEST_F(eventQueueFixture, push_pop)
+{
+   EVQ_EVENT event;
+   /**
+    * <b>scenario</b>: Empty queue read.
+    * <b>expected</b>: Nothing read.
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_NOK, evq_pop(&queue, &event));
+   EXPECT_EQ(0, evq_get_count(&queue));
+
+   /**
+    * <b>scenario</b>: Two events written and read.
+    * <b>expected</b>: Events read in the same order.
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, evq_push(&queue, &fake_handler1, 1));
+   EXPECT_EQ(RETURN_OK, evq_push(&queue, &fake_handler2, 2));
+   EXPECT_EQ(2, evq_get_count(&queue));
+
+   EXPECT_EQ(RETURN_OK, evq_pop(&queue, &event));
+   EXPECT_EQ(&fake_handler1, event.handler);
+   EXPECT_EQ(1, event.arg);
+   EXPECT_EQ(RETURN_OK, evq_pop(&queue, &event));
+   EXPECT_EQ(&fake_handler2, event.handler);
+   EXPECT_EQ(2, event.arg);
+   EXPECT_EQ(RETURN_NOK, evq_pop(&queue, &event));
+   EXPECT_EQ(2, evq_get_high_water(&queue));
+}
+
+/**
+ * @test Overflow handling and index wrapping
+ */
+TEST_F(eventQueueFixture, overflow)
+{
+   EVQ_EVENT event;
+   /**
+    * <b>scenario</b>: Queue filled and one more event written.
+    * <b>expected</b>: Last event dropped, overflow counted, previous events untouched.
+    * ************************************************
+    */
+   for (uint16_t i = 0; i < EVQ_DEPTH; i++)
+   {
+      EXPECT_EQ(RETURN_OK, evq_push(&queue, &fake_handler1, i));
+   }
+   EXPECT_EQ(RETURN_NOK, evq_push(&queue, &fake_handler1, 0xFF));
+   EXPECT_EQ(1, evq_get_overflows(&queue));
+   EXPECT_EQ(EVQ_DEPTH, evq_get_count(&queue));
+
+   EXPECT_EQ(RETURN_OK, evq_pop(&queue, &event));
+   EXPECT_EQ(0, event.arg);
+
+   /**
+    * <b>scenario</b>: Slot released, next event written many times, indexes are wrapping.
+    * <b>expected</b>: All events read in order.
+    * ************************************************
+    */
+   for (uint32_t i = 0; i < 70000; i++)
+   {
+      EXPECT_EQ(RETURN_OK, evq_push(&queue, &fake_handler1, EVQ_DEPTH + i));
+      EXPECT_EQ(RETURN_OK, evq_pop(&queue, &event));
+      EXPECT_EQ(i + 1, event.arg);
+   }
+   EXPECT_EQ(EVQ_DEPTH - 1, evq_get_count(&queue));
+   EXPECT_EQ(1, evq_get_overflows(&queue));
+
+   /**
+    * <b>scenario</b>: Queue flushed.
+    * <b>expected</b>: No events, counters unchanged.
+    * ************************************************
+    */
+   evq_flush(&queue);
+   EXPECT_EQ(0, evq_get_count(&queue));
+   EXPECT_EQ(1, evq_get_overflows(&queue));
+   EXPECT_EQ(EVQ_DEPTH, evq_get_high_water(&queue));
+
+   /**
+    * <b>scenario</b>: Queue initialized.
+    * <b>expected</b>: Counters cleared.
+    * ************************************************
+    */
+   evq_init(&queue);
+   EXPECT_EQ(0, evq_get_overflows(&queue));
+   EXPECT_EQ(0, evq_get_high_water(&queue));
+}
+
+/**
+ * @test Dispatching events from single and registered queues
+ */
+TEST_F(eventQueueFixture, dispatching)
+{
+   /**
+    * <b>scenario</b>: Events pending in queue, queue dispatched.
+    * <b>expected</b>: Handlers called in order, queue empty.
+    * ************************************************
+    */
+   {
+      InSequence seq;
+      EXPECT_CALL(*handler_mock, handler1(10));
+      EXPECT_CALL(*handler_mock, handler2(20));
+   }
+   evq_push(&queue, &fake_handler1, 10);
+   evq_push(&queue, NULL, 15);
+   evq_push(&queue, &fake_handler2, 20);
+   EXPECT_EQ(3, evq_dispatch(&queue));
+   EXPECT_EQ(0, evq_get_count(&queue));
+
+   /**
+    * <b>scenario</b>: Two queues registered, events pending in both.
+    * <b>expected</b>: All handlers called by single dispatch.
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, evq_register(&queue));
+   EXPECT_EQ(RETURN_OK, evq_register(&queue2));
+   EXPECT_EQ(RETURN_OK, evq_register(&queue));
+   EXPECT_CALL(*handler_mock, handler1(1));
+   EXPECT_CALL(*handler_mock, handler2(2));
+   evq_push(&queue, &fake_handler1, 1);
+   evq_push(&queue2, &fake_handler2, 2);
+   EXPECT_EQ(2, evq_dispatch_all());
+
+   /**
+    * <b>scenario</b>: Overflows in both queues.
+    * <b>expected</b>: Total overflows summed.
+    * ************************************************
+    */
+   for (uint16_t i = 0; i <= EVQ_DEPTH; i++)
+   {
+      evq_push(&queue, NULL, i);
+      evq_push(&queue2, NULL, i);
+   }
+   EXPECT_EQ(2, evq_get_total_overflows());
+
+   /**
+    * <b>scenario</b>: Queue unregistered.
+    * <b>expected</b>: Queue not drained anymore.
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, evq_unregister(&queue2));
+   EXPECT_EQ(RETURN_NOK, evq_unregister(&queue2));
+   EXPECT_EQ(EVQ_DEPTH, evq_dispatch_all());
+   EXPECT_EQ(EVQ_DEPTH, evq_get_count(&queue2));
+}
+
+/**
+ * @test Registering more queues than allowed
+ */
+TEST_F(eventQueueFixture, register_limit)
+{
+   EVQ queues [EVQ_MAX_QUEUES + 1];
+   for (uint8_t i = 0; i < EVQ_MAX_QUEUES; i++)
+   {
+      EXPECT_EQ(RETURN_OK, evq_register(&queues[i]));
+   }
+   EXPECT_EQ(RETURN_NOK, evq_register(&queues[EVQ_MAX_QUEUES]));
+   EXPECT_EQ(RETURN_NOK, evq_register(NULL));
+}
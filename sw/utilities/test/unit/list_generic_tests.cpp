@@ -1,4 +1,5 @@
 #include "gtest/gtest.h"
+#include <vector>
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -175,3 +176,191 @@ TEST(task_list_tests, two_list_created)
 	EXPECT_EQ(test_subject->size, 4);
 	EXPECT_EQ(test_subject2->size, 4);
 }
+
+/**
+ * @test Releasing list with items
+ */
+TEST(task_list_tests, deinit_list)
+{
+	L_LIST* test_subject = list_init();
+
+	/**
+	 * @<b>scenario<\b>: List with 3 allocated items released.
+	 * @<b>expected<\b>: All items and data released, also the last one.
+	 */
+	EXPECT_EQ(RETURN_OK, list_add(test_subject, malloc(1)));
+	EXPECT_EQ(RETURN_OK, list_add(test_subject, malloc(1)));
+	EXPECT_EQ(RETURN_OK, list_add(test_subject, malloc(1)));
+	EXPECT_EQ(test_subject->tail->prev->prev, test_subject->head);
+	list_deinit(test_subject);
+
+	/**
+	 * @<b>scenario<\b>: Empty list released.
+	 * @<b>expected<\b>: No crash.
+	 */
+	list_deinit(list_init());
+}
+
+struct ilistTestItem
+{
+	uint32_t value;
+	LIST_NODE node;
+};
+
+/**
+ * @test Adding and removing nodes from intrusive list
+ */
+TEST(task_list_tests, intrusive_list)
+{
+	I_LIST test_subject;
+	ilistTestItem items[4] = {{1, {}}, {2, {}}, {3, {}}, {4, {}}};
+	LIST_NODE* node;
+	LIST_NODE* tmp;
+	std::vector<uint32_t> values;
+
+	ilist_init(&test_subject, 0, 0);
+	EXPECT_EQ(0, ilist_get_size(&test_subject));
+	EXPECT_TRUE(ilist_pop_front(&test_subject) == NULL);
+
+	/**
+	 * @<b>scenario<\b>: Nodes added at the end and at the beginning.
+	 * @<b>expected<\b>: Nodes iterated in correct order.
+	 */
+	EXPECT_EQ(RETURN_OK, ilist_push_back(&test_subject, &items[1].node));
+	EXPECT_EQ(RETURN_OK, ilist_push_back(&test_subject, &items[2].node));
+	EXPECT_EQ(RETURN_OK, ilist_push_front(&test_subject, &items[0].node));
+	EXPECT_EQ(RETURN_OK, ilist_push_back(&test_subject, &items[3].node));
+	EXPECT_EQ(4, ilist_get_size(&test_subject));
+	ILIST_FOR_EACH(&test_subject, node)
+	{
+		values.push_back(LIST_CONTAINER_OF(node, ilistTestItem, node)->value);
+	}
+	EXPECT_EQ(std::vector<uint32_t>({1, 2, 3, 4}), values);
+
+	/**
+	 * @<b>scenario<\b>: Middle, last and first node removed.
+	 * @<b>expected<\b>: Head and tail updated.
+	 */
+	EXPECT_EQ(RETURN_OK, ilist_remove(&test_subject, &items[1].node));
+	EXPECT_EQ(RETURN_OK, ilist_remove(&test_subject, &items[3].node));
+	EXPECT_EQ(&items[2].node, test_subject.tail);
+	EXPECT_EQ(RETURN_OK, ilist_remove(&test_subject, &items[0].node));
+	EXPECT_EQ(&items[2].node, test_subject.head);
+	EXPECT_EQ(&items[2].node, test_subject.tail);
+	EXPECT_EQ(1, ilist_get_size(&test_subject));
+
+	/**
+	 * @<b>scenario<\b>: Nodes removed while iterating.
+	 * @<b>expected<\b>: All nodes removed, list empty.
+	 */
+	EXPECT_EQ(RETURN_OK, ilist_push_back(&test_subject, &items[0].node));
+	EXPECT_EQ(RETURN_OK, ilist_push_back(&test_subject, &items[1].node));
+	ILIST_FOR_EACH_SAFE(&test_subject, node, tmp)
+	{
+		EXPECT_EQ(RETURN_OK, ilist_remove(&test_subject, node));
+	}
+	EXPECT_EQ(0, ilist_get_size(&test_subject));
+	EXPECT_TRUE(test_subject.head == NULL);
+	EXPECT_TRUE(test_subject.tail == NULL);
+	EXPECT_EQ(RETURN_NOK, ilist_remove(&test_subject, &items[0].node));
+
+	/**
+	 * @<b>scenario<\b>: Nodes taken from the beginning.
+	 * @<b>expected<\b>: Nodes returned in FIFO order.
+	 */
+	EXPECT_EQ(RETURN_OK, ilist_push_back(&test_subject, &items[3].node));
+	EXPECT_EQ(RETURN_OK, ilist_push_back(&test_subject, &items[2].node));
+	EXPECT_EQ(&items[3].node, ilist_pop_front(&test_subject));
+	EXPECT_EQ(&items[2].node, ilist_pop_front(&test_subject));
+	EXPECT_TRUE(ilist_pop_front(&test_subject) == NULL);
+}
+
+/**
+ * @test Intrusive list with limited capacity
+ */
+TEST(task_list_tests, intrusive_list_capacity)
+{
+	I_LIST test_subject;
+	LIST_NODE nodes[3];
+
+	/**
+	 * @<b>scenario<\b>: ISR safe list with capacity 2, 3 nodes added.
+	 * @<b>expected<\b>: Third node rejected, accepted again when place available.
+	 */
+	ilist_init(&test_subject, 2, ILIST_ISR_SAFE);
+	EXPECT_EQ(RETURN_OK, ilist_push_back(&test_subject, &nodes[0]));
+	EXPECT_EQ(RETURN_OK, ilist_push_back(&test_subject, &nodes[1]));
+	EXPECT_EQ(RETURN_NOK, ilist_push_back(&test_subject, &nodes[2]));
+	EXPECT_EQ(RETURN_NOK, ilist_push_front(&test_subject, &nodes[2]));
+	EXPECT_EQ(2, ilist_get_size(&test_subject));
+
+	EXPECT_EQ(&nodes[0], ilist_pop_front(&test_subject));
+	EXPECT_EQ(RETURN_OK, ilist_push_front(&test_subject, &nodes[2]));
+	EXPECT_EQ(&nodes[2], test_subject.head);
+	EXPECT_EQ(&nodes[1], test_subject.tail);
+}
+
+/**
+ * @test List of pointers with nodes from static pool
+ */
+TEST(task_list_tests, pool_list)
+{
+	LIST_POOL pool;
+	LIST_POOL_ITEM pool_items[3];
+	I_LIST list1;
+	I_LIST list2;
+	uint8_t data[4];
+	LIST_NODE* node;
+	std::vector<void*> values;
+
+	list_pool_init(&pool, pool_items, 3, 0);
+	ilist_init(&list1, 0, 0);
+	ilist_init(&list2, 0, 0);
+	EXPECT_EQ(3, list_pool_get_free(&pool));
+
+	/**
+	 * @<b>scenario<\b>: Pointers added to two lists sharing pool.
+	 * @<b>expected<\b>: Added until pool is empty.
+	 */
+	EXPECT_EQ(RETURN_OK, list_pool_add(&pool, &list1, &data[0]));
+	EXPECT_EQ(RETURN_OK, list_pool_add(&pool, &list2, &data[1]));
+	EXPECT_EQ(RETURN_OK, list_pool_add(&pool, &list1, &data[2]));
+	EXPECT_EQ(RETURN_NOK, list_pool_add(&pool, &list2, &data[3]));
+	EXPECT_EQ(0, list_pool_get_free(&pool));
+	ILIST_FOR_EACH(&list1, node)
+	{
+		values.push_back(LIST_POOL_DATA(node));
+	}
+	EXPECT_EQ(std::vector<void*>({&data[0], &data[2]}), values);
+
+	/**
+	 * @<b>scenario<\b>: Pointer removed from list.
+	 * @<b>expected<\b>: Item returned to pool, unknown pointer not removed.
+	 */
+	EXPECT_EQ(RETURN_OK, list_pool_remove(&pool, &list1, &data[0]));
+	EXPECT_EQ(RETURN_NOK, list_pool_remove(&pool, &list1, &data[0]));
+	EXPECT_EQ(1, list_pool_get_free(&pool));
+	EXPECT_EQ(1, ilist_get_size(&list1));
+
+	/**
+	 * @<b>scenario<\b>: List with limited capacity is full.
+	 * @<b>expected<\b>: Item not lost, still available in pool.
+	 */
+	I_LIST limited;
+	ilist_init(&limited, 1, 0);
+	EXPECT_EQ(RETURN_OK, list_pool_add(&pool, &limited, &data[3]));
+	EXPECT_EQ(&data[1], list_pool_pop(&pool, &list2));
+	EXPECT_EQ(1, list_pool_get_free(&pool));
+	EXPECT_EQ(RETURN_NOK, list_pool_add(&pool, &limited, &data[0]));
+	EXPECT_EQ(1, list_pool_get_free(&pool));
+	EXPECT_EQ(1, ilist_get_size(&limited));
+
+	/**
+	 * @<b>scenario<\b>: Pointers taken from the beginning.
+	 * @<b>expected<\b>: Returned in FIFO order, NULL when empty.
+	 */
+	EXPECT_EQ(&data[2], list_pool_pop(&pool, &list1));
+	EXPECT_TRUE(list_pool_pop(&pool, &list1) == NULL);
+	EXPECT_EQ(&data[3], list_pool_pop(&pool, &limited));
+	EXPECT_EQ(3, list_pool_get_free(&pool));
+}
@@ -0,0 +1,251 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <string>
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../source/ring_buffer.c"
+#ifdef __cplusplus
+}
+#endif
+
+/* ============================= */
+/**
+ * @file ring_buffer_tests.cpp
+ *
+ * @brief Unit tests of Ring Buffer utility
+ *
+ * @details
+ * This tests verifies behavior of Ring Buffer utility
+ */
+/* ============================= */
+
+
+using namespace ::testing;
+
+static const uint16_t TEST_BUFFER_SIZE = 8;
+
+struct ringBufferFixture : public ::testing::Test
+{
+   virtual void SetUp()
+   {
+      memset(memory, 0, sizeof(memory));
+      rb_init(&rb, memory, TEST_BUFFER_SIZE);
+   }
+
+   virtual void TearDown()
+   {
+   }
+
+   std::string pop_all()
+   {
+      char data[TEST_BUFFER_SIZE];
+      uint16_t size = rb_pop_n(&rb, (uint8_t*)data, sizeof(data));
+      return std::string(data, size);
+   }
+
+   uint16_t push_string(const std::string& data)
+   {
+      return rb_push_n(&rb, (const uint8_t*)data.c_str(), data.size());
+   }
+
+   RING_BUFFER rb;
+   uint8_t memory[TEST_BUFFER_SIZE];
+};
+
+/**
+ * @test Buffer initialization
+ */
+TEST_F(ringBufferFixture, init)
+{
+   /**
+    * <b>scenario</b>: Size is not a power of 2, or out of range.
+    * <b>expected</b>: Buffer not initialized.
+    * ************************************************
+    */
+   RING_BUFFER test_rb;
+   EXPECT_EQ(RETURN_NOK, rb_init(&test_rb, memory, 0));
+   EXPECT_EQ(RETURN_NOK, rb_init(&test_rb, memory, 1));
+   EXPECT_EQ(RETURN_NOK, rb_init(&test_rb, memory, 6));
+   EXPECT_EQ(RETURN_NOK, rb_init(&test_rb, memory, 65535));
+   EXPECT_EQ(RETURN_NOK, rb_init(&test_rb, NULL, 8));
+
+   /**
+    * <b>scenario</b>: Valid size.
+    * <b>expected</b>: Buffer empty.
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_OK, rb_init(&test_rb, memory, 4));
+   EXPECT_EQ(0, rb_get_count(&test_rb));
+   EXPECT_EQ(4, rb_get_space(&test_rb));
+
+   /**
+    * <b>scenario</b>: Size aligned to power of 2.
+    * <b>expected</b>: The smallest valid size not less than requested.
+    * ************************************************
+    */
+   EXPECT_EQ(2, rb_align_size(0));
+   EXPECT_EQ(2, rb_align_size(2));
+   EXPECT_EQ(16, rb_align_size(15));
+   EXPECT_EQ(16, rb_align_size(16));
+   EXPECT_EQ(32, rb_align_size(20));
+   EXPECT_EQ(RB_MAX_SIZE, rb_align_size(RB_MAX_SIZE + 1));
+}
+
+/**
+ * @test Single byte write and read, full buffer detection
+ */
+TEST_F(ringBufferFixture, push_pop)
+{
+   uint8_t byte;
+   /**
+    * <b>scenario</b>: Empty buffer read.
+    * <b>expected</b>: Nothing read.
+    * ************************************************
+    */
+   EXPECT_EQ(RETURN_NOK, rb_pop(&rb, &byte));
+
+   /**
+    * <b>scenario</b>: Buffer filled and one more byte written.
+    * <b>expected</b>: Last byte dropped, overflow counted, previous bytes untouched.
+    * ************************************************
+    */
+   for (uint8_t i = 0; i < TEST_BUFFER_SIZE; i++)
+   {
+      EXPECT_EQ(RETURN_OK, rb_push(&rb, i));
+   }
+   EXPECT_EQ(TEST_BUFFER_SIZE, rb_get_count(&rb));
+   EXPECT_EQ(0, rb_get_space(&rb));
+   EXPECT_EQ(RETURN_NOK, rb_push(&rb, 0xFF));
+   EXPECT_EQ(1, rb_get_overflows(&rb));
+
+   for (uint8_t i = 0; i < TEST_BUFFER_SIZE; i++)
+   {
+      EXPECT_EQ(RETURN_OK, rb_pop(&rb, &byte));
+      EXPECT_EQ(i, byte);
+   }
+   EXPECT_EQ(RETURN_NOK, rb_pop(&rb, &byte));
+
+   /**
+    * <b>scenario</b>: 16-bit indexes wrap.
+    * <b>expected</b>: Count and data still correct.
+    * ************************************************
+    */
+   rb.head = 0xFFFE;
+   rb.tail = 0xFFFE;
+   EXPECT_EQ(RETURN_OK, rb_push(&rb, 1));
+   EXPECT_EQ(RETURN_OK, rb_push(&rb, 2));
+   EXPECT_EQ(RETURN_OK, rb_push(&rb, 3));
+   EXPECT_EQ(0x0001, rb.head);
+   EXPECT_EQ(3, rb_get_count(&rb));
+   EXPECT_EQ(TEST_BUFFER_SIZE - 3, rb_get_space(&rb));
+   EXPECT_EQ(RETURN_OK, rb_pop(&rb, &byte));
+   EXPECT_EQ(1, byte);
+   EXPECT_EQ(RETURN_OK, rb_pop(&rb, &byte));
+   EXPECT_EQ(2, byte);
+   EXPECT_EQ(RETURN_OK, rb_pop(&rb, &byte));
+   EXPECT_EQ(3, byte);
+}
+
+/**
+ * @test Bulk write and read
+ */
+TEST_F(ringBufferFixture, push_pop_n)
+{
+   /**
+    * <b>scenario</b>: Data written and read in the middle of buffer.
+    * <b>expected</b>: Data read in the same order.
+    * ************************************************
+    */
+   EXPECT_EQ(5, push_string("abcde"));
+   EXPECT_EQ("abcde", pop_all());
+
+   /**
+    * <b>scenario</b>: Data wraps at the end of buffer.
+    * <b>expected</b>: Data split into two parts, read in the same order.
+    * ************************************************
+    */
+   EXPECT_EQ(6, push_string("fghijk"));
+   EXPECT_EQ('f', memory[5]);
+   EXPECT_EQ('k', memory[2]);
+   EXPECT_EQ("fghijk", pop_all());
+
+   /**
+    * <b>scenario</b>: More data than free space.
+    * <b>expected</b>: Only part which fits written, no overflow counted.
+    * ************************************************
+    */
+   EXPECT_EQ(3, push_string("123"));
+   EXPECT_EQ(5, push_string("4567890"));
+   EXPECT_EQ(0, push_string("x"));
+   EXPECT_EQ(0, rb_get_overflows(&rb));
+
+   /**
+    * <b>scenario</b>: Part of data read.
+    * <b>expected</b>: The oldest bytes read, rest kept.
+    * ************************************************
+    */
+   uint8_t data[3];
+   EXPECT_EQ(3, rb_pop_n(&rb, data, sizeof(data)));
+   EXPECT_EQ(0, memcmp("123", data, sizeof(data)));
+   EXPECT_EQ("45678", pop_all());
+   EXPECT_EQ(0, rb_pop_n(&rb, data, sizeof(data)));
+}
+
+/**
+ * @test Reading data without removing it
+ */
+TEST_F(ringBufferFixture, peek_and_views)
+{
+   uint8_t byte;
+   const uint8_t* read_view;
+   uint8_t* write_view;
+   /**
+    * <b>scenario</b>: Byte peeked at offset.
+    * <b>expected</b>: Byte read, buffer not changed, nothing read after the end.
+    * ************************************************
+    */
+   rb.head = 6;
+   rb.tail = 6;
+   EXPECT_EQ(5, push_string("abcde"));
+   EXPECT_EQ(RETURN_OK, rb_peek(&rb, 0, &byte));
+   EXPECT_EQ('a', byte);
+   EXPECT_EQ(RETURN_OK, rb_peek(&rb, 4, &byte));
+   EXPECT_EQ('e', byte);
+   EXPECT_EQ(RETURN_NOK, rb_peek(&rb, 5, &byte));
+   EXPECT_EQ(5, rb_get_count(&rb));
+
+   /**
+    * <b>scenario</b>: Data read in place when it wraps.
+    * <b>expected</b>: Two contiguous parts returned.
+    * ************************************************
+    */
+   EXPECT_EQ(2, rb_get_read_view(&rb, &read_view));
+   EXPECT_EQ(0, memcmp("ab", read_view, 2));
+   rb_consume(&rb, 2);
+   EXPECT_EQ(3, rb_get_read_view(&rb, &read_view));
+   EXPECT_EQ(0, memcmp("cde", read_view, 3));
+   rb_consume(&rb, 3);
+   EXPECT_EQ(0, rb_get_read_view(&rb, &read_view));
+
+   /**
+    * <b>scenario</b>: Data written in place.
+    * <b>expected</b>: Contiguous space to the end of buffer, data visible after commit.
+    * ************************************************
+    */
+   EXPECT_EQ(5, rb_get_write_view(&rb, &write_view));
+   memcpy(write_view, "xyz", 3);
+   EXPECT_EQ(0, rb_get_count(&rb));
+   rb_commit(&rb, 3);
+   EXPECT_EQ("xyz", pop_all());
+
+   /**
+    * <b>scenario</b>: Buffer flushed.
+    * <b>expected</b>: Pending data dropped.
+    * ************************************************
+    */
+   EXPECT_EQ(4, push_string("1234"));
+   rb_flush(&rb);
+   EXPECT_EQ(0, rb_get_count(&rb));
+   EXPECT_EQ(TEST_BUFFER_SIZE, rb_get_space(&rb));
+}
@@ -1,5 +1,8 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <cstdio>
+#include <climits>
+#include <string>
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -68,3 +71,140 @@ TEST_F(stringFormatterFixture, string_formatting_tests)
    string_format(result, "RESULT: %d %.2d %.3d\n", 0, 0, 0);
    EXPECT_STREQ(result, "RESULT: 0 00 000\n");
 }
+
+/**
+ * @test Integer conversion tests
+ */
+TEST_F(stringFormatterFixture, integer_conversion_tests)
+{
+   char result [50];
+   /**
+    * <b>scenario</b>: Values with odd and even number of digits, limits of types.<br>
+    * <b>expected</b>: String formatted as expected.<br>
+    * ************************************************
+    */
+   string_format(result, "%u %u %u %u %u", 0, 7, 42, 999, 4294967295U);
+   EXPECT_STREQ(result, "0 7 42 999 4294967295");
+   string_format(result, "%d %d %X", -2147483647 - 1, 2147483647, 0xDEADBEEF);
+   EXPECT_STREQ(result, "-2147483648 2147483647 DEADBEEF");
+
+   /**
+    * <b>scenario</b>: Two digits precision used for bytes.<br>
+    * <b>expected</b>: Values padded to two digits, bigger values not truncated.<br>
+    * ************************************************
+    */
+   string_format(result, "%.2u %.2u %.2u %.2u ", 0, 5, 10, 255);
+   EXPECT_STREQ(result, "00 05 10 255 ");
+
+   /**
+    * <b>scenario</b>: Precision followed by specifier without precision, negative value with precision.<br>
+    * <b>expected</b>: Precision applied only to its specifier, sign placed before zeros.<br>
+    * ************************************************
+    */
+   string_format(result, "%.3u %u %.3d %.10u", 12, 5, -5, 1);
+   EXPECT_STREQ(result, "012 5 -005 0000000001");
+}
+
+/**
+ * @test Bounded formatting tests
+ */
+TEST_F(stringFormatterFixture, bounded_formatting_tests)
+{
+   char result [10];
+   /**
+    * <b>scenario</b>: Formatted string fits into buffer.<br>
+    * <b>expected</b>: String formatted, length returned.<br>
+    * ************************************************
+    */
+   EXPECT_EQ(5, string_format_n(result, sizeof(result), "%s:%.2u", "ab", 3));
+   EXPECT_STREQ(result, "ab:03");
+
+   /**
+    * <b>scenario</b>: Formatted string longer than buffer.<br>
+    * <b>expected</b>: String truncated and NULL terminated, bytes after buffer not changed.<br>
+    * ************************************************
+    */
+   memset(result, 'x', sizeof(result));
+   EXPECT_EQ(5, string_format_n(result, 6, "%s %u", "abc", 12345));
+   EXPECT_STREQ(result, "abc 1");
+   EXPECT_EQ('x', result[6]);
+   EXPECT_EQ(4, string_format_n(result, 5, "%u", 4294967295U));
+   EXPECT_STREQ(result, "4294");
+   EXPECT_EQ(1, string_format_n(result, 2, "%.2u", 7));
+   EXPECT_STREQ(result, "0");
+
+   /**
+    * <b>scenario</b>: Buffer of size 1 and 0, format ending with '%'.<br>
+    * <b>expected</b>: Only NULL terminator written, nothing written at all for size 0.<br>
+    * ************************************************
+    */
+   memset(result, 'x', sizeof(result));
+   EXPECT_EQ(0, string_format_n(result, 1, "abc"));
+   EXPECT_EQ(0x00, result[0]);
+   EXPECT_EQ(0, string_format_n(result + 1, 0, "abc"));
+   EXPECT_EQ('x', result[1]);
+   EXPECT_EQ(2, string_format_n(result, sizeof(result), "ab%"));
+   EXPECT_STREQ(result, "ab");
+}
+
+/**
+ * @test Conformance with snprintf
+ */
+TEST_F(stringFormatterFixture, snprintf_conformance_tests)
+{
+   char result [64];
+   char expected [64];
+   const unsigned int VALUES[] = {0, 1, 9, 10, 99, 100, 101, 999, 1000, 65535, 99999, 100000, 1234567,
+                                  99999999, 100000000, 2147483647, 2147483648U, 4000000000U, UINT_MAX};
+   /* string formatter prints hex digits always uppercase */
+   const char* SPECS[][2] = {{"%u", "%u"}, {"%d", "%d"}, {"%i", "%i"}, {"%x", "%X"}, {"%X", "%X"}};
+   const char* PRECISIONS[] = {"", ".1", ".2", ".3", ".4", ".9", ".10", ".12"};
+
+   /**
+    * <b>scenario</b>: Every conversion with different precisions and values.<br>
+    * <b>expected</b>: The same string and length as from snprintf.<br>
+    * ************************************************
+    */
+   for (auto& spec : SPECS)
+   {
+      for (const char* precision : PRECISIONS)
+      {
+         std::string fmt = std::string("<%") + precision + (spec[0] + 1) + ">";
+         std::string libc_fmt = std::string("<%") + precision + (spec[1] + 1) + ">";
+         for (unsigned int value : VALUES)
+         {
+            int length = string_format(result, fmt.c_str(), value);
+            int expected_length = snprintf(expected, sizeof(expected), libc_fmt.c_str(), value);
+            EXPECT_STREQ(expected, result) << "format " << fmt << " value " << value;
+            EXPECT_EQ(expected_length, length) << "format " << fmt << " value " << value;
+         }
+      }
+   }
+
+   /**
+    * <b>scenario</b>: Characters, strings and formats used by firmware.<br>
+    * <b>expected</b>: The same string as from snprintf.<br>
+    * ************************************************
+    */
+   string_format(result, "[%.2d-%.2d-%d %.2d:%.2d:%.2d:%.3d] - %s - %s:", 1, 2, 2020, 0, 5, 59, 7, "DEBUG", "main");
+   snprintf(expected, sizeof(expected), "[%.2d-%.2d-%d %.2d:%.2d:%.2d:%.3d] - %s - %s:", 1, 2, 2020, 0, 5, 59, 7, "DEBUG", "main");
+   EXPECT_STREQ(expected, result);
+   string_format(result, "AT+CIPSEND=%d,%d\r\n%c%s%%", 3, 1460, 'z', "");
+   snprintf(expected, sizeof(expected), "AT+CIPSEND=%d,%d\r\n%c%s%%", 3, 1460, 'z', "");
+   EXPECT_STREQ(expected, result);
+
+   /**
+    * <b>scenario</b>: Bounded variant with every buffer size.<br>
+    * <b>expected</b>: The same content as from snprintf, length of stored string returned.<br>
+    * ************************************************
+    */
+   const char* FMT = "%s=%.3d,%X;";
+   int full_length = snprintf(expected, sizeof(expected), FMT, "abc", -42, 0xBEEF);
+   for (size_t size = 1; size <= (size_t)full_length + 1; size++)
+   {
+      char bounded[64];
+      snprintf(expected, size, FMT, "abc", -42, 0xBEEF);
+      EXPECT_EQ((int)strlen(expected), string_format_n(bounded, size, FMT, "abc", -42, 0xBEEF));
+      EXPECT_STREQ(expected, bounded) << "size " << size;
+   }
+}